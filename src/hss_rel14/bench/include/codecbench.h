@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CODECBENCH_H
+#define __CODECBENCH_H
+
+#include <ostream>
+
+// Round trips every byte value and TBCD digit pair through the SCodec
+// conversions, reporting the first mismatch.
+bool verifyCodecs(std::ostream& os);
+
+// Reports the time per conversion for identifiers and key material of the
+// sizes the HSS handles, with the sscanf() IMSI parse as a reference.
+void runCodecBench(int count, std::ostream& os);
+
+#endif  // #define __CODECBENCH_H
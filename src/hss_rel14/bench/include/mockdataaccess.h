@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __MOCKDATAACCESS_H
+#define __MOCKDATAACCESS_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "localdataaccess.h"
+#include "ssync.h"
+#include "sthread.h"
+#include "timer.h"
+
+class MockDataAccess;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct MockCompletion {
+  CassFutureCallback cb;
+  void* data;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class MockCompletionThread : public SThread {
+ public:
+  MockCompletionThread(MockDataAccess& mock);
+  ~MockCompletionThread();
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  MockCompletionThread();
+
+  MockDataAccess& m_mock;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// The embedded storage engine without persistence, standing in for the
+// Cassandra backed DataAccess.  Queries are answered by LocalDataAccess when
+// they are issued and the callback is invoked with a NULL future from a
+// completion thread once the injected latency has expired, so the processors
+// see the same asynchronous behavior they see with the real driver.
+//
+class MockDataAccess : public LocalDataAccess {
+  friend MockCompletionThread;
+
+ public:
+  MockDataAccess();
+  ~MockDataAccess();
+
+  void provision(
+      uint64_t imsifirst, uint32_t imsicount, uint64_t msisdnfirst,
+      const std::string& subscription_data, const uint8_t* key,
+      const uint8_t* opc);
+
+  void start(int latency_us, int jitter_us, int threads);
+  void stop();
+
+  uint64_t issued() { return m_issued; }
+  uint64_t completed() { return m_completed; }
+
+ protected:
+  bool complete(CassFutureCallback cb, void* data);
+
+ private:
+  bool nextCompletion(MockCompletion& c, stimer_t& wait);
+  stimer_t latency();
+
+  SMutex m_cmpmutex;
+  std::multimap<stimer_t, MockCompletion> m_completions;
+  std::vector<MockCompletionThread*> m_threads;
+  volatile bool m_shutdown;
+
+  stimer_t m_latency;
+  stimer_t m_jitter;
+  volatile uint64_t m_seed;
+  volatile uint64_t m_issued;
+  volatile uint64_t m_completed;
+};
+
+#endif  // #define __MOCKDATAACCESS_H
@@ -0,0 +1,681 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "fd.h"
+#include "fdhss.h"
+#include "logger.h"
+#include "options.h"
+#include "s6as6d_impl.h"
+#include "satomic.h"
+#include "scodec.h"
+#include "statshss.h"
+#include "timer.h"
+
+#include "codecbench.h"
+#include "mockdataaccess.h"
+
+extern "C" {
+#include "hss_config.h"
+#include "aucpp.h"
+#include "auc.h"
+}
+
+hss_config_t hss_config;
+FDHss fdHss;
+
+#define ULR_S6A_S6D_INDICATOR (1U << 1)
+#define ULR_INITIAL_ATTACH_IND (1U << 5)
+#define RAT_TYPE_EUTRAN 1004
+
+// the requests appear to have been received from this peer, it is never
+// connected so the answers are dropped by the freeDiameter routing module
+#define BENCH_PEER "mme.bench.openair4G.eur"
+
+// give up on a run if no procedure completes for this long
+#define BENCH_STALL_MS 10000
+
+#define DEFAULT_KEY "8baf473f2f8fd09487cccbd7097c6862"
+#define DEFAULT_OPC "8e27b6af0e692e750f32667a3b14605d"
+#define DEFAULT_SUBSCRIPTION_DATA                                              \
+  "{\"Subscription-Data\":{\"Access-Restriction-Data\":41,"                    \
+  "\"Subscriber-Status\":0,\"Network-Access-Mode\":2,"                         \
+  "\"AMBR\":{\"Max-Requested-Bandwidth-UL\":50000000,"                         \
+  "\"Max-Requested-Bandwidth-DL\":100000000},"                                 \
+  "\"APN-Configuration-Profile\":{\"Context-Identifier\":0,"                   \
+  "\"All-APN-Configurations-Included-Indicator\":0,"                           \
+  "\"APN-Configuration\":{\"Context-Identifier\":0,\"PDN-Type\":0,"            \
+  "\"Service-Selection\":\"apn1\",\"EPS-Subscribed-QoS-Profile\":{"            \
+  "\"QoS-Class-Identifier\":9,\"Allocation-Retention-Priority\":{"             \
+  "\"Priority-Level\":15,\"Pre-emption-Capability\":0,"                        \
+  "\"Pre-emption-Vulnerability\":0}},\"AMBR\":{"                               \
+  "\"Max-Requested-Bandwidth-UL\":50000000,"                                   \
+  "\"Max-Requested-Bandwidth-DL\":100000000},"                                 \
+  "\"PDN-GW-Allocation-Type\":0}},"                                            \
+  "\"Subscribed-Periodic-RAU-TAU-Timer\":0}}"
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct BenchOptions {
+  BenchOptions()
+      : hsscfg("conf/bench.json"),
+        count(100000),
+        ulrpct(50),
+        latency(500),
+        jitter(100),
+        dbthreads(2),
+        imsifirst(208930000000001ULL),
+        imsicount(10000),
+        msisdnfirst(33600000001ULL),
+        vectors(1),
+        concurrent(0),
+        codec(false) {
+    workers.push_back(1);
+    workers.push_back(2);
+    workers.push_back(4);
+    workers.push_back(8);
+  }
+
+  std::string hsscfg;
+  std::vector<int> workers;
+  int count;
+  int ulrpct;
+  int latency;
+  int jitter;
+  int dbthreads;
+  uint64_t imsifirst;
+  uint32_t imsicount;
+  uint64_t msisdnfirst;
+  int vectors;
+  int concurrent;
+  bool codec;
+  std::string subdata;
+  std::string report;
+};
+
+struct BenchResult {
+  int workers;
+  int ulr;
+  int air;
+  stimer_t elapsed_ns;
+  stimer_t cpu_ns;
+  uint64_t answers;
+  uint64_t success;
+  uint64_t dbops;
+  PhaseTiming ulrtiming;
+  PhaseTiming airtiming;
+};
+
+static BenchOptions opt;
+
+static struct dict_object* resultCodeEntry = NULL;
+static volatile uint64_t answersDropped    = 0;
+static volatile uint64_t answersSuccess    = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static void help() {
+  std::cout
+      << std::endl
+      << "Usage: hss_bench [OPTIONS]..." << std::endl
+      << "  -h, --help                   Print help and exit" << std::endl
+      << "  -j, --hsscfg filename        The HSS json configuration "
+         "(default conf/bench.json)"
+      << std::endl
+      << "  -w, --workers list           Comma separated worker counts "
+         "(default 1,2,4,8)"
+      << std::endl
+      << "  -n, --count num              Procedures per run (default 100000)"
+      << std::endl
+      << "  -u, --ulr pct                Percentage of ULR procedures, the "
+         "remainder are AIR (default 50)"
+      << std::endl
+      << "  -l, --latency us             Injected database latency "
+         "(default 500)"
+      << std::endl
+      << "  -x, --jitter us              Injected database latency jitter "
+         "(default 100)"
+      << std::endl
+      << "  -t, --dbthreads num          Database completion threads "
+         "(default 2)"
+      << std::endl
+      << "  -i, --imsifirst imsi         First provisioned IMSI" << std::endl
+      << "  -k, --imsicount num          Number of provisioned IMSIs "
+         "(default 10000)"
+      << std::endl
+      << "  -v, --vectors num            Vectors requested per AIR "
+         "(default 1)"
+      << std::endl
+      << "  -c, --concurrent num         Concurrent transactions, overrides "
+         "the HSS configuration"
+      << std::endl
+      << "  -s, --subdata filename       File containing the subscription "
+         "data json"
+      << std::endl
+      << "  -o, --report filename        Also write the report to filename"
+      << std::endl
+      << "  -C, --codec                  Verify and time the identifier "
+         "conversions, -n sets the iterations"
+      << std::endl;
+}
+
+static bool parseWorkers(const char* s) {
+  std::stringstream ss(s);
+  std::string item;
+
+  opt.workers.clear();
+  while (std::getline(ss, item, ',')) {
+    int n = atoi(item.c_str());
+    if (n <= 0) {
+      std::cout << "Invalid worker count [" << item << "]" << std::endl;
+      return false;
+    }
+    opt.workers.push_back(n);
+  }
+
+  // the worker pool only grows so the runs are performed in ascending order
+  std::sort(opt.workers.begin(), opt.workers.end());
+
+  return !opt.workers.empty();
+}
+
+static bool parseOptions(int argc, char** argv) {
+  int c;
+  int option_index = 0;
+
+  struct option long_options[] = {
+      {"help", no_argument, NULL, 'h'},
+      {"hsscfg", required_argument, NULL, 'j'},
+      {"workers", required_argument, NULL, 'w'},
+      {"count", required_argument, NULL, 'n'},
+      {"ulr", required_argument, NULL, 'u'},
+      {"latency", required_argument, NULL, 'l'},
+      {"jitter", required_argument, NULL, 'x'},
+      {"dbthreads", required_argument, NULL, 't'},
+      {"imsifirst", required_argument, NULL, 'i'},
+      {"imsicount", required_argument, NULL, 'k'},
+      {"vectors", required_argument, NULL, 'v'},
+      {"concurrent", required_argument, NULL, 'c'},
+      {"subdata", required_argument, NULL, 's'},
+      {"report", required_argument, NULL, 'o'},
+      {"codec", no_argument, NULL, 'C'},
+      {NULL, 0, NULL, 0}};
+
+  while (1) {
+    c = getopt_long(
+        argc, argv, "hj:w:n:u:l:x:t:i:k:v:c:s:o:C", long_options,
+        &option_index);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'h': {
+        help();
+        exit(0);
+      }
+      case 'j': {
+        opt.hsscfg = optarg;
+        break;
+      }
+      case 'w': {
+        if (!parseWorkers(optarg)) return false;
+        break;
+      }
+      case 'n': {
+        opt.count = atoi(optarg);
+        break;
+      }
+      case 'u': {
+        opt.ulrpct = atoi(optarg);
+        break;
+      }
+      case 'l': {
+        opt.latency = atoi(optarg);
+        break;
+      }
+      case 'x': {
+        opt.jitter = atoi(optarg);
+        break;
+      }
+      case 't': {
+        opt.dbthreads = atoi(optarg);
+        break;
+      }
+      case 'i': {
+        opt.imsifirst = strtoull(optarg, NULL, 10);
+        break;
+      }
+      case 'k': {
+        opt.imsicount = strtoul(optarg, NULL, 10);
+        break;
+      }
+      case 'v': {
+        opt.vectors = atoi(optarg);
+        break;
+      }
+      case 'c': {
+        opt.concurrent = atoi(optarg);
+        break;
+      }
+      case 's': {
+        opt.subdata = optarg;
+        break;
+      }
+      case 'o': {
+        opt.report = optarg;
+        break;
+      }
+      case 'C': {
+        opt.codec = true;
+        break;
+      }
+      default: {
+        help();
+        return false;
+      }
+    }
+  }
+
+  if (opt.count <= 0 || opt.ulrpct < 0 || opt.ulrpct > 100 ||
+      opt.latency < 0 || opt.jitter < 0 || opt.jitter > opt.latency ||
+      opt.dbthreads <= 0 || opt.imsicount == 0 || opt.vectors <= 0 ||
+      opt.vectors > AUTH_MAX_EUTRAN_VECTORS) {
+    std::cout << "Invalid benchmark options" << std::endl;
+    help();
+    return false;
+  }
+
+  return true;
+}
+
+static bool hex2bin(const char* hex, uint8_t* bin, size_t len) {
+  return strlen(hex) == len * 2 && SCodec::hexDecode(hex, bin, len);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Every answer is dropped by the routing module since the originating peer
+// does not exist, registering for the dropped hook replaces the default
+// logging and lets the benchmark count the answers and their result.
+//
+static void onMessageDropped(
+    enum fd_hook_type type, struct msg* msg, struct peer_hdr* peer, void* other,
+    struct fd_hook_permsgdata* pmd, void* regdata) {
+  struct msg_hdr* hdr = NULL;
+
+  if (!msg || fd_msg_hdr(msg, &hdr) != 0 || (hdr->msg_flags & CMD_FLAG_REQUEST))
+    return;
+
+  struct avp* avp = NULL;
+  if (fd_msg_search_avp(msg, resultCodeEntry, &avp) == 0 && avp) {
+    struct avp_hdr* ahdr = NULL;
+    if (fd_msg_avp_hdr(avp, &ahdr) == 0 && ahdr->avp_value &&
+        ahdr->avp_value->u32 == ER_DIAMETER_SUCCESS)
+      atomic_inc_fetch(answersSuccess);
+  }
+
+  atomic_inc_fetch(answersDropped);
+}
+
+static void addCommon(
+    s6as6d::Application& app, FDMessageRequest* req, const std::string& session,
+    const std::string& imsi) {
+  static uint8_t visitedplmn[3] = {0x00, 0xf1, 0x10};
+
+  req->add(app.getDict().avpSessionId(), session);
+  req->add(app.getDict().avpAuthSessionState(), 1);
+  req->addOrigin();
+  req->add(
+      app.getDict().avpDestinationRealm(),
+      std::string(fd_g_config->cnf_diamrlm));
+  req->add(app.getDict().avpUserName(), imsi);
+  req->add(app.getDict().avpVisitedPlmnId(), visitedplmn, sizeof(visitedplmn));
+
+  fd_msg_source_set(req->getMsg(), (DiamId_t) BENCH_PEER, strlen(BENCH_PEER));
+}
+
+static FDMessageRequest* createULR(
+    s6as6d::Application& app, const std::string& imsi) {
+  s6as6d::UPLRreq* s = new s6as6d::UPLRreq(app);
+
+  addCommon(app, s, s->getSessionId(), imsi);
+  s->add(app.getDict().avpRatType(), (int32_t) RAT_TYPE_EUTRAN);
+  s->add(
+      app.getDict().avpUlrFlags(),
+      (uint32_t)(ULR_S6A_S6D_INDICATOR | ULR_INITIAL_ATTACH_IND));
+
+  return s;
+}
+
+static FDMessageRequest* createAIR(
+    s6as6d::Application& app, const std::string& imsi) {
+  s6as6d::AUIRreq* s = new s6as6d::AUIRreq(app);
+
+  addCommon(app, s, s->getSessionId(), imsi);
+
+  FDAvp reai(app.getDict().avpRequestedEutranAuthenticationInfo());
+  reai.add(app.getDict().avpNumberOfRequestedVectors(), (uint32_t) opt.vectors);
+  reai.add(app.getDict().avpImmediateResponsePreferred(), (uint32_t) 1);
+  s->add(reai);
+
+  return s;
+}
+
+static stimer_t processCpuTime() {
+  struct timespec ts;
+  if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts)) return 0;
+  return ((stimer_t) ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static bool runBench(
+    s6as6d::Application& app, MockDataAccess& mock, int workers,
+    BenchResult& r) {
+  std::vector<FDMessageRequest*> reqs;
+  std::vector<bool> isulr;
+
+  r.workers = workers;
+  r.ulr     = 0;
+  r.air     = 0;
+
+  if (fdHss.getWorkMgr().numWorkers() < workers)
+    fdHss.getWorkMgr().init(workers - fdHss.getWorkMgr().numWorkers());
+
+  //
+  // the requests are built before the clock starts, only the HSS processing
+  // of each request is measured
+  //
+  reqs.reserve(opt.count);
+  isulr.reserve(opt.count);
+  try {
+    for (int i = 0; i < opt.count; i++) {
+      std::string imsi = std::to_string(opt.imsifirst + (i % opt.imsicount));
+      bool ulr         = (i % 100) < opt.ulrpct;
+      reqs.push_back(ulr ? createULR(app, imsi) : createAIR(app, imsi));
+      isulr.push_back(ulr);
+      if (ulr)
+        r.ulr++;
+      else
+        r.air++;
+    }
+  } catch (FDException& ex) {
+    std::cout << "Error creating the requests - " << ex.what() << std::endl;
+    for (auto it = reqs.begin(); it != reqs.end(); ++it) delete *it;
+    return false;
+  }
+
+  ulrPhaseTiming.reset();
+  airPhaseTiming.reset();
+  answersDropped = 0;
+  answersSuccess = 0;
+  uint64_t dbops = mock.completed();
+
+  stimer_t start    = STIMER_GET_CURRENT_TIME;
+  stimer_t cpustart = processCpuTime();
+
+  // submit the requests the same way the freeDiameter dispatch callback does
+  for (int i = 0; i < opt.count; i++) {
+    if (isulr[i])
+      app.getUPLRcmd().process(reqs[i]);
+    else
+      app.getAUIRcmd().process(reqs[i]);
+  }
+
+  // wait for every processor to finish and every answer to be routed
+  uint64_t last      = 0;
+  stimer_t lastprogr = STIMER_GET_CURRENT_TIME;
+  bool stalled       = false;
+
+  while (true) {
+    QueueGauges g;
+    fdHss.getWorkerQueue().getGauges(g);
+
+    if (g.pending == 0 && g.active == 0 &&
+        answersDropped >= (uint64_t) opt.count)
+      break;
+
+    if (answersDropped != last) {
+      last      = answersDropped;
+      lastprogr = STIMER_GET_CURRENT_TIME;
+    } else if (STIMER_GET_ELAPSED_NS(lastprogr) > BENCH_STALL_MS * 1000000LL) {
+      std::cout << "Run with " << workers << " workers stalled, pending="
+                << g.pending << " active=" << g.active
+                << " answers=" << answersDropped << std::endl;
+      stalled = true;
+      break;
+    }
+
+    SThread::sleep(1);
+  }
+
+  r.elapsed_ns = STIMER_GET_ELAPSED_NS(start);
+  r.cpu_ns     = processCpuTime() - cpustart;
+  r.answers    = answersDropped;
+  r.success    = answersSuccess;
+  r.dbops      = mock.completed() - dbops;
+  memcpy(
+      (void*) r.ulrtiming.calls, (void*) ulrPhaseTiming.calls,
+      sizeof(r.ulrtiming.calls));
+  memcpy(
+      (void*) r.ulrtiming.cpu_ns, (void*) ulrPhaseTiming.cpu_ns,
+      sizeof(r.ulrtiming.cpu_ns));
+  memcpy(
+      (void*) r.airtiming.calls, (void*) airPhaseTiming.calls,
+      sizeof(r.airtiming.calls));
+  memcpy(
+      (void*) r.airtiming.cpu_ns, (void*) airPhaseTiming.cpu_ns,
+      sizeof(r.airtiming.cpu_ns));
+
+  // the dispatch callback never frees the request objects, the answers (and
+  // the underlying request messages) have been freed by freeDiameter
+  if (!stalled)
+    for (auto it = reqs.begin(); it != reqs.end(); ++it) delete *it;
+
+  return !stalled;
+}
+
+static void reportTiming(
+    std::ostream& os, const char* proc, const char* phases[], int nphases,
+    PhaseTiming& t, int procedures) {
+  if (procedures == 0) return;
+
+  for (int i = 0; i < PHASE_TIMING_SLOTS; i++) {
+    if (t.calls[i] == 0) continue;
+
+    const char* name = i == PHASE_TIMING_CALLBACK ?
+                           "CALLBACK" :
+                           i < nphases ? phases[i] : "UNKNOWN";
+
+    os << "    " << proc << " " << std::left << std::setw(12) << name
+       << std::right << " calls " << std::setw(10) << t.calls[i]
+       << "  cpu us/call " << std::setw(8) << std::fixed
+       << std::setprecision(2) << (double) t.cpu_ns[i] / t.calls[i] / 1000
+       << "  cpu us/proc " << std::setw(8)
+       << (double) t.cpu_ns[i] / procedures / 1000 << std::endl;
+  }
+}
+
+static void report(std::ostream& os, std::vector<BenchResult>& results) {
+  static const char* ulrphases[] = {"PHASEFINAL", "PHASE1", "PHASE2",
+                                    "PHASE3",     "PHASE4", "PHASE5"};
+  static const char* airphases[] = {"PHASEFINAL", "PHASE1", "PHASE2",
+                                    "PHASE3"};
+
+  os << std::endl
+     << "HSS benchmark: " << opt.count << " procedures per run, " << opt.ulrpct
+     << "% ULR, latency " << opt.latency << "us +/- " << opt.jitter
+     << "us, concurrent " << opt.concurrent << std::endl
+     << std::endl;
+
+  os << std::setw(8) << "workers" << std::setw(12) << "proc/s"
+     << std::setw(12) << "elapsed ms" << std::setw(12) << "answers"
+     << std::setw(12) << "success" << std::setw(12) << "db ops"
+     << std::setw(14) << "cpu us/proc" << std::endl;
+
+  for (auto it = results.begin(); it != results.end(); ++it) {
+    int procs = it->ulr + it->air;
+    double secs = (double) it->elapsed_ns / 1000000000;
+
+    os << std::setw(8) << it->workers << std::setw(12) << std::fixed
+       << std::setprecision(0) << (secs > 0 ? procs / secs : 0)
+       << std::setw(12) << it->elapsed_ns / 1000000 << std::setw(12)
+       << it->answers << std::setw(12) << it->success << std::setw(12)
+       << it->dbops << std::setw(14) << std::setprecision(2)
+       << (double) it->cpu_ns / procs / 1000 << std::endl;
+
+    reportTiming(os, "ULR", ulrphases, 6, it->ulrtiming, it->ulr);
+    reportTiming(os, "AIR", airphases, 4, it->airtiming, it->air);
+  }
+
+  os << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  if (!parseOptions(argc, argv)) return 1;
+
+  if (opt.codec) {
+    if (!verifyCodecs(std::cout)) return 1;
+    runCodecBench(opt.count, std::cout);
+    return 0;
+  }
+
+  // the HSS options are read from the json configuration only
+  char* hssargv[] = {argv[0], (char*) "-j", (char*) opt.hsscfg.c_str(), NULL};
+  optind          = 1;
+  if (!Options::parse(3, hssargv)) {
+    std::cout << "Options::parse() failed" << std::endl;
+    return 1;
+  }
+
+  if (opt.concurrent <= 0) opt.concurrent = Options::getconcurrent();
+  fdHss.getWorkerQueue().setConcurrent(opt.concurrent);
+
+  std::string subdata = DEFAULT_SUBSCRIPTION_DATA;
+  if (!opt.subdata.empty()) {
+    std::ifstream ifs(opt.subdata.c_str());
+    if (!ifs) {
+      std::cout << "Unable to open [" << opt.subdata << "]" << std::endl;
+      return 1;
+    }
+    std::stringstream ss;
+    ss << ifs.rdbuf();
+    subdata = ss.str();
+  }
+
+  uint8_t key[KEY_LENGTH];
+  uint8_t opc[OPC_LENGTH];
+  hex2bin(DEFAULT_KEY, key, sizeof(key));
+  hex2bin(DEFAULT_OPC, opc, sizeof(opc));
+
+  Logger::init("hss_bench");
+  StatsHss::initstats(&Logger::singleton().stat());
+
+  memset(&hss_config, 0, sizeof(hss_config_t));
+  Options::fillhssconfig(&hss_config);
+
+  random_init();
+
+  FDEngine diameter;
+  MockDataAccess mock;
+  s6as6d::Application* app = NULL;
+  struct fd_hook_hdl* hook = NULL;
+  std::vector<BenchResult> results;
+
+  try {
+    diameter.setConfigFile(hss_config.freediameter_config);
+    if (!diameter.init()) return 1;
+
+    app             = new s6as6d::Application(mock);
+    resultCodeEntry = app->getDict().avpResultCode().getEntry();
+
+    if (fd_hook_register(
+            HOOK_MASK(HOOK_MESSAGE_DROPPED), onMessageDropped, NULL, NULL,
+            &hook) != 0) {
+      std::cout << "Unable to register the dropped message hook" << std::endl;
+      return 1;
+    }
+
+    if (!diameter.start()) return 1;
+  } catch (FDException& ex) {
+    std::cout << "Error initializing freeDiameter - " << ex.what()
+              << std::endl;
+    return 1;
+  }
+
+  StatsHss::singleton().setInterval(Options::statsFrequency());
+  StatsHss::singleton().init(NULL);
+
+  std::cout << "Provisioning " << opt.imsicount << " subscribers" << std::endl;
+  mock.provision(
+      opt.imsifirst, opt.imsicount, opt.msisdnfirst, subdata, key, opc);
+
+  // the ULR's are sent with this node's origin host
+  std::string mmehost(fd_g_config->cnf_diamid);
+  std::string mmerealm(fd_g_config->cnf_diamrlm);
+  mock.addMmeIdentity(mmehost, mmerealm, 1);
+
+  mock.start(opt.latency, opt.jitter, opt.dbthreads);
+
+  for (auto it = opt.workers.begin(); it != opt.workers.end(); ++it) {
+    BenchResult r;
+    std::cout << "Running " << opt.count << " procedures with " << *it
+              << " workers" << std::endl;
+    if (!runBench(*app, mock, *it, r)) break;
+    results.push_back(r);
+  }
+
+  report(std::cout, results);
+  if (!opt.report.empty()) {
+    std::ofstream ofs(opt.report.c_str());
+    report(ofs, results);
+  }
+
+  fdHss.getWorkMgr().waitForShutdown();
+  mock.stop();
+
+  if (hook) fd_hook_unregister(hook);
+  diameter.uninit(false);
+  diameter.waitForShutdown();
+
+  if (StatsHss::singleton().isRunning()) StatsHss::singleton().quit();
+  StatsHss::singleton().join();
+
+  Logger::flush();
+  Logger::cleanup();
+
+  return 0;
+}
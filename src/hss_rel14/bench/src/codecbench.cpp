@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <iomanip>
+#include <string>
+
+#include "scodec.h"
+#include "timer.h"
+
+#include "codecbench.h"
+
+#define BENCH_KEY "8baf473f2f8fd09487cccbd7097c6862"
+#define BENCH_IMSI "208930000000001"
+#define BENCH_MSISDN "33600000001"
+
+// keeps the conversions from being optimized away
+static volatile uint64_t sink;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static bool verifyHex(std::ostream& os) {
+  uint8_t bytes[256];
+  uint8_t decoded[256];
+  char hex[512];
+
+  for (int i = 0; i < 256; i++) bytes[i] = (uint8_t) i;
+
+  for (int upper = 0; upper < 2; upper++) {
+    // every length exercises both the vector blocks and the scalar tail
+    for (size_t len = 0; len <= sizeof(bytes); len++) {
+      SCodec::hexEncode(bytes, len, hex, upper);
+
+      for (size_t i = 0; i < len; i++) {
+        char expected[3];
+        snprintf(expected, sizeof(expected), upper ? "%02X" : "%02x", bytes[i]);
+        if (hex[i * 2] != expected[0] || hex[i * 2 + 1] != expected[1]) {
+          os << "hexEncode mismatch for " << (int) bytes[i] << std::endl;
+          return false;
+        }
+      }
+
+      if (!SCodec::hexDecode(hex, decoded, len) ||
+          memcmp(bytes, decoded, len) != 0) {
+        os << "hexDecode round trip failed, length " << len << std::endl;
+        return false;
+      }
+    }
+  }
+
+  // every character in every position of a 16 byte block
+  SCodec::hexEncode(bytes, 16, hex);
+  for (int pos = 0; pos < 32; pos++) {
+    char saved = hex[pos];
+    for (int c = 0; c < 256; c++) {
+      hex[pos]   = (char) c;
+      bool valid = isxdigit(c);
+      if (SCodec::hexDecode(hex, decoded, 16) != valid) {
+        os << "hexDecode accepted or rejected " << c << " at " << pos
+           << std::endl;
+        return false;
+      }
+    }
+    hex[pos] = saved;
+  }
+
+  return true;
+}
+
+static bool verifyTbcd(std::ostream& os) {
+  static const char* digits = "0123456789*#abc";
+
+  for (int hi = 0; hi < 15; hi++) {
+    for (int lo = 0; lo < 16; lo++) {
+      char str[3] = {digits[hi], lo < 15 ? digits[lo] : '\0', '\0'};
+      size_t len  = strlen(str);
+      uint8_t tbcd;
+      char decoded[3];
+
+      if (SCodec::tbcdEncode(str, len, &tbcd, 1) != 1 ||
+          tbcd != (uint8_t)((hi << 4) | lo) ||
+          SCodec::tbcdDecode(&tbcd, 1, decoded, sizeof(decoded)) != len ||
+          strcmp(str, decoded) != 0) {
+        os << "TBCD round trip failed for [" << str << "]" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+static bool verifyDigits(std::ostream& os) {
+  static const char* imsi = "2089300000000012345678901234567";
+  uint8_t values[32];
+  uint64_t v;
+
+  if (!SCodec::digitsDecode(imsi, strlen(imsi), values)) {
+    os << "digitsDecode rejected [" << imsi << "]" << std::endl;
+    return false;
+  }
+  for (size_t i = 0; i < strlen(imsi); i++) {
+    if (values[i] != imsi[i] - '0') {
+      os << "digitsDecode mismatch at " << i << std::endl;
+      return false;
+    }
+  }
+
+  if (!SCodec::parseUint64(BENCH_IMSI, v) || v != 208930000000001ULL ||
+      !SCodec::parseUint64("18446744073709551615", v) || v != UINT64_MAX ||
+      SCodec::parseUint64("18446744073709551616", v) ||
+      SCodec::parseUint64("20893000000000x", v)) {
+    os << "parseUint64 failed" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool verifyCodecs(std::ostream& os) {
+  return verifyHex(os) && verifyTbcd(os) && verifyDigits(os);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static void reportCodec(
+    std::ostream& os, const char* name, stimer_t elapsed, int count) {
+  os << std::left << std::setw(28) << name << std::right << std::fixed
+     << std::setprecision(1) << std::setw(10) << (double) elapsed / count
+     << " ns/op" << std::endl;
+}
+
+void runCodecBench(int count, std::ostream& os) {
+  uint8_t key[16];
+  uint8_t tbcd[8];
+  uint8_t digits[16];
+  char hex[32];
+  char str[17];
+  size_t tbcdlen;
+  uint64_t v = 0;
+  stimer_t start;
+
+  SCodec::hexDecode(BENCH_KEY, key, sizeof(key));
+  tbcdlen = SCodec::tbcdEncode(
+      BENCH_MSISDN, strlen(BENCH_MSISDN), tbcd, sizeof(tbcd));
+
+  os << "Codec timing (" << count << " iterations)" << std::endl;
+
+  STIMER_GET_CURRENT_TP(start);
+  for (int i = 0; i < count; i++) {
+    SCodec::hexEncode(key, sizeof(key), hex);
+    sink += hex[i & 31];
+  }
+  reportCodec(os, "hexEncode (16 bytes)", STIMER_GET_ELAPSED_NS(start), count);
+
+  STIMER_GET_CURRENT_TP(start);
+  for (int i = 0; i < count; i++) {
+    SCodec::hexDecode(BENCH_KEY, key, sizeof(key));
+    sink += key[i & 15];
+  }
+  reportCodec(os, "hexDecode (32 digits)", STIMER_GET_ELAPSED_NS(start), count);
+
+  STIMER_GET_CURRENT_TP(start);
+  for (int i = 0; i < count; i++) {
+    SCodec::tbcdEncode(BENCH_MSISDN, strlen(BENCH_MSISDN), tbcd, sizeof(tbcd));
+    sink += tbcd[i & 3];
+  }
+  reportCodec(
+      os, "tbcdEncode (MSISDN)", STIMER_GET_ELAPSED_NS(start), count);
+
+  STIMER_GET_CURRENT_TP(start);
+  for (int i = 0; i < count; i++)
+    sink += SCodec::tbcdDecode(tbcd, tbcdlen, str, sizeof(str));
+  reportCodec(
+      os, "tbcdDecode (MSISDN)", STIMER_GET_ELAPSED_NS(start), count);
+
+  STIMER_GET_CURRENT_TP(start);
+  for (int i = 0; i < count; i++) {
+    SCodec::digitsDecode(BENCH_IMSI, strlen(BENCH_IMSI), digits);
+    sink += digits[i & 7];
+  }
+  reportCodec(os, "digitsDecode (IMSI)", STIMER_GET_ELAPSED_NS(start), count);
+
+  STIMER_GET_CURRENT_TP(start);
+  for (int i = 0; i < count; i++) {
+    SCodec::parseUint64(BENCH_IMSI, strlen(BENCH_IMSI), v);
+    sink += v;
+  }
+  reportCodec(os, "parseUint64 (IMSI)", STIMER_GET_ELAPSED_NS(start), count);
+
+  STIMER_GET_CURRENT_TP(start);
+  for (int i = 0; i < count; i++) {
+    sscanf(BENCH_IMSI, "%" SCNu64, &v);
+    sink += v;
+  }
+  reportCodec(os, "sscanf (IMSI)", STIMER_GET_ELAPSED_NS(start), count);
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+#include <time.h>
+#include <sstream>
+
+#include "mockdataaccess.h"
+#include "common_def.h"
+#include "logger.h"
+#include "satomic.h"
+#include "util.h"
+
+// upper bound on how long a completion thread sleeps before checking the
+// completion queue again
+#define MOCK_MAX_SLEEP_NS 100000
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+MockCompletionThread::MockCompletionThread(MockDataAccess& mock)
+    : SThread(true), m_mock(mock) {}
+
+MockCompletionThread::~MockCompletionThread() {}
+
+unsigned long MockCompletionThread::threadProc(void* arg) {
+  MockCompletion c;
+  stimer_t wait;
+
+  while (!m_mock.m_shutdown) {
+    if (m_mock.nextCompletion(c, wait)) {
+      c.cb(NULL, c.data);
+      atomic_inc_fetch(m_mock.m_completed);
+      continue;
+    }
+
+    struct timespec ts;
+    ts.tv_sec  = 0;
+    ts.tv_nsec = wait < MOCK_MAX_SLEEP_NS ? wait : MOCK_MAX_SLEEP_NS;
+    nanosleep(&ts, NULL);
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+MockDataAccess::MockDataAccess()
+    : m_shutdown(false),
+      m_latency(0),
+      m_jitter(0),
+      m_seed(0x9e3779b97f4a7c15ULL),
+      m_issued(0),
+      m_completed(0) {
+  // nothing is persisted and the completions are scheduled by this class
+  open("", 0, false, 0);
+}
+
+MockDataAccess::~MockDataAccess() {
+  stop();
+}
+
+void MockDataAccess::provision(
+    uint64_t imsifirst, uint32_t imsicount, uint64_t msisdnfirst,
+    const std::string& subscription_data, const uint8_t* key,
+    const uint8_t* opc) {
+  for (uint32_t i = 0; i < imsicount; i++) {
+    std::stringstream ss;
+    ss << imsifirst + i;
+
+    DAImsiInfo info;
+    DAImsiSec sec;
+
+    info.imsi               = ss.str();
+    info.msisdn             = msisdnfirst + i;
+    info.str_msisdn         = std::to_string(info.msisdn);
+    info.subscription_data  = subscription_data;
+    info.access_restriction = 0;
+    info.mme_id             = -1;
+
+    memcpy(sec.key, key, KEY_LENGTH);
+    memcpy(sec.opc, opc, OPC_LENGTH);
+    memset(sec.rand, 0, RAND_LENGTH);
+    memset(sec.sqn, 0, SQN_LENGTH);
+
+    addImsi(info, sec);
+  }
+}
+
+void MockDataAccess::start(int latency_us, int jitter_us, int threads) {
+  m_latency  = (stimer_t) latency_us * 1000;
+  m_jitter   = (stimer_t) jitter_us * 1000;
+  m_shutdown = false;
+
+  for (int i = 0; i < threads; i++) {
+    MockCompletionThread* t = new MockCompletionThread(*this);
+    t->init(NULL);
+    m_threads.push_back(t);
+  }
+}
+
+void MockDataAccess::stop() {
+  m_shutdown = true;
+
+  for (auto it = m_threads.begin(); it != m_threads.end(); ++it) {
+    (*it)->join();
+    delete *it;
+  }
+
+  m_threads.clear();
+}
+
+stimer_t MockDataAccess::latency() {
+  if (m_jitter <= 0) return m_latency;
+
+  // xorshift over a shared seed, the occasional lost update between threads
+  // only affects the distribution of the jitter
+  uint64_t x = m_seed;
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  m_seed = x;
+
+  stimer_t l = m_latency - m_jitter + (stimer_t)(x % (2 * m_jitter + 1));
+  return l < 0 ? 0 : l;
+}
+
+bool MockDataAccess::complete(CassFutureCallback cb, void* data) {
+  // synchronous callers do not supply a callback
+  if (!cb) return true;
+
+  MockCompletion c;
+  c.cb   = cb;
+  c.data = data;
+
+  stimer_t due = STIMER_GET_CURRENT_TIME + latency();
+
+  atomic_inc_fetch(m_issued);
+
+  SMutexLock l(m_cmpmutex);
+  m_completions.insert(std::make_pair(due, c));
+
+  return true;
+}
+
+bool MockDataAccess::nextCompletion(MockCompletion& c, stimer_t& wait) {
+  SMutexLock l(m_cmpmutex);
+
+  if (m_completions.empty()) {
+    wait = MOCK_MAX_SLEEP_NS;
+    return false;
+  }
+
+  auto it      = m_completions.begin();
+  stimer_t now = STIMER_GET_CURRENT_TIME;
+
+  if (it->first > now) {
+    wait = it->first - now;
+    return false;
+  }
+
+  c = it->second;
+  m_completions.erase(it);
+
+  return true;
+}
@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __BULK_H
+#define __BULK_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <zlib.h>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "scassandra.h"
+#include "ssync.h"
+#include "sthread.h"
+
+class Importer;
+class Exporter;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct BulkOptions {
+  BulkOptions()
+      : keyspace("vhss"),
+        threads(8),
+        ranges(256),
+        pagesize(1000),
+        inflight(1024),
+        secbin(false) {}
+
+  std::string fdcfg;
+  std::string host;
+  std::string keyspace;
+  std::string command;
+  std::string file;
+  std::string format;
+  std::string statefile;
+  int threads;
+  int ranges;
+  int pagesize;
+  int inflight;
+  bool secbin;
+};
+
+//
+// The provisioned values of a subscriber as they are imported and exported.
+// An empty string, or a has_ flag that is not set, is a value that is not
+// supplied, it is left unchanged by an import.
+//
+struct BulkSubscriber {
+  BulkSubscriber() { clear(); }
+
+  void clear() {
+    imsi.clear();
+    msisdn             = 0;
+    has_ar             = false;
+    access_restriction = 0;
+    key.clear();
+    opc.clear();
+    rand.clear();
+    has_sqn = false;
+    sqn     = 0;
+    has_subdata = false;
+    subscription_data.clear();
+    extids.clear();
+  }
+
+  std::string imsi;
+  int64_t msisdn;
+  bool has_ar;
+  int32_t access_restriction;
+  // hex
+  std::string key;
+  std::string opc;
+  std::string rand;
+  bool has_sqn;
+  int64_t sqn;
+  bool has_subdata;
+  std::string subscription_data;
+  std::vector<std::string> extids;
+};
+
+//
+// The CSV and NDJSON representations of a subscriber.  Both use the column
+// names of users_imsi, extids are a JSON array or a CSV field separated by
+// ';'.  A CSV file starts with a header naming its columns, a field may be
+// quoted as described in RFC 4180 but may not contain a line break.
+//
+class BulkFormat {
+ public:
+  BulkFormat(const std::string& format) : m_csv(format == "csv") {}
+
+  bool isCsv() { return m_csv; }
+
+  bool parseHeader(const std::string& line, std::string& err);
+  bool parse(const std::string& line, BulkSubscriber& sub, std::string& err);
+
+  void header(std::string& out);
+  void format(const BulkSubscriber& sub, std::string& out);
+
+  static const char* columns[];
+
+ private:
+  bool parseCsv(const std::string& line, BulkSubscriber& sub, std::string& err);
+  bool parseJson(
+      const std::string& line, BulkSubscriber& sub, std::string& err);
+  bool setValue(
+      int column, const std::string& value, BulkSubscriber& sub,
+      std::string& err);
+
+  bool m_csv;
+  std::vector<int> m_header;
+};
+
+//
+// The progress of an import or export that is saved to the state file, so
+// an interrupted or partially failed run resumes where it left off.  An
+// import records the number of input lines that have been written, an
+// export the size of the output and the token ranges it contains.
+//
+class BulkState {
+ public:
+  BulkState(const std::string& path)
+      : m_path(path), m_lines(0), m_offset(0), m_total(0) {}
+
+  bool load();
+  bool save();
+  void remove();
+
+  uint64_t lines() { return m_lines; }
+  void lines(uint64_t l) { m_lines = l; }
+
+  uint64_t offset() { return m_offset; }
+  void offset(uint64_t o) { m_offset = o; }
+
+  // the number of ranges the token ring was split into
+  int total() { return m_total; }
+  void total(int t) { m_total = t; }
+  std::set<int>& ranges() { return m_ranges; }
+
+ private:
+  std::string m_path;
+  uint64_t m_lines;
+  uint64_t m_offset;
+  int m_total;
+  std::set<int> m_ranges;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// a block of consecutive input lines, the unit in which import progress is
+// recorded
+struct ImportChunk {
+  ImportChunk(Importer& importer, uint64_t index, uint64_t firstline)
+      : importer(importer),
+        index(index),
+        firstline(firstline),
+        pending(1),
+        failed(false) {}
+
+  Importer& importer;
+  uint64_t index;
+  uint64_t firstline;
+  std::vector<std::string> lines;
+  // outstanding writes, plus one until all of the writes have been issued
+  volatile int pending;
+  volatile bool failed;
+};
+
+class ImportWorker : public SThread {
+ public:
+  ImportWorker(Importer& importer);
+  ~ImportWorker();
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  ImportWorker();
+
+  Importer& m_importer;
+};
+
+//
+// Reads the input on the calling thread and hands blocks of lines to the
+// worker threads, which parse them and issue the writes asynchronously with
+// at most BulkOptions::inflight outstanding.  The writes are prepared
+// statements, so the driver routes each one to a replica of its partition.
+// Progress is recorded once every block before it has been written, a block
+// with a failed write stops progress from advancing so the next run retries
+// it.  The writes are upserts, so writing a line again is harmless.
+//
+class Importer {
+  friend ImportWorker;
+
+ public:
+  Importer(BulkOptions& opt);
+  ~Importer();
+
+  bool connect();
+  bool run();
+
+  void report(std::ostream& os);
+
+  uint64_t failed() { return m_failed + m_rejected; }
+
+ private:
+  static void on_write_callback(CassFuture* future, void* data);
+
+  void queue(ImportChunk* chunk);
+  ImportChunk* nextChunk();
+  void process(ImportChunk* chunk);
+  void importLine(ImportChunk* chunk, uint64_t lineno, const std::string& line);
+  void write(ImportChunk* chunk, SCassStatement& stmt);
+  void issued(ImportChunk* chunk);
+  void completed(ImportChunk* chunk);
+  void progress(bool final);
+
+  BulkOptions& m_opt;
+  BulkFormat m_format;
+  BulkState m_state;
+  SCassandra m_db;
+  SCassPrepared m_insimsi;
+  SCassPrepared m_insimsibin;
+  SCassPrepared m_insmsisdn;
+  SCassPrepared m_insextid;
+  SCassPrepared m_insextidimsi;
+  SCassPrepared m_insextidxref;
+
+  SSemaphore m_window;
+  SSemaphore m_queued;
+  SSemaphore m_queueslots;
+  SMutex m_mutex;
+  std::deque<ImportChunk*> m_queue;
+  std::map<uint64_t, ImportChunk*> m_done;
+  uint64_t m_nextdone;
+  uint64_t m_checkpoint;
+  bool m_stalled;
+
+  volatile uint64_t m_lines;
+  volatile uint64_t m_subscribers;
+  volatile uint64_t m_writes;
+  volatile uint64_t m_failed;
+  volatile uint64_t m_rejected;
+  uint64_t m_started;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class ExportWorker : public SThread {
+ public:
+  ExportWorker(Exporter& exporter);
+  ~ExportWorker();
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  ExportWorker();
+
+  Exporter& m_exporter;
+};
+
+//
+// Scans users_imsi and extid_imsi_xref in parallel token ranges.  The rows
+// of a range are formatted in memory and appended to the output when the
+// range is complete, as a separate gzip member when the output is
+// compressed, after which the range is recorded in the state file.  A run
+// that is resumed truncates the output to the recorded size and skips the
+// recorded ranges.
+//
+class Exporter {
+  friend ExportWorker;
+
+ public:
+  Exporter(BulkOptions& opt);
+  ~Exporter();
+
+  bool connect();
+  bool run();
+
+  void report(std::ostream& os);
+
+  uint64_t failed() { return m_rangeerrors; }
+
+ private:
+  bool nextRange(int& range);
+  bool scanRange(int range, std::string& out);
+  bool scanExtIds(
+      int64_t first, int64_t last, bool inclusive,
+      std::map<std::string, std::vector<std::string>>& extids);
+  bool append(int range, const std::string& data);
+  bool compress(const std::string& data, std::string& out);
+
+  BulkOptions& m_opt;
+  BulkFormat m_format;
+  BulkState m_state;
+  SCassandra m_db;
+  bool m_compress;
+  FILE* m_fp;
+
+  SMutex m_mutex;
+  volatile int m_nextrange;
+  volatile uint64_t m_subscribers;
+  volatile uint64_t m_bytes;
+  volatile uint64_t m_rangeerrors;
+  uint64_t m_started;
+};
+
+#endif  // #define __BULK_H
@@ -0,0 +1,820 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+
+#include "fdjson.h"
+#include "satomic.h"
+#include "scodec.h"
+
+#include "bulk.h"
+
+// seconds between progress reports
+#define BULK_PROGRESS_INTERVAL 10
+// input lines per import chunk
+#define BULK_CHUNK_LINES 1000
+// chunks read ahead of the import workers, per worker
+#define BULK_CHUNKS_QUEUED 2
+// bytes read from the input at a time
+#define BULK_READ_SIZE 65536
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// the error callback has no context argument, so the line being encoded is
+// kept per worker thread for the messages
+static thread_local uint64_t subdataLine;
+
+static void subdataError(const char* msg) {
+  std::cout << "Line " << subdataLine << " - " << msg << std::endl;
+}
+
+static double bulkRate(uint64_t count, uint64_t started) {
+  time_t elapsed = time(NULL) - started;
+  return elapsed > 0 ? (double) count / elapsed : count;
+}
+
+// reads a line of any length, without the line feed
+static bool bulkGetLine(gzFile fp, std::string& line) {
+  char buf[BULK_READ_SIZE];
+
+  line.clear();
+
+  while (gzgets(fp, buf, sizeof(buf))) {
+    size_t len = strlen(buf);
+
+    if (len > 0 && buf[len - 1] == '\n') {
+      line.append(buf, len - 1);
+      return true;
+    }
+
+    line.append(buf, len);
+  }
+
+  // the final line may not end with a line feed
+  return !line.empty();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ImportWorker::ImportWorker(Importer& importer)
+    : SThread(true), m_importer(importer) {}
+
+ImportWorker::~ImportWorker() {}
+
+unsigned long ImportWorker::threadProc(void* arg) {
+  ImportChunk* chunk;
+
+  while ((chunk = m_importer.nextChunk())) m_importer.process(chunk);
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+Importer::Importer(BulkOptions& opt)
+    : m_opt(opt),
+      m_format(opt.format),
+      m_state(opt.statefile),
+      m_window(opt.inflight, opt.inflight),
+      m_queued(0, opt.threads * (BULK_CHUNKS_QUEUED + 1)),
+      m_queueslots(
+          opt.threads * BULK_CHUNKS_QUEUED, opt.threads * BULK_CHUNKS_QUEUED),
+      m_nextdone(0),
+      m_checkpoint(0),
+      m_stalled(false),
+      m_lines(0),
+      m_subscribers(0),
+      m_writes(0),
+      m_failed(0),
+      m_rejected(0),
+      m_started(0) {}
+
+Importer::~Importer() {
+  m_db.disconnect();
+}
+
+bool Importer::connect() {
+  m_db.host(m_opt.host);
+  m_db.keyspace(m_opt.keyspace);
+
+  SCassFuture future = m_db.connect();
+  future.wait();
+
+  if (future.errorCode() != CASS_OK) {
+    std::cout << "Unable to connect to " << m_opt.host
+              << " - error_code=" << future.errorCode() << std::endl;
+    return false;
+  }
+
+  m_db.setCoreConnectionsPerHost(m_opt.threads);
+  m_db.setMaxConnectionsPerHost(m_opt.threads * 2);
+
+  // each write is a single partition statement, so the driver sends it
+  // directly to a replica that owns the partition key
+  struct {
+    const char* qry;
+    SCassPrepared& prepared;
+  } stmts[] = {
+      {"INSERT INTO users_imsi (imsi, msisdn, access_restriction, key, opc, "
+       "rand, sqn, subscription_data, subscription_data_bin) "
+       "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
+       m_insimsi},
+      {"INSERT INTO users_imsi (imsi, msisdn, access_restriction, key_bin, "
+       "opc_bin, rand_bin, sqn, subscription_data, subscription_data_bin) "
+       "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
+       m_insimsibin},
+      {"INSERT INTO msisdn_imsi (msisdn, imsi) VALUES (?, ?)", m_insmsisdn},
+      {"INSERT INTO extid (extid) VALUES (?)", m_insextid},
+      {"INSERT INTO extid_imsi (extid, imsi) VALUES (?, ?)", m_insextidimsi},
+      {"INSERT INTO extid_imsi_xref (imsi, extid) VALUES (?, ?)",
+       m_insextidxref},
+  };
+
+  for (size_t i = 0; i < sizeof(stmts) / sizeof(stmts[0]); i++) {
+    CassError err = m_db.prepare(stmts[i].qry, stmts[i].prepared);
+
+    if (err != CASS_OK) {
+      std::cout << "Error " << err << " preparing [" << stmts[i].qry << "]"
+                << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool Importer::run() {
+  gzFile fp = gzopen(m_opt.file.c_str(), "rb");
+  std::vector<ImportWorker*> workers;
+  std::string line;
+  std::string err;
+  ImportChunk* chunk = NULL;
+  uint64_t lineno    = 0;
+  uint64_t index     = 0;
+  time_t reported    = time(NULL);
+
+  if (!fp) {
+    std::cout << "Unable to open [" << m_opt.file << "]" << std::endl;
+    return false;
+  }
+
+  gzbuffer(fp, BULK_READ_SIZE);
+
+  if (m_format.isCsv()) {
+    if (!bulkGetLine(fp, line) || !m_format.parseHeader(line, err)) {
+      std::cout << "Invalid CSV header - " << err << std::endl;
+      gzclose(fp);
+      return false;
+    }
+    lineno = m_checkpoint = 1;
+  }
+
+  if (m_state.load() && m_state.lines() > m_checkpoint) {
+    std::cout << "Resuming after line " << m_state.lines() << std::endl;
+    m_checkpoint = m_state.lines();
+  }
+
+  m_started = time(NULL);
+
+  for (int i = 0; i < m_opt.threads; i++) {
+    ImportWorker* w = new ImportWorker(*this);
+    w->init(NULL);
+    workers.push_back(w);
+  }
+
+  while (bulkGetLine(fp, line)) {
+    if (++lineno <= m_checkpoint) continue;
+
+    atomic_inc_fetch(m_lines);
+
+    if (!chunk) chunk = new ImportChunk(*this, index++, lineno);
+    chunk->lines.push_back(line);
+
+    if (chunk->lines.size() == BULK_CHUNK_LINES) {
+      queue(chunk);
+      chunk = NULL;
+    }
+
+    if (time(NULL) - reported >= BULK_PROGRESS_INTERVAL) {
+      progress(false);
+      reported = time(NULL);
+    }
+  }
+
+  if (!gzeof(fp)) {
+    int errnum;
+    std::cout << "Error reading [" << m_opt.file
+              << "] - " << gzerror(fp, &errnum) << std::endl;
+    atomic_inc_fetch(m_failed);
+  }
+
+  gzclose(fp);
+
+  // the remaining lines, followed by a NULL chunk to stop each worker
+  if (chunk) queue(chunk);
+  for (int i = 0; i < m_opt.threads; i++) {
+    {
+      SMutexLock l(m_mutex);
+      m_queue.push_back(NULL);
+    }
+    m_queued.increment();
+  }
+
+  for (auto it = workers.begin(); it != workers.end(); ++it) {
+    (*it)->join();
+    delete *it;
+  }
+
+  // wait for the outstanding writes by taking the whole window
+  for (int acquired = 0; acquired < m_opt.inflight;) {
+    if (m_window.decrement(false)) {
+      acquired++;
+    } else {
+      usleep(10000);
+      if (time(NULL) - reported >= BULK_PROGRESS_INTERVAL) {
+        progress(false);
+        reported = time(NULL);
+      }
+    }
+  }
+
+  progress(true);
+
+  return m_failed == 0;
+}
+
+void Importer::report(std::ostream& os) {
+  os << "Lines read        : " << m_lines << std::endl
+     << "Subscribers       : " << m_subscribers << std::endl
+     << "Lines rejected    : " << m_rejected << std::endl
+     << "Writes completed  : " << m_writes << std::endl
+     << "Writes failed     : " << m_failed << std::endl
+     << "Subscribers/sec   : " << (uint64_t) bulkRate(m_subscribers, m_started)
+     << std::endl;
+
+  if (m_failed)
+    os << "Rerun the import to resume after line " << m_state.lines()
+       << std::endl;
+}
+
+void Importer::queue(ImportChunk* chunk) {
+  m_queueslots.decrement();
+  {
+    SMutexLock l(m_mutex);
+    m_queue.push_back(chunk);
+  }
+  m_queued.increment();
+}
+
+ImportChunk* Importer::nextChunk() {
+  ImportChunk* chunk;
+
+  m_queued.decrement();
+  {
+    SMutexLock l(m_mutex);
+    chunk = m_queue.front();
+    m_queue.pop_front();
+  }
+
+  if (chunk) m_queueslots.increment();
+
+  return chunk;
+}
+
+void Importer::process(ImportChunk* chunk) {
+  uint64_t lineno = chunk->firstline;
+
+  for (auto it = chunk->lines.begin(); it != chunk->lines.end(); ++it)
+    importLine(chunk, lineno++, *it);
+
+  issued(chunk);
+}
+
+void Importer::importLine(
+    ImportChunk* chunk, uint64_t lineno, const std::string& line) {
+  BulkSubscriber sub;
+  std::string err;
+  std::string subdata_bin;
+  uint8_t bin[16];
+
+  if (line.empty() || line == "\r") return;
+
+  if (!m_format.parse(line, sub, err)) {
+    std::cout << "Line " << lineno << " - " << err << std::endl;
+    atomic_inc_fetch(m_rejected);
+    return;
+  }
+
+  if (sub.has_subdata && !m_opt.fdcfg.empty()) {
+    subdataLine = lineno;
+    if (fdJsonEncodeAvps(
+            sub.subscription_data.c_str(), subdata_bin, subdataError) !=
+        FDJSON_SUCCESS) {
+      atomic_inc_fetch(m_rejected);
+      return;
+    }
+  }
+
+  atomic_inc_fetch(m_subscribers);
+
+  // the values that were not supplied are left unset, so an existing
+  // subscriber keeps its current values for them
+  {
+    SCassStatement stmt(m_opt.secbin ? m_insimsibin : m_insimsi);
+    const std::string* sec[] = {&sub.key, &sub.opc, &sub.rand};
+
+    stmt.bind(0, sub.imsi);
+    if (sub.msisdn) stmt.bind(1, sub.msisdn);
+    if (sub.has_ar) stmt.bind(2, sub.access_restriction);
+    for (int i = 0; i < 3; i++) {
+      if (sec[i]->empty()) continue;
+      if (m_opt.secbin) {
+        SCodec::hexDecode(sec[i]->c_str(), bin, sizeof(bin));
+        stmt.bindBytes(3 + i, bin, sizeof(bin));
+      } else {
+        stmt.bind(3 + i, *sec[i]);
+      }
+    }
+    if (sub.has_sqn) stmt.bind(6, sub.sqn);
+    if (sub.has_subdata) {
+      // a stale encoding must not be left behind for new subscription data
+      stmt.bind(7, sub.subscription_data);
+      if (subdata_bin.empty())
+        stmt.bindNull(8);
+      else
+        stmt.bindBytes(
+            8, (const uint8_t*) subdata_bin.data(), subdata_bin.size());
+    }
+    write(chunk, stmt);
+  }
+
+  if (sub.msisdn) {
+    SCassStatement stmt(m_insmsisdn);
+    stmt.bind(0, sub.msisdn);
+    stmt.bind(1, sub.imsi);
+    write(chunk, stmt);
+  }
+
+  for (auto it = sub.extids.begin(); it != sub.extids.end(); ++it) {
+    {
+      SCassStatement stmt(m_insextid);
+      stmt.bind(0, *it);
+      write(chunk, stmt);
+    }
+    {
+      SCassStatement stmt(m_insextidimsi);
+      stmt.bind(0, *it);
+      stmt.bind(1, sub.imsi);
+      write(chunk, stmt);
+    }
+    {
+      SCassStatement stmt(m_insextidxref);
+      stmt.bind(0, sub.imsi);
+      stmt.bind(1, *it);
+      write(chunk, stmt);
+    }
+  }
+}
+
+void Importer::write(ImportChunk* chunk, SCassStatement& stmt) {
+  m_window.decrement();
+  atomic_inc_fetch(chunk->pending);
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (!future.setCallback(on_write_callback, chunk)) {
+    chunk->failed = true;
+    atomic_inc_fetch(m_failed);
+    issued(chunk);
+    m_window.increment();
+  }
+}
+
+void Importer::on_write_callback(CassFuture* future, void* data) {
+  SCassFuture f(future, true);
+  ImportChunk* chunk = (ImportChunk*) data;
+  Importer& importer = chunk->importer;
+
+  if (f.errorCode() == CASS_OK) {
+    atomic_inc_fetch(importer.m_writes);
+  } else {
+    // only the first failure of a chunk is reported
+    if (!atomic_swap(chunk->failed, true))
+      std::cout << "Error " << f.errorCode() << " writing lines "
+                << chunk->firstline << " to "
+                << chunk->firstline + chunk->lines.size() - 1 << std::endl;
+    atomic_inc_fetch(importer.m_failed);
+  }
+
+  // the window is released last so the import is not considered complete
+  // before the chunk has been recorded
+  importer.issued(chunk);
+  importer.m_window.increment();
+}
+
+void Importer::issued(ImportChunk* chunk) {
+  if (atomic_dec_fetch(chunk->pending) == 0) completed(chunk);
+}
+
+void Importer::completed(ImportChunk* chunk) {
+  SMutexLock l(m_mutex);
+
+  // the checkpoint only advances over consecutive chunks that were written
+  // successfully
+  m_done[chunk->index] = chunk;
+
+  for (auto it = m_done.find(m_nextdone); it != m_done.end();
+       it = m_done.find(m_nextdone)) {
+    ImportChunk* c = it->second;
+
+    if (c->failed) m_stalled = true;
+    if (!m_stalled) m_checkpoint = c->firstline + c->lines.size() - 1;
+
+    delete c;
+    m_done.erase(it);
+    m_nextdone++;
+  }
+}
+
+void Importer::progress(bool final) {
+  {
+    SMutexLock l(m_mutex);
+    m_state.lines(m_checkpoint);
+  }
+
+  if (final && m_failed == 0) {
+    m_state.remove();
+  } else if (!m_state.save()) {
+    std::cout << "Unable to save the import state to ["
+              << m_opt.statefile << "]" << std::endl;
+  }
+
+  if (!final)
+    std::cout << "lines " << m_lines << " subscribers " << m_subscribers
+              << " writes " << m_writes << " failed " << m_failed
+              << " rejected " << m_rejected << " ("
+              << (uint64_t) bulkRate(m_subscribers, m_started)
+              << " subscribers/sec)" << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ExportWorker::ExportWorker(Exporter& exporter)
+    : SThread(true), m_exporter(exporter) {}
+
+ExportWorker::~ExportWorker() {}
+
+unsigned long ExportWorker::threadProc(void* arg) {
+  std::string out;
+  int range;
+
+  while (m_exporter.nextRange(range)) {
+    out.clear();
+    if (!m_exporter.scanRange(range, out) || !m_exporter.append(range, out))
+      atomic_inc_fetch(m_exporter.m_rangeerrors);
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+Exporter::Exporter(BulkOptions& opt)
+    : m_opt(opt),
+      m_format(opt.format),
+      m_state(opt.statefile),
+      m_compress(false),
+      m_fp(NULL),
+      m_nextrange(0),
+      m_subscribers(0),
+      m_bytes(0),
+      m_rangeerrors(0),
+      m_started(0) {}
+
+Exporter::~Exporter() {
+  if (m_fp) fclose(m_fp);
+  m_db.disconnect();
+}
+
+bool Exporter::connect() {
+  m_db.host(m_opt.host);
+  m_db.keyspace(m_opt.keyspace);
+
+  SCassFuture future = m_db.connect();
+  future.wait();
+
+  if (future.errorCode() != CASS_OK) {
+    std::cout << "Unable to connect to " << m_opt.host
+              << " - error_code=" << future.errorCode() << std::endl;
+    return false;
+  }
+
+  m_db.setCoreConnectionsPerHost(m_opt.threads);
+  m_db.setMaxConnectionsPerHost(m_opt.threads * 2);
+
+  return true;
+}
+
+bool Exporter::run() {
+  std::vector<ExportWorker*> workers;
+  size_t len = m_opt.file.size();
+
+  m_compress = len > 3 && m_opt.file.compare(len - 3, 3, ".gz") == 0;
+
+  if (m_state.load()) {
+    if (m_state.total() != m_opt.ranges) {
+      std::cout << "The export was started with " << m_state.total()
+                << " ranges, resume it with the same number of ranges"
+                << std::endl;
+      return false;
+    }
+
+    // anything written after the last recorded range is discarded
+    m_fp = fopen(m_opt.file.c_str(), "r+b");
+    if (!m_fp || ftruncate(fileno(m_fp), m_state.offset()) != 0 ||
+        fseek(m_fp, 0, SEEK_END) != 0) {
+      std::cout << "Unable to resume the export to [" << m_opt.file << "]"
+                << std::endl;
+      return false;
+    }
+
+    std::cout << "Resuming with " << m_state.ranges().size() << " of "
+              << m_opt.ranges << " ranges exported" << std::endl;
+  } else {
+    std::string header;
+
+    m_fp = fopen(m_opt.file.c_str(), "wb");
+    if (!m_fp) {
+      std::cout << "Unable to create [" << m_opt.file << "]" << std::endl;
+      return false;
+    }
+
+    m_state.total(m_opt.ranges);
+    m_format.header(header);
+    if (!append(-1, header)) return false;
+  }
+
+  m_started = time(NULL);
+
+  for (int i = 0; i < m_opt.threads; i++) {
+    ExportWorker* w = new ExportWorker(*this);
+    w->init(NULL);
+    workers.push_back(w);
+  }
+
+  int elapsed = 0;
+  for (auto it = workers.begin(); it != workers.end(); ++it) {
+    while ((*it)->isRunning()) {
+      sleep(1);
+      if (++elapsed % BULK_PROGRESS_INTERVAL == 0) {
+        size_t done;
+        {
+          SMutexLock l(m_mutex);
+          done = m_state.ranges().size();
+        }
+        std::cout << "ranges " << done << "/" << m_opt.ranges
+                  << " subscribers " << m_subscribers << " bytes " << m_bytes
+                  << " (" << (uint64_t) bulkRate(m_subscribers, m_started)
+                  << " subscribers/sec)" << std::endl;
+      }
+    }
+    (*it)->join();
+    delete *it;
+  }
+
+  if (m_rangeerrors == 0) m_state.remove();
+
+  return m_rangeerrors == 0;
+}
+
+void Exporter::report(std::ostream& os) {
+  os << "Subscribers       : " << m_subscribers << std::endl
+     << "Bytes written     : " << m_bytes << std::endl
+     << "Ranges incomplete : " << m_rangeerrors << std::endl
+     << "Subscribers/sec   : " << (uint64_t) bulkRate(m_subscribers, m_started)
+     << std::endl;
+
+  if (m_rangeerrors)
+    os << "Rerun the export to retry the incomplete ranges" << std::endl;
+}
+
+bool Exporter::nextRange(int& range) {
+  while ((range = atomic_inc_fetch(m_nextrange) - 1) < m_opt.ranges) {
+    SMutexLock l(m_mutex);
+    if (m_state.ranges().find(range) == m_state.ranges().end()) return true;
+  }
+
+  return false;
+}
+
+bool Exporter::scanRange(int range, std::string& out) {
+  std::map<std::string, std::vector<std::string>> extids;
+  std::stringstream ss;
+  bool more_pages = true;
+  uint64_t count  = 0;
+  int64_t first;
+  int64_t last;
+  bool inclusive;
+
+  SCassTokenRange(range, m_opt.ranges, first, last, inclusive);
+
+  if (!scanExtIds(first, last, inclusive, extids)) return false;
+
+  ss << "SELECT imsi, msisdn, access_restriction, key, key_bin, opc, opc_bin, "
+        "rand, rand_bin, sqn, subscription_data FROM users_imsi "
+        "WHERE token(imsi) "
+     << (inclusive ? ">= " : "> ") << first << " AND token(imsi) <= " << last
+     << " ;";
+
+  SCassStatement stmt(ss.str());
+
+  stmt.setPagingSize(m_opt.pagesize);
+
+  while (more_pages) {
+    SCassFuture future = m_db.execute(stmt);
+
+    if (future.errorCode() != CASS_OK) {
+      std::cout << "Error " << future.errorCode() << " executing ["
+                << ss.str() << "]" << std::endl;
+      return false;
+    }
+
+    SCassResult res    = future.result();
+    SCassIterator rows = res.rows();
+
+    while (rows.nextRow()) {
+      SCassRow row = rows.row();
+      BulkSubscriber sub;
+      const char* sec[]        = {"key", "opc", "rand"};
+      std::string* secvalues[] = {&sub.key, &sub.opc, &sub.rand};
+
+      if (!row.getColumn("imsi").get(sub.imsi)) continue;
+
+      row.getColumn("msisdn").get(sub.msisdn);
+      sub.has_ar =
+          row.getColumn("access_restriction").get(sub.access_restriction);
+      sub.has_sqn = row.getColumn("sqn").get(sub.sqn);
+      sub.has_subdata =
+          row.getColumn("subscription_data").get(sub.subscription_data);
+
+      // the blob columns take precedence over the hex text columns
+      for (int i = 0; i < 3; i++) {
+        std::string bincol = std::string(sec[i]) + "_bin";
+        SCassValue bin     = row.getColumn(bincol.c_str());
+        const uint8_t* p;
+        size_t len;
+
+        if (!bin.isNull() && bin.get(p, len) && len > 0)
+          *secvalues[i] = SCodec::hexEncode(p, len);
+        else
+          row.getColumn(sec[i]).get(*secvalues[i]);
+      }
+
+      auto it = extids.find(sub.imsi);
+      if (it != extids.end()) sub.extids.swap(it->second);
+
+      m_format.format(sub, out);
+      count++;
+    }
+
+    more_pages = res.morePages();
+
+    if (more_pages) stmt.setPagingState(res);
+  }
+
+  atomic_add_fetch(m_subscribers, count);
+
+  return true;
+}
+
+bool Exporter::scanExtIds(
+    int64_t first, int64_t last, bool inclusive,
+    std::map<std::string, std::vector<std::string>>& extids) {
+  std::stringstream ss;
+  bool more_pages = true;
+
+  // extid_imsi_xref is partitioned by imsi, so the same token range holds
+  // the external identifiers of the subscribers in the range
+  ss << "SELECT imsi, extid FROM extid_imsi_xref WHERE token(imsi) "
+     << (inclusive ? ">= " : "> ") << first << " AND token(imsi) <= " << last
+     << " ;";
+
+  SCassStatement stmt(ss.str());
+
+  stmt.setPagingSize(m_opt.pagesize);
+
+  while (more_pages) {
+    SCassFuture future = m_db.execute(stmt);
+
+    if (future.errorCode() != CASS_OK) {
+      std::cout << "Error " << future.errorCode() << " executing ["
+                << ss.str() << "]" << std::endl;
+      return false;
+    }
+
+    SCassResult res    = future.result();
+    SCassIterator rows = res.rows();
+
+    while (rows.nextRow()) {
+      SCassRow row = rows.row();
+      std::string imsi;
+      std::string extid;
+
+      if (row.getColumn("imsi").get(imsi) && row.getColumn("extid").get(extid))
+        extids[imsi].push_back(extid);
+    }
+
+    more_pages = res.morePages();
+
+    if (more_pages) stmt.setPagingState(res);
+  }
+
+  return true;
+}
+
+bool Exporter::append(int range, const std::string& data) {
+  std::string compressed;
+  const std::string* out = &data;
+
+  if (m_compress && !data.empty()) {
+    if (!compress(data, compressed)) {
+      std::cout << "Error compressing range " << range << std::endl;
+      return false;
+    }
+    out = &compressed;
+  }
+
+  SMutexLock l(m_mutex);
+
+  // the data is on disk before the state records it
+  if (fwrite(out->data(), 1, out->size(), m_fp) != out->size() ||
+      fflush(m_fp) != 0 || fdatasync(fileno(m_fp)) != 0) {
+    std::cout << "Error writing range " << range << " to [" << m_opt.file
+              << "] - " << strerror(errno) << std::endl;
+    // discard a partial write so a later range does not follow it
+    if (ftruncate(fileno(m_fp), m_state.offset()) == 0)
+      fseek(m_fp, 0, SEEK_END);
+    return false;
+  }
+
+  m_state.offset(m_state.offset() + out->size());
+  if (range >= 0) m_state.ranges().insert(range);
+  atomic_add_fetch(m_bytes, out->size());
+
+  if (!m_state.save()) {
+    std::cout << "Unable to save the export state to [" << m_opt.statefile
+              << "]" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+bool Exporter::compress(const std::string& data, std::string& out) {
+  z_stream strm;
+
+  memset(&strm, 0, sizeof(strm));
+
+  // each range is a complete gzip member, concatenated members form a valid
+  // gzip file
+  if (deflateInit2(
+          &strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+          Z_DEFAULT_STRATEGY) != Z_OK)
+    return false;
+
+  out.resize(deflateBound(&strm, data.size()));
+
+  strm.next_in   = (Bytef*) data.data();
+  strm.avail_in  = data.size();
+  strm.next_out  = (Bytef*) &out[0];
+  strm.avail_out = out.size();
+
+  int ret = deflate(&strm, Z_FINISH);
+
+  out.resize(out.size() - strm.avail_out);
+  deflateEnd(&strm);
+
+  return ret == Z_STREAM_END;
+}
@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sstream>
+
+#define RAPIDJSON_NAMESPACE fdrapidjson
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include "scodec.h"
+
+#include "bulk.h"
+
+// the column indexes, in the order of BulkFormat::columns
+enum {
+  colImsi,
+  colMsisdn,
+  colAccessRestriction,
+  colKey,
+  colOpc,
+  colRand,
+  colSqn,
+  colSubscriptionData,
+  colExtIds,
+  colCount
+};
+
+const char* BulkFormat::columns[] = {"imsi",
+                                     "msisdn",
+                                     "access_restriction",
+                                     "key",
+                                     "opc",
+                                     "rand",
+                                     "sqn",
+                                     "subscription_data",
+                                     "extids",
+                                     NULL};
+
+// the SQN is a 48 bit value
+#define BULK_MAX_SQN 0xffffffffffffULL
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static void bulkSplitCsv(
+    const std::string& line, std::vector<std::string>& fields) {
+  std::string field;
+  bool quoted = false;
+  size_t len  = line.size();
+
+  if (len > 0 && line[len - 1] == '\r') len--;
+
+  for (size_t i = 0; i < len; i++) {
+    char c = line[i];
+
+    if (quoted) {
+      if (c != '"') {
+        field += c;
+      } else if (i + 1 < len && line[i + 1] == '"') {
+        field += c;
+        i++;
+      } else {
+        quoted = false;
+      }
+    } else if (c == '"') {
+      quoted = true;
+    } else if (c == ',') {
+      fields.push_back(field);
+      field.clear();
+    } else {
+      field += c;
+    }
+  }
+
+  fields.push_back(field);
+}
+
+static void bulkCsvField(const std::string& value, std::string& out) {
+  if (value.find_first_of(",\"") == std::string::npos) {
+    out += value;
+    return;
+  }
+
+  out += '"';
+  for (size_t i = 0; i < value.size(); i++) {
+    if (value[i] == '"') out += '"';
+    out += value[i];
+  }
+  out += '"';
+}
+
+static void bulkJsonString(const std::string& value, std::string& out) {
+  static const char* hexDigits = "0123456789abcdef";
+
+  out += '"';
+  for (size_t i = 0; i < value.size(); i++) {
+    unsigned char c = value[i];
+
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default: {
+        if (c < 0x20) {
+          out += "\\u00";
+          out += hexDigits[c >> 4];
+          out += hexDigits[c & 0x0f];
+        } else {
+          out += c;
+        }
+      }
+    }
+  }
+  out += '"';
+}
+
+static bool bulkGetUint(const std::string& value, uint64_t max, uint64_t& v) {
+  return SCodec::parseUint64(value, v) && v <= max;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool BulkFormat::parseHeader(const std::string& line, std::string& err) {
+  std::vector<std::string> fields;
+  bool imsi = false;
+
+  bulkSplitCsv(line, fields);
+
+  m_header.clear();
+  for (auto it = fields.begin(); it != fields.end(); ++it) {
+    int col = 0;
+
+    while (columns[col] && *it != columns[col]) col++;
+
+    if (!columns[col]) {
+      err = "unknown column [" + *it + "]";
+      return false;
+    }
+
+    if (col == colImsi) imsi = true;
+    m_header.push_back(col);
+  }
+
+  if (!imsi) {
+    err = "the header does not contain the imsi column";
+    return false;
+  }
+
+  return true;
+}
+
+bool BulkFormat::parse(
+    const std::string& line, BulkSubscriber& sub, std::string& err) {
+  sub.clear();
+
+  if (!(m_csv ? parseCsv(line, sub, err) : parseJson(line, sub, err)))
+    return false;
+
+  if (sub.imsi.empty()) {
+    err = "the imsi is missing";
+    return false;
+  }
+
+  return true;
+}
+
+bool BulkFormat::parseCsv(
+    const std::string& line, BulkSubscriber& sub, std::string& err) {
+  std::vector<std::string> fields;
+
+  bulkSplitCsv(line, fields);
+
+  if (fields.size() != m_header.size()) {
+    std::stringstream ss;
+    ss << "expected " << m_header.size() << " fields, found "
+       << fields.size();
+    err = ss.str();
+    return false;
+  }
+
+  for (size_t i = 0; i < fields.size(); i++) {
+    if (!setValue(m_header[i], fields[i], sub, err)) return false;
+  }
+
+  return true;
+}
+
+bool BulkFormat::parseJson(
+    const std::string& line, BulkSubscriber& sub, std::string& err) {
+  RAPIDJSON_NAMESPACE::Document doc;
+
+  if (doc.Parse(line.c_str()).HasParseError() || !doc.IsObject()) {
+    err = "invalid JSON object";
+    return false;
+  }
+
+  for (int col = 0; col < colCount; col++) {
+    if (!doc.HasMember(columns[col])) continue;
+
+    const RAPIDJSON_NAMESPACE::Value& v = doc[columns[col]];
+    std::string value;
+
+    if (v.IsNull()) continue;
+
+    if (col == colSubscriptionData && v.IsObject()) {
+      RAPIDJSON_NAMESPACE::StringBuffer buffer;
+      RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::StringBuffer> writer(
+          buffer);
+      v.Accept(writer);
+      value = buffer.GetString();
+    } else if (col == colExtIds && v.IsArray()) {
+      for (RAPIDJSON_NAMESPACE::SizeType i = 0; i < v.Size(); i++) {
+        if (!v[i].IsString()) {
+          err = "invalid extids";
+          return false;
+        }
+        if (!value.empty()) value += ';';
+        value += v[i].GetString();
+      }
+    } else if (v.IsUint64()) {
+      value = std::to_string(v.GetUint64());
+    } else if (v.IsString()) {
+      value = v.GetString();
+    } else {
+      err = std::string("invalid ") + columns[col];
+      return false;
+    }
+
+    if (!setValue(col, value, sub, err)) return false;
+  }
+
+  return true;
+}
+
+bool BulkFormat::setValue(
+    int column, const std::string& value, BulkSubscriber& sub,
+    std::string& err) {
+  uint64_t u64;
+  uint8_t bin[16];
+
+  if (value.empty()) return true;
+
+  switch (column) {
+    case colImsi: {
+      if (value.size() > 15 ||
+          value.find_first_not_of("0123456789") != std::string::npos) {
+        err = "invalid imsi";
+        return false;
+      }
+      sub.imsi = value;
+      break;
+    }
+    case colMsisdn: {
+      if (!bulkGetUint(value, INT64_MAX, u64) || u64 == 0) {
+        err = "invalid msisdn";
+        return false;
+      }
+      sub.msisdn = (int64_t) u64;
+      break;
+    }
+    case colAccessRestriction: {
+      if (!bulkGetUint(value, INT32_MAX, u64)) {
+        err = "invalid access_restriction";
+        return false;
+      }
+      sub.has_ar             = true;
+      sub.access_restriction = (int32_t) u64;
+      break;
+    }
+    case colKey:
+    case colOpc:
+    case colRand: {
+      if (value.size() != sizeof(bin) * 2 ||
+          !SCodec::hexDecode(value.c_str(), bin, sizeof(bin))) {
+        err = std::string("invalid ") + columns[column];
+        return false;
+      }
+      if (column == colKey)
+        sub.key = value;
+      else if (column == colOpc)
+        sub.opc = value;
+      else
+        sub.rand = value;
+      break;
+    }
+    case colSqn: {
+      if (!bulkGetUint(value, BULK_MAX_SQN, u64)) {
+        err = "invalid sqn";
+        return false;
+      }
+      sub.has_sqn = true;
+      sub.sqn     = (int64_t) u64;
+      break;
+    }
+    case colSubscriptionData: {
+      sub.has_subdata       = true;
+      sub.subscription_data = value;
+      break;
+    }
+    case colExtIds: {
+      std::stringstream ss(value);
+      std::string extid;
+
+      while (std::getline(ss, extid, ';')) {
+        if (!extid.empty()) sub.extids.push_back(extid);
+      }
+      break;
+    }
+  }
+
+  return true;
+}
+
+void BulkFormat::header(std::string& out) {
+  if (!m_csv) return;
+
+  for (int col = 0; col < colCount; col++) {
+    if (col) out += ',';
+    out += columns[col];
+  }
+  out += '\n';
+}
+
+void BulkFormat::format(const BulkSubscriber& sub, std::string& out) {
+  std::string extids;
+
+  for (auto it = sub.extids.begin(); it != sub.extids.end(); ++it) {
+    if (!extids.empty()) extids += ';';
+    extids += *it;
+  }
+
+  if (m_csv) {
+    out += sub.imsi;
+    out += ',';
+    if (sub.msisdn) out += std::to_string(sub.msisdn);
+    out += ',';
+    if (sub.has_ar) out += std::to_string(sub.access_restriction);
+    out += ',';
+    out += sub.key;
+    out += ',';
+    out += sub.opc;
+    out += ',';
+    out += sub.rand;
+    out += ',';
+    if (sub.has_sqn) out += std::to_string(sub.sqn);
+    out += ',';
+    bulkCsvField(sub.subscription_data, out);
+    out += ',';
+    bulkCsvField(extids, out);
+    out += '\n';
+    return;
+  }
+
+  out += "{\"imsi\":";
+  bulkJsonString(sub.imsi, out);
+  if (sub.msisdn) out += ",\"msisdn\":" + std::to_string(sub.msisdn);
+  if (sub.has_ar)
+    out +=
+        ",\"access_restriction\":" + std::to_string(sub.access_restriction);
+  if (!sub.key.empty()) out += ",\"key\":\"" + sub.key + "\"";
+  if (!sub.opc.empty()) out += ",\"opc\":\"" + sub.opc + "\"";
+  if (!sub.rand.empty()) out += ",\"rand\":\"" + sub.rand + "\"";
+  if (sub.has_sqn) out += ",\"sqn\":" + std::to_string(sub.sqn);
+  if (sub.has_subdata) {
+    out += ",\"subscription_data\":";
+    bulkJsonString(sub.subscription_data, out);
+  }
+  if (!sub.extids.empty()) {
+    out += ",\"extids\":[";
+    for (auto it = sub.extids.begin(); it != sub.extids.end(); ++it) {
+      if (it != sub.extids.begin()) out += ',';
+      bulkJsonString(*it, out);
+    }
+    out += ']';
+  }
+  out += "}\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool BulkState::load() {
+  FILE* fp = fopen(m_path.c_str(), "r");
+  char buf[4096];
+
+  if (!fp) return false;
+
+  while (fgets(buf, sizeof(buf), fp)) {
+    std::string line(buf);
+    size_t eq = line.find('=');
+
+    if (eq == std::string::npos) continue;
+
+    std::string name  = line.substr(0, eq);
+    std::string value = line.substr(eq + 1);
+    uint64_t u64;
+
+    if (!value.empty() && value[value.size() - 1] == '\n')
+      value.erase(value.size() - 1);
+
+    if (name == "lines" && SCodec::parseUint64(value, u64)) {
+      m_lines = u64;
+    } else if (name == "offset" && SCodec::parseUint64(value, u64)) {
+      m_offset = u64;
+    } else if (name == "total" && SCodec::parseUint64(value, u64)) {
+      m_total = (int) u64;
+    } else if (name == "ranges") {
+      std::stringstream ss(value);
+      std::string range;
+
+      while (std::getline(ss, range, ',')) {
+        if (SCodec::parseUint64(range, u64)) m_ranges.insert((int) u64);
+      }
+    }
+  }
+
+  fclose(fp);
+
+  return true;
+}
+
+bool BulkState::save() {
+  std::string tmp = m_path + ".tmp";
+  FILE* fp        = fopen(tmp.c_str(), "w");
+
+  if (!fp) return false;
+
+  fprintf(fp, "lines=%llu\n", (unsigned long long) m_lines);
+  fprintf(fp, "offset=%llu\n", (unsigned long long) m_offset);
+  fprintf(fp, "total=%d\n", m_total);
+  fprintf(fp, "ranges=");
+  for (auto it = m_ranges.begin(); it != m_ranges.end(); ++it)
+    fprintf(fp, "%s%d", it == m_ranges.begin() ? "" : ",", *it);
+  fprintf(fp, "\n");
+
+  bool ok = fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+
+  if (fclose(fp) != 0) ok = false;
+
+  // the rename replaces the previous state atomically
+  return ok && rename(tmp.c_str(), m_path.c_str()) == 0;
+}
+
+void BulkState::remove() {
+  unlink(m_path.c_str());
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <getopt.h>
+#include <stdlib.h>
+#include <iostream>
+
+#include "fd.h"
+
+#include "bulk.h"
+
+static BulkOptions opt;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static void help() {
+  std::cout
+      << std::endl
+      << "Usage: hss_bulk [OPTIONS]... import|export FILE" << std::endl
+      << "  -h, --help                   Print help and exit" << std::endl
+      << "  -f, --fdcfg filename         The freeDiameter configuration, "
+         "used to encode subscription_data_bin on import"
+      << std::endl
+      << "  -c, --host host              The Cassandra contact point(s)"
+      << std::endl
+      << "  -k, --keyspace name          The keyspace (default vhss)"
+      << std::endl
+      << "  -t, --threads num            Worker threads (default 8)"
+      << std::endl
+      << "  -r, --ranges num             Token ranges to split the export "
+         "into (default 256)"
+      << std::endl
+      << "  -p, --pagesize num           Rows per page (default 1000)"
+      << std::endl
+      << "  -i, --inflight num           Maximum outstanding writes "
+         "(default 1024)"
+      << std::endl
+      << "  -F, --format csv|ndjson      The file format (default from the "
+         "file extension)"
+      << std::endl
+      << "  -s, --state filename         The resume state (default "
+         "FILE.state)"
+      << std::endl
+      << "  -b, --secbin                 Import key, opc and rand to the "
+         "blob columns"
+      << std::endl
+      << std::endl
+      << "A FILE ending in .gz is compressed." << std::endl;
+}
+
+static bool parseOptions(int argc, char** argv) {
+  int c;
+  int option_index = 0;
+
+  struct option long_options[] = {{"help", no_argument, NULL, 'h'},
+                                  {"fdcfg", required_argument, NULL, 'f'},
+                                  {"host", required_argument, NULL, 'c'},
+                                  {"keyspace", required_argument, NULL, 'k'},
+                                  {"threads", required_argument, NULL, 't'},
+                                  {"ranges", required_argument, NULL, 'r'},
+                                  {"pagesize", required_argument, NULL, 'p'},
+                                  {"inflight", required_argument, NULL, 'i'},
+                                  {"format", required_argument, NULL, 'F'},
+                                  {"state", required_argument, NULL, 's'},
+                                  {"secbin", no_argument, NULL, 'b'},
+                                  {NULL, 0, NULL, 0}};
+
+  while (1) {
+    c = getopt_long(
+        argc, argv, "hf:c:k:t:r:p:i:F:s:b", long_options, &option_index);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'h': {
+        help();
+        exit(0);
+      }
+      case 'f': {
+        opt.fdcfg = optarg;
+        break;
+      }
+      case 'c': {
+        opt.host = optarg;
+        break;
+      }
+      case 'k': {
+        opt.keyspace = optarg;
+        break;
+      }
+      case 't': {
+        opt.threads = atoi(optarg);
+        break;
+      }
+      case 'r': {
+        opt.ranges = atoi(optarg);
+        break;
+      }
+      case 'p': {
+        opt.pagesize = atoi(optarg);
+        break;
+      }
+      case 'i': {
+        opt.inflight = atoi(optarg);
+        break;
+      }
+      case 'F': {
+        opt.format = optarg;
+        break;
+      }
+      case 's': {
+        opt.statefile = optarg;
+        break;
+      }
+      case 'b': {
+        opt.secbin = true;
+        break;
+      }
+      default: {
+        help();
+        return false;
+      }
+    }
+  }
+
+  if (optind == argc - 2) {
+    opt.command = argv[optind];
+    opt.file    = argv[optind + 1];
+  }
+
+  if (opt.format.empty()) {
+    std::string name = opt.file;
+
+    if (name.size() > 3 && name.compare(name.size() - 3, 3, ".gz") == 0)
+      name.erase(name.size() - 3);
+
+    size_t dot = name.rfind('.');
+    if (dot != std::string::npos) opt.format = name.substr(dot + 1);
+  }
+
+  if (opt.statefile.empty()) opt.statefile = opt.file + ".state";
+
+  if (opt.host.empty() || opt.file.empty() ||
+      (opt.command != "import" && opt.command != "export") ||
+      (opt.format != "csv" && opt.format != "ndjson") || opt.threads <= 0 ||
+      opt.ranges <= 0 || opt.pagesize <= 0 || opt.inflight <= 0) {
+    std::cout << "Invalid bulk options" << std::endl;
+    help();
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  if (!parseOptions(argc, argv)) return 1;
+
+  // the engine is initialized but not started, only the dictionaries loaded
+  // by the configured extensions are needed to encode the AVP's
+  FDEngine diameter;
+
+  if (!opt.fdcfg.empty()) {
+    try {
+      diameter.setConfigFile(opt.fdcfg);
+      if (!diameter.init()) return 1;
+    } catch (FDException& ex) {
+      std::cout << "Error initializing freeDiameter - " << ex.what()
+                << std::endl;
+      return 1;
+    }
+  }
+
+  if (opt.command == "import") {
+    Importer importer(opt);
+
+    if (!importer.connect()) return 1;
+
+    bool ok = importer.run();
+    importer.report(std::cout);
+
+    return ok && importer.failed() == 0 ? 0 : 1;
+  }
+
+  Exporter exporter(opt);
+
+  if (!exporter.connect()) return 1;
+
+  bool ok = exporter.run();
+  exporter.report(std::cout);
+
+  return ok ? 0 : 1;
+}
@@ -77,7 +77,8 @@ int apply_access_restriction(char* imsi, uint8_t* vplmn) {
   uint8_t hmcc[3], hmnc[3] = {0};
   uint8_t imsi_hex[15];
 
-  if (bcd_to_hex(imsi_hex, imsi, strlen(imsi)) != 0) {
+  if (strlen(imsi) > sizeof(imsi_hex) ||
+      bcd_to_hex(imsi_hex, imsi, strlen(imsi)) != 0) {
     FPRINTF_ERROR("Failed to convert imsi %s to hex representation\n", imsi);
     return -1;
   }
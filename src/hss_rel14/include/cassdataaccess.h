@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __CASSDATAACCESS_H
+#define __CASSDATAACCESS_H
+
+#include "dataaccess.h"
+#include "scassandra.h"
+
+class EventIndex;
+class Preloader;
+
+class CassDataAccess : public DataAccess {
+ public:
+  CassDataAccess();
+  virtual ~CassDataAccess();
+
+  using DataAccess::getEvent;
+  using DataAccess::deleteEvent;
+  using DataAccess::checkImsiExists;
+  using DataAccess::checkExtIdExists;
+  using DataAccess::getImsiListFromExtId;
+  using DataAccess::getExtIdsFromImsi;
+  using DataAccess::getImsiFromMsisdn;
+  using DataAccess::getMsisdnFromImsi;
+  using DataAccess::getImsiInfo;
+  using DataAccess::getEventIdsFromExtId;
+  using DataAccess::getEventIdsFromExtIds;
+  using DataAccess::getSubDataFromImsi;
+  using DataAccess::UpdateValidityTime;
+  using DataAccess::UpdateNIRDestination;
+
+  std::string& host(const char* hst) { return m_db.host(hst); }
+  std::string& host(const std::string& hst) { return m_db.host(hst); }
+  std::string& host() { return m_db.host(); }
+
+  std::string& keyspace(const char* ks) { return m_db.keyspace(ks); }
+  std::string& keyspace(const std::string& ks) { return m_db.keyspace(ks); }
+  std::string& keyspace() { return m_db.keyspace(); }
+
+  int protocolVersion(int pv) { return m_db.protocolVersion(pv); }
+  int protocolVersion() { return m_db.protocolVersion(); }
+
+  // when set, getImsiInfo() reads subscription_data_bin instead of the JSON
+  // subscription_data column
+  bool subDataBin(bool sdb) { return m_subdatabin = sdb; }
+  bool subDataBin() { return m_subdatabin; }
+
+  // when set, K, OPc and RAND are read from the blob columns, falling back to
+  // the hex text columns, and RAND and OPc are written to the blob columns
+  bool secBin(bool sb) { return m_secbin = sb; }
+  bool secBin() { return m_secbin; }
+
+  // when set, connect() starts an index of the subscribers with monitoring
+  // events so that mayHaveEvents() can rule out the others
+  bool eventIndex(bool ei) { return m_useeventindex = ei; }
+  bool eventIndex() { return m_useeventindex; }
+
+  void connect();
+  void connect(const std::string& hst, const std::string& ks = "vhss");
+  void connect(const char* hst, const char* ks = "vhss");
+
+  void disconnect();
+
+  bool addEvent(DAEvent& event);
+
+  bool getEvent(const char* scef_id, uint32_t scef_ref_id, DAEvent& event);
+
+  bool getEvents(
+      const char* scef_id, std::list<uint32_t> scef_ref_ids,
+      DAEventList& events, CassFutureCallback cb, void* data);
+  bool getEventsData(SCassFuture& future, DAEventList& events);
+
+  void deleteEvent(const char* scef_id, uint32_t scef_ref_id);
+
+  bool applyEvents(DAEventBatch& batch, CassFutureCallback cb, void* data);
+  bool applyEventsData(SCassFuture& future);
+
+  bool mayHaveEvents(const char* imsi);
+
+  void preload(DAPreloadCallback cb, void* data);
+
+  bool checkMSISDNExists(int64_t msisdn);
+  bool checkImsiExists(const char* imsi);
+  bool checkExtIdExists(const char* extid);
+
+  bool getImsiListFromExtId(const char* extid, DAImsiList& imsilst);
+
+  bool getExtIdsFromImsiData(SCassFuture& future, DAExtIdList& extids);
+  bool getExtIdsFromImsi(
+      const char* imsi, DAExtIdList& extids, CassFutureCallback cb, void* data);
+
+  bool getImsiFromMsisdn(int64_t msisdn, std::string& imsi);
+  bool getImsiFromMsisdn(const char* msisdn, std::string& imsi);
+
+  bool getMsisdnFromImsi(const char* imsi, std::string& msisdn);
+  bool getMsisdnFromImsi(const char* imsi, int64_t& msisdn);
+
+  bool getImsiInfoData(SCassFuture& future, DAImsiInfo& info);
+  bool getImsiInfo(
+      const char* imsi, DAImsiInfo& info, bool subdata, CassFutureCallback cb,
+      void* data);
+
+  bool getEventIdsFromMsisdnData(SCassFuture& future, DAEventIdList& el);
+  bool getEventIdsFromMsisdn(
+      int64_t msisdn, DAEventIdList& el, CassFutureCallback cb, void* data);
+
+  void getEventIdsFromExtId(const char* extid, DAEventIdList& el);
+
+  bool getEventIdsFromExtIds(
+      const char* extid, DAEventIdList& el, CassFutureCallback cb, void* data);
+  bool getEventIdsFromExtIdsData(SCassFuture& future, DAEventIdList& el);
+
+  bool checkOpcKeys(const uint8_t opP[16]);
+  bool updateOpc(std::string& imsi, std::string& opc);
+
+  bool purgeUE(std::string& imsi);
+
+  bool getMmeIdentityFromImsi(std::string& imsi, DAMmeIdentity& mmeid);
+
+  bool getMmeIdentity(std::string& mme_id, DAMmeIdentity& mmeid);
+  bool getMmeIdentity(int32_t mme_id, DAMmeIdentity& mmeid);
+
+  bool getLatestIdentity(
+      const char* table_name, int64_t& id, CassFutureCallback cb, void* data);
+  bool getLatestIdentityData(SCassFuture& future, int64_t& id);
+
+  bool updateLatestIdentity(
+      const char* table_name, CassFutureCallback cb, void* data);
+
+  bool getMmeIdFromHostData(SCassFuture& future, int32_t& mmeid);
+  bool getMmeIdFromHost(
+      std::string& host, int32_t& mmeid, CassFutureCallback cb, void* data);
+
+  bool addMmeIdentity(std::string& host, std::string& realm, int32_t mmeid);
+  bool addMmeIdentity1(
+      std::string& host, std::string& realm, int32_t mmeid,
+      CassFutureCallback cb, void* data);
+  bool addMmeIdentity2(
+      std::string& host, std::string& realm, int32_t mmeid,
+      CassFutureCallback cb, void* data);
+  bool deleteMmeIdentity(std::string& host);
+
+  bool updateLocation(
+      DAImsiInfo& location, uint32_t present_flags, int32_t idmmeidentity,
+      CassFutureCallback cb, void* data);
+  bool updateLocation(
+      DAImsiInfo& location, uint32_t present_flags, CassFutureCallback cb,
+      void* data);
+  bool updateLocationData(SCassFuture& future);
+
+  bool getImsiSec(
+      const std::string& imsi, DAImsiSec& imsisec, CassFutureCallback cb,
+      void* data);
+  bool getImsiSecData(SCassFuture& future, DAImsiSec& imsisec);
+
+  bool updateRandSqn(
+      const std::string& imsi, uint8_t* rand_p, uint8_t* sqn, bool inc_sqn,
+      CassFutureCallback cb, void* data);
+  bool updateRandSqnData(SCassFuture& future);
+
+  bool incSqn(std::string& imsi, uint8_t* sqn);
+
+  bool getSubDataFromImsi(const char* imsi, std::string& sub_data);
+
+  bool updateSubscriptionData(
+      const char* imsi, const std::string& sub_data,
+      const std::string& sub_data_bin);
+
+  bool putImsi(
+      const DAImsiInfo& info, const DAImsiSec& sec, uint32_t present_flags,
+      CassFutureCallback cb, void* data);
+  bool putImsiData(SCassFuture& future);
+  bool deleteImsi(
+      const std::string& imsi, CassFutureCallback cb, void* data);
+  bool deleteImsiData(SCassFuture& future);
+
+  void UpdateValidityTime(const char* imsi, std::string& validity_time);
+
+  void UpdateNIRDestination(
+      const char* imsi, std::string& host, std::string& realm);
+
+ private:
+  // a put or delete of a subscriber, written once the stored MSISDN is read
+  struct ImsiChange {
+    ImsiChange(
+        CassDataAccess& da, bool del, const DAImsiInfo& info,
+        const DAImsiSec& sec, uint32_t present_flags, CassFutureCallback cb,
+        void* data)
+        : da(da),
+          del(del),
+          info(info),
+          sec(sec),
+          present_flags(present_flags),
+          cb(cb),
+          data(data) {}
+
+    CassDataAccess& da;
+    bool del;
+    DAImsiInfo info;
+    DAImsiSec sec;
+    uint32_t present_flags;
+    CassFutureCallback cb;
+    void* data;
+  };
+
+  void prepare(const char* qry, SCassPrepared& prepared);
+
+  bool changeImsi(ImsiChange* chg);
+  bool writeImsi(const ImsiChange& chg, int64_t stored_msisdn);
+  static bool storedMsisdn(SCassFuture& future, int64_t& msisdn);
+  static void on_stored_msisdn_callback(CassFuture* future, void* data);
+
+  // a getImsiInfo() that reads the JSON when the encoded subscription data
+  // can not be used
+  struct ImsiInfoQuery {
+    ImsiInfoQuery(
+        CassDataAccess& da, const char* imsi, CassFutureCallback cb,
+        void* data)
+        : da(da), imsi(imsi), cb(cb), data(data) {}
+
+    CassDataAccess& da;
+    std::string imsi;
+    CassFutureCallback cb;
+    void* data;
+  };
+
+  SCassFuture queryImsiInfo(const char* imsi, const char* subcols);
+  bool subDataBinUsable(SCassFuture& future);
+  static void on_imsi_info_callback(CassFuture* future, void* data);
+
+  SCassandra m_db;
+  bool m_subdatabin;
+  bool m_secbin;
+  bool m_useeventindex;
+  EventIndex* m_eventindex;
+  Preloader* m_preloader;
+
+  SCassPrepared m_insevent;
+  SCassPrepared m_inseventmsisdn;
+  SCassPrepared m_inseventextid;
+  SCassPrepared m_delevent;
+  SCassPrepared m_deleventmsisdn;
+  SCassPrepared m_deleventextid;
+  SCassPrepared m_insimsi;
+  SCassPrepared m_insimsibin;
+  SCassPrepared m_insmsisdn;
+  SCassPrepared m_delimsi;
+  SCassPrepared m_delmsisdn;
+  SCassPrepared m_getimsimsisdn;
+  SCassPrepared m_updrandsqn;
+  SCassPrepared m_getmmeidhost;
+  SCassPrepared m_insmmeidentity;
+  SCassPrepared m_insmmeidentityhost;
+  SCassPrepared m_delmmeidentity;
+  SCassPrepared m_delmmeidentityhost;
+};
+
+#endif  // #define __CASSDATAACCESS_H
@@ -19,9 +19,16 @@
 
 #include <stdexcept>
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
-#include "scassandra.h"
+#include <cassandra.h>
+
+#include "subscriberkey.h"
+
+// the future the Cassandra backend passes to the *Data() methods
+class SCassFuture;
 
 #define MME_IDENTITY_PRESENT (1U)
 #define MME_SUPPORTED_FEATURES_PRESENT (1U << 1)
@@ -29,6 +36,14 @@
 #define SV_PRESENT (1U << 3)
 #define UE_SRVCC_PRESENT (1U << 4)
 
+#define PUT_MSISDN_PRESENT (1U)
+#define PUT_ACCESS_RESTRICTION_PRESENT (1U << 1)
+#define PUT_KEY_PRESENT (1U << 2)
+#define PUT_OPC_PRESENT (1U << 3)
+#define PUT_RAND_PRESENT (1U << 4)
+#define PUT_SQN_PRESENT (1U << 5)
+#define PUT_SUBSCRIPTION_DATA_PRESENT (1U << 6)
+
 #define KEY_LENGTH (16)
 #define SQN_LENGTH (6)
 #define RAND_LENGTH (16)
@@ -40,7 +55,7 @@ class DAException : public std::runtime_error {
   DAException(const std::string& m) : std::runtime_error(m) {}
 };
 
-class DAImsiList : public std::list<std::string> {
+class DAImsiList : public std::vector<SubscriberKey> {
  public:
   DAImsiList() {}
   ~DAImsiList() {}
@@ -63,6 +78,7 @@ class DAEvent {
     extid.clear();
     ui_json.clear();
     mec_json.clear();
+    monitoring_type = 0;
   }
 
   std::string scef_id;
@@ -80,6 +96,38 @@ class DAEventList : public std::list<DAEvent*> {
   ~DAEventList();
 };
 
+//
+// Monitoring event changes written by DataAccess::applyEvents().  The events
+// table and its msisdn and extid index tables are updated atomically, so a
+// failure can not leave an index entry without its event.  A removed event
+// is the event as read by getEvent(), its msisdn and extid identify the
+// index entries to remove.
+//
+class DAEventBatch {
+ public:
+  DAEventBatch() {}
+  ~DAEventBatch() {}
+
+  void add(const DAEvent& event) { m_adds.push_back(event); }
+  void remove(const DAEvent& event) { m_removes.push_back(event); }
+
+  std::list<DAEvent>& adds() { return m_adds; }
+  std::list<DAEvent>& removes() { return m_removes; }
+
+  bool empty() { return m_adds.empty() && m_removes.empty(); }
+
+  // the event added with the scef_id and scef_ref_id, NULL if there is none
+  const DAEvent* added(const std::string& scef_id, uint32_t scef_ref_id) {
+    for (auto it = m_adds.begin(); it != m_adds.end(); ++it)
+      if (it->scef_ref_id == scef_ref_id && it->scef_id == scef_id) return &*it;
+    return NULL;
+  }
+
+ private:
+  std::list<DAEvent> m_adds;
+  std::list<DAEvent> m_removes;
+};
+
 struct DAEventId {
   std::string scef_id;
   uint32_t scef_ref_id;
@@ -103,12 +151,35 @@ class DAEventIdList : public std::list<DAEventId*> {
   }
 };
 
+// a value left in the buffer it was read into, see DAImsiInfo::keepalive
+class DAView {
+ public:
+  DAView() : m_data(NULL), m_len(0) {}
+  DAView(const char* data, size_t len) : m_data(data), m_len(len) {}
+
+  const char* data() const { return m_data; }
+  size_t size() const { return m_len; }
+  bool empty() const { return m_len == 0; }
+
+  std::string str() const { return std::string(m_data, m_len); }
+
+  void clear() {
+    m_data = NULL;
+    m_len  = 0;
+  }
+
+ private:
+  const char* m_data;
+  size_t m_len;
+};
+
 struct DAImsiInfo {
   std::string imsi;
   std::string mmehost;
   std::string mmerealm;
   std::string ms_ps_status;
   std::string subscription_data;
+  std::string subscription_data_bin;
   int64_t msisdn;
   std::string str_msisdn;
   std::string visited_plmnid;
@@ -116,6 +187,31 @@ struct DAImsiInfo {
   std::string imei;
   std::string imei_sv;
   int32_t mme_id;
+
+  // A storage implementation may leave the subscription data as views of
+  // the buffer it was read into instead of copying it, keepalive owns that
+  // buffer.  Use getSubscriptionData() and getSubscriptionDataBin() rather
+  // than the strings above.
+  std::shared_ptr<void> keepalive;
+  DAView subscription_data_view;
+  DAView subscription_data_bin_view;
+
+  const std::string& getSubscriptionData() {
+    if (subscription_data.empty() && !subscription_data_view.empty())
+      subscription_data = subscription_data_view.str();
+    return subscription_data;
+  }
+
+  DAView getSubscriptionDataView() {
+    if (!subscription_data.empty() || subscription_data_view.empty())
+      return DAView(subscription_data.data(), subscription_data.size());
+    return subscription_data_view;
+  }
+
+  DAView getSubscriptionDataBin() {
+    if (!subscription_data_bin_view.empty()) return subscription_data_bin_view;
+    return DAView(subscription_data_bin.data(), subscription_data_bin.size());
+  }
 };
 
 struct DAImsiSec {
@@ -125,110 +221,137 @@ struct DAImsiSec {
   uint8_t opc[OPC_LENGTH];
 };
 
+typedef void (*DAPreloadCallback)(void* data);
+
+//
+// Storage interface used by the HSS applications.  Operations that accept a
+// CassFutureCallback are asynchronous when a callback is supplied: the call
+// returns once the operation has been issued and the callback is invoked
+// later from a backend thread, never from within the issuing call.  The
+// callback passes the future to the matching *Data() method to retrieve the
+// result.  A backend that does not use Cassandra invokes the callback with a
+// NULL future and its *Data() methods do not reference the future.  When no
+// callback is supplied the operation completes before returning.
+//
 class DataAccess {
  public:
   DataAccess();
   virtual ~DataAccess();
 
-  std::string& host(const char* hst) { return m_db.host(hst); }
-  std::string& host(const std::string& hst) { return m_db.host(hst); }
-  std::string& host() { return m_db.host(); }
-
-  std::string& keyspace(const char* ks) { return m_db.keyspace(ks); }
-  std::string& keyspace(const std::string& ks) { return m_db.keyspace(ks); }
-  std::string& keyspace() { return m_db.keyspace(); }
-
-  int protocolVersion(int pv) { return m_db.protocolVersion(pv); }
-  int protocolVersion() { return m_db.protocolVersion(); }
-
-  void connect();
-  void connect(const std::string& hst, const std::string& ks = "vhss");
-  void connect(const char* hst, const char* ks = "vhss");
-
-  void disconnect();
-
-  bool addEvent(DAEvent& event);
+  virtual bool addEvent(DAEvent& event) = 0;
 
-  bool getEvent(const char* scef_id, uint32_t scef_ref_id, DAEvent& event);
+  virtual bool getEvent(
+      const char* scef_id, uint32_t scef_ref_id, DAEvent& event) = 0;
   bool getEvent(
       const std::string& scef_id, uint32_t scef_ref_id, DAEvent& event) {
     return getEvent(scef_id.c_str(), scef_ref_id, event);
   }
 
-  bool getEvents(
+  virtual bool getEvents(
       const char* scef_id, std::list<uint32_t> scef_ref_ids,
-      DAEventList& events, CassFutureCallback cb, void* data);
-  bool getEventsData(SCassFuture& future, DAEventList& events);
+      DAEventList& events, CassFutureCallback cb, void* data)    = 0;
+  virtual bool getEventsData(SCassFuture& future, DAEventList& events) = 0;
 
-  void deleteEvent(const char* scef_id, uint32_t scef_ref_id);
+  virtual void deleteEvent(const char* scef_id, uint32_t scef_ref_id) = 0;
   void deleteEvent(const std::string& scef_id, uint32_t scef_ref_id) {
     deleteEvent(scef_id.c_str(), scef_ref_id);
   }
 
-  bool checkMSISDNExists(int64_t msisdn);
+  // removes and adds the events of a non-empty batch in a single write
+  virtual bool applyEvents(
+      DAEventBatch& batch, CassFutureCallback cb, void* data) = 0;
+  virtual bool applyEventsData(SCassFuture& future)           = 0;
 
-  bool checkImsiExists(const char* imsi);
+  // false when the subscriber is known to have no monitoring events for its
+  // MSISDN or external identifiers, so the event queries can be skipped
+  virtual bool mayHaveEvents(const char* imsi) { return true; }
+
+  // warms the caches used to process requests in the background, the
+  // callback is invoked once the caches are warm
+  virtual void preload(DAPreloadCallback cb, void* data) {
+    if (cb) cb(data);
+  }
+
+  virtual bool checkMSISDNExists(int64_t msisdn) = 0;
+
+  virtual bool checkImsiExists(const char* imsi) = 0;
   bool checkImsiExists(const std::string& imsi) {
     return checkImsiExists(imsi.c_str());
   }
 
-  bool checkExtIdExists(const char* extid);
+  virtual bool checkExtIdExists(const char* extid) = 0;
   bool checkExtIdExists(const std::string& extid) {
     return checkExtIdExists(extid.c_str());
   }
 
-  bool getImsiListFromExtId(const char* extid, DAImsiList& imsilst);
+  virtual bool getImsiListFromExtId(const char* extid, DAImsiList& imsilst) = 0;
   bool getImsiListFromExtId(std::string& extid, DAImsiList& imsilst) {
     return getImsiListFromExtId(extid.c_str(), imsilst);
   }
 
-  bool getExtIdsFromImsiData(SCassFuture& future, DAExtIdList& extids);
-  bool getExtIdsFromImsi(
-      const char* imsi, DAExtIdList& extids, CassFutureCallback cb, void* data);
+  virtual bool getExtIdsFromImsiData(
+      SCassFuture& future, DAExtIdList& extids) = 0;
+  virtual bool getExtIdsFromImsi(
+      const char* imsi, DAExtIdList& extids, CassFutureCallback cb,
+      void* data) = 0;
   bool getExtIdsFromImsi(
       const std::string& imsi, DAExtIdList& extids, CassFutureCallback cb,
       void* data) {
     return getExtIdsFromImsi(imsi.c_str(), extids, cb, data);
   }
 
-  bool getImsiFromMsisdn(int64_t msisdn, std::string& imsi);
-  bool getImsiFromMsisdn(const char* msisdn, std::string& imsi);
+  virtual bool getImsiFromMsisdn(int64_t msisdn, std::string& imsi)     = 0;
+  virtual bool getImsiFromMsisdn(const char* msisdn, std::string& imsi) = 0;
   bool getImsiFromMsisdn(const std::string& msisdn, std::string& imsi) {
     return getImsiFromMsisdn(msisdn.c_str(), imsi);
   }
 
-  bool getMsisdnFromImsi(const char* imsi, std::string& msisdn);
+  virtual bool getMsisdnFromImsi(const char* imsi, std::string& msisdn) = 0;
   bool getMsisdnFromImsi(const std::string& imsi, std::string& msisdn) {
     return getMsisdnFromImsi(imsi.c_str(), msisdn);
   }
-  bool getMsisdnFromImsi(const char* imsi, int64_t& msisdn);
-
-  bool getImsiInfoData(SCassFuture& future, DAImsiInfo& info);
+  virtual bool getMsisdnFromImsi(const char* imsi, int64_t& msisdn) = 0;
+
+  virtual bool getImsiInfoData(SCassFuture& future, DAImsiInfo& info) = 0;
+  // Returns false when the query was not issued, the callback is then not
+  // invoked.  A backend that looks the subscriber up when the query is
+  // issued, like the local data store, reports an unknown subscriber this
+  // way, getImsiInfoData() returns false for it otherwise.  subdata false
+  // leaves the subscription data out of the info.
+  virtual bool getImsiInfo(
+      const char* imsi, DAImsiInfo& info, bool subdata, CassFutureCallback cb,
+      void* data) = 0;
   bool getImsiInfo(
-      const char* imsi, DAImsiInfo& info, CassFutureCallback cb, void* data);
+      const char* imsi, DAImsiInfo& info, CassFutureCallback cb, void* data) {
+    return getImsiInfo(imsi, info, true, cb, data);
+  }
   bool getImsiInfo(
       const std::string& imsi, DAImsiInfo& info, CassFutureCallback cb,
       void* data) {
-    return getImsiInfo(imsi.c_str(), info, cb, data);
+    return getImsiInfo(imsi.c_str(), info, true, cb, data);
   }
 
-  bool getEventIdsFromMsisdnData(SCassFuture& future, DAEventIdList& el);
-  bool getEventIdsFromMsisdn(
-      int64_t msisdn, DAEventIdList& el, CassFutureCallback cb, void* data);
+  virtual bool getEventIdsFromMsisdnData(
+      SCassFuture& future, DAEventIdList& el) = 0;
+  virtual bool getEventIdsFromMsisdn(
+      int64_t msisdn, DAEventIdList& el, CassFutureCallback cb,
+      void* data) = 0;
 
-  void getEventIdsFromExtId(const char* extid, DAEventIdList& el);
+  virtual void getEventIdsFromExtId(const char* extid, DAEventIdList& el) = 0;
   void getEventIdsFromExtId(const std::string& extid, DAEventIdList& el) {
     getEventIdsFromExtId(extid.c_str(), el);
   }
 
-  bool getEventIdsFromExtIds(
-      const char* extid, DAEventIdList& el, CassFutureCallback cb, void* data);
+  virtual bool getEventIdsFromExtIds(
+      const char* extid, DAEventIdList& el, CassFutureCallback cb,
+      void* data) = 0;
   bool getEventIdsFromExtIds(
       const std::string& extid, DAEventIdList& el, CassFutureCallback cb,
       void* data) {
     return getEventIdsFromExtIds(extid.c_str(), el, cb, data);
   }
-  bool getEventIdsFromExtIdsData(SCassFuture& future, DAEventIdList& el);
+  virtual bool getEventIdsFromExtIdsData(
+      SCassFuture& future, DAEventIdList& el) = 0;
 
   void getEventsFromImsi(const char* imsi, DAEventList& mcel);
   void getEventsFromImsi(const std::string& imsi, DAEventList& mcel) {
@@ -236,86 +359,83 @@ class DataAccess {
   }
   void getEventsFromImsi(DAImsiInfo& info, DAEventList& el);
 
-  bool checkOpcKeys(const uint8_t opP[16]);
-  bool updateOpc(std::string& imsi, std::string& opc);
-
-  bool purgeUE(std::string& imsi);
+  virtual bool checkOpcKeys(const uint8_t opP[16])           = 0;
+  virtual bool updateOpc(std::string& imsi, std::string& opc) = 0;
 
-  bool getMmeIdentityFromImsi(std::string& imsi, DAMmeIdentity& mmeid);
+  virtual bool purgeUE(std::string& imsi) = 0;
 
-  bool getMmeIdentity(std::string& mme_id, DAMmeIdentity& mmeid);
-  bool getMmeIdentity(int32_t mme_id, DAMmeIdentity& mmeid);
+  virtual bool getMmeIdentityFromImsi(
+      std::string& imsi, DAMmeIdentity& mmeid) = 0;
 
-  bool getLatestIdentity(
-      const char* table_name, int64_t& id, CassFutureCallback cb, void* data);
-  bool getLatestIdentityData(SCassFuture& future, int64_t& id);
+  virtual bool getMmeIdentity(std::string& mme_id, DAMmeIdentity& mmeid) = 0;
+  virtual bool getMmeIdentity(int32_t mme_id, DAMmeIdentity& mmeid)      = 0;
 
-  bool updateLatestIdentity(
-      const char* table_name, CassFutureCallback cb, void* data);
+  virtual bool getMmeIdFromHostData(SCassFuture& future, int32_t& mmeid) = 0;
+  virtual bool getMmeIdFromHost(
+      std::string& host, int32_t& mmeid, CassFutureCallback cb,
+      void* data) = 0;
 
-  bool getMmeIdFromHostData(SCassFuture& future, int32_t& mmeid);
-  bool getMmeIdFromHost(
-      std::string& host, int32_t& mmeid, CassFutureCallback cb, void* data);
+  virtual bool addMmeIdentity(
+      std::string& host, std::string& realm, int32_t mmeid) = 0;
+  virtual bool deleteMmeIdentity(std::string& host) = 0;
 
-  bool addMmeIdentity(std::string& host, std::string& realm, int32_t mmeid);
-  bool addMmeIdentity1(
-      std::string& host, std::string& realm, int32_t mmeid,
-      CassFutureCallback cb, void* data);
-  bool addMmeIdentity2(
-      std::string& host, std::string& realm, int32_t mmeid,
-      CassFutureCallback cb, void* data);
-
-  bool updateLocation(
+  virtual bool updateLocation(
       DAImsiInfo& location, uint32_t present_flags, int32_t idmmeidentity,
-      CassFutureCallback cb, void* data);
-  bool updateLocation(
+      CassFutureCallback cb, void* data) = 0;
+  virtual bool updateLocation(
       DAImsiInfo& location, uint32_t present_flags, CassFutureCallback cb,
-      void* data);
+      void* data)                                    = 0;
+  virtual bool updateLocationData(SCassFuture& future) = 0;
 
-  bool getImsiSec(
+  virtual bool getImsiSec(
       const std::string& imsi, DAImsiSec& imsisec, CassFutureCallback cb,
-      void* data);
-  bool getImsiSecData(SCassFuture& future, DAImsiSec& imsisec);
+      void* data)                                                     = 0;
+  virtual bool getImsiSecData(SCassFuture& future, DAImsiSec& imsisec) = 0;
 
-  bool updateRandSqn(
+  virtual bool updateRandSqn(
       const std::string& imsi, uint8_t* rand_p, uint8_t* sqn, bool inc_sqn,
-      CassFutureCallback cb, void* data);
+      CassFutureCallback cb, void* data)            = 0;
+  virtual bool updateRandSqnData(SCassFuture& future) = 0;
 
-  bool incSqn(std::string& imsi, uint8_t* sqn);
+  virtual bool incSqn(std::string& imsi, uint8_t* sqn) = 0;
 
-  bool getSubDataFromImsi(const char* imsi, std::string& sub_data);
+  virtual bool getSubDataFromImsi(const char* imsi, std::string& sub_data) = 0;
   bool getSubDataFromImsi(const std::string& imsi, std::string& sub_data) {
     return getSubDataFromImsi(imsi.c_str(), sub_data);
   }
 
-  void UpdateValidityTime(const char* imsi, std::string& validity_time);
+  // sub_data_bin is the Diameter encoding of sub_data (see fdJsonEncodeAvps),
+  // an empty string clears the encoded column
+  virtual bool updateSubscriptionData(
+      const char* imsi, const std::string& sub_data,
+      const std::string& sub_data_bin) = 0;
+
+  // Subscriber provisioning.  putImsi() creates the subscriber or replaces
+  // the provisioned values named by present_flags (PUT_*_PRESENT), the
+  // values that are not present and the location of an existing subscriber
+  // are left untouched.  A changed MSISDN replaces the index entry of the
+  // stored one.  deleteImsi() removes the subscriber and the index entry of
+  // its stored MSISDN, an unknown subscriber is reported like getImsiInfo().
+  virtual bool putImsi(
+      const DAImsiInfo& info, const DAImsiSec& sec, uint32_t present_flags,
+      CassFutureCallback cb, void* data)       = 0;
+  virtual bool putImsiData(SCassFuture& future) = 0;
+  virtual bool deleteImsi(
+      const std::string& imsi, CassFutureCallback cb, void* data) = 0;
+  virtual bool deleteImsiData(SCassFuture& future)                = 0;
+
+  virtual void UpdateValidityTime(
+      const char* imsi, std::string& validity_time) = 0;
   void UpdateValidityTime(const std::string& imsi, std::string& validity_time) {
     UpdateValidityTime(imsi.c_str(), validity_time);
   }
 
-  void UpdateNIRDestination(
-      const char* imsi, std::string& host, std::string& realm);
+  virtual void UpdateNIRDestination(
+      const char* imsi, std::string& host, std::string& realm) = 0;
   void UpdateNIRDestination(
       const std::string& imsi, std::string& host, std::string& realm) {
     UpdateNIRDestination(imsi.c_str(), host, realm);
   }
-
-  //	bool getImsiFromScefIdScefRefId( char *scef_id, uint32_t scef_ref_id,
-  // std::string &imsi );
-
-  //	bool getScefIdScefRefIdFromImsi( char *imsi, std::string &scef_id,
-  // uint32_t &scef_ref_id );
-
-  //	bool delScefIds( const char *imsi);
-
-  //	bool delImsiFromScefIds ( const char *scef_id, uint32_t scef_ref_id );
-
-  // bool isImsiAttached ( const char *imsi );
-  // bool isImsiAttached ( const std::string &imsi ) { return isImsiAttached(
-  // imsi.c_str() ); }
-
- private:
-  SCassandra m_db;
 };
 
 #endif /* __DATAACCESS_H */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __EVENTINDEX_H
+#define __EVENTINDEX_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dataaccess.h"
+#include "scassandra.h"
+#include "sthread.h"
+#include "subscriberkey.h"
+
+const uint16_t EVENTINDEX_UPDATE  = ETM_USER + 5;
+const uint16_t EVENTINDEX_REBUILD = ETM_USER + 6;
+
+class EventIndexUpdateMsg : public SEventThreadMessage {
+ public:
+  EventIndexUpdateMsg(const DAEvent& event, bool add)
+      : SEventThreadMessage(EVENTINDEX_UPDATE), m_event(event), m_add(add) {}
+
+  DAEvent m_event;
+  bool m_add;
+
+ private:
+  EventIndexUpdateMsg();
+};
+
+//
+// The subscribers that have monitoring events for their MSISDN or one of
+// their external identifiers.  The index is built by scanning events_msisdn
+// and events_extid when the thread starts and again every refresh interval,
+// which picks up provisioning changes and the events written by other HSS
+// instances.  The events written by this instance are applied as they are
+// written.  Until the first scan completes, while an added event has not
+// been applied and after invalidate() until the index has been rebuilt,
+// every subscriber may have events.  The events and MSISDN changes written
+// by another HSS instance are only seen by the next scan, so the index is
+// only exact with a single instance.
+//
+class EventIndex : public SEventThread {
+ public:
+  EventIndex(DataAccess& da, SCassandra& db, unsigned refresh);
+  virtual ~EventIndex();
+
+  void onInit();
+  void onQuit();
+  void onTimer(SEventThread::Timer& t);
+  void dispatch(SEventThreadMessage& msg);
+
+  void add(const DAEvent& event);
+  void remove(const DAEvent& event);
+
+  // a subscriber's MSISDN may have changed, so an event for the MSISDN may
+  // belong to a subscriber that is not indexed
+  void invalidate();
+
+  // stops a scan in progress and ends the thread
+  void stop();
+
+  bool mayHaveEvents(const char* imsi);
+
+ private:
+  typedef std::pair<std::string, uint32_t> EventKey;
+  typedef std::map<EventKey, std::vector<SubscriberKey> > EventImsis;
+  typedef std::unordered_map<SubscriberKey, uint32_t> ImsiCounts;
+  typedef std::unordered_map<int64_t, SubscriberKey> MsisdnCache;
+  typedef std::unordered_map<std::string, DAImsiList> ExtIdCache;
+
+  EventIndex();
+
+  void build();
+  bool scan(
+      const char* qry, bool msisdn, EventImsis& events, MsisdnCache& msisdns,
+      ExtIdCache& extids);
+
+  bool resolve(
+      const DAEvent& event, std::vector<SubscriberKey>& imsis,
+      MsisdnCache& msisdns, ExtIdCache& extids);
+  void count(const std::vector<SubscriberKey>& imsis, bool add);
+
+  DataAccess& m_da;
+  SCassandra& m_db;
+  unsigned m_refresh;
+  SEventThread::Timer m_timer;
+
+  // only referenced by the index thread
+  EventImsis m_events;
+
+  SMutex m_mutex;
+  ImsiCounts m_counts;
+
+  volatile bool m_ready;
+  volatile bool m_stop;
+  volatile int m_pending;
+  volatile int m_invalidated;
+};
+
+#endif  // #define __EVENTINDEX_H
@@ -19,6 +19,7 @@
 
 #ifdef __cplusplus
 
+#include <list>
 #include <set>
 #include "fd.h"
 #include "dataaccess.h"
@@ -59,25 +60,25 @@ class Endpoint;
 class MonitoringConfEventStatus;
 class ImsiResult;
 class RIRBuilder;
-class ImsiStatus;
+struct RIRItem;
 
 typedef std::map<std::pair<std::string, uint32_t>, MonitoringConfEventStatus>
     EvenStatusMap;
 
-typedef std::map<std::pair<std::string, uint32_t>, std::vector<ImsiStatus> >
-    EventImsiStatus;
+typedef std::map<std::pair<std::string, uint32_t>, std::vector<RIRItem> >
+    EventRIRItems;
 
 typedef struct hss_config_s hss_config_t;
 
 class HandleMmeResponseEvtMsg : public SEventThreadMessage {
  public:
   HandleMmeResponseEvtMsg(
-      EvenStatusMap* mme_response, std::string& imsi, int imsi_reachable,
-      std::string& msisdn);
+      EvenStatusMap* mme_response, const SubscriberKey& imsi,
+      int imsi_reachable, const SubscriberKey& msisdn);
   EvenStatusMap* m_mme_response;
-  std::string m_imsi;
+  SubscriberKey m_imsi;
   int m_imsi_reachable;
-  std::string m_msisdn;
+  SubscriberKey m_msisdn;
 
  private:
   HandleMmeResponseEvtMsg();
@@ -105,21 +106,14 @@ class MonitoringConfEventStatus {
   bool is_long_term;
 };
 
-class ImsiStatus {
- public:
-  ImsiStatus(
-      std::string& imsi, MonitoringConfEventStatus& status, int reachability,
-      std::string& msisdn) {
-    m_imsi         = imsi;
-    m_status       = status;
-    m_reachability = reachability;
-    m_msisdn       = msisdn;
-  }
-
-  std::string m_imsi;
-  MonitoringConfEventStatus m_status;
-  int m_reachability;
-  std::string m_msisdn;
+// a Group-Monitoring-Event-Report-Item that has not been reported yet
+struct RIRItem {
+  RIRItem(const SubscriberKey& msisdn, uint32_t result, bool absent)
+      : msisdn(msisdn), result(result), absent(absent) {}
+
+  SubscriberKey msisdn;
+  uint32_t result;
+  bool absent;
 };
 
 class ImsiImeiData {
@@ -134,6 +128,10 @@ class ImsiImeiData {
   std::string new_imei_sv;
 };
 
+#define HSS_QUEUE_OTHER 0
+#define HSS_QUEUE_ULR 1
+#define HSS_QUEUE_AIR 2
+
 class HSSWorkerQueue : public QueueManager {
  public:
   HSSWorkerQueue();
@@ -141,7 +139,7 @@ class HSSWorkerQueue : public QueueManager {
 
   void addProcessor(QueueProcessor* processor);
   void startProcessor();
-  void finishProcessor();
+  void finishProcessor(int type = HSS_QUEUE_OTHER);
 };
 
 class FDHss {
@@ -164,15 +162,18 @@ class FDHss {
 
   int sendINSDRreq(
       s6t::MonitoringEventConfigurationExtractorList& cir_monevtcfg,
-      std::string& imsi, FDMessageRequest* cir_req, EvenStatusMap* evt_map,
-      RIRBuilder* rir_builder);
+      const SubscriberKey& imsi, FDMessageRequest* cir_req,
+      EvenStatusMap* evt_map, RIRBuilder* rir_builder);
 
-  void sendRIR_ChangeImsiImeiSvAssn(ImsiImeiData& data);
+  // reports an IMEI(SV) change of a subscriber to the references of a SCEF
+  void sendRIR_ChangeImsiImeiSvAssn(
+      const std::string& imsi, int64_t msisdn, const std::string& scef_id,
+      const std::list<uint32_t>& scef_ref_ids);
 
   s6t::Application* gets6tApp() { return m_s6tapp; }
   s6as6d::Application* gets6as6dApp() { return m_s6aapp; }
   s6c::Application* gets6cApp() { return m_s6capp; }
-  DataAccess& getDb() { return m_dbobj; }
+  DataAccess& getDb() { return *m_dbobj; }
   WorkerManager& getWorkMgr() { return m_wrkmgr; }
   HSSWorkerQueue& getWorkerQueue() { return m_workerqueue; }
 
@@ -182,20 +183,31 @@ class FDHss {
   bool synchFix();
 
  private:
+  // reports the HSS as ready through OSS once the caches have been preloaded
+  static void on_preload_callback(void* data);
+
   FDEngine m_diameter;
   s6t::Application* m_s6tapp;
   s6as6d::Application* m_s6aapp;
   s6c::Application* m_s6capp;
   FDPeerList m_mme_peers;
-  DataAccess m_dbobj;
+  DataAccess* m_dbobj;
   Pistache::Http::Endpoint* m_endpoint;
   OssEndpoint<Logger>* m_ossendpoint;
+  SMutex m_ossmutex;
   WorkerManager m_wrkmgr;
   HSSWorkerQueue m_workerqueue;
 };
 
 extern FDHss fdHss;
 
+//
+// Reports the results of a group configuration to the SCEF.  The items are
+// sent when the reporting interval expires, when the number of items or
+// their estimated size reaches the configured limit and once every member
+// has been processed.  Items are released once sent, so a large group is
+// reported in a series of RIRs.
+//
 class RIRBuilder : public SEventThread {
  public:
   RIRBuilder(
@@ -209,7 +221,11 @@ class RIRBuilder : public SEventThread {
   void dispatch(SEventThreadMessage& msg);
 
  private:
+  void addItem(
+      const std::pair<std::string, uint32_t>& event, const RIRItem& item);
+  void checkLimits();
   void sendRIR();
+  void finish();
 
   long m_interval;
   int m_nb_ida_proc;
@@ -219,7 +235,10 @@ class RIRBuilder : public SEventThread {
   std::string m_destination_realm;
 
   EvenStatusMap* m_hss_insert_status;
-  EventImsiStatus imsi_status_map;
+  EventRIRItems m_items;
+  size_t m_nbitems;
+  size_t m_nbbytes;
+  uint32_t m_nbsent;
   bool m_ciasent;
 };
 
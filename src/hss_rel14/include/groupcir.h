@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __GROUPCIR_H
+#define __GROUPCIR_H
+
+#include <stdint.h>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "dataaccess.h"
+#include "fdhss.h"
+#include "sthread.h"
+
+namespace s6as6d {
+class Application;
+}
+
+const uint16_t GROUP_LOOKUP_COMPLETE = ETM_USER + 4;
+
+class GroupConfiguration;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// A member of the group from the time its subscriber information is requested
+// until its INSDR Request has been sent or its status has been reported.
+struct GroupLookup {
+  GroupLookup(GroupConfiguration& group, const SubscriberKey& imsi)
+      : group(group), imsi(imsi), info(), found(false) {}
+
+  GroupConfiguration& group;
+  SubscriberKey imsi;
+  DAImsiInfo info;
+  bool found;
+};
+
+class GroupLookupMsg : public SEventThreadMessage {
+ public:
+  GroupLookupMsg(GroupLookup* lookup)
+      : SEventThreadMessage(GROUP_LOOKUP_COMPLETE), m_lookup(lookup) {}
+
+  GroupLookup* m_lookup;
+
+ private:
+  GroupLookupMsg();
+};
+
+//
+// Sends the INSDR Requests of a group CIR.  The subscriber information is
+// retrieved asynchronously with up to Options::getgroupcirconcurrent() members
+// outstanding, a member remaining outstanding until its request has been sent,
+// so an MME that is being rate limited also bounds the members held in memory.
+// The state of each MME peer is checked at most once a second and, when
+// Options::getgroupidrrate() is set, no more than that many requests are sent
+// to an MME each second.  The thread deletes itself once the status of every
+// member has been reported to the RIR builder.
+//
+class GroupConfiguration : public SEventThread {
+ public:
+  GroupConfiguration(
+      s6as6d::Application& app, DAImsiList& imsis, std::string& monevtcfg,
+      RIRBuilder* rir_builder, const std::string& origin_host);
+  virtual ~GroupConfiguration();
+
+  void onInit();
+  void onQuit();
+  void onTimer(SEventThread::Timer& t);
+  void dispatch(SEventThreadMessage& msg);
+
+  // converts the Monitoring-Event-Configuration AVP's of the CIR to their
+  // Diameter encoding, so they remain available once the CIR has been freed
+  static bool encodeMonitoringEventConfiguration(
+      s6t::MonitoringEventConfigurationExtractorList& cfg, std::string& bin);
+
+ private:
+  struct MmeState {
+    MmeState() : checked(false), reachable(false), sent(0) {}
+
+    bool checked;
+    bool reachable;
+    uint32_t sent;
+    std::deque<GroupLookup*> pending;
+  };
+
+  GroupConfiguration();
+
+  static void on_lookup_callback(CassFuture* future, void* data);
+
+  void lookup();
+  void process(GroupLookup* l);
+  bool mmeReachable(MmeState& mme, const std::string& host);
+  void send(MmeState& mme, GroupLookup* l);
+  void report(GroupLookup* l, int reachability);
+  void release(GroupLookup* l);
+  void logProgress(const char* state);
+
+  s6as6d::Application& m_app;
+  DAImsiList m_imsis;
+  std::string m_monevtcfg;
+  RIRBuilder* m_rir_builder;
+  std::string m_origin_host;
+
+  size_t m_concurrent;
+  uint32_t m_rate;
+
+  size_t m_next;
+  size_t m_outstanding;
+  size_t m_completed;
+  size_t m_sent;
+  size_t m_notactive;
+  size_t m_mmedown;
+  bool m_done;
+
+  std::unordered_map<std::string, MmeState> m_mmes;
+  SEventThread::Timer m_timer;
+  int m_ticks;
+};
+
+#endif  // #define __GROUPCIR_H
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __IMEICHANGE_H
+#define __IMEICHANGE_H
+
+#include <stdint.h>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "dataaccess.h"
+#include "fdhss.h"
+#include "worker.h"
+
+#define IMEICHANGE_PHASE1 (WORKER_EVENT + 300)
+#define IMEICHANGE_PHASEFINAL (WORKER_EVENT + 301)
+
+#define IMEICHANGEDB_GET_IMSI_INFO 1
+#define IMEICHANGEDB_GET_EXT_IDS 2
+#define IMEICHANGEDB_GET_EVNTIDS_MSISDN 3
+#define IMEICHANGEDB_GET_EVNTIDS_EXTIDS 4
+#define IMEICHANGEDB_GET_EVNTS_EVNTIDS 5
+
+class ImeiChangeProcessor;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// the monitoring events of a subscriber whose IMEI(SV) changed, the queries
+// outstanding for it hold a reference until they complete
+struct ImeiChangeLookup {
+  ImeiChangeLookup(ImeiChangeProcessor& processor, const ImsiImeiData& data)
+      : processor(processor),
+        imsi(data.imsi),
+        msisdn(data.msisdn),
+        found(false),
+        pending(1),
+        eventsissued(false) {}
+
+  ImeiChangeProcessor& processor;
+  std::string imsi;
+  int64_t msisdn;
+  DAImsiInfo info;
+  bool found;
+  volatile int pending;
+  bool eventsissued;
+  SMutex mutex;
+  DAEventIdList evtids;
+  DAEventList events;
+};
+
+// a query of a lookup, the results are collected here since the driver
+// thread completing it may run alongside the other queries of the lookup
+class ImeiChangeQuery {
+ public:
+  ImeiChangeQuery(uint16_t action, ImeiChangeLookup& lookup)
+      : m_action(action), m_lookup(lookup) {}
+
+  uint16_t getAction() { return m_action; }
+  ImeiChangeLookup& getLookup() { return m_lookup; }
+
+  DAExtIdList extids;
+  DAEventIdList evtids;
+  DAEventList events;
+  std::string scef_id;
+  std::list<uint32_t> scef_ref_ids;
+
+ private:
+  ImeiChangeQuery();
+
+  uint16_t m_action;
+  ImeiChangeLookup& m_lookup;
+};
+
+class ImeiChangeStateProcessor : public WorkProcessor {
+ public:
+  ImeiChangeStateProcessor(uint16_t state, ImeiChangeProcessor* processor)
+      : m_state(state), m_processor(processor) {}
+  virtual ~ImeiChangeStateProcessor() {}
+
+  void process();
+
+ private:
+  uint16_t m_state;
+  ImeiChangeProcessor* m_processor;
+};
+
+//
+// Reports IMEI(SV) changes received by the REST interface to the SCEF's
+// monitoring them.  Notifications are collected into the batch of the
+// processor waiting in the worker queue, so a burst of notifications is
+// handled by a few processors instead of one per subscriber, up to
+// Options::getimeichangebatch() notifications each.  The subscribers of a
+// batch are looked up concurrently and each is reported once, with a single
+// RIR per SCEF carrying a Monitoring-Event-Report for each of its
+// references.
+//
+class ImeiChangeProcessor : public QueueProcessor {
+ public:
+  ImeiChangeProcessor();
+  virtual ~ImeiChangeProcessor();
+
+  // queues a notification, safe to call from any thread
+  static void add(const ImsiImeiData& data);
+
+  void triggerNextPhase();
+  void phase1();
+  void phaseFinal();
+
+ private:
+  static void on_query_callback(CassFuture* future, void* data);
+
+  void issue(ImeiChangeLookup& l, ImeiChangeQuery* q);
+  void completed(ImeiChangeQuery* q, SCassFuture& future);
+  void getEvents(ImeiChangeLookup& l);
+  void release(ImeiChangeLookup& l);
+  void lookupComplete();
+  void report(ImeiChangeLookup& l);
+
+  static SMutex m_addmutex;
+  static ImeiChangeProcessor* m_open;
+
+  std::vector<ImsiImeiData> m_batch;
+  std::vector<ImeiChangeLookup*> m_lookups;
+  volatile int m_outstanding;
+};
+
+#endif  // #define __IMEICHANGE_H
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOCALDATAACCESS_H
+#define __LOCALDATAACCESS_H
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dataaccess.h"
+#include "squeue.h"
+#include "ssync.h"
+#include "sthread.h"
+
+#define LOCAL_SNAPSHOT_FILE "hss.snapshot"
+#define LOCAL_LOG_FILE "hss.log"
+
+class LocalDataAccess;
+class LocalRecord;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct LocalSubscriber {
+  DAImsiInfo info;
+  DAImsiSec sec;
+  std::string niddvalidity;
+  std::string nir_dest_host;
+  std::string nir_dest_realm;
+  std::set<std::string> extids;
+};
+
+// scef_id and scef_ref_id of a monitoring event
+typedef std::pair<std::string, uint32_t> LocalEventId;
+typedef std::set<LocalEventId> LocalEventIdSet;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class LocalCompletion : public SQueueMessage {
+ public:
+  LocalCompletion(CassFutureCallback cb, void* data);
+
+  CassFutureCallback cb() { return m_cb; }
+  void* data() { return m_data; }
+
+ private:
+  LocalCompletion();
+
+  CassFutureCallback m_cb;
+  void* m_data;
+};
+
+class LocalCompletionThread : public SThread {
+ public:
+  LocalCompletionThread(LocalDataAccess& local);
+  ~LocalCompletionThread();
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  LocalCompletionThread();
+
+  LocalDataAccess& m_local;
+};
+
+// writes a snapshot encoded by LocalDataAccess and removes the logs that
+// were rotated before it was taken
+class LocalSnapshotThread : public SThread {
+ public:
+  LocalSnapshotThread(
+      const std::string& dir, std::string* data, uint32_t logseq,
+      size_t subscribers);
+  ~LocalSnapshotThread();
+
+  bool ok() { return m_ok; }
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  LocalSnapshotThread();
+
+  std::string m_dir;
+  std::string* m_data;
+  uint32_t m_logseq;
+  size_t m_subscribers;
+  bool m_ok;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Embedded storage engine.  All of the data is held in memory in hash
+// indexes.  Every change is appended to a log before it is applied.  Once
+// the log reaches the snapshot interval it is rotated to hss.log.<seq> and
+// the complete data set is encoded and written to a snapshot by a
+// LocalSnapshotThread, which then removes the rotated logs.  On startup the
+// snapshot is loaded and the rotated logs and the log are replayed on top of
+// it.  Log records carry the resulting values rather than the operation, so
+// replaying a log that is already reflected in the snapshot is harmless.  If
+// no directory is supplied to open() nothing is persisted.
+//
+// Lookups are performed when an operation is issued, an operation that does
+// not find the requested subscriber fails immediately, otherwise the callback
+// is queued to the completion threads.
+//
+class LocalDataAccess : public DataAccess {
+  friend LocalCompletionThread;
+
+ public:
+  LocalDataAccess();
+  virtual ~LocalDataAccess();
+
+  using DataAccess::getEvent;
+  using DataAccess::deleteEvent;
+  using DataAccess::checkImsiExists;
+  using DataAccess::checkExtIdExists;
+  using DataAccess::getImsiListFromExtId;
+  using DataAccess::getExtIdsFromImsi;
+  using DataAccess::getImsiFromMsisdn;
+  using DataAccess::getMsisdnFromImsi;
+  using DataAccess::getImsiInfo;
+  using DataAccess::getEventIdsFromExtId;
+  using DataAccess::getEventIdsFromExtIds;
+  using DataAccess::getSubDataFromImsi;
+  using DataAccess::UpdateValidityTime;
+  using DataAccess::UpdateNIRDestination;
+
+  void open(
+      const std::string& dir, uint32_t snapshot_interval, bool sync,
+      int threads);
+  void close();
+
+  bool snapshot();
+
+  bool addImsi(const DAImsiInfo& info, const DAImsiSec& sec);
+  bool deleteImsi(const std::string& imsi);
+  bool addExtId(const std::string& imsi, const std::string& extid);
+
+  size_t subscriberCount();
+
+  bool addEvent(DAEvent& event);
+
+  bool getEvent(const char* scef_id, uint32_t scef_ref_id, DAEvent& event);
+
+  bool getEvents(
+      const char* scef_id, std::list<uint32_t> scef_ref_ids,
+      DAEventList& events, CassFutureCallback cb, void* data);
+  bool getEventsData(SCassFuture& future, DAEventList& events);
+
+  void deleteEvent(const char* scef_id, uint32_t scef_ref_id);
+
+  bool applyEvents(DAEventBatch& batch, CassFutureCallback cb, void* data);
+  bool applyEventsData(SCassFuture& future);
+
+  bool mayHaveEvents(const char* imsi);
+
+  bool checkMSISDNExists(int64_t msisdn);
+  bool checkImsiExists(const char* imsi);
+  bool checkExtIdExists(const char* extid);
+
+  bool getImsiListFromExtId(const char* extid, DAImsiList& imsilst);
+
+  bool getExtIdsFromImsiData(SCassFuture& future, DAExtIdList& extids);
+  bool getExtIdsFromImsi(
+      const char* imsi, DAExtIdList& extids, CassFutureCallback cb, void* data);
+
+  bool getImsiFromMsisdn(int64_t msisdn, std::string& imsi);
+  bool getImsiFromMsisdn(const char* msisdn, std::string& imsi);
+
+  bool getMsisdnFromImsi(const char* imsi, std::string& msisdn);
+  bool getMsisdnFromImsi(const char* imsi, int64_t& msisdn);
+
+  bool getImsiInfoData(SCassFuture& future, DAImsiInfo& info);
+  bool getImsiInfo(
+      const char* imsi, DAImsiInfo& info, bool subdata, CassFutureCallback cb,
+      void* data);
+
+  bool getEventIdsFromMsisdnData(SCassFuture& future, DAEventIdList& el);
+  bool getEventIdsFromMsisdn(
+      int64_t msisdn, DAEventIdList& el, CassFutureCallback cb, void* data);
+
+  void getEventIdsFromExtId(const char* extid, DAEventIdList& el);
+
+  bool getEventIdsFromExtIds(
+      const char* extid, DAEventIdList& el, CassFutureCallback cb, void* data);
+  bool getEventIdsFromExtIdsData(SCassFuture& future, DAEventIdList& el);
+
+  bool checkOpcKeys(const uint8_t opP[16]);
+  bool updateOpc(std::string& imsi, std::string& opc);
+
+  bool purgeUE(std::string& imsi);
+
+  bool getMmeIdentityFromImsi(std::string& imsi, DAMmeIdentity& mmeid);
+
+  bool getMmeIdentity(std::string& mme_id, DAMmeIdentity& mmeid);
+  bool getMmeIdentity(int32_t mme_id, DAMmeIdentity& mmeid);
+
+  bool getMmeIdFromHostData(SCassFuture& future, int32_t& mmeid);
+  bool getMmeIdFromHost(
+      std::string& host, int32_t& mmeid, CassFutureCallback cb, void* data);
+
+  bool addMmeIdentity(std::string& host, std::string& realm, int32_t mmeid);
+  bool deleteMmeIdentity(std::string& host);
+
+  bool updateLocation(
+      DAImsiInfo& location, uint32_t present_flags, int32_t idmmeidentity,
+      CassFutureCallback cb, void* data);
+  bool updateLocation(
+      DAImsiInfo& location, uint32_t present_flags, CassFutureCallback cb,
+      void* data);
+  bool updateLocationData(SCassFuture& future);
+
+  bool getImsiSec(
+      const std::string& imsi, DAImsiSec& imsisec, CassFutureCallback cb,
+      void* data);
+  bool getImsiSecData(SCassFuture& future, DAImsiSec& imsisec);
+
+  bool updateRandSqn(
+      const std::string& imsi, uint8_t* rand_p, uint8_t* sqn, bool inc_sqn,
+      CassFutureCallback cb, void* data);
+  bool updateRandSqnData(SCassFuture& future);
+
+  bool incSqn(std::string& imsi, uint8_t* sqn);
+
+  bool getSubDataFromImsi(const char* imsi, std::string& sub_data);
+
+  bool updateSubscriptionData(
+      const char* imsi, const std::string& sub_data,
+      const std::string& sub_data_bin);
+
+  bool putImsi(
+      const DAImsiInfo& info, const DAImsiSec& sec, uint32_t present_flags,
+      CassFutureCallback cb, void* data);
+  bool putImsiData(SCassFuture& future);
+  bool deleteImsi(
+      const std::string& imsi, CassFutureCallback cb, void* data);
+  bool deleteImsiData(SCassFuture& future);
+
+  void UpdateValidityTime(const char* imsi, std::string& validity_time);
+
+  void UpdateNIRDestination(
+      const char* imsi, std::string& host, std::string& realm);
+
+ protected:
+  virtual bool complete(CassFutureCallback cb, void* data);
+
+ private:
+  void commit(LocalRecord& rec);
+  void putSubscriber(const LocalSubscriber& sub);
+  void apply(LocalRecord& rec);
+  void applyPutImsi(LocalRecord& rec);
+  void applyDelImsi(const std::string& imsi);
+  void applyPutEvent(const DAEvent& event);
+  void applyDelEvent(const std::string& scef_id, uint32_t scef_ref_id);
+
+  uint64_t load(const std::string& path, bool truncate);
+  void startSnapshot();
+  bool reapSnapshot();
+  bool waitSnapshot();
+
+  SMutex m_mutex;
+
+  std::unordered_map<SubscriberKey, LocalSubscriber> m_subscribers;
+  std::unordered_map<int64_t, SubscriberKey> m_msisdns;
+  std::unordered_map<std::string, std::set<SubscriberKey>> m_extids;
+
+  std::unordered_map<int32_t, DAMmeIdentity> m_mmes;
+  std::unordered_map<std::string, int32_t> m_mmehosts;
+
+  std::unordered_map<std::string, std::map<uint32_t, DAEvent>> m_events;
+  std::unordered_map<int64_t, LocalEventIdSet> m_msisdnevents;
+  std::unordered_map<std::string, LocalEventIdSet> m_extidevents;
+
+  std::string m_dir;
+  int m_logfd;
+  bool m_sync;
+  uint32_t m_snapshotinterval;
+  uint32_t m_logrecords;
+  uint32_t m_logseq;
+  LocalSnapshotThread* m_snapshotthread;
+
+  SQueue m_completions;
+  std::vector<LocalCompletionThread*> m_threads;
+};
+
+#endif  // #define __LOCALDATAACCESS_H
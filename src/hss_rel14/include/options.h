@@ -62,6 +62,32 @@ class Options {
   static const unsigned& getcassioqueuesize() { return m_cassioqueuesize; }
   static const unsigned& getcassiothreads() { return m_cassiothreads; }
 
+  static const std::string& getstorage() { return m_storage; }
+  static const std::string& getlocaldir() { return m_localdir; }
+  static const unsigned& getlocalsnapshot() { return m_localsnapshot; }
+  static bool getlocalsync() { return m_localsync; }
+  static const unsigned& getlocalthreads() { return m_localthreads; }
+
+  static const unsigned& getsubdatacache() { return m_subdatacache; }
+  static bool getsubdatabin() { return m_subdatabin; }
+  static bool getsecbin() { return m_secbin; }
+
+  static const unsigned& getgroupcirconcurrent() {
+    return m_groupcirconcurrent;
+  }
+  static const unsigned& getgroupidrrate() { return m_groupidrrate; }
+  static const unsigned& getrirmaxitems() { return m_rirmaxitems; }
+  static const unsigned& getrirmaxbytes() { return m_rirmaxbytes; }
+  static const unsigned& getrirflushinterval() { return m_rirflushinterval; }
+  static const unsigned& getrestthreads() { return m_restthreads; }
+  static const unsigned& getrestmaxpayload() { return m_restmaxpayload; }
+  static const unsigned& getprovconcurrent() { return m_provconcurrent; }
+  static const unsigned& getimeichangebatch() { return m_imeichangebatch; }
+  static bool geteventindex() { return m_eventindex; }
+  static const unsigned& geteventindexrefresh() { return m_eventindexrefresh; }
+  static bool getpreload() { return m_preload; }
+  static const unsigned& getpreloadthreads() { return m_preloadthreads; }
+
   static bool getrandvector() { return m_randvector; }
   static bool getroamallow() { return m_roamallow; }
   static const std::string& getoptkey() { return m_optkey; }
@@ -145,6 +171,27 @@ class Options {
   static unsigned m_cassmaxconnections;
   static unsigned m_cassioqueuesize;
   static unsigned m_cassiothreads;
+  static std::string m_storage;
+  static std::string m_localdir;
+  static unsigned m_localsnapshot;
+  static bool m_localsync;
+  static unsigned m_localthreads;
+  static unsigned m_subdatacache;
+  static bool m_subdatabin;
+  static bool m_secbin;
+  static unsigned m_groupcirconcurrent;
+  static unsigned m_groupidrrate;
+  static unsigned m_rirmaxitems;
+  static unsigned m_rirmaxbytes;
+  static unsigned m_rirflushinterval;
+  static unsigned m_restthreads;
+  static unsigned m_restmaxpayload;
+  static unsigned m_provconcurrent;
+  static unsigned m_imeichangebatch;
+  static bool m_eventindex;
+  static unsigned m_eventindexrefresh;
+  static bool m_preload;
+  static unsigned m_preloadthreads;
   static bool m_randvector;
   static bool m_roamallow;
   static std::string m_optkey;
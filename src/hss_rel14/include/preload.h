@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __PRELOAD_H
+#define __PRELOAD_H
+
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dataaccess.h"
+#include "scassandra.h"
+#include "sthread.h"
+
+class Preloader;
+
+// the subscribers sharing a subscription_data block
+struct PreloadSubData {
+  PreloadSubData() : subscribers(0), attached(0) {}
+
+  uint64_t subscribers;
+  // the latest ms_ps_status write time of an attached subscriber, zero if
+  // none of them is attached
+  int64_t attached;
+};
+
+typedef std::unordered_map<std::string, PreloadSubData> PreloadSubDataMap;
+
+class PreloadWorker : public SThread {
+ public:
+  PreloadWorker(Preloader& preloader);
+  ~PreloadWorker();
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  PreloadWorker();
+
+  Preloader& m_preloader;
+};
+
+//
+// Warms the caches of a starting HSS.  The worker threads scan users_imsi
+// in token ranges, which reads the subscriber rows into the caches of the
+// Cassandra nodes, and collect the distinct subscription_data blocks.  The
+// blocks of the most recently attached subscribers, followed by the most
+// widely shared ones, are then compiled into the subscription data template
+// cache up to its capacity.  The callback is invoked once the preload is
+// complete, but not if it is stopped.
+//
+class Preloader : public SThread {
+  friend PreloadWorker;
+
+ public:
+  Preloader(
+      SCassandra& db, unsigned threads, size_t budget, bool subdata,
+      DAPreloadCallback cb, void* data);
+  ~Preloader();
+
+  void stop() { m_stop = true; }
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  Preloader();
+
+  bool nextRange(int64_t& first, int64_t& last, bool& inclusive);
+  bool scanRange(int64_t first, int64_t last, bool inclusive);
+  void merge(PreloadSubDataMap& page);
+  size_t loadTemplates();
+
+  SCassandra& m_db;
+  unsigned m_threads;
+  int m_ranges;
+  size_t m_budget;
+  bool m_subdata;
+  DAPreloadCallback m_cb;
+  void* m_data;
+
+  SMutex m_mutex;
+  PreloadSubDataMap m_subdatas;
+  size_t m_attachedblocks;
+  size_t m_otherblocks;
+
+  volatile bool m_stop;
+  volatile int m_nextrange;
+  volatile uint64_t m_scanned;
+  volatile uint64_t m_attachedsubs;
+  volatile uint64_t m_rangeerrors;
+};
+
+#endif  // #define __PRELOAD_H
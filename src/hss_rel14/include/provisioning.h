@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __PROVISIONING_H
+#define __PROVISIONING_H
+
+#include <stdint.h>
+#include <list>
+#include <string>
+#include <utility>
+
+#include "dataaccess.h"
+#include "ssync.h"
+
+class BulkProvisioning;
+
+// a change that has been issued to DataAccess and has not completed
+struct BulkProvisioningItem {
+  BulkProvisioningItem(BulkProvisioning& bulk, size_t line, bool del)
+      : bulk(bulk), line(line), del(del) {}
+
+  BulkProvisioning& bulk;
+  size_t line;
+  bool del;
+};
+
+//
+// Applies a bulk provisioning request received by RestHandler.  The body is
+// NDJSON, each line is a JSON object describing the change of a single
+// subscriber or MME identity.  The lines are parsed and issued as they are
+// read with at most Options::getprovconcurrent() subscriber changes
+// outstanding.  The methods return once every change has completed,
+// summary() then describes the result.
+//
+class BulkProvisioning {
+ public:
+  BulkProvisioning(DataAccess& dataaccess);
+  ~BulkProvisioning();
+
+  void subscribers(const std::string& body);
+  void mmes(const std::string& body);
+
+  size_t failed() { return m_failed; }
+  std::string summary();
+
+ private:
+  BulkProvisioning();
+
+  static void on_change_callback(CassFuture* future, void* data);
+
+  bool nextLine(const std::string& body, size_t& pos, std::string& line);
+  void subscriber(size_t line, const std::string& json);
+  void mme(size_t line, const std::string& json);
+  void issue(
+      BulkProvisioningItem* item, DAImsiInfo& info, DAImsiSec& sec,
+      uint32_t present_flags);
+  void complete(size_t line, bool ok, const char* error);
+  void drain();
+
+  DataAccess& m_dataaccess;
+  unsigned m_concurrent;
+  SSemaphore m_window;
+  SMutex m_mutex;
+  size_t m_lines;
+  size_t m_succeeded;
+  size_t m_failed;
+  std::list<std::pair<size_t, std::string>> m_errors;
+};
+
+#endif  // #define __PROVISIONING_H
@@ -20,6 +20,8 @@
 #include "s6as6d.h"
 #include "fdhss.h"
 #include "worker.h"
+#include "timer.h"
+#include "satomic.h"
 
 extern "C" {
 #include "hss_config.h"
@@ -67,14 +69,24 @@ class Application : public ApplicationBase {
   bool sendAUIRreq(FDPeer& peer);
   int sendINSDRreq(
       s6t::MonitoringEventConfigurationExtractorList& cir_monevtcfg,
-      std::string& imsi, FDMessageRequest* cir_req, EvenStatusMap* evt_map,
-      RIRBuilder* rir_builder);
+      const SubscriberKey& imsi, FDMessageRequest* cir_req,
+      EvenStatusMap* evt_map, RIRBuilder* rir_builder);
+  // sends the INSDR Request of a group configuration member whose subscriber
+  // information has already been retrieved
+  bool sendINSDRreq(
+      const std::string& monevtcfg, const SubscriberKey& imsi,
+      DAImsiInfo& imsi_info, RIRBuilder* rir_builder);
   bool sendDESDRreq(FDPeer& peer);
   bool sendPUURreq(FDPeer& peer);
   bool sendRERreq(FDPeer& peer);
 
   DataAccess& dataaccess() { return m_dbobj; }
 
+  // adds the subscriber's Subscription-Data to msg, from the pre-encoded
+  // column when it is populated, otherwise from the JSON subscription data
+  int addSubscriptionData(
+      DAImsiInfo& info, msg_or_avp* msg, void (*errfunc)(const char*));
+
  private:
   void registerHandlers();
   UPLRcmd m_cmd_uplr;
@@ -92,8 +104,14 @@ class Application : public ApplicationBase {
   AUIRreq* createAUIRreq(FDPeer& peer);
   INSDRreq* createINSDRreq(
       s6t::MonitoringEventConfigurationExtractorList& cir_monevtcfg,
-      std::string& imsi, FDMessageRequest* cir_req, EvenStatusMap* evt_map,
+      const SubscriberKey& imsi, FDMessageRequest* cir_req,
+      EvenStatusMap* evt_map, DAImsiInfo& imsi_info, RIRBuilder* rir_builder);
+  INSDRreq* createINSDRreq(
+      const std::string& monevtcfg, const SubscriberKey& imsi,
       DAImsiInfo& imsi_info, RIRBuilder* rir_builder);
+  INSDRreq* createIDRRreq(
+      const SubscriberKey& imsi, FDMessageRequest* cir_req,
+      EvenStatusMap* evt_map, DAImsiInfo& imsi_info, RIRBuilder* rir_builder);
   DESDRreq* createDESDRreq(FDPeer& peer);
   PUURreq* createPUURreq(FDPeer& peer);
   RERreq* createRERreq(FDPeer& peer);
@@ -105,7 +123,8 @@ class IDRRreq : public INSDRreq {
  public:
   IDRRreq(
       Application& app, FDMessageRequest* cir_req, EvenStatusMap* evt_map,
-      RIRBuilder* rirbuilder, std::string& imsi, std::string& msisdn);
+      RIRBuilder* rirbuilder, const SubscriberKey& imsi,
+      const SubscriberKey& msisdn);
 
   void processAnswer(FDMessageAnswer& ans);
 
@@ -113,8 +132,8 @@ class IDRRreq : public INSDRreq {
   FDMessageRequest* cir_req;
   EvenStatusMap* evt_map;
   RIRBuilder* m_rirbuilder;
-  std::string m_imsi;
-  std::string m_msisdn;
+  SubscriberKey m_imsi;
+  SubscriberKey m_msisdn;
 };
 
 }  // namespace s6as6d
@@ -142,6 +161,50 @@ class IDRRreq : public INSDRreq {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+#ifdef PHASE_TIMING
+// per phase thread CPU time, the slot index is the phase offset from the
+// state base (0 is the final phase), the last slot accumulates the time
+// spent in the database callbacks
+#define PHASE_TIMING_SLOTS 8
+#define PHASE_TIMING_CALLBACK (PHASE_TIMING_SLOTS - 1)
+
+struct PhaseTiming {
+  PhaseTiming() { reset(); }
+
+  void reset() {
+    for (int i = 0; i < PHASE_TIMING_SLOTS; i++) {
+      calls[i]  = 0;
+      cpu_ns[i] = 0;
+    }
+  }
+
+  volatile uint64_t calls[PHASE_TIMING_SLOTS];
+  volatile uint64_t cpu_ns[PHASE_TIMING_SLOTS];
+};
+
+extern PhaseTiming ulrPhaseTiming;
+extern PhaseTiming airPhaseTiming;
+
+#define PHASE_TIMING_START(_start, _slot)                                      \
+  stimer_t _start   = STIMER_GET_THREAD_CPU_TIME;                              \
+  int _start##_slot = (_slot);
+
+#define PHASE_TIMING_STOP(_timing, _start)                                     \
+  {                                                                            \
+    if (_start##_slot >= 0 && _start##_slot < PHASE_TIMING_SLOTS) {            \
+      atomic_inc_fetch(_timing.calls[_start##_slot]);                          \
+      atomic_add_fetch(                                                        \
+          _timing.cpu_ns[_start##_slot], STIMER_GET_THREAD_CPU_TIME - _start); \
+    }                                                                          \
+  }
+#else
+#define PHASE_TIMING_START(_start, _slot)
+#define PHASE_TIMING_STOP(_timing, _start)
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 class DatabaseAction {
  public:
   DatabaseAction(uint32_t action) : m_action(action) {}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SUBSCRIBERKEY_H
+#define __SUBSCRIBERKEY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <functional>
+#include <string>
+
+//
+// An IMSI or MSISDN packed in 64 bits, the decimal value in the low 60 bits
+// and the number of digits in the high 4 bits so that leading zeros survive
+// the conversion back to text.  The text is validated once when the key is
+// built, a key built from anything other than 1 to 15 digits is invalid and
+// never equal to a valid key.
+//
+class SubscriberKey {
+ public:
+  enum { MaxDigits = 15 };
+
+  SubscriberKey() : m_key(0) {}
+  explicit SubscriberKey(const char* s) : m_key(pack(s, strlen(s))) {}
+  explicit SubscriberKey(const std::string& s)
+      : m_key(pack(s.data(), s.size())) {}
+  SubscriberKey(const char* s, size_t len) : m_key(pack(s, len)) {}
+
+  // a value without leading zeros, such as an int64_t MSISDN column
+  static SubscriberKey fromValue(uint64_t value);
+
+  bool valid() const { return m_key != 0; }
+  uint64_t value() const { return m_key & VALUE_MASK; }
+  size_t digits() const { return (size_t)(m_key >> DIGITS_SHIFT); }
+  uint64_t packed() const { return m_key; }
+
+  std::string str() const;
+  // dstlen is the size of dst including the NUL terminator, returns the
+  // number of digits written or zero if dst is too small
+  size_t str(char* dst, size_t dstlen) const;
+
+  bool operator==(const SubscriberKey& k) const { return m_key == k.m_key; }
+  bool operator!=(const SubscriberKey& k) const { return m_key != k.m_key; }
+  bool operator<(const SubscriberKey& k) const { return m_key < k.m_key; }
+
+ private:
+  static const int DIGITS_SHIFT    = 60;
+  static const uint64_t VALUE_MASK = (1ULL << DIGITS_SHIFT) - 1;
+
+  static uint64_t pack(const char* s, size_t len);
+
+  uint64_t m_key;
+};
+
+namespace std {
+template <>
+struct hash<SubscriberKey> {
+  // the low bits of consecutive IMSIs differ very little, mix them so the
+  // keys spread across the buckets
+  size_t operator()(const SubscriberKey& k) const {
+    uint64_t h = k.packed() * 0x9e3779b97f4a7c15ULL;
+    return (size_t)(h ^ (h >> 32));
+  }
+};
+}  // namespace std
+
+#endif  // #define __SUBSCRIBERKEY_H
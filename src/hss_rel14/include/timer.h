@@ -66,4 +66,15 @@ typedef long long int stimer_t;
     __now__;                                                                   \
   })
 
+#define STIMER_GET_THREAD_CPU_TIME                                             \
+  ({                                                                           \
+    struct timespec __ts__;                                                    \
+    stimer_t __now__;                                                          \
+    __now__ = clock_gettime(CLOCK_THREAD_CPUTIME_ID, &__ts__) ?                \
+                  -1 :                                                         \
+                  (((stimer_t) __ts__.tv_sec) * 1000000000) +                  \
+                      ((stimer_t) __ts__.tv_nsec);                             \
+    __now__;                                                                   \
+  })
+
 #endif
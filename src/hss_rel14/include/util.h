@@ -68,6 +68,7 @@ class Utility {
  public:
   static std::string bytes2hex(
       const uint8_t* bytes, size_t len, char delim = '\0', bool upper = false);
+  static bool hex2bytes(const std::string& hex, uint8_t* bytes, size_t len);
 };
 
 #endif /* C3PO_HSS_INCLUDE_UTIL_H_ */
@@ -23,10 +23,14 @@
 #include "squeue.h"
 #include "sthread.h"
 #include "scassandra.h"
+#include "satomic.h"
+#include "timer.h"
 
 #define WORKER_SHUTDOWN 99
 #define WORKER_EVENT 100
 
+#define QUEUE_MAX_TYPES 4
+
 class WorkerMessage;
 
 class WorkerManager {
@@ -44,11 +48,15 @@ class WorkerManager {
 
   void threadShutdown();
 
+  int queueLength() { return m_queued; }
+  int numWorkers() { return m_numWorkers; }
+
  private:
   SMutex m_mutex;
   SEvent m_shutdown;
   SQueue m_queue;
   int m_numWorkers;
+  int m_queued;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -98,21 +106,64 @@ class WorkerThread : public SThread {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+struct QueueGauges {
+  int pending;
+  int active;
+  int concurrent;
+  long oldest_pending_ms;
+  int pending_by_type[QUEUE_MAX_TYPES];
+  int active_by_type[QUEUE_MAX_TYPES];
+};
+
 class QueueManager {
  public:
-  QueueManager() : m_concurrent(10), m_active(0), m_pending(0) {}
+  QueueManager() : m_concurrent(10), m_active(0), m_pending(0) {
+    for (int i = 0; i < QUEUE_MAX_TYPES; i++) {
+      m_pendingbytype[i] = 0;
+      m_activebytype[i]  = 0;
+    }
+  }
 
   ~QueueManager() {}
 
-  int setConcurrent(int concurrent) { return m_concurrent = concurrent; }
+  int setConcurrent(int concurrent) {
+    SMutexLock l(m_mutex);
+    return m_concurrent = concurrent;
+  }
 
-  size_t queueDepth() { return m_queue.size(); }
+  size_t queueDepth() {
+    SMutexLock l(m_mutex);
+    return m_queue.size();
+  }
+
+  void getGauges(QueueGauges& g) {
+    SMutexLock l(m_mutex);
+
+    g.pending           = m_pending;
+    g.active            = m_active;
+    g.concurrent        = m_concurrent;
+    g.oldest_pending_ms = 0;
+    if (!m_queue.empty()) {
+      stimer_t ns = STIMER_GET_ELAPSED_NS(m_queue.front().queued);
+      if (ns > 0) g.oldest_pending_ms = (long) (ns / 1000000);
+    }
+    for (int i = 0; i < QUEUE_MAX_TYPES; i++) {
+      g.pending_by_type[i] = m_pendingbytype[i];
+      g.active_by_type[i]  = m_activebytype[i];
+    }
+  }
 
  protected:
-  void addEntry(void* data) {
+  void addEntry(void* data, int type = 0) {
+    QueueEntry e;
+    e.data = data;
+    e.type = type >= 0 && type < QUEUE_MAX_TYPES ? type : 0;
+    STIMER_GET_CURRENT_TP(e.queued);
+
     SMutexLock l(m_mutex);
-    m_queue.push(data);
+    m_queue.push(e);
     m_pending++;
+    m_pendingbytype[e.type]++;
   }
 
   void* startMessage() {
@@ -120,7 +171,10 @@ class QueueManager {
 
     SMutexLock l(m_mutex);
     if (m_active < m_concurrent && m_pending > 0) {
-      data = m_queue.front();
+      QueueEntry& e = m_queue.front();
+      data          = e.data;
+      m_pendingbytype[e.type]--;
+      m_activebytype[e.type]++;
       m_queue.pop();
       m_pending--;
       m_active++;
@@ -129,25 +183,39 @@ class QueueManager {
     return data;
   }
 
-  void finishMessage() {
+  void finishMessage(int type = 0) {
     SMutexLock l(m_mutex);
     m_active--;
+    m_activebytype[type >= 0 && type < QUEUE_MAX_TYPES ? type : 0]--;
   }
 
  private:
+  struct QueueEntry {
+    void* data;
+    int type;
+    stimer_t queued;
+  };
+
   SMutex m_mutex;
-  std::queue<void*> m_queue;
+  std::queue<QueueEntry> m_queue;
   int m_concurrent;
   int m_active;
   int m_pending;
+  int m_pendingbytype[QUEUE_MAX_TYPES];
+  int m_activebytype[QUEUE_MAX_TYPES];
 };
 
 class QueueProcessor {
  public:
-  QueueProcessor() {}
+  QueueProcessor(int type = 0) : m_queuetype(type) {}
   ~QueueProcessor() {}
 
   virtual void triggerNextPhase() = 0;
+
+  int getQueueType() { return m_queuetype; }
+
+ private:
+  int m_queuetype;
 };
 
 #endif
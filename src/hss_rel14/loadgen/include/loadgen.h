@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOADGEN_H
+#define __LOADGEN_H
+
+#include <stdint.h>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "fd.h"
+#include "satomic.h"
+#include "ssync.h"
+#include "sthread.h"
+#include "timer.h"
+
+#include "options.h"
+#include "s6as6d_impl.h"
+#include "s6c_impl.h"
+#include "s6t_impl.h"
+
+// number of linear sub-buckets per power of two, this bounds the relative
+// error of a recorded latency to 1/32 (~3%)
+#define LATENCY_SUB_BITS 5
+#define LATENCY_SUB_COUNT (1 << LATENCY_SUB_BITS)
+#define LATENCY_BUCKETS ((32 - LATENCY_SUB_BITS) * LATENCY_SUB_COUNT)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Log-linear histogram of latencies in microseconds.  Recording is lock free
+// so it can be performed directly from the freeDiameter answer callbacks.
+//
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  void record(uint64_t us);
+
+  uint64_t count() { return m_count; }
+  uint64_t min() { return m_count ? m_min : 0; }
+  uint64_t max() { return m_max; }
+  double mean() { return m_count ? (double) m_sum / m_count : 0.0; }
+  uint64_t percentile(double pct);
+
+ private:
+  static int bucket(uint64_t us);
+  static uint64_t bucketValue(int idx);
+
+  volatile uint64_t m_buckets[LATENCY_BUCKETS];
+  volatile uint64_t m_count;
+  volatile uint64_t m_sum;
+  volatile uint64_t m_min;
+  volatile uint64_t m_max;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct ProcedureStats {
+  ProcedureStats()
+      : sent(0), sendfailed(0), answered(0), success(0), expired(0) {}
+
+  volatile uint64_t sent;
+  volatile uint64_t sendfailed;
+  volatile uint64_t answered;
+  volatile uint64_t success;
+  volatile uint64_t expired;
+  LatencyHistogram latency;
+
+  // answer counts keyed by (vendor id << 32 | result code), a vendor id of
+  // zero identifies a Result-Code
+  SMutex mutex;
+  std::map<uint64_t, uint64_t> results;
+};
+
+// a request that has been created and not answered
+struct PendingRequest {
+  LoadProcedure lp;
+  stimer_t created;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Extracts only the Result-Code and Experimental-Result from an answer, the
+// full answer extractors resolve every AVP which is wasted work here.
+//
+template <class D>
+class ResultExtractor : public FDExtractor {
+ public:
+  ResultExtractor(FDMessage& msg, D& dict)
+      : FDExtractor(msg),
+        result_code(*this, dict.avpResultCode()),
+        experimental_result(*this, dict.avpExperimentalResult()),
+        vendor_id(experimental_result, dict.avpVendorId()),
+        experimental_result_code(
+            experimental_result, dict.avpExperimentalResultCode()) {
+    experimental_result.add(vendor_id);
+    experimental_result.add(experimental_result_code);
+    add(result_code);
+    add(experimental_result);
+  }
+
+  FDExtractorAvp result_code;
+  FDExtractor experimental_result;
+  FDExtractorAvp vendor_id;
+  FDExtractorAvp experimental_result_code;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Open loop load generator.  Requests are scheduled at a fixed interval
+// derived from the configured rate, independent of how quickly the HSS
+// answers, and latency is measured from the scheduled send time so that a
+// stalled HSS is not hidden by the generator falling behind (coordinated
+// omission).
+//
+class LoadGenerator : public SThread {
+ public:
+  LoadGenerator();
+  ~LoadGenerator();
+
+  using SThread::init;
+
+  bool init();
+  void uninit();
+
+  void stop() { m_stop = true; }
+
+  void report(std::ostream& os);
+
+  // a request that is not answered within ANSWER_TIMEOUT_MS is expired, so
+  // it no longer counts against maxoutstanding, and a later answer is
+  // ignored.  untrack() returns false once the request has expired.
+  uint64_t track(LoadProcedure lp);
+  bool untrack(uint64_t id);
+
+  void recordSendFailure(LoadProcedure lp);
+  void recordAnswer(
+      LoadProcedure lp, stimer_t scheduled, uint32_t vendor, uint32_t code);
+
+  template <class D>
+  void recordAnswer(
+      LoadProcedure lp, stimer_t scheduled, FDMessageAnswer& ans, D& dict) {
+    ResultExtractor<D> re(ans, dict);
+    uint32_t vendor = 0;
+    uint32_t code   = 0;
+
+    if (!re.result_code.get(code)) {
+      re.vendor_id.get(vendor);
+      re.experimental_result_code.get(code);
+    }
+
+    recordAnswer(lp, scheduled, vendor, code);
+  }
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  LoadProcedure selectProcedure(uint64_t seq);
+  bool sendRequest(LoadProcedure lp, uint64_t seq, stimer_t scheduled);
+  void progress(stimer_t now);
+  void expire();
+
+  FDEngine m_diameter;
+  s6as6d::Application* m_s6as6d;
+  s6t::Application* m_s6t;
+  s6c::Application* m_s6c;
+
+  volatile bool m_stop;
+  volatile int64_t m_outstanding;
+  uint64_t m_skipped;
+
+  SMutex m_pendingmutex;
+  std::map<uint64_t, PendingRequest> m_pending;
+  uint64_t m_nextid;
+
+  int m_mix[lpMAX];
+  int m_mixtotal;
+
+  stimer_t m_started;
+  stimer_t m_finished;
+  uint64_t m_lastanswered;
+  stimer_t m_lastprogress;
+
+  ProcedureStats m_stats[lpMAX];
+};
+
+extern LoadGenerator loadgen;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Wraps a generated request class so the answer is timed against the
+// scheduled send time and accounted to the originating procedure.
+//
+template <class REQ, class APP, LoadProcedure LP>
+class LoadRequest : public REQ {
+ public:
+  LoadRequest(APP& app, stimer_t scheduled)
+      : REQ(app), m_scheduled(scheduled), m_id(loadgen.track(LP)) {}
+  ~LoadRequest() { loadgen.untrack(m_id); }
+
+  void processAnswer(FDMessageAnswer& ans) {
+    if (loadgen.untrack(m_id))
+      loadgen.recordAnswer(
+          LP, m_scheduled, ans, REQ::getApplication().getDict());
+  }
+
+ private:
+  stimer_t m_scheduled;
+  uint64_t m_id;
+};
+
+#endif  // #define __LOADGEN_H
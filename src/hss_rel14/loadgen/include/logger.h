@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LOGGER_H
+#define __LOGGER_H
+
+#include <cstdarg>
+#include <stdexcept>
+#include <vector>
+
+#include "slogger.h"
+
+//#define SPDLOG_LEVEL_NAMES { "trace", "debug", "info",  "warning", "error",
+//"critical", "off" };
+#define SPDLOG_LEVEL_NAMES                                                     \
+  {"trace", "debug", "info", "startup", "warn", "error", "off"};
+
+#define SPDLOG_ENABLE_SYSLOG
+#include "spdlog/spdlog.h"
+
+class Logger {
+ public:
+  static void init(const char* app) { singleton()._init(app); }
+  static void init(const std::string& app) { init(app.c_str()); }
+  static void cleanup() { singleton()._cleanup(); }
+  static void flush() { singleton()._flush(); }
+
+  static SLogger& system() { return *singleton().m_system; }
+  static SLogger& s6as6d() { return *singleton().m_s6as6d; }
+  static SLogger& s6c() { return *singleton().m_s6c; }
+  static SLogger& s6t() { return *singleton().m_s6t; }
+
+ private:
+  static Logger* m_singleton;
+  static Logger& singleton() {
+    if (!m_singleton) m_singleton = new Logger();
+    return *m_singleton;
+  }
+
+  Logger() {}
+  ~Logger() {}
+
+  void _init(const char* app);
+  void _cleanup();
+  void _flush();
+
+  std::vector<spdlog::sink_ptr> m_sinks;
+
+  SLogger* m_system;
+  SLogger* m_s6as6d;
+  SLogger* m_s6c;
+  SLogger* m_s6t;
+};
+
+#endif  // __LOGGER_H
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __OPTIONS_H
+#define __OPTIONS_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+enum LoadProcedure { lpAIR, lpULR, lpPUR, lpCIR, lpSRR, lpMAX };
+
+class Options {
+ public:
+  static bool parse(int argc, char** argv);
+
+  static const std::string& originHost() { return singleton().m_originhost; }
+  static const std::string& originRealm() { return singleton().m_originrealm; }
+  static const std::string& diameterConfiguration() {
+    return singleton().m_fdcfg;
+  }
+  static const std::string& hssRealm() { return singleton().m_hssrealm; }
+  static const std::vector<std::string>& hssPeers() {
+    return singleton().m_hsspeers;
+  }
+
+  static const int rate() { return singleton().m_rate; }
+  static const int duration() { return singleton().m_duration; }
+  static const int maxOutstanding() { return singleton().m_maxoutstanding; }
+  static const uint64_t imsiFirst() { return singleton().m_imsifirst; }
+  static const uint32_t imsiCount() { return singleton().m_imsicount; }
+  static const int imsiLength() { return singleton().m_imsilength; }
+  static const uint64_t msisdnFirst() { return singleton().m_msisdnfirst; }
+  static const int msisdnLength() { return singleton().m_msisdnlength; }
+  static const std::string& visitedPlmn() { return singleton().m_visitedplmn; }
+  static const int vectors() { return singleton().m_vectors; }
+  static const std::string& scefId() { return singleton().m_scefid; }
+  static const std::string& scefRealm() { return singleton().m_scefrealm; }
+  static const uint32_t scefRefId() { return singleton().m_scefrefid; }
+  static const int mix(LoadProcedure lp) { return singleton().m_mix[lp]; }
+  static const std::string& reportFilename() { return singleton().m_report; }
+
+  static const int logMaxSize() { return singleton().m_logmaxsize; }
+  static const int logNumberFiles() { return singleton().m_lognbrfiles; }
+  static const std::string& logFilename() { return singleton().m_logfilename; }
+  static const int logQueueSize() { return singleton().m_logqueuesize; }
+
+  static const char* procedureName(LoadProcedure lp);
+
+ private:
+  enum OptionsSelected {
+    opt_jsoncfg        = 0x00000001,
+    opt_originhost     = 0x00000002,
+    opt_originrealm    = 0x00000004,
+    opt_fdcfg          = 0x00000008,
+    opt_hsspeers       = 0x00000010,
+    opt_hssrealm       = 0x00000020,
+    opt_logmaxsize     = 0x00000040,
+    opt_lognbrfiles    = 0x00000080,
+    opt_logfilename    = 0x00000100,
+    opt_logqueuesize   = 0x00000200,
+    opt_rate           = 0x00000400,
+    opt_duration       = 0x00000800,
+    opt_maxoutstanding = 0x00001000,
+    opt_imsifirst      = 0x00002000,
+    opt_imsicount      = 0x00004000,
+    opt_msisdnfirst    = 0x00008000,
+    opt_visitedplmn    = 0x00010000,
+    opt_vectors        = 0x00020000,
+    opt_scefid         = 0x00040000,
+    opt_scefrealm      = 0x00080000,
+    opt_mix            = 0x00100000,
+    opt_report         = 0x00200000,
+    opt_scefrefid      = 0x00400000
+  };
+
+  static Options* m_singleton;
+  static Options& singleton() {
+    if (!m_singleton) m_singleton = new Options();
+    return *m_singleton;
+  }
+  static void help();
+
+  Options();
+  ~Options();
+
+  bool parseInputOptions(int argc, char** argv);
+  bool parseJson();
+  bool parseMix(const std::string& mix);
+  bool validateOptions();
+
+  int m_options;
+
+  std::string m_jsoncfg;
+  std::string m_originhost;
+  std::string m_originrealm;
+  std::string m_fdcfg;
+  std::string m_hssrealm;
+  std::vector<std::string> m_hsspeers;
+
+  int m_rate;
+  int m_duration;
+  int m_maxoutstanding;
+  uint64_t m_imsifirst;
+  uint32_t m_imsicount;
+  int m_imsilength;
+  uint64_t m_msisdnfirst;
+  int m_msisdnlength;
+  std::string m_visitedplmn;
+  int m_vectors;
+  std::string m_scefid;
+  std::string m_scefrealm;
+  uint32_t m_scefrefid;
+  int m_mix[lpMAX];
+  std::string m_report;
+
+  int m_logmaxsize;
+  int m_lognbrfiles;
+  std::string m_logfilename;
+  int m_logqueuesize;
+};
+
+#endif  // #define __OPTIONS_H
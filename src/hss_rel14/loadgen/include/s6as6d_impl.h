@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __S6AS6D_IMPL_H
+#define __S6AS6D_IMPL_H
+
+#include <string>
+
+#include "s6as6d.h"
+#include "timer.h"
+
+namespace s6as6d {
+
+// Client side of the S6a/S6d interface, the load generator only originates
+// AIR, ULR and PUR requests and does not register any command handlers.
+class Application : public ApplicationBase {
+ public:
+  Application();
+  ~Application();
+
+  bool sendAUIRreq(
+      const std::string& imsi, const std::string& peer, stimer_t scheduled);
+  bool sendUPLRreq(
+      const std::string& imsi, const std::string& peer, stimer_t scheduled);
+  bool sendPUURreq(
+      const std::string& imsi, const std::string& peer, stimer_t scheduled);
+
+ private:
+  bool send(FDMessageRequest* req);
+  void addCommon(
+      FDMessageRequest* req, const std::string& session,
+      const std::string& imsi, const std::string& peer);
+
+  uint8_t m_visitedplmn[3];
+};
+
+}  // namespace s6as6d
+
+#endif  // __S6AS6D_IMPL_H
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __S6C_IMPL_H
+#define __S6C_IMPL_H
+
+#include <string>
+
+#include "s6c.h"
+#include "timer.h"
+
+namespace s6c {
+
+// Client side of the S6c interface, the load generator originates SRR
+// requests identified by both the MSISDN and the IMSI.
+class Application : public ApplicationBase {
+ public:
+  Application();
+  ~Application();
+
+  bool sendSERIFSRreq(
+      const std::string& msisdn, const std::string& imsi,
+      const std::string& peer, stimer_t scheduled);
+};
+
+}  // namespace s6c
+
+#endif  // __S6C_IMPL_H
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __S6T_IMPL_H
+#define __S6T_IMPL_H
+
+#include <string>
+
+#include "s6t.h"
+#include "timer.h"
+
+namespace s6t {
+
+// Client side of the S6t interface, the load generator originates CIR
+// requests that configure a single report monitoring event.
+class Application : public ApplicationBase {
+ public:
+  Application();
+  ~Application();
+
+  bool sendCOIRreq(
+      const std::string& msisdn, const std::string& peer, stimer_t scheduled);
+
+ private:
+  volatile uint32_t m_scefrefid;
+};
+
+}  // namespace s6t
+
+#endif  // __S6T_IMPL_H
@@ -0,0 +1,434 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "loadgen.h"
+#include "logger.h"
+
+#define NS_PER_SEC 1000000000LL
+#define NS_PER_US 1000LL
+
+// how long to wait for the outstanding answers once the run has completed
+#define DRAIN_TIMEOUT_MS 5000
+
+// how long a request may remain unanswered before it is expired
+#define ANSWER_TIMEOUT_MS 4000
+
+#define ER_DIAMETER_SUCCESS 2001
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+LatencyHistogram::LatencyHistogram()
+    : m_count(0), m_sum(0), m_min(UINT64_MAX), m_max(0) {
+  memset((void*) m_buckets, 0, sizeof(m_buckets));
+}
+
+int LatencyHistogram::bucket(uint64_t us) {
+  if (us < (LATENCY_SUB_COUNT << 1)) return (int) us;
+
+  int msb   = 63 - __builtin_clzll(us);
+  int shift = msb - LATENCY_SUB_BITS;
+  int idx   = ((shift + 1) << LATENCY_SUB_BITS) +
+            (int) ((us >> shift) & (LATENCY_SUB_COUNT - 1));
+
+  return idx < LATENCY_BUCKETS ? idx : LATENCY_BUCKETS - 1;
+}
+
+uint64_t LatencyHistogram::bucketValue(int idx) {
+  if (idx < (LATENCY_SUB_COUNT << 1)) return (uint64_t) idx;
+
+  int shift = (idx >> LATENCY_SUB_BITS) - 1;
+  uint64_t sub = idx & (LATENCY_SUB_COUNT - 1);
+
+  // report the upper bound of the bucket so percentiles are never optimistic
+  return ((LATENCY_SUB_COUNT + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t us) {
+  atomic_inc_fetch(m_buckets[bucket(us)]);
+  atomic_inc_fetch(m_count);
+  atomic_add_fetch(m_sum, us);
+
+  uint64_t cur = m_min;
+  while (us < cur) {
+    uint64_t prev = atomic_cas(m_min, cur, us);
+    if (prev == cur) break;
+    cur = prev;
+  }
+
+  cur = m_max;
+  while (us > cur) {
+    uint64_t prev = atomic_cas(m_max, cur, us);
+    if (prev == cur) break;
+    cur = prev;
+  }
+}
+
+uint64_t LatencyHistogram::percentile(double pct) {
+  uint64_t total = m_count;
+  if (total == 0) return 0;
+
+  uint64_t target = (uint64_t)((pct / 100.0) * total + 0.5);
+  if (target == 0) target = 1;
+
+  uint64_t seen = 0;
+  for (int idx = 0; idx < LATENCY_BUCKETS; idx++) {
+    seen += m_buckets[idx];
+    if (seen >= target) {
+      uint64_t val = bucketValue(idx);
+      return val < m_max ? val : m_max;
+    }
+  }
+
+  return m_max;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+LoadGenerator::LoadGenerator()
+    : m_s6as6d(NULL),
+      m_s6t(NULL),
+      m_s6c(NULL),
+      m_stop(false),
+      m_outstanding(0),
+      m_skipped(0),
+      m_nextid(0),
+      m_mixtotal(0),
+      m_started(0),
+      m_finished(0),
+      m_lastanswered(0),
+      m_lastprogress(0) {
+  memset(m_mix, 0, sizeof(m_mix));
+}
+
+LoadGenerator::~LoadGenerator() {}
+
+bool LoadGenerator::init() {
+  // set the diameter configuration file
+  m_diameter.setConfigFile(Options::diameterConfiguration());
+
+  // initialize diameter
+  if (!m_diameter.init()) return false;
+
+  try {
+    m_s6as6d = new s6as6d::Application();
+    m_s6t    = new s6t::Application();
+    m_s6c    = new s6c::Application();
+
+    FDDictionaryEntryVendor vnd3gpp(m_s6t->getDict().app());
+    m_diameter.advertiseSupport(m_s6as6d->getDict().app(), vnd3gpp, 1, 0);
+    m_diameter.advertiseSupport(m_s6t->getDict().app(), vnd3gpp, 1, 0);
+    m_diameter.advertiseSupport(m_s6c->getDict().app(), vnd3gpp, 1, 0);
+    Logger::system().startup(
+        "LoadGenerator::%s - interfaces initialized", __func__);
+  } catch (FDException& e) {
+    Logger::system().error(
+        "LoadGenerator::%s - FDException initializing interfaces - %s",
+        __func__, e.what());
+    return false;
+  }
+
+  m_mixtotal = 0;
+  for (int lp = lpAIR; lp < lpMAX; lp++) {
+    m_mixtotal += Options::mix((LoadProcedure) lp);
+    m_mix[lp] = m_mixtotal;
+  }
+
+  return m_diameter.start();
+}
+
+void LoadGenerator::uninit() {
+  m_diameter.uninit();
+
+  if (m_s6as6d) delete m_s6as6d;
+  if (m_s6t) delete m_s6t;
+  if (m_s6c) delete m_s6c;
+  m_s6as6d = NULL;
+  m_s6t    = NULL;
+  m_s6c    = NULL;
+}
+
+LoadProcedure LoadGenerator::selectProcedure(uint64_t seq) {
+  // a multiplicative hash of the sequence spreads the procedures evenly
+  // across the run while remaining reproducible
+  uint64_t h = (seq * 0x9E3779B97F4A7C15ULL) >> 32;
+  int pick   = (int) (h % m_mixtotal);
+
+  for (int lp = lpAIR; lp < lpMAX; lp++)
+    if (pick < m_mix[lp]) return (LoadProcedure) lp;
+
+  return lpAIR;
+}
+
+bool LoadGenerator::sendRequest(
+    LoadProcedure lp, uint64_t seq, stimer_t scheduled) {
+  const std::vector<std::string>& peers = Options::hssPeers();
+  const std::string& peer               = peers[seq % peers.size()];
+  uint64_t offset                       = seq % Options::imsiCount();
+  char imsi[32];
+  char msisdn[32];
+
+  snprintf(
+      imsi, sizeof(imsi), "%0*llu", Options::imsiLength(),
+      (unsigned long long) (Options::imsiFirst() + offset));
+
+  switch (lp) {
+    case lpAIR:
+      return m_s6as6d->sendAUIRreq(imsi, peer, scheduled);
+    case lpULR:
+      return m_s6as6d->sendUPLRreq(imsi, peer, scheduled);
+    case lpPUR:
+      return m_s6as6d->sendPUURreq(imsi, peer, scheduled);
+    case lpCIR:
+    case lpSRR: {
+      snprintf(
+          msisdn, sizeof(msisdn), "%0*llu", Options::msisdnLength(),
+          (unsigned long long) (Options::msisdnFirst() + offset));
+      if (lp == lpCIR) return m_s6t->sendCOIRreq(msisdn, peer, scheduled);
+      return m_s6c->sendSERIFSRreq(msisdn, imsi, peer, scheduled);
+    }
+    default:
+      break;
+  }
+
+  return false;
+}
+
+unsigned long LoadGenerator::threadProc(void* arg) {
+  uint64_t total = (uint64_t) Options::rate() * Options::duration();
+  double interval = (double) NS_PER_SEC / Options::rate();
+
+  Logger::system().startup(
+      "LoadGenerator::%s - starting rate=%d duration=%d peers=%u imsis=%u",
+      __func__, Options::rate(), Options::duration(),
+      (unsigned int) Options::hssPeers().size(), Options::imsiCount());
+
+  m_started      = STIMER_GET_CURRENT_TIME;
+  m_lastprogress = m_started;
+
+  for (uint64_t seq = 0; seq < total && !m_stop; seq++) {
+    stimer_t due = m_started + (stimer_t)(seq * interval);
+    stimer_t now = STIMER_GET_CURRENT_TIME;
+
+    if (due > now) {
+      struct timespec ts;
+      ts.tv_sec  = due / NS_PER_SEC;
+      ts.tv_nsec = due % NS_PER_SEC;
+      while (clock_nanosleep(CLOCK_REALTIME, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        if (m_stop) break;
+      now = due;
+    }
+
+    if (now - m_lastprogress >= NS_PER_SEC) progress(now);
+
+    // never exceed the configured number of unanswered requests, a skipped
+    // request is reported rather than delayed so the schedule is kept
+    if (m_outstanding >= Options::maxOutstanding()) {
+      m_skipped++;
+      continue;
+    }
+
+    LoadProcedure lp = selectProcedure(seq);
+
+    atomic_inc_fetch(m_outstanding);
+    atomic_inc_fetch(m_stats[lp].sent);
+
+    if (!sendRequest(lp, seq, due)) recordSendFailure(lp);
+  }
+
+  Logger::system().startup(
+      "LoadGenerator::%s - schedule complete, waiting for %lld answers",
+      __func__, (long long) m_outstanding);
+
+  m_finished = STIMER_GET_CURRENT_TIME;
+
+  for (int ms = 0; m_outstanding > 0 && ms < DRAIN_TIMEOUT_MS && !m_stop;
+       ms += 10) {
+    sleep(10);
+    expire();
+  }
+
+  return 0;
+}
+
+void LoadGenerator::progress(stimer_t now) {
+  uint64_t sent     = 0;
+  uint64_t answered = 0;
+
+  expire();
+
+  for (int lp = lpAIR; lp < lpMAX; lp++) {
+    sent += m_stats[lp].sent;
+    answered += m_stats[lp].answered;
+  }
+
+  double secs = (double) (now - m_lastprogress) / NS_PER_SEC;
+
+  Logger::system().info(
+      "LoadGenerator::%s - elapsed=%llds sent=%llu answered=%llu "
+      "outstanding=%lld skipped=%llu answers/s=%.0f",
+      __func__, (long long) ((now - m_started) / NS_PER_SEC),
+      (unsigned long long) sent, (unsigned long long) answered,
+      (long long) m_outstanding, (unsigned long long) m_skipped,
+      (answered - m_lastanswered) / secs);
+
+  m_lastanswered = answered;
+  m_lastprogress = now;
+}
+
+uint64_t LoadGenerator::track(LoadProcedure lp) {
+  SMutexLock l(m_pendingmutex);
+  PendingRequest& pr = m_pending[++m_nextid];
+
+  pr.lp      = lp;
+  pr.created = STIMER_GET_CURRENT_TIME;
+
+  return m_nextid;
+}
+
+bool LoadGenerator::untrack(uint64_t id) {
+  SMutexLock l(m_pendingmutex);
+
+  return m_pending.erase(id) != 0;
+}
+
+void LoadGenerator::expire() {
+  stimer_t expired =
+      STIMER_GET_CURRENT_TIME - (stimer_t) ANSWER_TIMEOUT_MS * 1000000LL;
+  SMutexLock l(m_pendingmutex);
+
+  // the ids are assigned in the order the requests are created
+  while (!m_pending.empty() && m_pending.begin()->second.created < expired) {
+    atomic_dec_fetch(m_outstanding);
+    atomic_inc_fetch(m_stats[m_pending.begin()->second.lp].expired);
+    m_pending.erase(m_pending.begin());
+  }
+}
+
+void LoadGenerator::recordSendFailure(LoadProcedure lp) {
+  atomic_dec_fetch(m_outstanding);
+  atomic_inc_fetch(m_stats[lp].sendfailed);
+}
+
+void LoadGenerator::recordAnswer(
+    LoadProcedure lp, stimer_t scheduled, uint32_t vendor, uint32_t code) {
+  stimer_t elapsed = STIMER_GET_CURRENT_TIME - scheduled;
+  ProcedureStats& ps = m_stats[lp];
+
+  atomic_dec_fetch(m_outstanding);
+  atomic_inc_fetch(ps.answered);
+  if (vendor == 0 && code == ER_DIAMETER_SUCCESS) atomic_inc_fetch(ps.success);
+
+  ps.latency.record(elapsed > 0 ? (uint64_t)(elapsed / NS_PER_US) : 0);
+
+  SMutexLock l(ps.mutex);
+  ps.results[((uint64_t) vendor << 32) | code]++;
+}
+
+void LoadGenerator::report(std::ostream& os) {
+  stimer_t end =
+      m_finished ? m_finished : (stimer_t) STIMER_GET_CURRENT_TIME;
+  double secs = m_started ? (double) (end - m_started) / NS_PER_SEC : 0.0;
+  uint64_t sent = 0, answered = 0, success = 0, failed = 0, expired = 0;
+  char buf[256];
+
+  for (int lp = lpAIR; lp < lpMAX; lp++) {
+    sent += m_stats[lp].sent;
+    answered += m_stats[lp].answered;
+    success += m_stats[lp].success;
+    failed += m_stats[lp].sendfailed;
+    expired += m_stats[lp].expired;
+  }
+
+  os << std::endl << "hss_loadgen summary" << std::endl;
+
+  snprintf(
+      buf, sizeof(buf),
+      "  duration %.3fs offered %d/s peers %u imsis %u maxoutstanding %d",
+      secs, Options::rate(), (unsigned int) Options::hssPeers().size(),
+      Options::imsiCount(), Options::maxOutstanding());
+  os << buf << std::endl;
+
+  snprintf(
+      buf, sizeof(buf),
+      "  sent %llu answered %llu success %llu outstanding %lld skipped %llu "
+      "send failures %llu expired %llu",
+      (unsigned long long) sent, (unsigned long long) answered,
+      (unsigned long long) success, (long long) m_outstanding,
+      (unsigned long long) m_skipped, (unsigned long long) failed,
+      (unsigned long long) expired);
+  os << buf << std::endl;
+
+  snprintf(
+      buf, sizeof(buf), "  throughput %.1f answers/s (%.1f successful/s)",
+      secs > 0 ? answered / secs : 0.0, secs > 0 ? success / secs : 0.0);
+  os << buf << std::endl << std::endl;
+
+  snprintf(
+      buf, sizeof(buf), "  %-4s %10s %10s %10s %9s %9s %9s %9s %9s %9s %9s",
+      "proc", "sent", "answered", "success", "tput/s", "mean ms", "p50 ms",
+      "p90 ms", "p99 ms", "p99.9 ms", "max ms");
+  os << buf << std::endl;
+
+  for (int lp = lpAIR; lp < lpMAX; lp++) {
+    ProcedureStats& ps = m_stats[lp];
+    if (ps.sent == 0) continue;
+
+    snprintf(
+        buf, sizeof(buf),
+        "  %-4s %10llu %10llu %10llu %9.1f %9.3f %9.3f %9.3f %9.3f %9.3f "
+        "%9.3f",
+        Options::procedureName((LoadProcedure) lp),
+        (unsigned long long) ps.sent, (unsigned long long) ps.answered,
+        (unsigned long long) ps.success, secs > 0 ? ps.answered / secs : 0.0,
+        ps.latency.mean() / 1000.0, ps.latency.percentile(50.0) / 1000.0,
+        ps.latency.percentile(90.0) / 1000.0,
+        ps.latency.percentile(99.0) / 1000.0,
+        ps.latency.percentile(99.9) / 1000.0, ps.latency.max() / 1000.0);
+    os << buf << std::endl;
+  }
+
+  os << std::endl << "  result codes" << std::endl;
+
+  for (int lp = lpAIR; lp < lpMAX; lp++) {
+    ProcedureStats& ps = m_stats[lp];
+    SMutexLock l(ps.mutex);
+
+    for (std::map<uint64_t, uint64_t>::iterator it = ps.results.begin();
+         it != ps.results.end(); ++it) {
+      uint32_t vendor = (uint32_t)(it->first >> 32);
+      uint32_t code   = (uint32_t)(it->first & 0xffffffff);
+
+      if (vendor)
+        snprintf(
+            buf, sizeof(buf), "  %-4s experimental %u/%u %llu",
+            Options::procedureName((LoadProcedure) lp), vendor, code,
+            (unsigned long long) it->second);
+      else
+        snprintf(
+            buf, sizeof(buf), "  %-4s result %u %llu",
+            Options::procedureName((LoadProcedure) lp), code,
+            (unsigned long long) it->second);
+      os << buf << std::endl;
+    }
+  }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "logger.h"
+#include "options.h"
+
+Logger* Logger::m_singleton = NULL;
+
+void Logger::_init(const char* app) {
+  m_sinks.push_back(std::make_shared<spdlog::sinks::syslog_sink>());
+  m_sinks.push_back(
+      std::make_shared<spdlog::sinks::ansicolor_stdout_sink_mt>());
+  m_sinks.push_back(std::make_shared<spdlog::sinks::rotating_file_sink_mt>(
+      Options::logFilename(), Options::logMaxSize() * 1024 * 1024,
+      Options::logNumberFiles()));
+
+  m_sinks[0]->set_level(spdlog::level::err);
+  m_sinks[1]->set_level(spdlog::level::info);
+  m_sinks[2]->set_level(spdlog::level::trace);
+
+  std::stringstream ss;
+  ss << "[%Y-%m-%dT%H:%M:%S.%e] [" << app << "] [%n] [%l] %v";
+
+  m_system =
+      new SLogger("system", m_sinks, ss.str().c_str(), Options::logQueueSize());
+  m_s6as6d =
+      new SLogger("s6as6d", m_sinks, ss.str().c_str(), Options::logQueueSize());
+  m_s6c = new SLogger("s6c", m_sinks, ss.str().c_str(), Options::logQueueSize());
+  m_s6t = new SLogger("s6t", m_sinks, ss.str().c_str(), Options::logQueueSize());
+
+  // the per interface loggers are only used for failures so that logging
+  // does not influence the measurements
+  m_system->set_level(spdlog::level::info);
+  m_s6as6d->set_level(spdlog::level::warn);
+  m_s6c->set_level(spdlog::level::warn);
+  m_s6t->set_level(spdlog::level::warn);
+}
+
+void Logger::_cleanup() {
+  if (m_system) delete m_system;
+  if (m_s6as6d) delete m_s6as6d;
+  if (m_s6c) delete m_s6c;
+  if (m_s6t) delete m_s6t;
+}
+
+void Logger::_flush() {
+  if (m_system) m_system->flush();
+  if (m_s6as6d) m_s6as6d->flush();
+  if (m_s6c) m_s6c->flush();
+  if (m_s6t) m_s6t->flush();
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <signal.h>
+#include <fstream>
+#include <iostream>
+
+#include "fd.h"
+
+#include "options.h"
+#include "serror.h"
+#include "logger.h"
+
+#include "loadgen.h"
+
+LoadGenerator loadgen;
+
+void handler(int signo, siginfo_t* pinfo, void* pcontext) {
+  // stop scheduling new requests, the summary is still produced
+  loadgen.stop();
+}
+
+void initHandler() {
+  struct sigaction sa;
+
+  Logger::system().startup("registering signal hander");
+
+  sa.sa_flags     = SA_SIGINFO;
+  sa.sa_sigaction = handler;
+  sigemptyset(&sa.sa_mask);
+  int signo = SIGINT;
+  if (sigaction(signo, &sa, NULL) == -1)
+    SError::throwRuntimeExceptionWithErrno("Unable to register signal handler");
+}
+
+int main(int argc, char** argv) {
+  if (!Options::parse(argc, argv)) {
+    std::cout << "Options::parse() failed" << std::endl;
+    return 1;
+  }
+
+  Logger::init("hss_loadgen");
+
+  /////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////
+
+  // initialize the signal handler
+  initHandler();
+
+  // initialize diameter and connect to the HSS peers
+  if (!loadgen.init()) {
+    Logger::system().error("unable to initialize the load generator");
+    Logger::flush();
+    return 1;
+  }
+
+  // run the load and wait for it to complete
+  loadgen.init(NULL);
+  loadgen.join();
+
+  loadgen.report(std::cout);
+
+  if (!Options::reportFilename().empty()) {
+    std::ofstream ofs(Options::reportFilename().c_str());
+    if (ofs.is_open())
+      loadgen.report(ofs);
+    else
+      Logger::system().error(
+          "unable to open the report file [%s]",
+          Options::reportFilename().c_str());
+  }
+
+  loadgen.uninit();
+
+  Logger::system().startup("exiting");
+  Logger::flush();
+
+  return 0;
+}
@@ -0,0 +1,593 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <getopt.h>
+
+#include <freeDiameter/freeDiameter-host.h>
+
+#include "options.h"
+
+#define RAPIDJSON_NAMESPACE loadgenrapidjson
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/document.h"
+
+Options* Options::m_singleton = NULL;
+
+static const char* procedureNames[] = {"air", "ulr", "pur", "cir", "srr"};
+
+Options::Options()
+    : m_options(0),
+      m_rate(100),
+      m_duration(60),
+      m_maxoutstanding(10000),
+      m_imsifirst(0),
+      m_imsicount(1),
+      m_imsilength(15),
+      m_msisdnfirst(0),
+      m_msisdnlength(0),
+      m_vectors(1),
+      m_scefrefid(0),
+      m_logmaxsize(20),
+      m_lognbrfiles(5),
+      m_logfilename("logs/loadgen.log"),
+      m_logqueuesize(8192) {
+  m_mix[lpAIR] = 1;
+  m_mix[lpULR] = 0;
+  m_mix[lpPUR] = 0;
+  m_mix[lpCIR] = 0;
+  m_mix[lpSRR] = 0;
+}
+
+Options::~Options() {}
+
+const char* Options::procedureName(LoadProcedure lp) {
+  return lp >= lpAIR && lp < lpMAX ? procedureNames[lp] : "unknown";
+}
+
+void Options::help() {
+  std::cout
+      << std::endl
+      << "Usage:  hss_loadgen -j jsoncfg [OPTIONS]..." << std::endl
+      << "  -h, --help                   Print help and exit" << std::endl
+      << "  -j, --jsoncfg filename       The JSON configuration file."
+      << std::endl
+      << "  -s, --originhost host        The diameter origin host."
+      << std::endl
+      << "  -r, --originrealm realm      The diameter origin realm."
+      << std::endl
+      << "  -a, --hsspeer host           A diameter peer (HSS) to send "
+         "requests to, may be"
+      << std::endl
+      << "                               repeated to spread the load "
+         "across several peers."
+      << std::endl
+      << "  -b, --hssrealm realm         The diameter realm for the HSS."
+      << std::endl
+      << "  -t, --rate tps               The offered load in requests per "
+         "second."
+      << std::endl
+      << "  -d, --duration seconds       The length of the run in seconds."
+      << std::endl
+      << "  -o, --maxoutstanding count   The maximum number of unanswered "
+         "requests."
+      << std::endl
+      << "  -i, --imsifirst imsi         The first IMSI of the subscriber "
+         "range."
+      << std::endl
+      << "  -k, --imsicount count        The number of IMSI's in the "
+         "subscriber range."
+      << std::endl
+      << "  -m, --msisdnfirst msisdn     The MSISDN of the first subscriber "
+         "in the range."
+      << std::endl
+      << "  -x, --mix air:n,ulr:n,...    The relative weight of each "
+         "procedure (air, ulr, pur,"
+      << std::endl
+      << "                               cir, srr)." << std::endl
+      << "  -p, --report filename        Write the summary report to this "
+         "file."
+      << std::endl
+      << "  -z, --logsize size           The maximum log size in MB."
+      << std::endl
+      << "  -n, --lognumber number       The number of log files to maintain."
+      << std::endl
+      << "  -l, --logname filename       The base filename for the log files."
+      << std::endl
+      << "  -q, --logqsize size          The log queue size in bytes, must be "
+         "a power of 2."
+      << std::endl
+      << "  -c, --fdcfg filename         Read the freeDiameter configuration "
+         "from this file"
+      << std::endl
+      << "                               instead of the default location "
+         "(" DEFAULT_CONF_PATH "/" FD_DEFAULT_CONF_FILENAME ")."
+      << std::endl;
+}
+
+bool Options::parse(int argc, char** argv) {
+  bool ret = true;
+
+  ret = singleton().parseInputOptions(argc, argv);
+
+  if (ret && !singleton().m_jsoncfg.empty()) {
+    ret &= singleton().parseJson();
+  }
+
+  ret &= singleton().validateOptions();
+
+  return ret;
+}
+
+bool Options::parseInputOptions(int argc, char** argv) {
+  int c;
+  int option_index = 0;
+  bool result      = true;
+
+  struct option long_options[] = {
+      {"help", no_argument, NULL, 'h'},
+      {"jsoncfg", required_argument, NULL, 'j'},
+      {"originhost", required_argument, NULL, 's'},
+      {"originrealm", required_argument, NULL, 'r'},
+      {"hsspeer", required_argument, NULL, 'a'},
+      {"hssrealm", required_argument, NULL, 'b'},
+      {"rate", required_argument, NULL, 't'},
+      {"duration", required_argument, NULL, 'd'},
+      {"maxoutstanding", required_argument, NULL, 'o'},
+      {"imsifirst", required_argument, NULL, 'i'},
+      {"imsicount", required_argument, NULL, 'k'},
+      {"msisdnfirst", required_argument, NULL, 'm'},
+      {"mix", required_argument, NULL, 'x'},
+      {"report", required_argument, NULL, 'p'},
+      {"logsize", required_argument, NULL, 'z'},
+      {"lognumber", required_argument, NULL, 'n'},
+      {"logname", required_argument, NULL, 'l'},
+      {"logqsize", required_argument, NULL, 'q'},
+      {"fdcfg", required_argument, NULL, 'c'},
+      {NULL, 0, NULL, 0}};
+
+  // Loop on arguments
+  while (1) {
+    c = getopt_long(
+        argc, argv, "hj:s:r:a:b:t:d:o:i:k:m:x:p:z:n:l:q:c:", long_options,
+        &option_index);
+    if (c == -1) break;  // Exit from the loop.
+
+    switch (c) {
+      case 'h': {
+        help();
+        exit(0);
+      }
+      case 'j': {
+        m_jsoncfg = optarg;
+        m_options |= opt_jsoncfg;
+        break;
+      }
+      case 's': {
+        m_originhost = optarg;
+        m_options |= opt_originhost;
+        break;
+      }
+      case 'r': {
+        m_originrealm = optarg;
+        m_options |= opt_originrealm;
+        break;
+      }
+      case 'a': {
+        m_hsspeers.push_back(optarg);
+        m_options |= opt_hsspeers;
+        break;
+      }
+      case 'b': {
+        m_hssrealm = optarg;
+        m_options |= opt_hssrealm;
+        break;
+      }
+      case 't': {
+        m_rate = atoi(optarg);
+        m_options |= opt_rate;
+        break;
+      }
+      case 'd': {
+        m_duration = atoi(optarg);
+        m_options |= opt_duration;
+        break;
+      }
+      case 'o': {
+        m_maxoutstanding = atoi(optarg);
+        m_options |= opt_maxoutstanding;
+        break;
+      }
+      case 'i': {
+        m_imsifirst  = strtoull(optarg, NULL, 10);
+        m_imsilength = strlen(optarg);
+        m_options |= opt_imsifirst;
+        break;
+      }
+      case 'k': {
+        m_imsicount = strtoul(optarg, NULL, 10);
+        m_options |= opt_imsicount;
+        break;
+      }
+      case 'm': {
+        m_msisdnfirst  = strtoull(optarg, NULL, 10);
+        m_msisdnlength = strlen(optarg);
+        m_options |= opt_msisdnfirst;
+        break;
+      }
+      case 'x': {
+        if (!parseMix(optarg)) {
+          std::cout << "Invalid procedure mix [" << optarg << "]"
+                    << std::endl;
+          result = false;
+        }
+        m_options |= opt_mix;
+        break;
+      }
+      case 'p': {
+        m_report = optarg;
+        m_options |= opt_report;
+        break;
+      }
+      case 'c': {
+        m_fdcfg = optarg;
+        m_options |= opt_fdcfg;
+        break;
+      }
+      case 'z': {
+        m_logmaxsize = atoi(optarg);
+        m_options |= opt_logmaxsize;
+        break;
+      }
+      case 'n': {
+        m_lognbrfiles = atoi(optarg);
+        m_options |= opt_lognbrfiles;
+        break;
+      }
+      case 'l': {
+        m_logfilename = optarg;
+        m_options |= opt_logfilename;
+        break;
+      }
+      case 'q': {
+        m_logqueuesize = atoi(optarg);
+        m_options |= opt_logqueuesize;
+        break;
+      }
+      case '?': {
+        std::cout << "Option -" << (char)optopt
+                  << " is unrecognized or requires an argument" << std::endl;
+        result = false;
+        break;
+      }
+      default: {
+        std::cout << "Unrecognized option [" << c << "]" << std::endl;
+        result = false;
+      }
+    }
+  }
+
+  return result;
+}
+
+bool Options::parseMix(const std::string& mix) {
+  int weights[lpMAX] = {0, 0, 0, 0, 0};
+  std::stringstream ss(mix);
+  std::string item;
+
+  while (std::getline(ss, item, ',')) {
+    size_t sep = item.find(':');
+    if (sep == std::string::npos) return false;
+
+    std::string name = item.substr(0, sep);
+    int lp           = lpAIR;
+    for (; lp < lpMAX; lp++)
+      if (name == procedureNames[lp]) break;
+    if (lp == lpMAX) return false;
+
+    weights[lp] = atoi(item.substr(sep + 1).c_str());
+    if (weights[lp] < 0) return false;
+  }
+
+  memcpy(m_mix, weights, sizeof(m_mix));
+  return true;
+}
+
+bool Options::parseJson() {
+  char buf[2048];
+
+  FILE* fp = fopen(m_jsoncfg.c_str(), "r");
+  if (!fp) {
+    std::cout << "Unable to open the json config file [" << m_jsoncfg << "]"
+              << std::endl;
+    return false;
+  }
+  RAPIDJSON_NAMESPACE::FileReadStream is(fp, buf, sizeof(buf));
+  RAPIDJSON_NAMESPACE::Document doc;
+  doc.ParseStream<0>(is);
+  fclose(fp);
+
+  if (!doc.IsObject()) {
+    std::cout << "Error parsing the json config file [" << m_jsoncfg << "]"
+              << std::endl;
+    return false;
+  }
+
+  if (doc.HasMember("common")) {
+    const RAPIDJSON_NAMESPACE::Value& commonSection = doc["common"];
+    if (!(m_options & opt_fdcfg) && commonSection.HasMember("fdcfg")) {
+      if (!commonSection["fdcfg"].IsString()) {
+        std::cout << "Error parsing json value: [fdcfg]" << std::endl;
+        return false;
+      }
+      m_fdcfg = commonSection["fdcfg"].GetString();
+      m_options |= opt_fdcfg;
+    }
+    if (!(m_options & opt_originhost) &&
+        commonSection.HasMember("originhost")) {
+      if (!commonSection["originhost"].IsString()) {
+        std::cout << "Error parsing json value: [originhost]" << std::endl;
+        return false;
+      }
+      m_originhost = commonSection["originhost"].GetString();
+      m_options |= opt_originhost;
+    }
+    if (!(m_options & opt_originrealm) &&
+        commonSection.HasMember("originrealm")) {
+      if (!commonSection["originrealm"].IsString()) {
+        std::cout << "Error parsing json value: [originrealm]" << std::endl;
+        return false;
+      }
+      m_originrealm = commonSection["originrealm"].GetString();
+      m_options |= opt_originrealm;
+    }
+  }
+  if (doc.HasMember("loadgen")) {
+    const RAPIDJSON_NAMESPACE::Value& lgSection = doc["loadgen"];
+    if (!(m_options & opt_hssrealm) && lgSection.HasMember("hssrealm")) {
+      if (!lgSection["hssrealm"].IsString()) {
+        std::cout << "Error parsing json value: [hssrealm]" << std::endl;
+        return false;
+      }
+      m_hssrealm = lgSection["hssrealm"].GetString();
+      m_options |= opt_hssrealm;
+    }
+    if (!(m_options & opt_hsspeers) && lgSection.HasMember("hsspeers")) {
+      const RAPIDJSON_NAMESPACE::Value& peers = lgSection["hsspeers"];
+      if (!peers.IsArray()) {
+        std::cout << "Error parsing json value: [hsspeers]" << std::endl;
+        return false;
+      }
+      for (RAPIDJSON_NAMESPACE::SizeType i = 0; i < peers.Size(); i++) {
+        if (!peers[i].IsString()) {
+          std::cout << "Error parsing json value: [hsspeers]" << std::endl;
+          return false;
+        }
+        m_hsspeers.push_back(peers[i].GetString());
+      }
+      m_options |= opt_hsspeers;
+    }
+    if (!(m_options & opt_rate) && lgSection.HasMember("rate")) {
+      if (!lgSection["rate"].IsInt()) {
+        std::cout << "Error parsing json value: [rate]" << std::endl;
+        return false;
+      }
+      m_rate = lgSection["rate"].GetInt();
+      m_options |= opt_rate;
+    }
+    if (!(m_options & opt_duration) && lgSection.HasMember("duration")) {
+      if (!lgSection["duration"].IsInt()) {
+        std::cout << "Error parsing json value: [duration]" << std::endl;
+        return false;
+      }
+      m_duration = lgSection["duration"].GetInt();
+      m_options |= opt_duration;
+    }
+    if (!(m_options & opt_maxoutstanding) &&
+        lgSection.HasMember("maxoutstanding")) {
+      if (!lgSection["maxoutstanding"].IsInt()) {
+        std::cout << "Error parsing json value: [maxoutstanding]" << std::endl;
+        return false;
+      }
+      m_maxoutstanding = lgSection["maxoutstanding"].GetInt();
+      m_options |= opt_maxoutstanding;
+    }
+    if (!(m_options & opt_imsifirst) && lgSection.HasMember("imsifirst")) {
+      if (!lgSection["imsifirst"].IsString()) {
+        std::cout << "Error parsing json value: [imsifirst]" << std::endl;
+        return false;
+      }
+      m_imsifirst  = strtoull(lgSection["imsifirst"].GetString(), NULL, 10);
+      m_imsilength = lgSection["imsifirst"].GetStringLength();
+      m_options |= opt_imsifirst;
+    }
+    if (!(m_options & opt_imsicount) && lgSection.HasMember("imsicount")) {
+      if (!lgSection["imsicount"].IsUint()) {
+        std::cout << "Error parsing json value: [imsicount]" << std::endl;
+        return false;
+      }
+      m_imsicount = lgSection["imsicount"].GetUint();
+      m_options |= opt_imsicount;
+    }
+    if (!(m_options & opt_msisdnfirst) && lgSection.HasMember("msisdnfirst")) {
+      if (!lgSection["msisdnfirst"].IsString()) {
+        std::cout << "Error parsing json value: [msisdnfirst]" << std::endl;
+        return false;
+      }
+      m_msisdnfirst  = strtoull(lgSection["msisdnfirst"].GetString(), NULL, 10);
+      m_msisdnlength = lgSection["msisdnfirst"].GetStringLength();
+      m_options |= opt_msisdnfirst;
+    }
+    if (!(m_options & opt_visitedplmn) && lgSection.HasMember("visitedplmn")) {
+      if (!lgSection["visitedplmn"].IsString()) {
+        std::cout << "Error parsing json value: [visitedplmn]" << std::endl;
+        return false;
+      }
+      m_visitedplmn = lgSection["visitedplmn"].GetString();
+      m_options |= opt_visitedplmn;
+    }
+    if (!(m_options & opt_vectors) && lgSection.HasMember("vectors")) {
+      if (!lgSection["vectors"].IsInt()) {
+        std::cout << "Error parsing json value: [vectors]" << std::endl;
+        return false;
+      }
+      m_vectors = lgSection["vectors"].GetInt();
+      m_options |= opt_vectors;
+    }
+    if (!(m_options & opt_scefid) && lgSection.HasMember("scefid")) {
+      if (!lgSection["scefid"].IsString()) {
+        std::cout << "Error parsing json value: [scefid]" << std::endl;
+        return false;
+      }
+      m_scefid = lgSection["scefid"].GetString();
+      m_options |= opt_scefid;
+    }
+    if (!(m_options & opt_scefrealm) && lgSection.HasMember("scefrealm")) {
+      if (!lgSection["scefrealm"].IsString()) {
+        std::cout << "Error parsing json value: [scefrealm]" << std::endl;
+        return false;
+      }
+      m_scefrealm = lgSection["scefrealm"].GetString();
+      m_options |= opt_scefrealm;
+    }
+    if (!(m_options & opt_scefrefid) && lgSection.HasMember("scefrefid")) {
+      if (!lgSection["scefrefid"].IsUint()) {
+        std::cout << "Error parsing json value: [scefrefid]" << std::endl;
+        return false;
+      }
+      m_scefrefid = lgSection["scefrefid"].GetUint();
+      m_options |= opt_scefrefid;
+    }
+    if (!(m_options & opt_mix) && lgSection.HasMember("mix")) {
+      const RAPIDJSON_NAMESPACE::Value& mix = lgSection["mix"];
+      if (!mix.IsObject()) {
+        std::cout << "Error parsing json value: [mix]" << std::endl;
+        return false;
+      }
+      for (int lp = lpAIR; lp < lpMAX; lp++) {
+        m_mix[lp] = 0;
+        if (mix.HasMember(procedureNames[lp])) {
+          if (!mix[procedureNames[lp]].IsInt() ||
+              mix[procedureNames[lp]].GetInt() < 0) {
+            std::cout << "Error parsing json value: [mix."
+                      << procedureNames[lp] << "]" << std::endl;
+            return false;
+          }
+          m_mix[lp] = mix[procedureNames[lp]].GetInt();
+        }
+      }
+      m_options |= opt_mix;
+    }
+    if (!(m_options & opt_report) && lgSection.HasMember("report")) {
+      if (!lgSection["report"].IsString()) {
+        std::cout << "Error parsing json value: [report]" << std::endl;
+        return false;
+      }
+      m_report = lgSection["report"].GetString();
+      m_options |= opt_report;
+    }
+    if (!(m_options & opt_logmaxsize) && lgSection.HasMember("logsize")) {
+      if (!lgSection["logsize"].IsInt()) {
+        std::cout << "Error parsing json value: [logsize]" << std::endl;
+        return false;
+      }
+      m_logmaxsize = lgSection["logsize"].GetInt();
+      m_options |= opt_logmaxsize;
+    }
+    if (!(m_options & opt_lognbrfiles) && lgSection.HasMember("lognumber")) {
+      if (!lgSection["lognumber"].IsInt()) {
+        std::cout << "Error parsing json value: [lognumber]" << std::endl;
+        return false;
+      }
+      m_lognbrfiles = lgSection["lognumber"].GetInt();
+      m_options |= opt_lognbrfiles;
+    }
+    if (!(m_options & opt_logfilename) && lgSection.HasMember("logname")) {
+      if (!lgSection["logname"].IsString()) {
+        std::cout << "Error parsing json value: [logname]" << std::endl;
+        return false;
+      }
+      m_logfilename = lgSection["logname"].GetString();
+      m_options |= opt_logfilename;
+    }
+    if (!(m_options & opt_logqueuesize) && lgSection.HasMember("logqsize")) {
+      if (!lgSection["logqsize"].IsInt()) {
+        std::cout << "Error parsing json value: [logqsize]" << std::endl;
+        return false;
+      }
+      m_logqueuesize = lgSection["logqsize"].GetInt();
+      m_options |= opt_logqueuesize;
+    }
+  }
+
+  return true;
+}
+
+bool Options::validateOptions() {
+  bool result = (m_options & opt_originhost) &&
+                (m_options & opt_originrealm) && (m_options & opt_fdcfg) &&
+                (m_options & opt_hsspeers) && (m_options & opt_hssrealm) &&
+                (m_options & opt_imsifirst);
+
+  if (!result) {
+    std::cout << "The origin host/realm, freeDiameter configuration, HSS "
+                 "peer(s)/realm and first IMSI are required"
+              << std::endl;
+    return false;
+  }
+
+  if (m_rate <= 0 || m_duration <= 0 || m_imsicount == 0 ||
+      m_maxoutstanding <= 0) {
+    std::cout << "The rate, duration, IMSI count and maximum outstanding "
+                 "must be greater than zero"
+              << std::endl;
+    return false;
+  }
+
+  int total = 0;
+  for (int lp = lpAIR; lp < lpMAX; lp++) total += m_mix[lp];
+  if (total == 0) {
+    std::cout << "At least one procedure must have a non-zero weight"
+              << std::endl;
+    return false;
+  }
+
+  if ((m_mix[lpCIR] > 0 || m_mix[lpSRR] > 0) && !(m_options & opt_msisdnfirst)) {
+    std::cout << "The first MSISDN is required for CIR and SRR" << std::endl;
+    return false;
+  }
+
+  if (m_mix[lpCIR] > 0 && m_scefid.empty()) m_scefid = m_originhost;
+  // the reference ids of each run start at a random value, so the events
+  // created by a previous run are not found as duplicates
+  if (!(m_options & opt_scefrefid)) m_scefrefid = std::random_device()();
+  if (m_scefrealm.empty()) m_scefrealm = m_originrealm;
+
+  if (m_visitedplmn.empty()) m_visitedplmn = "00f110";
+  if (m_visitedplmn.length() != 6 ||
+      m_visitedplmn.find_first_not_of("0123456789abcdefABCDEF") !=
+          std::string::npos) {
+    std::cout << "The visited PLMN must be 6 hex characters" << std::endl;
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <string>
+
+#include "loadgen.h"
+#include "logger.h"
+#include "options.h"
+#include "s6as6d_impl.h"
+
+#define ULR_S6A_S6D_INDICATOR (1U << 1)
+#define ULR_INITIAL_ATTACH_IND (1U << 5)
+
+#define PUR_UE_PURGED_IN_MME (1U)
+
+#define RAT_TYPE_EUTRAN 1004
+
+namespace s6as6d {
+
+typedef LoadRequest<AUIRreq, Application, lpAIR> LoadAUIRreq;
+typedef LoadRequest<UPLRreq, Application, lpULR> LoadUPLRreq;
+typedef LoadRequest<PUURreq, Application, lpPUR> LoadPUURreq;
+
+Application::Application() : ApplicationBase() {
+  const std::string& plmn = Options::visitedPlmn();
+  for (int i = 0; i < 3; i++)
+    m_visitedplmn[i] = strtoul(plmn.substr(i * 2, 2).c_str(), NULL, 16);
+}
+
+Application::~Application() {}
+
+bool Application::send(FDMessageRequest* req) {
+  try {
+    req->send();
+  } catch (FDException& ex) {
+    Logger::s6as6d().warn(
+        "Application::%s - exception sending request - %s", __func__,
+        ex.what());
+    delete req;
+    return false;
+  }
+
+  // the request is deleted by the framework after the answer is processed
+  return true;
+}
+
+void Application::addCommon(
+    FDMessageRequest* req, const std::string& session, const std::string& imsi,
+    const std::string& peer) {
+  req->add(getDict().avpSessionId(), session);
+  req->add(getDict().avpAuthSessionState(), 1);  // NO_STATE_MAINTAINED
+  req->addOrigin();
+  req->add(getDict().avpDestinationHost(), peer);
+  req->add(getDict().avpDestinationRealm(), Options::hssRealm());
+  req->add(getDict().avpUserName(), imsi);
+}
+
+bool Application::sendAUIRreq(
+    const std::string& imsi, const std::string& peer, stimer_t scheduled) {
+  LoadAUIRreq* s = new LoadAUIRreq(*this, scheduled);
+
+  try {
+    addCommon(s, s->getSessionId(), imsi, peer);
+
+    FDAvp reai(getDict().avpRequestedEutranAuthenticationInfo());
+    reai.add(
+        getDict().avpNumberOfRequestedVectors(), (uint32_t) Options::vectors());
+    reai.add(getDict().avpImmediateResponsePreferred(), (uint32_t) 1);
+    s->add(reai);
+
+    s->add(getDict().avpVisitedPlmnId(), m_visitedplmn, sizeof(m_visitedplmn));
+  } catch (FDException& ex) {
+    Logger::s6as6d().warn(
+        "Application::%s - exception creating request - %s", __func__,
+        ex.what());
+    delete s;
+    return false;
+  }
+
+  return send(s);
+}
+
+bool Application::sendUPLRreq(
+    const std::string& imsi, const std::string& peer, stimer_t scheduled) {
+  LoadUPLRreq* s = new LoadUPLRreq(*this, scheduled);
+
+  try {
+    addCommon(s, s->getSessionId(), imsi, peer);
+    s->add(getDict().avpRatType(), (int32_t) RAT_TYPE_EUTRAN);
+    s->add(
+        getDict().avpUlrFlags(),
+        (uint32_t)(ULR_S6A_S6D_INDICATOR | ULR_INITIAL_ATTACH_IND));
+    s->add(getDict().avpVisitedPlmnId(), m_visitedplmn, sizeof(m_visitedplmn));
+  } catch (FDException& ex) {
+    Logger::s6as6d().warn(
+        "Application::%s - exception creating request - %s", __func__,
+        ex.what());
+    delete s;
+    return false;
+  }
+
+  return send(s);
+}
+
+bool Application::sendPUURreq(
+    const std::string& imsi, const std::string& peer, stimer_t scheduled) {
+  LoadPUURreq* s = new LoadPUURreq(*this, scheduled);
+
+  try {
+    addCommon(s, s->getSessionId(), imsi, peer);
+    s->add(getDict().avpPurFlags(), (uint32_t) PUR_UE_PURGED_IN_MME);
+  } catch (FDException& ex) {
+    Logger::s6as6d().warn(
+        "Application::%s - exception creating request - %s", __func__,
+        ex.what());
+    delete s;
+    return false;
+  }
+
+  return send(s);
+}
+
+// The generated request and command classes require these definitions, the
+// load generator only sends requests so none of the commands are registered.
+
+void UPLRreq::processAnswer(FDMessageAnswer& ans) {}
+int UPLRcmd::process(FDMessageRequest* req) { return -1; }
+void CALRreq::processAnswer(FDMessageAnswer& ans) {}
+int CALRcmd::process(FDMessageRequest* req) { return -1; }
+void AUIRreq::processAnswer(FDMessageAnswer& ans) {}
+int AUIRcmd::process(FDMessageRequest* req) { return -1; }
+void INSDRreq::processAnswer(FDMessageAnswer& ans) {}
+int INSDRcmd::process(FDMessageRequest* req) { return -1; }
+void DESDRreq::processAnswer(FDMessageAnswer& ans) {}
+int DESDRcmd::process(FDMessageRequest* req) { return -1; }
+void PUURreq::processAnswer(FDMessageAnswer& ans) {}
+int PUURcmd::process(FDMessageRequest* req) { return -1; }
+void RERreq::processAnswer(FDMessageAnswer& ans) {}
+int RERcmd::process(FDMessageRequest* req) { return -1; }
+
+}  // namespace s6as6d
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include "loadgen.h"
+#include "logger.h"
+#include "options.h"
+#include "s6c_impl.h"
+
+namespace s6c {
+
+typedef LoadRequest<SERIFSRreq, Application, lpSRR> LoadSERIFSRreq;
+
+Application::Application() : ApplicationBase() {}
+
+Application::~Application() {}
+
+bool Application::sendSERIFSRreq(
+    const std::string& msisdn, const std::string& imsi, const std::string& peer,
+    stimer_t scheduled) {
+  LoadSERIFSRreq* s = new LoadSERIFSRreq(*this, scheduled);
+
+  try {
+    s->add(getDict().avpSessionId(), s->getSessionId());
+
+    FDAvp vsai(getDict().avpVendorSpecificApplicationId());
+    vsai.add(getDict().avpVendorId(), getDict().vnd3GPP().getId());
+    vsai.add(getDict().avpAuthApplicationId(), getDict().app().getId());
+    s->add(vsai);
+
+    s->add(getDict().avpAuthSessionState(), 1);  // NO_STATE_MAINTAINED
+    s->addOrigin();
+    s->add(getDict().avpDestinationHost(), peer);
+    s->add(getDict().avpDestinationRealm(), Options::hssRealm());
+
+    uint8_t buf[15];
+    size_t len = FDUtility::str2tbcd(msisdn.c_str(), buf, sizeof(buf));
+    s->add(getDict().avpMsisdn(), buf, len);
+    s->add(getDict().avpUserName(), imsi);
+  } catch (FDException& ex) {
+    Logger::s6c().warn(
+        "Application::%s - exception creating request - %s", __func__,
+        ex.what());
+    delete s;
+    return false;
+  }
+
+  try {
+    s->send();
+  } catch (FDException& ex) {
+    Logger::s6c().warn(
+        "Application::%s - exception sending request - %s", __func__,
+        ex.what());
+    delete s;
+    return false;
+  }
+
+  return true;
+}
+
+// The generated request and command classes require these definitions, the
+// load generator only sends requests so none of the commands are registered.
+
+void SERIFSRreq::processAnswer(FDMessageAnswer& ans) {}
+int SERIFSRcmd::process(FDMessageRequest* req) { return -1; }
+void ALSCRreq::processAnswer(FDMessageAnswer& ans) {}
+int ALSCRcmd::process(FDMessageRequest* req) { return -1; }
+void RESDSRreq::processAnswer(FDMessageAnswer& ans) {}
+int RESDSRcmd::process(FDMessageRequest* req) { return -1; }
+
+}  // namespace s6c
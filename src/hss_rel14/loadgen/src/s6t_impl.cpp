@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+
+#include "loadgen.h"
+#include "logger.h"
+#include "options.h"
+#include "s6t_impl.h"
+
+#define MONITORING_TYPE_LOSS_OF_CONNECTIVITY 0
+
+namespace s6t {
+
+typedef LoadRequest<COIRreq, Application, lpCIR> LoadCOIRreq;
+
+Application::Application()
+    : ApplicationBase(), m_scefrefid(Options::scefRefId()) {}
+
+Application::~Application() {}
+
+bool Application::sendCOIRreq(
+    const std::string& msisdn, const std::string& peer, stimer_t scheduled) {
+  LoadCOIRreq* s = new LoadCOIRreq(*this, scheduled);
+
+  try {
+    s->add(getDict().avpSessionId(), s->getSessionId());
+    s->add(getDict().avpAuthSessionState(), 1);  // NO_STATE_MAINTAINED
+    s->addOrigin();
+    s->add(getDict().avpDestinationHost(), peer);
+    s->add(getDict().avpDestinationRealm(), Options::hssRealm());
+
+    uint8_t buf[15];
+    size_t len = FDUtility::str2tbcd(msisdn.c_str(), buf, sizeof(buf));
+    FDAvp ui(getDict().avpUserIdentifier());
+    ui.add(getDict().avpMsisdn(), buf, len);
+    s->add(ui);
+
+    // every configuration uses a new reference id so the HSS creates a new
+    // event instead of rejecting a duplicate
+    FDAvp mec(getDict().avpMonitoringEventConfiguration());
+    mec.add(getDict().avpScefReferenceId(), atomic_inc_fetch(m_scefrefid));
+    mec.add(getDict().avpScefId(), Options::scefId());
+    mec.add(
+        getDict().avpMonitoringType(),
+        (uint32_t) MONITORING_TYPE_LOSS_OF_CONNECTIVITY);
+    mec.add(getDict().avpMaximumNumberOfReports(), (uint32_t) 1);
+    s->add(mec);
+  } catch (FDException& ex) {
+    Logger::s6t().warn(
+        "Application::%s - exception creating request - %s", __func__,
+        ex.what());
+    delete s;
+    return false;
+  }
+
+  try {
+    s->send();
+  } catch (FDException& ex) {
+    Logger::s6t().warn(
+        "Application::%s - exception sending request - %s", __func__,
+        ex.what());
+    delete s;
+    return false;
+  }
+
+  return true;
+}
+
+// The generated request and command classes require these definitions, the
+// load generator only sends requests so none of the commands are registered.
+
+void COIRreq::processAnswer(FDMessageAnswer& ans) {}
+int COIRcmd::process(FDMessageRequest* req) { return -1; }
+void REIRreq::processAnswer(FDMessageAnswer& ans) {}
+int REIRcmd::process(FDMessageRequest* req) { return -1; }
+void NIIRreq::processAnswer(FDMessageAnswer& ans) {}
+int NIIRcmd::process(FDMessageRequest* req) { return -1; }
+
+}  // namespace s6t
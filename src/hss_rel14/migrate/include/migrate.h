@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __MIGRATE_H
+#define __MIGRATE_H
+
+#include <stdint.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "scassandra.h"
+#include "sthread.h"
+
+class Migrator;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct MigrateOptions {
+  MigrateOptions()
+      : keyspace("vhss"),
+        threads(8),
+        ranges(256),
+        pagesize(1000),
+        force(false),
+        dryrun(false) {}
+
+  std::string fdcfg;
+  std::string host;
+  std::string keyspace;
+  std::string task;
+  int threads;
+  int ranges;
+  int pagesize;
+  bool force;
+  bool dryrun;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// A SET clause and the write timestamp to apply it with, zero for the
+// current time.
+struct MigrateUpdate {
+  std::string set;
+  int64_t timestamp;
+};
+
+typedef std::vector<MigrateUpdate> MigrateUpdateList;
+
+//
+// A column migration of users_imsi.  columns() lists the columns the scan
+// retrieves in addition to the imsi, migrate() adds the updates for a row or
+// returns false if the row does not need to be updated.
+//
+class MigrateTask {
+ public:
+  MigrateTask() {}
+  virtual ~MigrateTask() {}
+
+  virtual const char* name()    = 0;
+  virtual const char* columns() = 0;
+
+  virtual bool migrate(
+      const std::string& imsi, SCassRow& row, bool force,
+      MigrateUpdateList& updates, bool& failed) = 0;
+};
+
+//
+// Backfills subscription_data_bin with the Diameter encoding of the JSON
+// subscription_data.  The update is written with the timestamp of the JSON
+// it was derived from, so it never overwrites an encoding written by a
+// newer change to the subscription data.
+//
+class SubDataTask : public MigrateTask {
+ public:
+  const char* name() { return "subdata"; }
+  const char* columns() {
+    return "subscription_data, writetime(subscription_data) AS "
+           "subscription_data_ts, subscription_data_bin";
+  }
+
+  bool migrate(
+      const std::string& imsi, SCassRow& row, bool force,
+      MigrateUpdateList& updates, bool& failed);
+};
+
+//
+// Backfills key_bin, opc_bin and rand_bin from the hex text columns.  Each
+// column is written with the timestamp of its text column, so a value the
+// HSS has already written to the blob column is not replaced.
+//
+class SecKeysTask : public MigrateTask {
+ public:
+  const char* name() { return "seckeys"; }
+  const char* columns() {
+    return "key, writetime(key) AS key_ts, key_bin, "
+           "opc, writetime(opc) AS opc_ts, opc_bin, "
+           "rand, writetime(rand) AS rand_ts, rand_bin";
+  }
+
+  bool migrate(
+      const std::string& imsi, SCassRow& row, bool force,
+      MigrateUpdateList& updates, bool& failed);
+
+ private:
+  bool migrateColumn(
+      const std::string& imsi, SCassRow& row, bool force, const char* col,
+      size_t len, MigrateUpdateList& updates);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class MigrateWorker : public SThread {
+ public:
+  MigrateWorker(Migrator& migrator);
+  ~MigrateWorker();
+
+ protected:
+  unsigned long threadProc(void* arg);
+
+ private:
+  MigrateWorker();
+
+  Migrator& m_migrator;
+};
+
+//
+// Scans users_imsi in parallel.  The token ring is split into a number of
+// ranges that the worker threads claim one at a time, so a slow range does
+// not hold up the remaining ranges.
+//
+class Migrator {
+  friend MigrateWorker;
+
+ public:
+  Migrator(MigrateOptions& opt, MigrateTask& task);
+  ~Migrator();
+
+  bool connect();
+  void run();
+
+  void report(std::ostream& os);
+
+  uint64_t failed() { return m_failed; }
+
+ private:
+  bool nextRange(int64_t& first, int64_t& last, bool& inclusive);
+  bool scanRange(int64_t first, int64_t last, bool inclusive);
+  bool update(const std::string& imsi, MigrateUpdateList& updates);
+
+  MigrateOptions& m_opt;
+  MigrateTask& m_task;
+  SCassandra m_db;
+
+  volatile int m_nextrange;
+  volatile uint64_t m_scanned;
+  volatile uint64_t m_migrated;
+  volatile uint64_t m_failed;
+  volatile uint64_t m_rangeerrors;
+};
+
+#endif  // #define __MIGRATE_H
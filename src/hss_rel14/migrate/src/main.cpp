@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <iostream>
+
+#include "fd.h"
+
+#include "migrate.h"
+
+static MigrateOptions opt;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static void help() {
+  std::cout
+      << std::endl
+      << "Usage: hss_migrate [OPTIONS]... TASK" << std::endl
+      << "  -h, --help                   Print help and exit" << std::endl
+      << "  -f, --fdcfg filename         The freeDiameter configuration, "
+         "used to load the dictionaries"
+      << std::endl
+      << "  -c, --host host              The Cassandra contact point(s)"
+      << std::endl
+      << "  -k, --keyspace name          The keyspace (default vhss)"
+      << std::endl
+      << "  -t, --threads num            Scan threads (default 8)" << std::endl
+      << "  -r, --ranges num             Token ranges to split the scan into "
+         "(default 256)"
+      << std::endl
+      << "  -p, --pagesize num           Rows per page (default 1000)"
+      << std::endl
+      << "  -a, --force                  Migrate rows that have already been "
+         "migrated"
+      << std::endl
+      << "  -n, --dryrun                 Report what would be migrated "
+         "without writing"
+      << std::endl
+      << std::endl
+      << "Tasks:" << std::endl
+      << "  subdata                      Populate subscription_data_bin from "
+         "subscription_data"
+      << std::endl
+      << "  seckeys                      Populate key_bin, opc_bin and "
+         "rand_bin from key, opc and rand"
+      << std::endl;
+}
+
+static bool parseOptions(int argc, char** argv) {
+  int c;
+  int option_index = 0;
+
+  struct option long_options[] = {{"help", no_argument, NULL, 'h'},
+                                  {"fdcfg", required_argument, NULL, 'f'},
+                                  {"host", required_argument, NULL, 'c'},
+                                  {"keyspace", required_argument, NULL, 'k'},
+                                  {"threads", required_argument, NULL, 't'},
+                                  {"ranges", required_argument, NULL, 'r'},
+                                  {"pagesize", required_argument, NULL, 'p'},
+                                  {"force", no_argument, NULL, 'a'},
+                                  {"dryrun", no_argument, NULL, 'n'},
+                                  {NULL, 0, NULL, 0}};
+
+  while (1) {
+    c = getopt_long(argc, argv, "hf:c:k:t:r:p:an", long_options, &option_index);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'h': {
+        help();
+        exit(0);
+      }
+      case 'f': {
+        opt.fdcfg = optarg;
+        break;
+      }
+      case 'c': {
+        opt.host = optarg;
+        break;
+      }
+      case 'k': {
+        opt.keyspace = optarg;
+        break;
+      }
+      case 't': {
+        opt.threads = atoi(optarg);
+        break;
+      }
+      case 'r': {
+        opt.ranges = atoi(optarg);
+        break;
+      }
+      case 'p': {
+        opt.pagesize = atoi(optarg);
+        break;
+      }
+      case 'a': {
+        opt.force = true;
+        break;
+      }
+      case 'n': {
+        opt.dryrun = true;
+        break;
+      }
+      default: {
+        help();
+        return false;
+      }
+    }
+  }
+
+  if (optind == argc - 1) opt.task = argv[optind];
+
+  if (opt.fdcfg.empty() || opt.host.empty() || opt.task.empty() ||
+      opt.threads <= 0 || opt.ranges <= 0 || opt.pagesize <= 0) {
+    std::cout << "Invalid migration options" << std::endl;
+    help();
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char** argv) {
+  if (!parseOptions(argc, argv)) return 1;
+
+  SubDataTask subdata;
+  SecKeysTask seckeys;
+  MigrateTask* task = NULL;
+
+  if (opt.task == subdata.name()) {
+    task = &subdata;
+  } else if (opt.task == seckeys.name()) {
+    task = &seckeys;
+  } else {
+    std::cout << "Unknown migration task [" << opt.task << "]" << std::endl;
+    help();
+    return 1;
+  }
+
+  // the engine is initialized but not started, only the dictionaries loaded
+  // by the configured extensions are needed to encode the AVP's
+  FDEngine diameter;
+
+  try {
+    diameter.setConfigFile(opt.fdcfg);
+    if (!diameter.init()) return 1;
+  } catch (FDException& ex) {
+    std::cout << "Error initializing freeDiameter - " << ex.what()
+              << std::endl;
+    return 1;
+  }
+
+  Migrator migrator(opt, *task);
+
+  if (!migrator.connect()) return 1;
+
+  migrator.run();
+  migrator.report(std::cout);
+
+  return migrator.failed() > 0 ? 1 : 0;
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <unistd.h>
+#include <iostream>
+#include <sstream>
+
+#include "fdjson.h"
+#include "satomic.h"
+
+#include "migrate.h"
+
+// seconds between progress reports
+#define MIGRATE_PROGRESS_INTERVAL 10
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static std::string toHex(const std::string& bin) {
+  static const char* hexDigits = "0123456789abcdef";
+  std::string s;
+
+  s.reserve(bin.size() * 2);
+  for (size_t i = 0; i < bin.size(); i++) {
+    s += hexDigits[(bin[i] >> 4) & 0x0f];
+    s += hexDigits[bin[i] & 0x0f];
+  }
+
+  return s;
+}
+
+// the error callback has no context argument, so the imsi being encoded is
+// kept per worker thread for the messages
+static thread_local std::string subdataImsi;
+
+static void subdataError(const char* msg) {
+  std::cout << "IMSI " << subdataImsi << " - " << msg << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool SubDataTask::migrate(
+    const std::string& imsi, SCassRow& row, bool force,
+    MigrateUpdateList& updates, bool& failed) {
+  SCassValue json = row.getColumn("subscription_data");
+  std::string sd;
+  std::string bin;
+  MigrateUpdate upd;
+
+  failed = false;
+
+  if (json.isNull() || !json.get(sd) || sd.empty()) return false;
+  if (!force && !row.getColumn("subscription_data_bin").isNull()) return false;
+
+  if (!row.getColumn("subscription_data_ts").get(upd.timestamp)) {
+    std::cout << "IMSI " << imsi
+              << " - unable to retrieve the subscription_data write time"
+              << std::endl;
+    failed = true;
+    return false;
+  }
+
+  subdataImsi = imsi;
+  if (fdJsonEncodeAvps(sd.c_str(), bin, subdataError) != FDJSON_SUCCESS) {
+    failed = true;
+    return false;
+  }
+
+  upd.set = "subscription_data_bin = 0x" + toHex(bin);
+  updates.push_back(upd);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool SecKeysTask::migrate(
+    const std::string& imsi, SCassRow& row, bool force,
+    MigrateUpdateList& updates, bool& failed) {
+  failed = false;
+
+  if (!migrateColumn(imsi, row, force, "key", 16, updates)) failed = true;
+  if (!migrateColumn(imsi, row, force, "opc", 16, updates)) failed = true;
+  if (!migrateColumn(imsi, row, force, "rand", 16, updates)) failed = true;
+
+  return !failed && !updates.empty();
+}
+
+bool SecKeysTask::migrateColumn(
+    const std::string& imsi, SCassRow& row, bool force, const char* col,
+    size_t len, MigrateUpdateList& updates) {
+  std::string bincol = std::string(col) + "_bin";
+  SCassValue text    = row.getColumn(col);
+  uint8_t value[16];
+  MigrateUpdate upd;
+
+  if (text.isNull()) return true;
+  if (!force && !row.getColumn(bincol.c_str()).isNull()) return true;
+
+  if (!text.getHex(value, len)) {
+    std::cout << "IMSI " << imsi << " - invalid " << col << std::endl;
+    return false;
+  }
+
+  if (!row.getColumn((std::string(col) + "_ts").c_str()).get(upd.timestamp)) {
+    std::cout << "IMSI " << imsi << " - unable to retrieve the " << col
+              << " write time" << std::endl;
+    return false;
+  }
+
+  upd.set = bincol + " = 0x" +
+            toHex(std::string((const char*) value, len));
+  updates.push_back(upd);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+MigrateWorker::MigrateWorker(Migrator& migrator)
+    : SThread(true), m_migrator(migrator) {}
+
+MigrateWorker::~MigrateWorker() {}
+
+unsigned long MigrateWorker::threadProc(void* arg) {
+  int64_t first;
+  int64_t last;
+  bool inclusive;
+
+  while (m_migrator.nextRange(first, last, inclusive)) {
+    if (!m_migrator.scanRange(first, last, inclusive))
+      atomic_inc_fetch(m_migrator.m_rangeerrors);
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+Migrator::Migrator(MigrateOptions& opt, MigrateTask& task)
+    : m_opt(opt),
+      m_task(task),
+      m_nextrange(0),
+      m_scanned(0),
+      m_migrated(0),
+      m_failed(0),
+      m_rangeerrors(0) {}
+
+Migrator::~Migrator() {
+  m_db.disconnect();
+}
+
+bool Migrator::connect() {
+  m_db.host(m_opt.host);
+  m_db.keyspace(m_opt.keyspace);
+
+  SCassFuture future = m_db.connect();
+  future.wait();
+
+  if (future.errorCode() != CASS_OK) {
+    std::cout << "Unable to connect to " << m_opt.host
+              << " - error_code=" << future.errorCode() << std::endl;
+    return false;
+  }
+
+  m_db.setCoreConnectionsPerHost(m_opt.threads);
+  m_db.setMaxConnectionsPerHost(m_opt.threads * 2);
+
+  return true;
+}
+
+void Migrator::run() {
+  std::vector<MigrateWorker*> workers;
+
+  for (int i = 0; i < m_opt.threads; i++) {
+    MigrateWorker* w = new MigrateWorker(*this);
+    w->init(NULL);
+    workers.push_back(w);
+  }
+
+  int elapsed = 0;
+  for (auto it = workers.begin(); it != workers.end(); ++it) {
+    while ((*it)->isRunning()) {
+      sleep(1);
+      if (++elapsed % MIGRATE_PROGRESS_INTERVAL == 0)
+        std::cout << "scanned " << m_scanned << " migrated " << m_migrated
+                  << " failed " << m_failed << std::endl;
+    }
+    (*it)->join();
+    delete *it;
+  }
+}
+
+void Migrator::report(std::ostream& os) {
+  os << "Task              : " << m_task.name() << std::endl
+     << "Rows scanned      : " << m_scanned << std::endl
+     << "Rows migrated     : " << m_migrated
+     << (m_opt.dryrun ? " (dry run, not written)" : "") << std::endl
+     << "Rows failed       : " << m_failed << std::endl
+     << "Ranges incomplete : " << m_rangeerrors << std::endl;
+}
+
+bool Migrator::nextRange(int64_t& first, int64_t& last, bool& inclusive) {
+  int range = atomic_inc_fetch(m_nextrange) - 1;
+
+  if (range >= m_opt.ranges) return false;
+
+  SCassTokenRange(range, m_opt.ranges, first, last, inclusive);
+
+  return true;
+}
+
+bool Migrator::scanRange(int64_t first, int64_t last, bool inclusive) {
+  std::stringstream ss;
+  bool more_pages = true;
+
+  ss << "SELECT imsi, " << m_task.columns()
+     << " FROM users_imsi WHERE token(imsi) " << (inclusive ? ">= " : "> ")
+     << first << " AND token(imsi) <= " << last << " ;";
+
+  SCassStatement stmt(ss.str());
+
+  stmt.setPagingSize(m_opt.pagesize);
+
+  while (more_pages) {
+    SCassFuture future = m_db.execute(stmt);
+
+    if (future.errorCode() != CASS_OK) {
+      std::cout << "Error " << future.errorCode() << " executing ["
+                << ss.str() << "]" << std::endl;
+      return false;
+    }
+
+    SCassResult res    = future.result();
+    SCassIterator rows = res.rows();
+
+    while (rows.nextRow()) {
+      SCassRow row = rows.row();
+      std::string imsi;
+      MigrateUpdateList updates;
+      bool failed = false;
+
+      atomic_inc_fetch(m_scanned);
+
+      if (!row.getColumn("imsi").get(imsi)) {
+        atomic_inc_fetch(m_failed);
+        continue;
+      }
+
+      if (!m_task.migrate(imsi, row, m_opt.force, updates, failed)) {
+        if (failed) atomic_inc_fetch(m_failed);
+        continue;
+      }
+
+      if (!m_opt.dryrun && !update(imsi, updates)) {
+        atomic_inc_fetch(m_failed);
+        continue;
+      }
+
+      atomic_inc_fetch(m_migrated);
+    }
+
+    more_pages = res.morePages();
+
+    if (more_pages) stmt.setPagingState(res);
+  }
+
+  return true;
+}
+
+bool Migrator::update(const std::string& imsi, MigrateUpdateList& updates) {
+  for (auto it = updates.begin(); it != updates.end(); ++it) {
+    std::stringstream ss;
+
+    ss << "UPDATE users_imsi";
+    if (it->timestamp) ss << " USING TIMESTAMP " << it->timestamp;
+    ss << " SET " << it->set << " WHERE imsi = '" << imsi << "' ;";
+
+    SCassStatement stmt(ss.str());
+    SCassFuture future = m_db.execute(stmt);
+
+    if (future.errorCode() != CASS_OK) {
+      std::cout << "IMSI " << imsi << " - error " << future.errorCode()
+                << " updating " << m_task.name() << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,2181 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <inttypes.h>
+#include <iomanip>
+
+#include "cassdataaccess.h"
+#include "eventindex.h"
+#include "preload.h"
+#include "scodec.h"
+#include "sutility.h"
+#include "serror.h"
+#include "common_def.h"
+
+#include "util.h"
+#include "logger.h"
+#include "options.h"
+
+extern "C" {
+#include "auc.h"
+}
+
+#define KEY_LENGTH (16)
+
+#define GET_EVENT_DATA(_row, _col, _dest)                                      \
+  {                                                                            \
+    SCassValue val = _row.getColumn(#_col);                                    \
+    if (!val.isNull() && !val.get(_dest))                                      \
+      throw DAException(SUtility::string_format(                               \
+          "CassDataAccess::%s - ERROR - Error %d getting [%s]", __func__,      \
+          future.errorCode(), #_col));                                         \
+  }
+
+#define GET_HEX_DATA(_row, _col, _dest, _len)                                  \
+  {                                                                            \
+    SCassValue val = _row.getColumn(#_col);                                    \
+    if (!val.isNull() && !val.getHex(_dest, _len))                             \
+      throw DAException(SUtility::string_format(                               \
+          "CassDataAccess::%s - ERROR - Error %d getting [%s]", __func__,      \
+          val.error(), #_col));                                                \
+  }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// Reads K, OPc or RAND into dest.  The blob column is preferred, unless the
+// text column was written after it (by provisioning that only knows the
+// text column), so a row is correct whether or not it has been migrated.
+static void getSecColumn(
+    SCassRow& row, const char* col, uint8_t* dest, size_t len) {
+  std::string bincol = std::string(col) + "_bin";
+  SCassValue text    = row.getColumn(col);
+  SCassValue bin     = row.getColumn(bincol.c_str());
+  bool usebin        = !bin.isNull();
+
+  if (usebin && !text.isNull()) {
+    int64_t textts = 0;
+    int64_t bints  = 0;
+
+    row.getColumn((std::string(col) + "_ts").c_str()).get(textts);
+    row.getColumn((bincol + "_ts").c_str()).get(bints);
+    usebin = bints >= textts;
+  }
+
+  if (usebin) {
+    const uint8_t* data;
+    size_t datalen;
+
+    if (!bin.get(data, datalen) || datalen != len)
+      throw DAException(SUtility::string_format(
+          "CassDataAccess::%s - ERROR - Invalid [%s]", __func__,
+          bincol.c_str()));
+
+    memcpy(dest, data, len);
+  } else if (!text.isNull() && !text.getHex(dest, len)) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - ERROR - Error %d getting [%s]", __func__,
+        text.error(), col));
+  }
+}
+
+// the columns getSecColumn() reads for a field, also used for the
+// subscription data
+static std::string secColumns(const char* col) {
+  std::stringstream ss;
+
+  ss << col << ", " << col << "_bin, writetime(" << col << ") AS " << col
+     << "_ts, writetime(" << col << "_bin) AS " << col << "_bin_ts";
+
+  return ss.str();
+}
+
+CassDataAccess::CassDataAccess()
+    : m_subdatabin(false),
+      m_secbin(false),
+      m_useeventindex(false),
+      m_eventindex(NULL),
+      m_preloader(NULL) {}
+
+CassDataAccess::~CassDataAccess() {
+  disconnect();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////// PUBLIC METHODS /////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void CassDataAccess::connect(const std::string& hst, const std::string& ks) {
+  host(hst);
+  keyspace(ks);
+  connect();
+}
+
+void CassDataAccess::connect(const char* hst, const char* ks) {
+  host(hst);
+  keyspace(ks);
+  connect();
+}
+
+void CassDataAccess::connect() {
+  SCassFuture connect_future = m_db.connect();
+
+  connect_future.wait();
+
+  if (connect_future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Unable to connect to %s - error_code=%d",
+        __func__, m_db.host().c_str(), connect_future.errorCode()));
+  }
+
+  m_db.setCoreConnectionsPerHost(Options::getcasscoreconnections());
+  m_db.setMaxConnectionsPerHost(Options::getcassmaxconnections());
+  m_db.setIOQueueSize(Options::getcassioqueuesize());
+  m_db.setIONumberThreads(Options::getcassiothreads());
+
+  prepare(
+      "INSERT INTO events (scef_id, scef_ref_id, msisdn, extid, "
+      "monitoring_event_configuration, user_identifier, monitoring_type) "
+      "VALUES (?, ?, ?, ?, ?, ?, ?)",
+      m_insevent);
+  prepare(
+      "INSERT INTO events_msisdn (msisdn, scef_id, scef_ref_id) "
+      "VALUES (?, ?, ?)",
+      m_inseventmsisdn);
+  prepare(
+      "INSERT INTO events_extid (extid, scef_id, scef_ref_id) "
+      "VALUES (?, ?, ?)",
+      m_inseventextid);
+  prepare(
+      "DELETE FROM events WHERE scef_id = ? AND scef_ref_id = ?", m_delevent);
+  prepare(
+      "DELETE FROM events_msisdn WHERE msisdn = ? AND scef_id = ? "
+      "AND scef_ref_id = ?",
+      m_deleventmsisdn);
+  prepare(
+      "DELETE FROM events_extid WHERE extid = ? AND scef_id = ? "
+      "AND scef_ref_id = ?",
+      m_deleventextid);
+  prepare(
+      "INSERT INTO users_imsi (imsi, msisdn, access_restriction, key, opc, "
+      "rand, sqn, subscription_data, subscription_data_bin) "
+      "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
+      m_insimsi);
+  prepare(
+      "INSERT INTO users_imsi (imsi, msisdn, access_restriction, key_bin, "
+      "opc_bin, rand_bin, sqn, subscription_data, subscription_data_bin) "
+      "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)",
+      m_insimsibin);
+  prepare("INSERT INTO msisdn_imsi (msisdn, imsi) VALUES (?, ?)", m_insmsisdn);
+  prepare("DELETE FROM users_imsi WHERE imsi = ?", m_delimsi);
+  prepare("DELETE FROM msisdn_imsi WHERE msisdn = ?", m_delmsisdn);
+  prepare("SELECT msisdn FROM users_imsi WHERE imsi = ?", m_getimsimsisdn);
+  prepare(
+      m_secbin ? "UPDATE users_imsi SET rand_bin = ?, sqn = ? WHERE imsi = ?" :
+                 "UPDATE users_imsi SET rand = ?, sqn = ? WHERE imsi = ?",
+      m_updrandsqn);
+  prepare(
+      "SELECT idmmeidentity FROM mmeidentity_host WHERE mmehost = ?",
+      m_getmmeidhost);
+  prepare(
+      "INSERT INTO mmeidentity (mmehost, mmerealm, idmmeidentity) "
+      "VALUES (?, ?, ?)",
+      m_insmmeidentity);
+  prepare(
+      "INSERT INTO mmeidentity_host (mmehost, idmmeidentity, mmerealm) "
+      "VALUES (?, ?, ?)",
+      m_insmmeidentityhost);
+  prepare("DELETE FROM mmeidentity WHERE idmmeidentity = ?", m_delmmeidentity);
+  prepare(
+      "DELETE FROM mmeidentity_host WHERE mmehost = ?", m_delmmeidentityhost);
+
+  if (m_useeventindex && !m_eventindex) {
+    m_eventindex =
+        new EventIndex(*this, m_db, Options::geteventindexrefresh());
+    m_eventindex->init(NULL);
+  }
+}
+
+void CassDataAccess::disconnect() {
+  if (m_preloader) {
+    m_preloader->stop();
+    m_preloader->join();
+    delete m_preloader;
+    m_preloader = NULL;
+  }
+
+  if (m_eventindex) {
+    m_eventindex->stop();
+    m_eventindex->join();
+    delete m_eventindex;
+    m_eventindex = NULL;
+  }
+
+  m_db.disconnect();
+}
+
+void CassDataAccess::prepare(const char* qry, SCassPrepared& prepared) {
+  CassError err = m_db.prepare(qry, prepared);
+
+  if (err != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d preparing [%s]", __func__, err, qry));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::addEvent(DAEvent& event) {
+  DAEventBatch batch;
+
+  batch.add(event);
+
+  return applyEvents(batch, NULL, NULL);
+}
+
+bool CassDataAccess::applyEvents(
+    DAEventBatch& events, CassFutureCallback cb, void* data) {
+  SCassBatch batch(CASS_BATCH_TYPE_LOGGED);
+
+  // the statements of a batch share a write timestamp and a delete wins over
+  // an insert with the same timestamp, so rows that an added event writes
+  // again are not deleted
+  for (auto it = events.removes().begin(); it != events.removes().end();
+       ++it) {
+    const DAEvent* readd = events.added(it->scef_id, it->scef_ref_id);
+
+    if (!readd) {
+      SCassStatement stmt(m_delevent);
+      stmt.bind(0, it->scef_id);
+      stmt.bind(1, (int64_t) it->scef_ref_id);
+      batch.add(stmt);
+    }
+
+    if (it->msisdn != 0 && !(readd && readd->msisdn == it->msisdn)) {
+      SCassStatement stmt(m_deleventmsisdn);
+      stmt.bind(0, it->msisdn);
+      stmt.bind(1, it->scef_id);
+      stmt.bind(2, (int64_t) it->scef_ref_id);
+      batch.add(stmt);
+    }
+
+    if (!it->extid.empty() && !(readd && readd->extid == it->extid)) {
+      SCassStatement stmt(m_deleventextid);
+      stmt.bind(0, it->extid);
+      stmt.bind(1, it->scef_id);
+      stmt.bind(2, (int64_t) it->scef_ref_id);
+      batch.add(stmt);
+    }
+  }
+
+  for (auto it = events.adds().begin(); it != events.adds().end(); ++it) {
+    {
+      SCassStatement stmt(m_insevent);
+      stmt.bind(0, it->scef_id);
+      stmt.bind(1, (int64_t) it->scef_ref_id);
+      stmt.bind(2, it->msisdn);
+      stmt.bind(3, it->extid);
+      stmt.bind(4, it->mec_json);
+      stmt.bind(5, it->ui_json);
+      stmt.bind(6, it->monitoring_type);
+      batch.add(stmt);
+    }
+
+    if (it->msisdn != 0) {
+      SCassStatement stmt(m_inseventmsisdn);
+      stmt.bind(0, it->msisdn);
+      stmt.bind(1, it->scef_id);
+      stmt.bind(2, (int64_t) it->scef_ref_id);
+      batch.add(stmt);
+    }
+
+    if (!it->extid.empty()) {
+      SCassStatement stmt(m_inseventextid);
+      stmt.bind(0, it->extid);
+      stmt.bind(1, it->scef_id);
+      stmt.bind(2, (int64_t) it->scef_ref_id);
+      batch.add(stmt);
+    }
+  }
+
+  // the index is updated before the write completes, a subscriber is not
+  // ruled out while an event added for it is being written.  The removes are
+  // undone by applyEventsData() rebuilding the index if the batch fails.
+  if (m_eventindex) {
+    for (auto it = events.removes().begin(); it != events.removes().end();
+         ++it)
+      m_eventindex->remove(*it);
+    for (auto it = events.adds().begin(); it != events.adds().end(); ++it)
+      m_eventindex->add(*it);
+  }
+
+  SCassFuture future = m_db.execute(batch);
+
+  if (cb) return future.setCallback(cb, data);
+
+  return applyEventsData(future);
+}
+
+bool CassDataAccess::applyEventsData(SCassFuture& future) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing applyEvents()", __func__,
+        future.errorCode());
+    // the removed events may not have been deleted
+    if (m_eventindex) m_eventindex->invalidate();
+    return false;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::mayHaveEvents(const char* imsi) {
+  return m_eventindex ? m_eventindex->mayHaveEvents(imsi) : true;
+}
+
+void CassDataAccess::preload(DAPreloadCallback cb, void* data) {
+  if (m_preloader) return;
+
+  // the subscription data templates are not used when the encoded column
+  // is read
+  size_t budget = Options::getsubdatacache();
+
+  m_preloader = new Preloader(
+      m_db, Options::getpreloadthreads(), budget, !m_subdatabin && budget > 0,
+      cb, data);
+  m_preloader->init(NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getEvent(
+    const char* scef_id, uint32_t scef_ref_id, DAEvent& event) {
+  std::stringstream ss;
+
+  ss << "SELECT * FROM events WHERE "
+     << "scef_id = '" << scef_id << "' "
+     << "AND scef_ref_id = " << scef_ref_id;
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    event.init();
+
+    GET_EVENT_DATA(row, scef_id, event.scef_id);
+    GET_EVENT_DATA(row, scef_ref_id, event.scef_ref_id);
+    GET_EVENT_DATA(row, msisdn, event.msisdn);
+    GET_EVENT_DATA(row, extid, event.extid);
+    GET_EVENT_DATA(row, monitoring_event_configuration, event.mec_json);
+    GET_EVENT_DATA(row, monitoring_type, event.monitoring_type);
+    GET_EVENT_DATA(row, user_identifier, event.ui_json);
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getEvents(
+    const char* scef_id, std::list<uint32_t> scef_ref_ids, DAEventList& events,
+    CassFutureCallback cb, void* data) {
+  std::stringstream ss;
+
+  ss << "SELECT * FROM events WHERE "
+     << "scef_id = '" << scef_id << "' "
+     << "AND scef_ref_id IN (";
+
+  bool first = true;
+  for (auto it = scef_ref_ids.begin(); it != scef_ref_ids.end(); ++it) {
+    if (first)
+      first = false;
+    else
+      ss << ",";
+    ss << *it;
+  }
+
+  ss << ")";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  return getEventsData(future, events);
+}
+
+bool CassDataAccess::getEventsData(SCassFuture& future, DAEventList& events) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing getEvents()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  SCassResult res = future.result();
+
+  SCassIterator rows = res.rows();
+
+  while (rows.nextRow()) {
+    SCassRow row   = rows.row();
+    DAEvent* event = new DAEvent();
+
+    GET_EVENT_DATA(row, scef_id, event->scef_id);
+    GET_EVENT_DATA(row, scef_ref_id, event->scef_ref_id);
+    GET_EVENT_DATA(row, msisdn, event->msisdn);
+    GET_EVENT_DATA(row, extid, event->extid);
+    GET_EVENT_DATA(row, monitoring_event_configuration, event->mec_json);
+    GET_EVENT_DATA(row, monitoring_type, event->monitoring_type);
+    GET_EVENT_DATA(row, user_identifier, event->ui_json);
+
+    events.push_back(event);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void CassDataAccess::deleteEvent(const char* scef_id, uint32_t scef_ref_id) {
+  DAEventBatch batch;
+  DAEvent event;
+
+  if (!getEvent(scef_id, scef_ref_id, event)) return;
+
+  batch.remove(event);
+
+  if (!applyEvents(batch, NULL, NULL)) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error deleting event [%s:%u]", __func__, scef_id,
+        scef_ref_id));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::checkMSISDNExists(int64_t msisdn) {
+  std::stringstream ss;
+
+  ss << "SELECT * FROM msisdn_imsi WHERE msisdn=" << msisdn << ";";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) return true;
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::checkImsiExists(const char* imsi) {
+  std::stringstream ss;
+
+  ss << "SELECT imsi FROM users_imsi WHERE imsi='" << imsi << "';";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) return true;
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::checkExtIdExists(const char* extid) {
+  std::stringstream ss;
+
+  ss << "SELECT extid FROM extid WHERE extid = '" << extid << "';";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) return true;
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getImsiListFromExtId(
+    const char* extid, DAImsiList& imsilst) {
+  std::stringstream ss;
+
+  ss << "SELECT imsi FROM extid_imsi WHERE extid ='" << extid << "'";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassIterator rows = res.rows();
+
+  std::string imsi;
+
+  while (rows.nextRow()) {
+    SCassRow row = rows.row();
+    GET_EVENT_DATA(row, imsi, imsi);
+
+    SubscriberKey key(imsi);
+    if (!key.valid()) {
+      Logger::system().error(
+          "CassDataAccess::%s - invalid IMSI [%s] for extid %s", __func__,
+          imsi.c_str(), extid);
+      continue;
+    }
+
+    imsilst.push_back(key);
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getExtIdsFromImsiData(
+    SCassFuture& future, DAExtIdList& extids) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing getExtIdsFromImsi()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  SCassResult res = future.result();
+
+  SCassIterator rows = res.rows();
+
+  std::string extid;
+
+  while (rows.nextRow()) {
+    SCassRow row = rows.row();
+    GET_EVENT_DATA(row, extid, extid);
+    extids.push_back(extid);
+  }
+
+  return true;
+}
+
+bool CassDataAccess::getExtIdsFromImsi(
+    const char* imsi, DAExtIdList& extids, CassFutureCallback cb, void* data) {
+  std::stringstream ss;
+
+  ss << "SELECT extid FROM extid_imsi_xref WHERE imsi = '" << imsi << "'";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  return getExtIdsFromImsiData(future, extids);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getImsiFromMsisdn(int64_t msisdn, std::string& imsi) {
+  std::stringstream ss;
+
+  ss << "SELECT imsi FROM msisdn_imsi WHERE msisdn = " << msisdn;
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, imsi, imsi);
+    return true;
+  }
+
+  return false;
+}
+
+bool CassDataAccess::getImsiFromMsisdn(const char* msisdn, std::string& imsi) {
+  std::stringstream ss;
+
+  ss << "SELECT imsi FROM msisdn_imsi WHERE msisdn = " << msisdn;
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, imsi, imsi);
+    return true;
+  }
+
+  return false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getMsisdnFromImsi(const char* imsi, std::string& msisdn) {
+  std::stringstream ss;
+
+  ss << "SELECT msisdn FROM users_imsi where imsi = '" << imsi << "' ;";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, msisdn, msisdn);
+    return true;
+  }
+
+  return false;
+}
+
+bool CassDataAccess::getMsisdnFromImsi(const char* imsi, int64_t& msisdn) {
+  std::stringstream ss;
+
+  ss << "SELECT msisdn FROM users_imsi where imsi = '" << imsi << "' ;";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, msisdn, msisdn);
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getImsiInfoData(SCassFuture& future, DAImsiInfo& info) {
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing getImsiInfo()", __func__,
+        future.errorCode()));
+  }
+
+  // the subscription data is left in the result, the info keeps the result
+  // so the views remain valid after the completion callback returns
+  SCassResultPtr res = future.sharedResult();
+
+  SCassRow row = res->firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, imsi, info.imsi);
+    GET_EVENT_DATA(row, mmehost, info.mmehost);
+    GET_EVENT_DATA(row, mmerealm, info.mmerealm);
+    GET_EVENT_DATA(row, ms_ps_status, info.ms_ps_status);
+    info.subscription_data.clear();
+    info.subscription_data_bin.clear();
+    info.subscription_data_view.clear();
+    info.subscription_data_bin_view.clear();
+    // getImsiInfo() selects at most one of the subscription data columns
+    if (row.hasColumn("subscription_data")) {
+      SCassView view;
+      GET_EVENT_DATA(row, subscription_data, view);
+      info.subscription_data_view = DAView(view.data(), view.size());
+    }
+    if (row.hasColumn("subscription_data_bin")) {
+      SCassView view;
+      GET_EVENT_DATA(row, subscription_data_bin, view);
+      info.subscription_data_bin_view = DAView(view.data(), view.size());
+    }
+    info.keepalive = res;
+    GET_EVENT_DATA(row, msisdn, info.msisdn);
+    info.str_msisdn = std::to_string(info.msisdn);
+    GET_EVENT_DATA(row, visited_plmnid, info.visited_plmnid);
+    GET_EVENT_DATA(row, access_restriction, info.access_restriction);
+    GET_EVENT_DATA(row, mmeidentity_idmmeidentity, info.mme_id);
+    return true;
+  }
+
+  return false;
+}
+
+static const char* SUBDATA_COLUMNS = "subscription_data, ";
+static const char* SUBDATABIN_COLUMNS =
+    "subscription_data_bin, writetime(subscription_data) AS "
+    "subscription_data_ts, writetime(subscription_data_bin) AS "
+    "subscription_data_bin_ts, ";
+
+// Only the encoded subscription data is read when it is enabled, with the
+// write time of the JSON.  Like getSecColumn(), the encoded column is not
+// used when it is missing or the JSON was written after it by provisioning
+// that only knows the JSON column, the subscriber is then read again with
+// the JSON.
+bool CassDataAccess::getImsiInfo(
+    const char* imsi, DAImsiInfo& info, bool subdata, CassFutureCallback cb,
+    void* data) {
+  const char* subcols = "";
+
+  if (subdata) subcols = m_subdatabin ? SUBDATABIN_COLUMNS : SUBDATA_COLUMNS;
+
+  SCassFuture future = queryImsiInfo(imsi, subcols);
+
+  if (subdata && m_subdatabin) {
+    if (cb) {
+      ImsiInfoQuery* q = new ImsiInfoQuery(*this, imsi, cb, data);
+      if (future.setCallback(on_imsi_info_callback, q)) return true;
+      delete q;
+      return false;
+    }
+
+    if (!subDataBinUsable(future)) {
+      SCassFuture json = queryImsiInfo(imsi, SUBDATA_COLUMNS);
+      return getImsiInfoData(json, info);
+    }
+  }
+
+  if (cb) return future.setCallback(cb, data);
+
+  return getImsiInfoData(future, info);
+}
+
+SCassFuture CassDataAccess::queryImsiInfo(
+    const char* imsi, const char* subcols) {
+  std::stringstream ss;
+
+  ss << "SELECT imsi, mmehost, mmerealm, ms_ps_status, " << subcols
+     << "msisdn, visited_plmnid, access_restriction, "
+        "mmeidentity_idmmeidentity FROM users_imsi where imsi = '"
+     << imsi << "' ;";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  return m_db.execute(stmt);
+}
+
+// a failed query or a missing subscriber is reported by getImsiInfoData()
+bool CassDataAccess::subDataBinUsable(SCassFuture& future) {
+  if (future.errorCode() != CASS_OK) return true;
+
+  SCassResult res = future.result();
+  SCassRow row    = res.firstRow();
+
+  if (!row.valid()) return true;
+
+  SCassValue bin = row.getColumn("subscription_data_bin");
+  int64_t textts = 0;
+  int64_t bints  = 0;
+
+  row.getColumn("subscription_data_ts").get(textts);
+  row.getColumn("subscription_data_bin_ts").get(bints);
+
+  return bin.isNull() ? textts == 0 : bints >= textts;
+}
+
+void CassDataAccess::on_imsi_info_callback(CassFuture* future, void* data) {
+  SCassFuture f(future, true);
+  ImsiInfoQuery* q = (ImsiInfoQuery*) data;
+
+  if (q->da.subDataBinUsable(f)) {
+    q->cb(future, q->data);
+  } else {
+    SCassFuture json = q->da.queryImsiInfo(q->imsi.c_str(), SUBDATA_COLUMNS);
+    if (!json.setCallback(q->cb, q->data))
+      Logger::system().error(
+          "CassDataAccess::%s - failed CassError (%d) for %s", __func__,
+          json.errorCode(), q->imsi.c_str());
+  }
+
+  delete q;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getEventIdsFromMsisdnData(
+    SCassFuture& future, DAEventIdList& eil) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing getEventIdsFromMsisdn()",
+        __func__, future.errorCode());
+    return false;
+  }
+
+  SCassResult res = future.result();
+
+  SCassIterator rows = res.rows();
+
+  while (rows.nextRow()) {
+    SCassRow row  = rows.row();
+    DAEventId* ei = new DAEventId();
+
+    GET_EVENT_DATA(row, scef_id, ei->scef_id);
+    GET_EVENT_DATA(row, scef_ref_id, ei->scef_ref_id);
+
+    eil.push_back(ei);
+  }
+
+  return true;
+}
+
+bool CassDataAccess::getEventIdsFromMsisdn(
+    int64_t msisdn, DAEventIdList& eil, CassFutureCallback cb, void* data) {
+  std::stringstream ss;
+
+  ss << "SELECT scef_id, scef_ref_id FROM events_msisdn WHERE msisdn = "
+     << msisdn << " order by scef_id, scef_ref_id";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) {
+    bool rval = future.setCallback(cb, data);
+    if (!rval)
+      Logger::system().error(
+          "CassDataAccess::%s - failed CassError (%d)", __func__,
+          future.errorCode());
+    return rval;
+  }
+
+  getEventIdsFromMsisdnData(future, eil);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void CassDataAccess::getEventIdsFromExtId(
+    const char* extid, DAEventIdList& eil) {
+  std::stringstream ss;
+
+  ss << "SELECT scef_id, scef_ref_id FROM events_extid WHERE extid = '" << extid
+     << "'";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassIterator rows = res.rows();
+
+  while (rows.nextRow()) {
+    SCassRow row  = rows.row();
+    DAEventId* ei = new DAEventId();
+
+    GET_EVENT_DATA(row, scef_id, ei->scef_id);
+    GET_EVENT_DATA(row, scef_ref_id, ei->scef_ref_id);
+
+    eil.push_back(ei);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::getEventIdsFromExtIds(
+    const char* extids, DAEventIdList& el, CassFutureCallback cb, void* data) {
+  std::stringstream ss;
+
+  ss << "SELECT scef_id, scef_ref_id FROM events_extid WHERE extid in ("
+     << extids << ")";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  return getEventIdsFromExtIdsData(future, el);
+}
+
+bool CassDataAccess::getEventIdsFromExtIdsData(
+    SCassFuture& future, DAEventIdList& el) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing getEventIdsFromExtIds()",
+        __func__, future.errorCode());
+    return false;
+  }
+
+  SCassResult res = future.result();
+
+  SCassIterator rows = res.rows();
+
+  try {
+    while (rows.nextRow()) {
+      SCassRow row  = rows.row();
+      DAEventId* ei = new DAEventId();
+
+      GET_EVENT_DATA(row, scef_id, ei->scef_id);
+      GET_EVENT_DATA(row, scef_ref_id, ei->scef_ref_id);
+
+      el.push_back(ei);
+    }
+  } catch (DAException& ex) {
+    Logger::system().error(
+        "CassDataAccess::%s - EXCEPTION - %s", __func__, ex.what());
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool CassDataAccess::checkOpcKeys(const uint8_t opP[16]) {
+  bool more_pages = true;
+  int cnt         = 0;
+  std::string qry = m_secbin ? "SELECT imsi," + secColumns("key") + "," +
+                                   secColumns("opc") + " from vhss.users_imsi" :
+                               "SELECT imsi,key,OPc from vhss.users_imsi";
+  SCassStatement stmt(qry);
+
+  stmt.setPagingSize(5000);
+
+  while (more_pages) {
+    SCassFuture future = m_db.execute(stmt);
+
+    if (future.errorCode() != CASS_OK) {
+      throw DAException(SUtility::string_format(
+          "CassDataAccess::%s - Error %d executing [%s]", __func__,
+          future.errorCode(), qry.c_str()));
+    }
+
+    SCassResult res    = future.result();
+    SCassIterator rows = res.rows();
+
+    while (rows.nextRow()) {
+      SCassRow row = rows.row();
+
+      std::string imsi;
+      std::string key;
+      std::string opc;
+
+      GET_EVENT_DATA(row, imsi, imsi);
+
+      uint8_t opccalc[16];
+      uint8_t key_bin[16];
+      if (m_secbin) {
+        // the opc written by updateOpc() is only in opc_bin
+        uint8_t opc_bin[OPC_LENGTH];
+
+        memset(opc_bin, 0, sizeof(opc_bin));
+        getSecColumn(row, "key", key_bin, KEY_LENGTH);
+        getSecColumn(row, "opc", opc_bin, OPC_LENGTH);
+        key = Utility::bytes2hex(key_bin, KEY_LENGTH);
+        opc = Utility::bytes2hex(opc_bin, OPC_LENGTH);
+      } else {
+        GET_EVENT_DATA(row, OPc, opc);
+        GET_EVENT_DATA(row, key, key);
+        if (key.size() != KEY_LENGTH * 2 ||
+            !SCodec::hexDecode(key.data(), key_bin, KEY_LENGTH)) {
+          Logger::system().error(
+              "CassDataAccess::%s - IMSI: %s invalid KEY: %s", __func__,
+              imsi.c_str(), key.c_str());
+          continue;
+        }
+      }
+      ComputeOPc(key_bin, opP, opccalc);
+
+      std::string newopc = Utility::bytes2hex(opccalc, OPC_LENGTH);
+
+      Logger::system().info(
+          "COUNT: %d IMSI: %s KEY: %s OPC: %s NEW OPC: %s", ++cnt,
+          (uint8_t*) imsi.c_str(), (uint8_t*) key.c_str(),
+          (uint8_t*) opc.c_str(), (uint8_t*) newopc.c_str());
+
+      if (!updateOpc(imsi, newopc)) {
+        return false;
+      }
+    }
+
+    more_pages = res.morePages();
+
+    if (more_pages) stmt.setPagingState(res);
+  }
+
+  return true;
+}
+
+bool CassDataAccess::updateOpc(std::string& imsi, std::string& opc) {
+  std::stringstream ss;
+  if (m_secbin)
+    ss << "UPDATE vhss.users_imsi SET opc_bin=0x" << opc << " WHERE imsi='"
+       << imsi << "';";
+  else
+    ss << "UPDATE vhss.users_imsi SET OPc='" << opc << "' WHERE imsi='"
+       << imsi << "';";
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK)
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+
+  return true;
+}
+
+bool CassDataAccess::purgeUE(std::string& imsi) {
+  if (imsi.empty()) return false;
+
+  std::stringstream ss;
+  ss << "UPDATE vhss.users_imsi SET ms_ps_status='PURGED' WHERE imsi='" << imsi
+     << "';";
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK)
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+
+  return true;
+}
+
+bool CassDataAccess::getMmeIdentityFromImsi(
+    std::string& imsi, DAMmeIdentity& mmeid) {
+  std::stringstream ss;
+
+  ss << "SELECT mmeidentity_idmmeidentity FROM vhss.users_imsi WHERE imsi = '"
+     << imsi << "';";
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    int32_t id;
+    GET_EVENT_DATA(row, mmeidentity_idmmeidentity, id);
+    return getMmeIdentity(id, mmeid);
+  }
+
+  return false;
+}
+
+bool CassDataAccess::getMmeIdentity(std::string& mme_id, DAMmeIdentity& mmeid) {
+  std::stringstream ss;
+
+  ss << "SELECT mmehost,mmerealm,mmeisdn FROM vhss.mmeidentity WHERE "
+        "idmmeidentity='"
+     << mme_id << "';";
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, mmehost, mmeid.mme_host);
+    GET_EVENT_DATA(row, mmerealm, mmeid.mme_realm);
+    GET_EVENT_DATA(row, mmeisdn, mmeid.mme_isdn);
+    return true;
+  }
+
+  return false;
+}
+
+bool CassDataAccess::getMmeIdentity(int32_t mme_id, DAMmeIdentity& mmeid) {
+  std::stringstream ss;
+
+  ss << "SELECT mmehost,mmerealm,mmeisdn FROM vhss.mmeidentity WHERE "
+        "idmmeidentity="
+     << mme_id << ";";
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, mmehost, mmeid.mme_host);
+    GET_EVENT_DATA(row, mmerealm, mmeid.mme_realm);
+    GET_EVENT_DATA(row, mmeisdn, mmeid.mme_isdn);
+    return true;
+  }
+
+  return false;
+}
+
+bool CassDataAccess::getLatestIdentity(
+    const char* table_name, int64_t& id, CassFutureCallback cb, void* data) {
+  std::stringstream ss;
+
+  ss << "SELECT id from vhss.global_ids WHERE table_name='" << table_name
+     << "';";
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  return getLatestIdentityData(future, id);
+}
+
+bool CassDataAccess::getLatestIdentityData(SCassFuture& future, int64_t& id) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing getLatestIdentity()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, id, id);
+  } else {
+    id = 0;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::updateLatestIdentity(
+    const char* table_name, CassFutureCallback cb, void* data) {
+  std::stringstream ss;
+  ss << "UPDATE vhss.global_ids set id=id+1 where table_name='" << table_name
+     << "';";
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing updateLatestIdentity()",
+        __func__, future.errorCode());
+    return false;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::getMmeIdFromHostData(SCassFuture& future, int32_t& mmeid) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing getMmeIdFromHost()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, idmmeidentity, mmeid);
+    return true;
+  }
+
+  return false;
+}
+
+bool CassDataAccess::getMmeIdFromHost(
+    std::string& host, int32_t& mmeid, CassFutureCallback cb, void* data) {
+  SCassStatement stmt(m_getmmeidhost);
+
+  stmt.bind(0, host);
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  return getMmeIdFromHostData(future, mmeid);
+}
+
+bool CassDataAccess::addMmeIdentity(
+    std::string& host, std::string& realm, int32_t mmeid) {
+  if (!addMmeIdentity1(host, realm, mmeid, NULL, NULL)) return false;
+
+  return addMmeIdentity2(host, realm, mmeid, NULL, NULL);
+}
+
+bool CassDataAccess::deleteMmeIdentity(std::string& host) {
+  int32_t mmeid;
+
+  if (!getMmeIdFromHost(host, mmeid, NULL, NULL)) return false;
+
+  SCassBatch batch(CASS_BATCH_TYPE_LOGGED);
+  SCassStatement stmt1(m_delmmeidentity);
+  SCassStatement stmt2(m_delmmeidentityhost);
+
+  stmt1.bind(0, mmeid);
+  stmt2.bind(0, host);
+  batch.add(stmt1);
+  batch.add(stmt2);
+
+  SCassFuture future = m_db.execute(batch);
+
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d deleting MME identity %s", __func__,
+        future.errorCode(), host.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::addMmeIdentity1(
+    std::string& host, std::string& realm, int32_t mmeid, CassFutureCallback cb,
+    void* data) {
+  SCassStatement stmt(m_insmmeidentity);
+
+  stmt.bind(0, host);
+  stmt.bind(1, realm);
+  stmt.bind(2, mmeid);
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing addMmeIdentity1()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::addMmeIdentity2(
+    std::string& host, std::string& realm, int32_t mmeid, CassFutureCallback cb,
+    void* data) {
+  SCassStatement stmt(m_insmmeidentityhost);
+
+  stmt.bind(0, host);
+  stmt.bind(1, mmeid);
+  stmt.bind(2, realm);
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing addMmeIdentity2()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::updateLocation(
+    DAImsiInfo& location, uint32_t present_flags, int32_t idmmeidentity,
+    CassFutureCallback cb, void* data) {
+  std::stringstream ss;
+  ss << "UPDATE vhss.users_imsi SET ";
+
+  if (FLAG_IS_SET(present_flags, IMEI_PRESENT)) {
+    ss << "imei='" << location.imei << "',";
+  }
+
+  if (FLAG_IS_SET(present_flags, SV_PRESENT)) {
+    ss << "imeisv='" << location.imei_sv << "',";
+  }
+
+  if (FLAG_IS_SET(present_flags, MME_IDENTITY_PRESENT)) {
+    ss << "mmeidentity_idmmeidentity=" << idmmeidentity << ",";
+    ss << "mmehost='" << location.mmehost << "',";
+    ss << "mmerealm='" << location.mmerealm << "',";
+  }
+
+  ss << "ms_ps_status='"
+     << "ATTACHED"
+     << "',";
+  ss << "visited_plmnid='" << location.visited_plmnid << "' ";
+
+  ss << "WHERE imsi='" << location.imsi << "';";
+
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  if (future.errorCode() != CASS_OK)
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+
+  return true;
+}
+
+bool CassDataAccess::updateLocation(
+    DAImsiInfo& location, uint32_t present_flags, CassFutureCallback cb,
+    void* data) {
+  std::stringstream ss;
+  ss << "UPDATE vhss.users_imsi SET ";
+
+  if (FLAG_IS_SET(present_flags, IMEI_PRESENT)) {
+    ss << "imei='" << location.imei << "',";
+  }
+
+  if (FLAG_IS_SET(present_flags, SV_PRESENT)) {
+    ss << "imeisv='" << location.imei_sv << "',";
+  }
+
+  if (FLAG_IS_SET(present_flags, MME_IDENTITY_PRESENT)) {
+    ss << "mmeidentity_idmmeidentity=" << location.mme_id << ",";
+    ss << "mmehost='" << location.mmehost << "',";
+    ss << "mmerealm='" << location.mmerealm << "',";
+  }
+
+  ss << "ms_ps_status='"
+     << "ATTACHED"
+     << "',";
+  ss << "visited_plmnid='" << location.visited_plmnid << "' ";
+
+  ss << "WHERE imsi='" << location.imsi << "';";
+
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  if (future.errorCode() != CASS_OK)
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+
+  return true;
+}
+
+bool CassDataAccess::updateLocationData(SCassFuture& future) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing updateLocation()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::getImsiSecData(SCassFuture& future, DAImsiSec& imsisec) {
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing getImsiSec()", __func__,
+        future.errorCode()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    int64_t sqn_nb = 0;
+
+    GET_EVENT_DATA(row, sqn, sqn_nb);
+
+    // the hex columns are decoded from the result directly into the binary
+    // fields
+    if (m_secbin) {
+      getSecColumn(row, "key", imsisec.key, KEY_LENGTH);
+      getSecColumn(row, "rand", imsisec.rand, RAND_LENGTH);
+      getSecColumn(row, "opc", imsisec.opc, KEY_LENGTH);
+    } else {
+      GET_HEX_DATA(row, key, imsisec.key, KEY_LENGTH);
+      GET_HEX_DATA(row, rand, imsisec.rand, RAND_LENGTH);
+      GET_HEX_DATA(row, OPc, imsisec.opc, KEY_LENGTH);
+    }
+
+    imsisec.sqn[0] = (sqn_nb & (255UL << 40)) >> 40;
+    imsisec.sqn[1] = (sqn_nb & (255UL << 32)) >> 32;
+    imsisec.sqn[2] = (sqn_nb & (255UL << 24)) >> 24;
+    imsisec.sqn[3] = (sqn_nb & (255UL << 16)) >> 16;
+    imsisec.sqn[4] = (sqn_nb & (255UL << 8)) >> 8;
+    imsisec.sqn[5] = (sqn_nb & 0xFF);
+
+    return true;
+  }
+
+  return false;
+}
+
+bool CassDataAccess::getImsiSec(
+    const std::string& imsi, DAImsiSec& imsisec, CassFutureCallback cb,
+    void* data) {
+  std::stringstream ss;
+
+  if (m_secbin)
+    ss << "SELECT sqn, " << secColumns("key") << ", " << secColumns("rand")
+       << ", " << secColumns("opc") << " FROM vhss.users_imsi WHERE imsi='"
+       << imsi << "';";
+  else
+    ss << "SELECT key,sqn,rand,OPc FROM vhss.users_imsi WHERE imsi='" << imsi
+       << "';";
+
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  return getImsiSecData(future, imsisec);
+}
+
+bool CassDataAccess::updateRandSqn(
+    const std::string& imsi, uint8_t* rand_p, uint8_t* sqn, bool inc_sqn,
+    CassFutureCallback cb, void* data) {
+  SqnU64Union eu;
+
+  SQN_TO_U64(sqn, eu);
+
+  if (inc_sqn) eu.u64 += 32;
+
+  SCassStatement stmt(m_updrandsqn);
+
+  if (m_secbin)
+    stmt.bindBytes(0, rand_p, RAND_LENGTH);
+  else
+    stmt.bind(0, Utility::bytes2hex(rand_p, RAND_LENGTH));
+  stmt.bind(1, (int64_t) eu.u64);
+  stmt.bind(2, imsi);
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (cb) return future.setCallback(cb, data);
+
+  if (future.errorCode() != CASS_OK)
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing updateRandSqn() for %s",
+        __func__, future.errorCode(), imsi.c_str()));
+
+  return true;
+}
+
+bool CassDataAccess::updateRandSqnData(SCassFuture& future) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().warn(
+        "CassDataAccess::%s - Error %d executing updateRandSqn()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::incSqn(std::string& imsi, uint8_t* sqn) {
+  SqnU64Union eu;
+
+  SQN_TO_U64(sqn, eu);
+
+  eu.u64 += 32;
+
+  std::stringstream ss;
+  ss << "UPDATE vhss.users_imsi SET sqn =" << eu.u64 << " WHERE imsi='" << imsi
+     << "';";
+  if (Logger::system().debug_enabled()) Logger::system().debug(ss.str());
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK)
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+
+  return true;
+}
+
+bool CassDataAccess::getSubDataFromImsi(
+    const char* imsi, std::string& sub_data) {
+  std::stringstream ss;
+
+  ss << "SELECT subscription_data FROM users_imsi where imsi = '" << imsi
+     << "' ;";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+
+  SCassResult res = future.result();
+
+  SCassRow row = res.firstRow();
+
+  if (row.valid()) {
+    GET_EVENT_DATA(row, subscription_data, sub_data);
+    return true;
+  }
+
+  return false;
+}
+
+bool CassDataAccess::updateSubscriptionData(
+    const char* imsi, const std::string& sub_data,
+    const std::string& sub_data_bin) {
+  std::stringstream ss;
+
+  ss << "UPDATE users_imsi SET subscription_data = '";
+  for (std::string::const_iterator it = sub_data.begin(); it != sub_data.end();
+       ++it) {
+    if (*it == '\'') ss << '\'';
+    ss << *it;
+  }
+  ss << "', subscription_data_bin = ";
+  if (sub_data_bin.empty())
+    ss << "null";
+  else
+    ss << "0x"
+       << Utility::bytes2hex(
+              (const uint8_t*) sub_data_bin.data(), sub_data_bin.size());
+  ss << " WHERE imsi = '" << imsi << "' ;";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d updating the subscription data for %s",
+        __func__, future.errorCode(), imsi);
+    return false;
+  }
+
+  return true;
+}
+
+bool CassDataAccess::putImsi(
+    const DAImsiInfo& info, const DAImsiSec& sec, uint32_t present_flags,
+    CassFutureCallback cb, void* data) {
+  // the index entry of the stored MSISDN is only replaced when the MSISDN is
+  // written
+  if (FLAG_IS_SET(present_flags, PUT_MSISDN_PRESENT))
+    return changeImsi(
+        new ImsiChange(*this, false, info, sec, present_flags, cb, data));
+
+  return writeImsi(
+      ImsiChange(*this, false, info, sec, present_flags, cb, data), 0);
+}
+
+bool CassDataAccess::putImsiData(SCassFuture& future) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing putImsi()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  // the subscriber's MSISDN may have changed, once it has been written
+  if (m_eventindex) m_eventindex->invalidate();
+
+  return true;
+}
+
+bool CassDataAccess::deleteImsi(
+    const std::string& imsi, CassFutureCallback cb, void* data) {
+  DAImsiInfo info = DAImsiInfo();
+  DAImsiSec sec;
+
+  memset(&sec, 0, sizeof(sec));
+  info.imsi = imsi;
+
+  return changeImsi(new ImsiChange(*this, true, info, sec, 0, cb, data));
+}
+
+bool CassDataAccess::deleteImsiData(SCassFuture& future) {
+  if (future.errorCode() != CASS_OK) {
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d executing deleteImsi()", __func__,
+        future.errorCode());
+    return false;
+  }
+
+  // the deleted subscriber's MSISDN may be reused by another subscriber
+  if (m_eventindex) m_eventindex->invalidate();
+
+  return true;
+}
+
+// reads the MSISDN stored for the subscriber before the change is written,
+// the msisdn_imsi entry is only removed for the MSISDN the subscriber has
+bool CassDataAccess::changeImsi(ImsiChange* chg) {
+  SCassStatement stmt(m_getimsimsisdn);
+
+  stmt.bind(0, chg->info.imsi);
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (chg->cb) {
+    if (future.setCallback(on_stored_msisdn_callback, chg)) return true;
+    Logger::system().error(
+        "CassDataAccess::%s - failed CassError (%d)", __func__,
+        future.errorCode());
+    delete chg;
+    return false;
+  }
+
+  int64_t stored_msisdn = 0;
+  bool rval             = false;
+
+  if (storedMsisdn(future, stored_msisdn))
+    rval = writeImsi(*chg, stored_msisdn);
+  else
+    Logger::system().error(
+        "CassDataAccess::%s - Error %d reading the MSISDN of %s", __func__,
+        future.errorCode(), chg->info.imsi.c_str());
+
+  delete chg;
+
+  return rval;
+}
+
+bool CassDataAccess::writeImsi(const ImsiChange& chg, int64_t stored_msisdn) {
+  SCassBatch batch(CASS_BATCH_TYPE_LOGGED);
+  const DAImsiInfo& info = chg.info;
+  const DAImsiSec& sec   = chg.sec;
+  uint32_t present_flags = chg.present_flags;
+
+  if (chg.del) {
+    SCassStatement stmt(m_delimsi);
+    stmt.bind(0, info.imsi);
+    batch.add(stmt);
+  } else {
+    // the columns that are not bound are left unset, so the values that were
+    // not supplied keep what is stored
+    SCassStatement stmt(m_secbin ? m_insimsibin : m_insimsi);
+
+    stmt.bind(0, info.imsi);
+    if (FLAG_IS_SET(present_flags, PUT_MSISDN_PRESENT))
+      stmt.bind(1, info.msisdn);
+    if (FLAG_IS_SET(present_flags, PUT_ACCESS_RESTRICTION_PRESENT))
+      stmt.bind(2, info.access_restriction);
+    if (m_secbin) {
+      if (FLAG_IS_SET(present_flags, PUT_KEY_PRESENT))
+        stmt.bindBytes(3, sec.key, KEY_LENGTH);
+      if (FLAG_IS_SET(present_flags, PUT_OPC_PRESENT))
+        stmt.bindBytes(4, sec.opc, OPC_LENGTH);
+      if (FLAG_IS_SET(present_flags, PUT_RAND_PRESENT))
+        stmt.bindBytes(5, sec.rand, RAND_LENGTH);
+    } else {
+      if (FLAG_IS_SET(present_flags, PUT_KEY_PRESENT))
+        stmt.bind(3, SCodec::hexEncode(sec.key, KEY_LENGTH));
+      if (FLAG_IS_SET(present_flags, PUT_OPC_PRESENT))
+        stmt.bind(4, SCodec::hexEncode(sec.opc, OPC_LENGTH));
+      if (FLAG_IS_SET(present_flags, PUT_RAND_PRESENT))
+        stmt.bind(5, SCodec::hexEncode(sec.rand, RAND_LENGTH));
+    }
+    if (FLAG_IS_SET(present_flags, PUT_SQN_PRESENT)) {
+      const uint8_t* sqn = sec.sqn;
+      SqnU64Union eu;
+
+      SQN_TO_U64(sqn, eu);
+      stmt.bind(6, (int64_t) eu.u64);
+    }
+    if (FLAG_IS_SET(present_flags, PUT_SUBSCRIPTION_DATA_PRESENT)) {
+      stmt.bind(7, info.subscription_data);
+      if (info.subscription_data_bin.empty())
+        stmt.bindNull(8);
+      else
+        stmt.bindBytes(
+            8, (const uint8_t*) info.subscription_data_bin.data(),
+            info.subscription_data_bin.size());
+    }
+    batch.add(stmt);
+  }
+
+  // the index entries are different partitions, so the delete of the stored
+  // MSISDN and the insert of a new one do not conflict
+  if (stored_msisdn != 0 &&
+      (chg.del || !FLAG_IS_SET(present_flags, PUT_MSISDN_PRESENT) ||
+       stored_msisdn != info.msisdn)) {
+    SCassStatement stmt(m_delmsisdn);
+    stmt.bind(0, stored_msisdn);
+    batch.add(stmt);
+  }
+
+  if (!chg.del && FLAG_IS_SET(present_flags, PUT_MSISDN_PRESENT) &&
+      info.msisdn != 0) {
+    SCassStatement stmt(m_insmsisdn);
+    stmt.bind(0, info.msisdn);
+    stmt.bind(1, info.imsi);
+    batch.add(stmt);
+  }
+
+  SCassFuture future = m_db.execute(batch);
+
+  if (chg.cb) return future.setCallback(chg.cb, chg.data);
+
+  return chg.del ? deleteImsiData(future) : putImsiData(future);
+}
+
+bool CassDataAccess::storedMsisdn(SCassFuture& future, int64_t& msisdn) {
+  if (future.errorCode() != CASS_OK) return false;
+
+  SCassResult res = future.result();
+  SCassRow row    = res.firstRow();
+
+  msisdn = 0;
+  if (row.valid()) row.getColumn("msisdn").get(msisdn);
+
+  return true;
+}
+
+void CassDataAccess::on_stored_msisdn_callback(
+    CassFuture* future, void* data) {
+  SCassFuture f(future, true);
+  ImsiChange* chg       = (ImsiChange*) data;
+  int64_t stored_msisdn = 0;
+
+  // a failed read is reported by the change's completion
+  if (!storedMsisdn(f, stored_msisdn)) {
+    chg->cb(future, chg->data);
+  } else if (!chg->da.writeImsi(*chg, stored_msisdn)) {
+    Logger::system().error(
+        "CassDataAccess::%s - unable to write the change for %s", __func__,
+        chg->info.imsi.c_str());
+  }
+
+  delete chg;
+}
+
+void CassDataAccess::UpdateValidityTime(
+    const char* imsi, std::string& validity_time) {
+  std::stringstream ss;
+
+  ss << "UPDATE users_imsi SET niddvalidity = '" << validity_time
+     << "' WHERE imsi= '" << imsi << "' ;";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+}
+
+void CassDataAccess::UpdateNIRDestination(
+    const char* imsi, std::string& host, std::string& realm) {
+  std::stringstream ss;
+
+  ss << "UPDATE users_imsi SET nir_dest_host = '" << host
+     << "' , nir_dest_realm = '" << realm << "' WHERE imsi='" << imsi << "' ;";
+
+  SCassStatement stmt(ss.str().c_str());
+
+  SCassFuture future = m_db.execute(stmt);
+
+  if (future.errorCode() != CASS_OK) {
+    throw DAException(SUtility::string_format(
+        "CassDataAccess::%s - Error %d executing [%s]", __func__,
+        future.errorCode(), ss.str().c_str()));
+  }
+}
+
+#if 0
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+
+
+bool CassDataAccess::getImsiFromScefIdScefRefId( char *scef_id, uint32_t scef_ref_id, std::string &imsi )
+{
+	std::stringstream ss;
+
+	ss << "SELECT imsi FROM scef_ids WHERE scef_id = '"
+	   <<  scef_id
+	   << "' AND scef_ref_id = " << scef_ref_id <<";" ;
+
+	SCassStatement stmt( ss.str().c_str() );
+
+	SCassFuture future = m_db.execute( stmt );
+
+	if( future.errorCode() != CASS_OK ) {
+		throw DAException(
+				SUtility::string_format( "CassDataAccess::%s - Error %d executing [%s]",
+						__func__, future.errorCode(), ss.str().c_str() )
+		);
+	}
+
+	SCassResult res = future.result();
+
+	SCassRow row = res.firstRow();
+
+	if ( row.valid() ) {
+		GET_EVENT_DATA( row, imsi, imsi);
+		return true;
+	}
+
+	return false;
+}
+
+bool CassDataAccess::getScefIdScefRefIdFromImsi( char *imsi, std::string &scef_id, uint32_t &scef_ref_id )
+{
+	std::stringstream ss;
+
+	ss << "SELECT scef_id, scef_ref_id FROM scef_ids_imsi WHERE imsi = '" << imsi << "' ;" ;
+
+	SCassStatement stmt( ss.str().c_str() );
+
+	SCassFuture future = m_db.execute( stmt );
+
+	if ( future.errorCode() != CASS_OK ) {
+		throw DAException(
+				SUtility::string_format( "CassDataAccess::%s -Error %d executing [%s]",
+						__func__, future.errorCode(), ss.str().c_str() )
+		);
+	}
+
+	SCassResult res = future.result();
+
+	SCassRow row = res.firstRow();
+
+	if ( row.valid() ) {
+		GET_EVENT_DATA( row, scef_id, scef_id);
+		GET_EVENT_DATA( row, scef_ref_id, scef_ref_id);
+		return true;
+	}
+
+	return false;
+}
+
+bool CassDataAccess::deleteEvent( std::string scef_id, uint32_t scef_ref_id )
+{
+	std::stringstream ss;
+
+	ss << "DELETE FROM monitoring_event_configuration WHERE scef_id = '"
+	   <<  scef_id
+	   << "' AND scef_ref_id = " << scef_ref_id << " ;" ;
+
+	SCassStatement stmt( ss.str().c_str() );
+
+	SCassFuture future = m_db.execute( stmt );
+
+	if ( future.errorCode() != CASS_OK ) {
+		throw DAException(
+				SUtility::string_format( "CassDataAccess::%s -Error %d executing [%s]",
+						__func__, future.errorCode(), ss.str().c_str() )
+		);
+	}
+
+	return true;
+}
+
+bool CassDataAccess::delScefIds( const char *imsi )
+{
+	std::stringstream ss;
+
+	ss << "DELETE FROM scef_ids_imsi WHERE imsi = '" << imsi << "' ;" ;
+
+	SCassStatement stmt( ss.str().c_str() );
+
+	SCassFuture future = m_db.execute( stmt );
+
+	if ( future.errorCode() != CASS_OK ) {
+		throw DAException(
+				SUtility::string_format( "CassDataAccess::%s -Error %d executing [%s]",
+						__func__, future.errorCode(), ss.str().c_str() )
+		);
+	}
+
+	return true;
+}
+
+bool CassDataAccess::delImsiFromScefIds ( const char *scef_id, uint32_t scef_ref_id )
+{
+	std::stringstream ss;
+
+	ss << "DELETE FROM scef_ids WHERE scef_id = '" << scef_id
+	   << "' AND scef_ref_id = " << scef_ref_id << " ;" ;
+
+	SCassStatement stmt( ss.str().c_str() );
+
+	SCassFuture future = m_db.execute( stmt );
+
+	if ( future.errorCode() != CASS_OK ) {
+		throw DAException(
+				SUtility::string_format( "CassDataAccess::%s - Error %d executing [%s]",
+						__func__, future.errorCode(), ss.str().c_str() )
+		);
+	}
+
+	return true;
+}
+
+bool CassDataAccess::CheckImsiAttached ( char *imsi )
+{
+	std::stringstream ss;
+
+	ss << "SELECT ms_ps_status FROM users_imsi WHERE imsi = '" << imsi << "' ;" ;
+
+	SCassStatement stmt( ss.str().c_str() );
+
+	SCassFuture future = m_db.execute( stmt );
+
+	if ( future.errorCode() != CASS_OK ) {
+		throw DAException(
+				SUtility::string_format( "CassDataAccess::%s - Error %d executing [%s]",
+						__func__, future.errorCode(), ss.str().c_str() )
+		);
+	}
+
+	SCassResult res = future.result();
+
+	SCassRow row = res.firstRow();
+
+	std::string imsi_status;
+
+	if ( row.valid() )
+	{
+		GET_EVENT_DATA( row, ms_ps_status, imsi_status);
+	}
+
+	return imsi_status.compare( "ATTACHED" ) == 0;
+}
+
+void CassDataAccess::getMonEventConfForImsi( const char *imsi, DAMonitoringConfEventList &mcel )
+{
+   std::stringstream ss;
+
+   ss << "SELECT imsi FROM extidentifier_imsi WHERE extid ='" << ext_id << "';" ;
+
+   SCassStatement stmt( ss.str().c_str() );
+
+   SCassFuture future = m_db.execute( stmt );
+
+   if ( future.errorCode() != CASS_OK )
+   {
+      throw DAException(
+         SUtility::string_format( "CassDataAccess::%s - Error %d executing [%s]",
+         __func__, future.errorCode(), ss.str().c_str() )
+      );
+   }
+
+   SCassResult res = future.result();
+
+   SCassIterator rows = res.rows();
+
+   std::string imsi;
+
+   while ( rows.nextRow() ) {
+      SCassRow row = rows.row();
+      GET_EVENT_DATA( row, imsi, imsi );
+      imsilst.push_back( imsi );
+   }
+
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+DAMonitoringConfEventList::DAMonitoringConfEventList()
+{
+}
+
+DAMonitoringConfEventList::~DAMonitoringConfEventList()
+{
+   std::list<MonitoringConfEvent*>::iterator it;
+
+   while ( (it = begin()) != end() )
+   {
+      delete *it;
+      pop_front();
+   }
+}
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "eventindex.h"
+#include "logger.h"
+#include "satomic.h"
+
+EventIndex::EventIndex(DataAccess& da, SCassandra& db, unsigned refresh)
+    : m_da(da),
+      m_db(db),
+      m_refresh(refresh),
+      m_ready(false),
+      m_stop(false),
+      m_pending(0),
+      m_invalidated(0) {}
+
+EventIndex::~EventIndex() {}
+
+void EventIndex::onInit() {
+  if (m_refresh > 0) {
+    m_timer.setInterval(m_refresh * 1000);
+    m_timer.setOneShot(false);
+    initTimer(m_timer);
+    m_timer.start();
+  }
+
+  build();
+}
+
+void EventIndex::onQuit() {
+  m_timer.destroy();
+}
+
+void EventIndex::onTimer(SEventThread::Timer& t) {
+  if (t.getId() == m_timer.getId()) build();
+}
+
+void EventIndex::dispatch(SEventThreadMessage& msg) {
+  if (msg.getId() == EVENTINDEX_REBUILD) return build();
+  if (msg.getId() != EVENTINDEX_UPDATE) return;
+
+  EventIndexUpdateMsg& upd = (EventIndexUpdateMsg&) msg;
+  EventKey key(upd.m_event.scef_id, upd.m_event.scef_ref_id);
+
+  // an event that is added again replaces the subscribers it was indexed for
+  auto it = m_events.find(key);
+  if (it != m_events.end()) {
+    count(it->second, false);
+    m_events.erase(it);
+  }
+
+  if (upd.m_add) {
+    MsisdnCache msisdns;
+    ExtIdCache extids;
+    std::vector<SubscriberKey>& imsis = m_events[key];
+
+    // without its subscribers the index is incomplete until it is rebuilt
+    if (!resolve(upd.m_event, imsis, msisdns, extids)) m_ready = false;
+    count(imsis, true);
+
+    atomic_dec_fetch(m_pending);
+  }
+}
+
+void EventIndex::add(const DAEvent& event) {
+  atomic_inc_fetch(m_pending);
+  postMessage(new EventIndexUpdateMsg(event, true));
+}
+
+void EventIndex::remove(const DAEvent& event) {
+  postMessage(new EventIndexUpdateMsg(event, false));
+}
+
+void EventIndex::invalidate() {
+  // a single rebuild is posted for a burst of changes
+  if (atomic_inc_fetch(m_invalidated) == 1)
+    postMessage(new SEventThreadMessage(EVENTINDEX_REBUILD));
+}
+
+void EventIndex::stop() {
+  m_stop = true;
+  quit();
+}
+
+bool EventIndex::mayHaveEvents(const char* imsi) {
+  if (!m_ready || m_pending != 0 || m_invalidated != 0) return true;
+
+  SubscriberKey key(imsi);
+  if (!key.valid()) return true;
+
+  SMutexLock l(m_mutex);
+
+  return m_counts.find(key) != m_counts.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void EventIndex::build() {
+  EventImsis events;
+  ImsiCounts counts;
+  MsisdnCache msisdns;
+  ExtIdCache extids;
+  int invalidated = m_invalidated;
+
+  if (!scan(
+          "SELECT msisdn, scef_id, scef_ref_id FROM events_msisdn", true,
+          events, msisdns, extids) ||
+      !scan(
+          "SELECT extid, scef_id, scef_ref_id FROM events_extid", false,
+          events, msisdns, extids))
+    return;
+
+  for (auto it = events.begin(); it != events.end(); ++it)
+    for (auto iit = it->second.begin(); iit != it->second.end(); ++iit)
+      counts[*iit]++;
+
+  // the updates posted while scanning are applied to the new index once they
+  // are dispatched
+  m_events.swap(events);
+
+  {
+    SMutexLock l(m_mutex);
+    m_counts.swap(counts);
+  }
+
+  // a change made while scanning may have been missed, the rebuild was only
+  // posted by invalidate() if none was outstanding when the scan started
+  if (!__sync_bool_compare_and_swap(&m_invalidated, invalidated, 0)) {
+    if (invalidated != 0)
+      postMessage(new SEventThreadMessage(EVENTINDEX_REBUILD));
+    return;
+  }
+
+  m_ready = true;
+
+  Logger::system().info(
+      "EventIndex::%s - indexed %zu events for %zu subscribers", __func__,
+      m_events.size(), m_counts.size());
+}
+
+bool EventIndex::scan(
+    const char* qry, bool msisdn, EventImsis& events, MsisdnCache& msisdns,
+    ExtIdCache& extids) {
+  bool more_pages = true;
+  SCassStatement stmt(qry);
+
+  stmt.setPagingSize(5000);
+
+  while (more_pages) {
+    if (m_stop) return false;
+
+    SCassFuture future = m_db.execute(stmt);
+
+    if (future.errorCode() != CASS_OK) {
+      Logger::system().error(
+          "EventIndex::%s - Error %d executing [%s]", __func__,
+          future.errorCode(), qry);
+      return false;
+    }
+
+    SCassResult res    = future.result();
+    SCassIterator rows = res.rows();
+
+    while (rows.nextRow()) {
+      SCassRow row = rows.row();
+      DAEvent event;
+      int64_t ref = 0;
+
+      if (!row.getColumn("scef_id").get(event.scef_id) ||
+          !row.getColumn("scef_ref_id").get(ref))
+        continue;
+
+      if (msisdn ? !row.getColumn("msisdn").get(event.msisdn) :
+                   !row.getColumn("extid").get(event.extid))
+        continue;
+
+      event.scef_ref_id = (uint32_t) ref;
+
+      if (!resolve(
+              event, events[EventKey(event.scef_id, event.scef_ref_id)],
+              msisdns, extids))
+        return false;
+    }
+
+    more_pages = res.morePages();
+
+    if (more_pages) stmt.setPagingState(res);
+  }
+
+  return true;
+}
+
+bool EventIndex::resolve(
+    const DAEvent& event, std::vector<SubscriberKey>& imsis,
+    MsisdnCache& msisdns, ExtIdCache& extids) {
+  DAImsiList found;
+
+  try {
+    if (event.msisdn != 0) {
+      auto it = msisdns.find(event.msisdn);
+
+      if (it == msisdns.end()) {
+        std::string imsi;
+        SubscriberKey key;
+
+        if (m_da.getImsiFromMsisdn(event.msisdn, imsi))
+          key = SubscriberKey(imsi);
+        it = msisdns.insert(std::make_pair(event.msisdn, key)).first;
+      }
+
+      if (it->second.valid()) found.push_back(it->second);
+    }
+
+    if (!event.extid.empty()) {
+      auto it = extids.find(event.extid);
+
+      if (it == extids.end()) {
+        DAImsiList lst;
+
+        m_da.getImsiListFromExtId(event.extid.c_str(), lst);
+        it = extids.insert(std::make_pair(event.extid, lst)).first;
+      }
+
+      found.insert(found.end(), it->second.begin(), it->second.end());
+    }
+  } catch (DAException& ex) {
+    Logger::system().error(
+        "EventIndex::%s - EXCEPTION - %s", __func__, ex.what());
+    return false;
+  }
+
+  // the msisdn and the external identifier can belong to the same subscriber
+  for (auto it = found.begin(); it != found.end(); ++it) {
+    bool dup = false;
+
+    for (auto iit = imsis.begin(); !dup && iit != imsis.end(); ++iit)
+      dup = *iit == *it;
+
+    if (!dup) imsis.push_back(*it);
+  }
+
+  return true;
+}
+
+void EventIndex::count(const std::vector<SubscriberKey>& imsis, bool add) {
+  SMutexLock l(m_mutex);
+
+  for (auto it = imsis.begin(); it != imsis.end(); ++it) {
+    if (add) {
+      m_counts[*it]++;
+    } else {
+      auto cit = m_counts.find(*it);
+      if (cit != m_counts.end() && --cit->second == 0) m_counts.erase(cit);
+    }
+  }
+}
@@ -26,7 +26,10 @@
 #include "s6as6d_impl.h"
 #include "s6c_impl.h"
 #include "dataaccess.h"
+#include "cassdataaccess.h"
+#include "localdataaccess.h"
 #include "common_def.h"
+#include "fdjson.h"
 #include "msg_event.h"
 
 #include "resthandler.h"
@@ -43,7 +46,7 @@ HSSWorkerQueue::HSSWorkerQueue() {}
 HSSWorkerQueue::~HSSWorkerQueue() {}
 
 void HSSWorkerQueue::addProcessor(QueueProcessor* processor) {
-  addEntry(processor);
+  addEntry(processor, processor->getQueueType());
 }
 
 void HSSWorkerQueue::startProcessor() {
@@ -51,13 +54,14 @@ void HSSWorkerQueue::startProcessor() {
   if (processor) processor->triggerNextPhase();
 }
 
-void HSSWorkerQueue::finishProcessor() {
-  finishMessage();
+void HSSWorkerQueue::finishProcessor(int type) {
+  finishMessage(type);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-FDHss::FDHss() : m_s6tapp(NULL), m_s6aapp(NULL), m_s6capp(NULL) {}
+FDHss::FDHss()
+    : m_s6tapp(NULL), m_s6aapp(NULL), m_s6capp(NULL), m_dbobj(NULL) {}
 
 FDHss::~FDHss() {
   if (NULL != m_s6tapp) {
@@ -72,11 +76,15 @@ FDHss::~FDHss() {
     delete m_s6capp;
     m_s6capp = NULL;
   }
+  if (NULL != m_dbobj) {
+    delete m_dbobj;
+    m_dbobj = NULL;
+  }
 }
 
 bool FDHss::isMmeValid(std::string& mmehost) {
   int32_t mmeid(0);
-  return m_dbobj.getMmeIdFromHost(mmehost, mmeid, NULL, NULL);
+  return m_dbobj->getMmeIdFromHost(mmehost, mmeid, NULL, NULL);
 }
 
 int FDHss::s6a_peer_validate(
@@ -109,7 +117,20 @@ int FDHss::s6a_peer_validate(
 }
 
 bool FDHss::initdb(hss_config_t* hss_config_p) {
-  m_dbobj.connect(hss_config_p->cassandra_server);
+  if (Options::getstorage() == "local") {
+    LocalDataAccess* local = new LocalDataAccess();
+    m_dbobj                = local;
+    local->open(
+        Options::getlocaldir(), Options::getlocalsnapshot(),
+        Options::getlocalsync(), Options::getlocalthreads());
+  } else {
+    CassDataAccess* cass = new CassDataAccess();
+    m_dbobj              = cass;
+    cass->subDataBin(Options::getsubdatabin());
+    cass->secBin(Options::getsecbin());
+    cass->eventIndex(Options::geteventindex());
+    cass->connect(hss_config_p->cassandra_server);
+  }
   return true;
 }
 
@@ -123,13 +144,21 @@ bool FDHss::init(hss_config_t* hss_config_p) {
       return false;
     }
 
-    std::cout << "Connecting to cassandra host: "
-              << hss_config_p->cassandra_server << std::endl;
+    if (Options::getstorage() == "local")
+      std::cout << "Using local storage: " << Options::getlocaldir()
+                << std::endl;
+    else
+      std::cout << "Connecting to cassandra host: "
+                << hss_config_p->cassandra_server << std::endl;
     // init the casssandra object with the parsed object
 
-    m_s6tapp = new s6t::Application(m_dbobj);
-    m_s6aapp = new s6as6d::Application(m_dbobj);
-    m_s6capp = new s6c::Application(m_dbobj);
+    fdJsonSetTemplateCacheSize(Options::getsubdatacache());
+    std::cout << "Loaded " << fdJsonLoadDictionary()
+              << " AVP dictionary entries" << std::endl;
+
+    m_s6tapp = new s6t::Application(*m_dbobj);
+    m_s6aapp = new s6as6d::Application(*m_dbobj);
+    m_s6capp = new s6c::Application(*m_dbobj);
 
     // advertise support for the accounting application
     FDDictionaryEntryVendor vnd3gpp(m_s6tapp->getDict().app());
@@ -163,8 +192,10 @@ bool FDHss::init(hss_config_t* hss_config_p) {
   try {
     Pistache::Address addr(
         Pistache::Ipv4::any(), Pistache::Port(Options::getrestport()));
-    auto opts = Pistache::Http::Endpoint::options().threads(1).flags(
-        Pistache::Tcp::Options::ReuseAddr);
+    auto opts = Pistache::Http::Endpoint::options()
+                    .threads(Options::getrestthreads())
+                    .maxPayload(Options::getrestmaxpayload())
+                    .flags(Pistache::Tcp::Options::ReuseAddr);
     //      .flags( Pistache::Tcp::Options::InstallSignalHandler |
     //      Pistache::Tcp::Options::ReuseAddr );
 
@@ -180,6 +211,7 @@ bool FDHss::init(hss_config_t* hss_config_p) {
         addrOss, &StatsHss::singleton(), &Logger::singleton().audit(),
         &Logger::singleton(), Options::getossfile());
     m_ossendpoint->init();
+    if (Options::getpreload()) m_ossendpoint->setReady(false);
     m_ossendpoint->start();
 
     Logger::system().startup(
@@ -204,11 +236,22 @@ bool FDHss::init(hss_config_t* hss_config_p) {
   StatsHss::singleton().setInterval(Options::statsFrequency());
   StatsHss::singleton().init(NULL);
 
+  if (Options::getpreload()) m_dbobj->preload(on_preload_callback, this);
+
   return true;
 }
 
+void FDHss::on_preload_callback(void* data) {
+  FDHss* hss = (FDHss*) data;
+  SMutexLock l(hss->m_ossmutex);
+
+  if (hss->m_ossendpoint) hss->m_ossendpoint->setReady(true);
+
+  Logger::system().startup("Preload complete, the HSS is ready");
+}
+
 void FDHss::updateOpcKeys(const uint8_t opP[16]) {
-  m_dbobj.checkOpcKeys(opP);
+  m_dbobj->checkOpcKeys(opP);
 }
 
 void FDHss::shutdown() {
@@ -220,10 +263,14 @@ void FDHss::shutdown() {
     m_endpoint = NULL;
   }
 
-  if (m_ossendpoint) {
-    m_ossendpoint->shutdown();
-    delete m_ossendpoint;
-    m_ossendpoint = NULL;
+  {
+    SMutexLock l(m_ossmutex);
+
+    if (m_ossendpoint) {
+      m_ossendpoint->shutdown();
+      delete m_ossendpoint;
+      m_ossendpoint = NULL;
+    }
   }
 
   m_diameter.uninit(false);
@@ -240,8 +287,8 @@ void FDHss::waitForShutdown() {
 
 int FDHss::sendINSDRreq(
     s6t::MonitoringEventConfigurationExtractorList& cir_monevtcfg,
-    std::string& imsi, FDMessageRequest* cir_req, EvenStatusMap* evt_map,
-    RIRBuilder* rir_builder) {
+    const SubscriberKey& imsi, FDMessageRequest* cir_req,
+    EvenStatusMap* evt_map, RIRBuilder* rir_builder) {
   return m_s6aapp->sendINSDRreq(
       cir_monevtcfg, imsi, cir_req, evt_map, rir_builder);
 }
@@ -316,7 +363,7 @@ bool FDHss::synchFix() {
 
   if (!parsehex(Options::getsynchauts().c_str(), auts, -1)) return false;
 
-  if (!m_dbobj.getImsiSec(Options::getsynchimsi(), imsisec, NULL, NULL))
+  if (!m_dbobj->getImsiSec(Options::getsynchimsi(), imsisec, NULL, NULL))
     return false;
 
   sqn = sqn_ms_derive_cpp(imsisec.opc, imsisec.key, auts, imsisec.rand);
@@ -332,7 +379,7 @@ bool FDHss::synchFix() {
     eu.u64 += 32;
     U64_TO_SQN(eu, sqn);
 
-    result = m_dbobj.updateRandSqn(
+    result = m_dbobj->updateRandSqn(
         Options::getsynchimsi(), rand, sqn, false, NULL, NULL);
 
     free(sqn);
@@ -344,67 +391,58 @@ bool FDHss::synchFix() {
   return result;
 }
 
-void FDHss::sendRIR_ChangeImsiImeiSvAssn(ImsiImeiData& data) {
-  DAEventList evt_list;
-  m_dbobj.getEventsFromImsi(data.imsi, evt_list);
-
-  for (DAEventList::iterator it_evt = evt_list.begin();
-       it_evt != evt_list.end(); ++it_evt) {
-    if ((*it_evt)->monitoring_type == CHANGE_IMSI_IMEI_SV_ASSN) {
-      uint8_t msisdn[5];
-
-      // Build the RIR for each scef to be notified
-      s6t::REIRreq* s = new s6t::REIRreq(*fdHss.gets6tApp());
-      s->add(fdHss.gets6tApp()->getDict().avpSessionId(), s->getSessionId());
-      s->add(fdHss.gets6tApp()->getDict().avpAuthSessionState(), 1);
-      s->addOrigin();
-
-      s->add(
-          fdHss.gets6tApp()->getDict().avpDestinationHost(),
-          (*it_evt)->scef_id);
-
-      size_t afound = (*it_evt)->scef_id.find(".");
-      if (afound != std::string::npos) {
-        s->add(
-            fdHss.gets6tApp()->getDict().avpDestinationRealm(),
-            (*it_evt)->scef_id.substr(afound + 1));
-      }
+void FDHss::sendRIR_ChangeImsiImeiSvAssn(
+    const std::string& imsi, int64_t msisdn, const std::string& scef_id,
+    const std::list<uint32_t>& scef_ref_ids) {
+  s6t::REIRreq* s = new s6t::REIRreq(*fdHss.gets6tApp());
+  s->add(fdHss.gets6tApp()->getDict().avpSessionId(), s->getSessionId());
+  s->add(fdHss.gets6tApp()->getDict().avpAuthSessionState(), 1);
+  s->addOrigin();
 
-      FDAvp user_identifier(fdHss.gets6tApp()->getDict().avpUserIdentifier());
-
-      user_identifier.add(
-          fdHss.gets6tApp()->getDict().avpUserName(), data.imsi);
-      std::string smsisdn = std::to_string(data.msisdn);
-      FDUtility::str2tbcd(smsisdn.c_str(), msisdn, sizeof(msisdn));
-      user_identifier.add(
-          fdHss.gets6tApp()->getDict().avpMsisdn(), msisdn, sizeof(msisdn));
-      s->add(user_identifier);
-
-      FDAvp monitoring_event_report(
-          fdHss.gets6tApp()->getDict().avpMonitoringEventReport());
-      monitoring_event_report.add(
-          fdHss.gets6tApp()->getDict().avpScefId(), (*it_evt)->scef_id);
-      monitoring_event_report.add(
-          fdHss.gets6tApp()->getDict().avpScefReferenceId(),
-          (*it_evt)->scef_ref_id);
-      monitoring_event_report.add(
-          fdHss.gets6tApp()->getDict().avpMonitoringType(),
-          CHANGE_IMSI_IMEI_SV_ASSN);
-      s->add(monitoring_event_report);
-
-      s->dump();
-
-      try {
-        if (s) {
-          s->send();
-        }
-      } catch (FDException& ex) {
-        std::cout << SUtility::currentTime() << " - EXCEPTION sending - "
-                  << ex.what() << std::endl;
-        delete s;
-        s = NULL;
-      }
-    }
+  s->add(fdHss.gets6tApp()->getDict().avpDestinationHost(), scef_id);
+
+  size_t afound = scef_id.find(".");
+  if (afound != std::string::npos) {
+    s->add(
+        fdHss.gets6tApp()->getDict().avpDestinationRealm(),
+        scef_id.substr(afound + 1));
+  }
+
+  FDAvp user_identifier(fdHss.gets6tApp()->getDict().avpUserIdentifier());
+
+  user_identifier.add(fdHss.gets6tApp()->getDict().avpUserName(), imsi);
+  if (msisdn != 0) {
+    uint8_t tbcd[8];
+    size_t len =
+        FDUtility::str2tbcd(std::to_string(msisdn), tbcd, sizeof(tbcd));
+    if (len > 0)
+      user_identifier.add(fdHss.gets6tApp()->getDict().avpMsisdn(), tbcd, len);
+  }
+  s->add(user_identifier);
+
+  // one report for each of the SCEF's references monitoring the subscriber
+  for (auto it = scef_ref_ids.begin(); it != scef_ref_ids.end(); ++it) {
+    FDAvp monitoring_event_report(
+        fdHss.gets6tApp()->getDict().avpMonitoringEventReport());
+    monitoring_event_report.add(
+        fdHss.gets6tApp()->getDict().avpScefId(), scef_id);
+    monitoring_event_report.add(
+        fdHss.gets6tApp()->getDict().avpScefReferenceId(), *it);
+    monitoring_event_report.add(
+        fdHss.gets6tApp()->getDict().avpMonitoringType(),
+        CHANGE_IMSI_IMEI_SV_ASSN);
+    s->add(monitoring_event_report);
+  }
+
+  s->dump();
+
+  try {
+    s->send();
+  } catch (FDException& ex) {
+    Logger::s6t().error(
+        "FDHss::%s - IMSI %s - EXCEPTION sending - %s", __func__,
+        imsi.c_str(), ex.what());
+    delete s;
   }
 }
 
@@ -453,14 +491,26 @@ void MonitoringConfEventStatus::forceLongTerm(bool is_long_tem) {
 ///////////////////
 /// RIRBUILDER
 ///////////////////
+
+// The encoded size of a Group-Monitoring-Event-Report-Item with a successful
+// Service-Result and of the optional Vendor-Id and S6t-HSS-Cause, and of a
+// Group-Monitoring-Event-Report without the SCEF-ID value or the items.
+#define RIR_ITEM_SIZE 84
+#define RIR_ITEM_VENDOR_ID_SIZE 12
+#define RIR_ITEM_HSS_CAUSE_SIZE 16
+#define RIR_REPORT_SIZE 40
+
 RIRBuilder::RIRBuilder(
     int nb_ida_proc, EvenStatusMap* hss_insert_status,
     std::string& destination_host, std::string& destination_realm)
-    : m_interval(0),
+    : m_interval(Options::getrirflushinterval()),
       m_nb_ida_proc(nb_ida_proc),
       m_destination_host(destination_host),
       m_destination_realm(destination_realm),
       m_hss_insert_status(hss_insert_status),
+      m_nbitems(0),
+      m_nbbytes(0),
+      m_nbsent(0),
       m_ciasent(false) {}
 
 RIRBuilder::~RIRBuilder() {}
@@ -479,6 +529,34 @@ void RIRBuilder::onTimer(SEventThread::Timer& t) {
   }
 }
 
+void RIRBuilder::addItem(
+    const std::pair<std::string, uint32_t>& event, const RIRItem& item) {
+  EventRIRItems::iterator it = m_items.find(event);
+
+  if (it == m_items.end()) {
+    it = m_items.insert(std::make_pair(event, std::vector<RIRItem>())).first;
+    m_nbbytes += RIR_REPORT_SIZE + ((event.first.size() + 3) & ~3);
+  }
+
+  it->second.push_back(item);
+
+  m_nbitems++;
+  m_nbbytes += RIR_ITEM_SIZE;
+  if (item.result != DIAMETER_SUCCESS) m_nbbytes += RIR_ITEM_VENDOR_ID_SIZE;
+  if (item.absent) m_nbbytes += RIR_ITEM_HSS_CAUSE_SIZE;
+}
+
+void RIRBuilder::checkLimits() {
+  // the SCEF does not receive an RIR before the CIA
+  if (!m_ciasent) return;
+
+  if ((Options::getrirmaxitems() > 0 &&
+       m_nbitems >= Options::getrirmaxitems()) ||
+      (Options::getrirmaxbytes() > 0 &&
+       m_nbbytes >= Options::getrirmaxbytes()))
+    sendRIR();
+}
+
 void RIRBuilder::sendRIR() {
   // build the RIR
   s6t::REIRreq* s = new s6t::REIRreq(*fdHss.gets6tApp());
@@ -491,35 +569,34 @@ void RIRBuilder::sendRIR() {
       fdHss.gets6tApp()->getDict().avpDestinationRealm(), m_destination_realm);
   s->add(fdHss.gets6tApp()->getDict().avpResultCode(), ER_DIAMETER_SUCCESS);
 
-  for (EventImsiStatus::iterator iter_imsist = imsi_status_map.begin();
-       iter_imsist != imsi_status_map.end(); ++iter_imsist) {
-    // std::cout << "imsi_status_map->first.first" << iter_imsist->first.first
-    // << "imsi_status_map->first.second" << iter_imsist->first.second <<
-    // std::endl;
-
+  for (EventRIRItems::iterator iter_event = m_items.begin();
+       iter_event != m_items.end(); ++iter_event) {
     FDAvp group_monitoring_event_report(
         fdHss.gets6tApp()->getDict().avpGroupMonitoringEventReport());
 
     group_monitoring_event_report.add(
-        fdHss.gets6tApp()->getDict().avpScefId(), iter_imsist->first.first);
+        fdHss.gets6tApp()->getDict().avpScefId(), iter_event->first.first);
     group_monitoring_event_report.add(
         fdHss.gets6tApp()->getDict().avpScefReferenceId(),
-        iter_imsist->first.second);
+        iter_event->first.second);
 
-    for (std::vector<ImsiStatus>::iterator iter_imsi =
-             iter_imsist->second.begin();
-         iter_imsi != iter_imsist->second.end(); ++iter_imsi) {
+    for (std::vector<RIRItem>::iterator iter_item = iter_event->second.begin();
+         iter_item != iter_event->second.end(); ++iter_item) {
       FDAvp group_monitoring_event_item(
           fdHss.gets6tApp()->getDict().avpGroupMonitoringEventReportItem());
 
       {
-        FDAvp user_identifier(fdHss.gets6tApp()->getDict().avpUserIdentifier());
-        uint8_t msisdn[5];
-        FDUtility::str2tbcd(iter_imsi->m_msisdn.c_str(), msisdn, 5);
-        user_identifier.add(
-            fdHss.gets6tApp()->getDict().avpMsisdn(), msisdn, 5);
-
-        group_monitoring_event_item.add(user_identifier);
+        uint8_t msisdn[8];
+        size_t len = FDUtility::str2tbcd(
+            iter_item->msisdn.str(), msisdn, sizeof(msisdn));
+
+        if (len > 0) {
+          FDAvp user_identifier(
+              fdHss.gets6tApp()->getDict().avpUserIdentifier());
+          user_identifier.add(
+              fdHss.gets6tApp()->getDict().avpMsisdn(), msisdn, len);
+          group_monitoring_event_item.add(user_identifier);
+        }
       }
 
       {
@@ -527,9 +604,9 @@ void RIRBuilder::sendRIR() {
         FDAvp serv_result(fdHss.gets6tApp()->getDict().avpServiceResult());
         serv_result.add(
             fdHss.gets6tApp()->getDict().avpServiceResultCode(),
-            iter_imsi->m_status.result);
+            iter_item->result);
 
-        if (iter_imsi->m_status.result != DIAMETER_SUCCESS) {
+        if (iter_item->result != DIAMETER_SUCCESS) {
           serv_result.add(
               fdHss.gets6tApp()->getDict().avpVendorId(), VENDOR_3GPP);
         }
@@ -538,7 +615,7 @@ void RIRBuilder::sendRIR() {
         group_monitoring_event_item.add(serv_report);
       }
 
-      if (iter_imsi->m_reachability == IMSI_NOT_ACTIVE) {
+      if (iter_item->absent) {
         group_monitoring_event_item.add(
             fdHss.gets6tApp()->getDict().avpS6tHssCause(), ABSENT_SUBSCRIBER);
       }
@@ -551,11 +628,29 @@ void RIRBuilder::sendRIR() {
   s->dump();
 
   s->send();
+
+  // the items have been reported
+  m_items.clear();
+  m_nbitems = 0;
+  m_nbbytes = 0;
+  m_nbsent++;
+}
+
+void RIRBuilder::finish() {
+  // a final RIR is only needed for items not reported yet, or if nothing
+  // has been reported
+  if (m_nbitems > 0 || m_nbsent == 0) sendRIR();
+
+  if (m_hss_insert_status != NULL) {
+    delete m_hss_insert_status;
+    m_hss_insert_status = NULL;
+  }
+  quit();
 }
 
 void RIRBuilder::dispatch(SEventThreadMessage& msg) {
   if (msg.getId() == GUARD_TIMEOUT) {
-    sendRIR();
+    if (m_ciasent && m_nbitems > 0) sendRIR();
   } else if (msg.getId() == HANDLE_MME_RESPONSE) {
     HandleMmeResponseEvtMsg& mme_response_msg = (HandleMmeResponseEvtMsg&) msg;
 
@@ -570,7 +665,7 @@ void RIRBuilder::dispatch(SEventThreadMessage& msg) {
     // of mme operations for one shot events for a given
     // imsi
     //
-    // We need to build a structure grouped by imsi containing
+    // We need to build a structure grouped by event containing
     // for each imsi: the long term db operations result (coming from
     // m_hss_insert_status) and the one shot mme operations results
     // coming from mme_response_msg.m_mme_response
@@ -579,7 +674,7 @@ void RIRBuilder::dispatch(SEventThreadMessage& msg) {
 
     for (EvenStatusMap::iterator it_hss_result = m_hss_insert_status->begin();
          it_hss_result != m_hss_insert_status->end(); ++it_hss_result) {
-      MonitoringConfEventStatus mixed_cfg = it_hss_result->second;
+      uint32_t result = it_hss_result->second.result;
 
       // Update the shorterm with the result coming from mme
       if (!it_hss_result->second.isLongTermEvt()) {
@@ -589,38 +684,20 @@ void RIRBuilder::dispatch(SEventThreadMessage& msg) {
               mme_response_msg.m_mme_response->find(it_hss_result->first);
 
           if (iter_mmeres != mme_response_msg.m_mme_response->end()) {
-            mixed_cfg.result = iter_mmeres->second.result;
+            result = iter_mmeres->second.result;
           }
         } else {
           // it is a simulated mme response because the mme was down or the ue
           // was unreachable
-          if (mme_response_msg.m_imsi_reachable == MME_DOWN) {
-            mixed_cfg.result = DIAMETER_UNABLE_TO_COMPLY;
-          } else {
-            mixed_cfg.result = DIAMETER_UNABLE_TO_COMPLY;
-          }
+          result = DIAMETER_UNABLE_TO_COMPLY;
         }
       }
 
-      ////////////////////////////
-      ////////////////////////////
-      // Fill the final structure from where the RIR will be built
-      ////////////////////////////
-      ////////////////////////////
-      ImsiStatus imsi_status(
-          mme_response_msg.m_imsi, mixed_cfg, mme_response_msg.m_imsi_reachable,
-          mme_response_msg.m_msisdn);
-      std::pair<std::string, uint32_t> ascef_id = it_hss_result->first;
-
-      EventImsiStatus::iterator imsi_statusiter =
-          imsi_status_map.find(ascef_id);
-      if (imsi_statusiter != imsi_status_map.end()) {
-        imsi_statusiter->second.push_back(imsi_status);
-      } else {
-        std::vector<ImsiStatus> list_imsi;
-        list_imsi.push_back(imsi_status);
-        imsi_status_map[ascef_id] = list_imsi;
-      }
+      addItem(
+          it_hss_result->first,
+          RIRItem(
+              mme_response_msg.m_msisdn, result,
+              mme_response_msg.m_imsi_reachable == IMSI_NOT_ACTIVE));
     }
 
     if (mme_response_msg.m_mme_response != NULL) {
@@ -629,29 +706,23 @@ void RIRBuilder::dispatch(SEventThreadMessage& msg) {
     }
 
     if (m_nb_ida_proc == 0 && m_ciasent) {
-      sendRIR();
-      if (m_hss_insert_status != NULL) {
-        delete m_hss_insert_status;
-        m_hss_insert_status = NULL;
-      }
-      quit();
+      finish();
+    } else {
+      checkLimits();
     }
   } else if (msg.getId() == HANDLE_CIA_SENT) {
     m_ciasent = true;
     if (m_nb_ida_proc == 0) {
-      sendRIR();
-      if (m_hss_insert_status != NULL) {
-        delete m_hss_insert_status;
-        m_hss_insert_status = NULL;
-      }
-      quit();
+      finish();
+    } else {
+      checkLimits();
     }
   }
 }
 
 HandleMmeResponseEvtMsg::HandleMmeResponseEvtMsg(
-    EvenStatusMap* mme_response, std::string& imsi, int imsi_reachable,
-    std::string& msisdn)
+    EvenStatusMap* mme_response, const SubscriberKey& imsi, int imsi_reachable,
+    const SubscriberKey& msisdn)
     : SEventThreadMessage(HANDLE_MME_RESPONSE),
       m_mme_response(mme_response),
       m_imsi(imsi),
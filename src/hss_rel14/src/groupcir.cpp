@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "groupcir.h"
+#include "fdjson.h"
+#include "logger.h"
+#include "options.h"
+#include "s6as6d_impl.h"
+#include "s6t.h"
+#include "scassandra.h"
+
+// the peer state and rate limit interval in milliseconds
+#define GROUP_TICK_INTERVAL 1000
+// intervals between progress reports
+#define GROUP_PROGRESS_TICKS 10
+
+static void groupJsonError(const char* err) {
+  Logger::s6t().error("GroupConfiguration - %s", err);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+GroupConfiguration::GroupConfiguration(
+    s6as6d::Application& app, DAImsiList& imsis, std::string& monevtcfg,
+    RIRBuilder* rir_builder, const std::string& origin_host)
+    : SEventThread(true),
+      m_app(app),
+      m_rir_builder(rir_builder),
+      m_origin_host(origin_host),
+      m_concurrent(Options::getgroupcirconcurrent()),
+      m_rate(Options::getgroupidrrate()),
+      m_next(0),
+      m_outstanding(0),
+      m_completed(0),
+      m_sent(0),
+      m_notactive(0),
+      m_mmedown(0),
+      m_done(false),
+      m_ticks(0) {
+  m_imsis.swap(imsis);
+  m_monevtcfg.swap(monevtcfg);
+
+  if (m_concurrent < 1) m_concurrent = 1;
+}
+
+GroupConfiguration::~GroupConfiguration() {}
+
+bool GroupConfiguration::encodeMonitoringEventConfiguration(
+    s6t::MonitoringEventConfigurationExtractorList& cfg, std::string& bin) {
+  bool result = true;
+
+  bin.clear();
+
+  for (std::list<FDExtractor*>::iterator it = cfg.getList().begin();
+       it != cfg.getList().end(); ++it) {
+    std::string json;
+    std::string encoded;
+
+    if (!(*it)->getJson(json)) continue;
+
+    if (fdJsonEncodeAvps(json.c_str(), encoded, groupJsonError) !=
+        FDJSON_SUCCESS) {
+      result = false;
+      continue;
+    }
+
+    bin.append(encoded);
+  }
+
+  return result;
+}
+
+void GroupConfiguration::onInit() {
+  Logger::s6t().info(
+      "GroupConfiguration - starting group configuration from %s for %zu "
+      "subscribers",
+      m_origin_host.c_str(), m_imsis.size());
+
+  m_timer.setInterval(GROUP_TICK_INTERVAL);
+  m_timer.setOneShot(false);
+  initTimer(m_timer);
+  m_timer.start();
+
+  lookup();
+}
+
+void GroupConfiguration::onQuit() {
+  m_timer.destroy();
+}
+
+void GroupConfiguration::onTimer(SEventThread::Timer& t) {
+  if (t.getId() != m_timer.getId() || m_done) return;
+
+  // the peer states are checked again and the rate limits restart, the
+  // requests held back for an MME are sent up to its new limit
+  for (auto it = m_mmes.begin(); it != m_mmes.end(); ++it) {
+    MmeState& mme = it->second;
+
+    mme.checked = false;
+    mme.sent    = 0;
+
+    while (!mme.pending.empty() && (m_rate == 0 || mme.sent < m_rate)) {
+      GroupLookup* l = mme.pending.front();
+      mme.pending.pop_front();
+
+      if (mmeReachable(mme, it->first))
+        send(mme, l);
+      else
+        report(l, MME_DOWN);
+    }
+  }
+
+  lookup();
+
+  if (!m_done && ++m_ticks % GROUP_PROGRESS_TICKS == 0)
+    logProgress("in progress");
+}
+
+void GroupConfiguration::dispatch(SEventThreadMessage& msg) {
+  if (msg.getId() == GROUP_LOOKUP_COMPLETE) {
+    process(((GroupLookupMsg&) msg).m_lookup);
+    lookup();
+  }
+}
+
+void GroupConfiguration::on_lookup_callback(CassFuture* future, void* data) {
+  SCassFuture f(future, true);
+  GroupLookup* l = (GroupLookup*) data;
+
+  try {
+    l->found = l->group.m_app.dataaccess().getImsiInfoData(f, l->info);
+  } catch (DAException& ex) {
+    Logger::s6t().error(
+        "GroupConfiguration::%s - IMSI %s - EXCEPTION - %s", __func__,
+        l->imsi.str().c_str(), ex.what());
+    l->found = false;
+  }
+
+  l->group.postMessage(new GroupLookupMsg(l));
+}
+
+// issues the subscriber information queries for the next members of the
+// group, up to the configured number of outstanding members
+void GroupConfiguration::lookup() {
+  while (m_outstanding < m_concurrent && m_next < m_imsis.size()) {
+    GroupLookup* l = new GroupLookup(*this, m_imsis[m_next++]);
+    bool issued    = false;
+
+    m_outstanding++;
+
+    try {
+      issued = m_app.dataaccess().getImsiInfo(
+          l->imsi.str().c_str(), l->info, on_lookup_callback, l);
+    } catch (DAException& ex) {
+      Logger::s6t().error(
+          "GroupConfiguration::%s - IMSI %s - EXCEPTION - %s", __func__,
+          l->imsi.str().c_str(), ex.what());
+    }
+
+    if (!issued) process(l);
+  }
+
+  if (m_completed == m_imsis.size() && !m_done) {
+    m_done = true;
+    logProgress("complete");
+    quit();
+  }
+}
+
+void GroupConfiguration::process(GroupLookup* l) {
+  if (!l->found || l->info.ms_ps_status != "ATTACHED") {
+    report(l, IMSI_NOT_ACTIVE);
+    return;
+  }
+
+  MmeState& mme = m_mmes[l->info.mmehost];
+
+  if (!mmeReachable(mme, l->info.mmehost))
+    report(l, MME_DOWN);
+  else if (m_rate != 0 && (mme.sent >= m_rate || !mme.pending.empty()))
+    mme.pending.push_back(l);
+  else
+    send(mme, l);
+}
+
+bool GroupConfiguration::mmeReachable(MmeState& mme, const std::string& host) {
+  if (!mme.checked) {
+    FDPeer peer;
+    peer.setDiameterId((DiamId_t) host.c_str());
+
+    mme.reachable = (peer.getState() == PSOpen);
+    mme.checked   = true;
+
+    if (!mme.reachable)
+      Logger::s6t().debug(
+          "GroupConfiguration::%s - MME_DOWN: %s", __func__, host.c_str());
+  }
+
+  return mme.reachable;
+}
+
+void GroupConfiguration::send(MmeState& mme, GroupLookup* l) {
+  mme.sent++;
+
+  if (!m_app.sendINSDRreq(m_monevtcfg, l->imsi, l->info, m_rir_builder)) {
+    report(l, MME_DOWN);
+    return;
+  }
+
+  // the IDA is reported to the RIR builder when it is received
+  m_sent++;
+  release(l);
+}
+
+// reports the status of a member whose INSDR Request was not sent
+void GroupConfiguration::report(GroupLookup* l, int reachability) {
+  if (reachability == IMSI_NOT_ACTIVE)
+    m_notactive++;
+  else
+    m_mmedown++;
+
+  m_rir_builder->postMessage(new HandleMmeResponseEvtMsg(
+      NULL, l->imsi, reachability, SubscriberKey::fromValue(l->info.msisdn)));
+
+  release(l);
+}
+
+void GroupConfiguration::release(GroupLookup* l) {
+  delete l;
+  m_outstanding--;
+  m_completed++;
+}
+
+void GroupConfiguration::logProgress(const char* state) {
+  Logger::s6t().info(
+      "GroupConfiguration - group configuration from %s %s - %zu of %zu "
+      "subscribers processed, %zu IDR sent, %zu not attached, %zu MME down",
+      m_origin_host.c_str(), state, m_completed, m_imsis.size(), m_sent,
+      m_notactive, m_mmedown);
+}
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <map>
+#include <sstream>
+#include <unordered_map>
+
+#include "common_def.h"
+#include "imeichange.h"
+#include "logger.h"
+#include "options.h"
+#include "scassandra.h"
+
+SMutex ImeiChangeProcessor::m_addmutex;
+ImeiChangeProcessor* ImeiChangeProcessor::m_open = NULL;
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void ImeiChangeStateProcessor::process() {
+  if (!m_processor) return;
+
+  if (m_state == IMEICHANGE_PHASE1) {
+    m_processor->phase1();
+  } else {
+    m_processor->phaseFinal();
+    delete m_processor;
+    fdHss.getWorkerQueue().finishProcessor(HSS_QUEUE_OTHER);
+    fdHss.getWorkerQueue().startProcessor();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+ImeiChangeProcessor::ImeiChangeProcessor()
+    : QueueProcessor(HSS_QUEUE_OTHER), m_outstanding(0) {}
+
+ImeiChangeProcessor::~ImeiChangeProcessor() {
+  for (auto it = m_lookups.begin(); it != m_lookups.end(); ++it) delete *it;
+}
+
+void ImeiChangeProcessor::add(const ImsiImeiData& data) {
+  size_t batch = Options::getimeichangebatch();
+  ImeiChangeProcessor* p;
+
+  if (batch < 1) batch = 1;
+
+  {
+    SMutexLock l(m_addmutex);
+
+    // the notification joins the batch of the processor that has not
+    // started yet, if there is room
+    if (m_open && m_open->m_batch.size() < batch) {
+      m_open->m_batch.push_back(data);
+      return;
+    }
+
+    p = m_open = new ImeiChangeProcessor();
+    p->m_batch.push_back(data);
+  }
+
+  fdHss.getWorkerQueue().addProcessor(p);
+  fdHss.getWorkerQueue().startProcessor();
+}
+
+void ImeiChangeProcessor::triggerNextPhase() {
+  fdHss.getWorkMgr().addWork(new WorkerMessage(
+      WORKER_EVENT, new ImeiChangeStateProcessor(IMEICHANGE_PHASE1, this)));
+}
+
+void ImeiChangeProcessor::phase1() {
+  std::unordered_map<std::string, size_t> index;
+
+  {
+    SMutexLock l(m_addmutex);
+    if (m_open == this) m_open = NULL;
+  }
+
+  // a subscriber is looked up and reported once per batch, with the MSISDN
+  // of its latest notification
+  for (auto it = m_batch.begin(); it != m_batch.end(); ++it) {
+    auto r = index.insert(std::make_pair(it->imsi, m_lookups.size()));
+
+    if (r.second)
+      m_lookups.push_back(new ImeiChangeLookup(*this, *it));
+    else if (it->msisdn)
+      m_lookups[r.first->second]->msisdn = it->msisdn;
+  }
+
+  Logger::s6t().debug(
+      "ImeiChangeProcessor::%s - %zu notifications for %zu subscribers",
+      __func__, m_batch.size(), m_lookups.size());
+
+  m_batch.clear();
+
+  // the extra reference keeps the batch from completing while the lookups
+  // are being issued
+  m_outstanding = m_lookups.size() + 1;
+
+  for (auto it = m_lookups.begin(); it != m_lookups.end(); ++it) {
+    issue(**it, new ImeiChangeQuery(IMEICHANGEDB_GET_IMSI_INFO, **it));
+    release(**it);
+  }
+
+  lookupComplete();
+}
+
+void ImeiChangeProcessor::phaseFinal() {
+  for (auto it = m_lookups.begin(); it != m_lookups.end(); ++it) {
+    report(**it);
+    delete *it;
+  }
+
+  m_lookups.clear();
+}
+
+void ImeiChangeProcessor::on_query_callback(CassFuture* future, void* data) {
+  SCassFuture f(future, true);
+  ImeiChangeQuery* q = (ImeiChangeQuery*) data;
+
+  q->getLookup().processor.completed(q, f);
+}
+
+void ImeiChangeProcessor::issue(ImeiChangeLookup& l, ImeiChangeQuery* q) {
+  DataAccess& db = fdHss.getDb();
+  bool issued    = false;
+
+  atomic_inc_fetch(l.pending);
+
+  try {
+    switch (q->getAction()) {
+      case IMEICHANGEDB_GET_IMSI_INFO: {
+        issued = db.getImsiInfo(l.imsi, l.info, on_query_callback, q);
+        break;
+      }
+      case IMEICHANGEDB_GET_EXT_IDS: {
+        issued = db.getExtIdsFromImsi(l.imsi, q->extids, on_query_callback, q);
+        break;
+      }
+      case IMEICHANGEDB_GET_EVNTIDS_MSISDN: {
+        issued = db.getEventIdsFromMsisdn(
+            l.info.msisdn, q->evtids, on_query_callback, q);
+        break;
+      }
+      case IMEICHANGEDB_GET_EVNTIDS_EXTIDS: {
+        std::stringstream ss;
+
+        for (auto it = q->extids.begin(); it != q->extids.end(); ++it)
+          ss << (it == q->extids.begin() ? "'" : ",'") << *it << "'";
+
+        issued =
+            db.getEventIdsFromExtIds(ss.str(), q->evtids, on_query_callback, q);
+        break;
+      }
+      case IMEICHANGEDB_GET_EVNTS_EVNTIDS: {
+        issued = db.getEvents(
+            q->scef_id.c_str(), q->scef_ref_ids, q->events, on_query_callback,
+            q);
+        break;
+      }
+    }
+  } catch (DAException& ex) {
+    Logger::s6t().error(
+        "ImeiChangeProcessor::%s - IMSI %s - EXCEPTION - %s", __func__,
+        l.imsi.c_str(), ex.what());
+  }
+
+  if (!issued) {
+    delete q;
+    release(l);
+  }
+}
+
+void ImeiChangeProcessor::completed(ImeiChangeQuery* q, SCassFuture& future) {
+  ImeiChangeLookup& l = q->getLookup();
+  DataAccess& db      = fdHss.getDb();
+
+  try {
+    switch (q->getAction()) {
+      case IMEICHANGEDB_GET_IMSI_INFO: {
+        l.found = db.getImsiInfoData(future, l.info);
+        if (l.found) {
+          if (l.msisdn == 0) l.msisdn = l.info.msisdn;
+          issue(l, new ImeiChangeQuery(IMEICHANGEDB_GET_EXT_IDS, l));
+          if (l.info.msisdn != 0)
+            issue(l, new ImeiChangeQuery(IMEICHANGEDB_GET_EVNTIDS_MSISDN, l));
+        }
+        break;
+      }
+      case IMEICHANGEDB_GET_EXT_IDS: {
+        if (db.getExtIdsFromImsiData(future, q->extids) &&
+            !q->extids.empty()) {
+          ImeiChangeQuery* eq =
+              new ImeiChangeQuery(IMEICHANGEDB_GET_EVNTIDS_EXTIDS, l);
+          eq->extids.swap(q->extids);
+          issue(l, eq);
+        }
+        break;
+      }
+      case IMEICHANGEDB_GET_EVNTIDS_MSISDN: {
+        if (db.getEventIdsFromMsisdnData(future, q->evtids)) {
+          SMutexLock lock(l.mutex);
+          l.evtids.splice(l.evtids.end(), q->evtids);
+        }
+        break;
+      }
+      case IMEICHANGEDB_GET_EVNTIDS_EXTIDS: {
+        if (db.getEventIdsFromExtIdsData(future, q->evtids)) {
+          SMutexLock lock(l.mutex);
+          l.evtids.splice(l.evtids.end(), q->evtids);
+        }
+        break;
+      }
+      case IMEICHANGEDB_GET_EVNTS_EVNTIDS: {
+        if (db.getEventsData(future, q->events)) {
+          SMutexLock lock(l.mutex);
+          l.events.splice(l.events.end(), q->events);
+        }
+        break;
+      }
+    }
+  } catch (DAException& ex) {
+    Logger::s6t().error(
+        "ImeiChangeProcessor::%s - IMSI %s - EXCEPTION - %s", __func__,
+        l.imsi.c_str(), ex.what());
+  }
+
+  delete q;
+  release(l);
+}
+
+// retrieves the events once the event id's from the MSISDN and the external
+// identifiers have been collected, a query per SCEF
+void ImeiChangeProcessor::getEvents(ImeiChangeLookup& l) {
+  ImeiChangeQuery* q = NULL;
+
+  // an event may be found through both the MSISDN and an external identifier
+  l.evtids.sort(DAEventIdList::compare);
+
+  for (auto it = l.evtids.begin(); it != l.evtids.end(); ++it) {
+    if (q && q->scef_id == (*it)->scef_id &&
+        q->scef_ref_ids.back() == (*it)->scef_ref_id)
+      continue;
+
+    if (q && q->scef_id != (*it)->scef_id) {
+      issue(l, q);
+      q = NULL;
+    }
+
+    if (!q) {
+      q          = new ImeiChangeQuery(IMEICHANGEDB_GET_EVNTS_EVNTIDS, l);
+      q->scef_id = (*it)->scef_id;
+    }
+
+    q->scef_ref_ids.push_back((*it)->scef_ref_id);
+  }
+
+  if (q) issue(l, q);
+}
+
+void ImeiChangeProcessor::release(ImeiChangeLookup& l) {
+  if (atomic_dec_fetch(l.pending) > 0) return;
+
+  // the lookup has no other queries outstanding at this point
+  if (l.found && !l.eventsissued) {
+    l.eventsissued = true;
+    atomic_inc_fetch(l.pending);
+    getEvents(l);
+    release(l);
+    return;
+  }
+
+  lookupComplete();
+}
+
+void ImeiChangeProcessor::lookupComplete() {
+  if (atomic_dec_fetch(m_outstanding) > 0) return;
+
+  // the RIR's are sent from a worker thread rather than the driver thread
+  // that completed the last query
+  fdHss.getWorkMgr().addWork(new WorkerMessage(
+      WORKER_EVENT,
+      new ImeiChangeStateProcessor(IMEICHANGE_PHASEFINAL, this)));
+}
+
+void ImeiChangeProcessor::report(ImeiChangeLookup& l) {
+  std::map<std::string, std::list<uint32_t>> scefs;
+
+  if (!l.found) {
+    Logger::s6t().debug(
+        "ImeiChangeProcessor::%s - IMSI %s not found", __func__,
+        l.imsi.c_str());
+    return;
+  }
+
+  for (auto it = l.events.begin(); it != l.events.end(); ++it) {
+    if ((*it)->monitoring_type == CHANGE_IMSI_IMEI_SV_ASSN)
+      scefs[(*it)->scef_id].push_back((*it)->scef_ref_id);
+  }
+
+  for (auto it = scefs.begin(); it != scefs.end(); ++it)
+    fdHss.sendRIR_ChangeImsiImeiSvAssn(l.imsi, l.msisdn, it->first, it->second);
+}
@@ -0,0 +1,1571 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <algorithm>
+
+#include "localdataaccess.h"
+#include "common_def.h"
+#include "sutility.h"
+
+#include "util.h"
+#include "logger.h"
+
+extern "C" {
+#include "auc.h"
+}
+
+#define LOCAL_COMPLETION 1
+#define LOCAL_COMPLETION_SHUTDOWN 2
+
+// a larger length in a record header can only be the result of corruption
+#define LOCAL_MAX_RECORD (64 * 1024 * 1024)
+
+enum LocalRecordType {
+  lrPutImsi = 1,
+  lrDelImsi,
+  lrSetSec,
+  lrSetLocation,
+  lrPutMme,
+  lrPutEvent,
+  lrDelEvent,
+  lrEventBatch,
+  lrDelMme
+};
+
+// prefixes each record in the log and snapshot files, the values are in host
+// byte order
+struct LocalRecordHeader {
+  uint32_t length;
+  uint32_t checksum;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Serialized form of a single change.  The first byte is the record type
+// followed by the fields of the record, strings are length prefixed.
+//
+class LocalRecord {
+ public:
+  LocalRecord(LocalRecordType type) : m_pos(0) { putU8(type); }
+  LocalRecord(const char* data, size_t len) : m_buf(data, len), m_pos(0) {}
+
+  const std::string& buffer() { return m_buf; }
+  void rewind() { m_pos = 0; }
+
+  void putU8(uint8_t v) { put(&v, sizeof(v)); }
+  void putU32(uint32_t v) { put(&v, sizeof(v)); }
+  void putI32(int32_t v) { put(&v, sizeof(v)); }
+  void putI64(int64_t v) { put(&v, sizeof(v)); }
+  void putBytes(const uint8_t* v, size_t len) { put(v, len); }
+  void putStr(const std::string& v) {
+    putU32(v.size());
+    put(v.data(), v.size());
+  }
+
+  uint8_t getU8() {
+    uint8_t v;
+    get(&v, sizeof(v));
+    return v;
+  }
+  uint32_t getU32() {
+    uint32_t v;
+    get(&v, sizeof(v));
+    return v;
+  }
+  int32_t getI32() {
+    int32_t v;
+    get(&v, sizeof(v));
+    return v;
+  }
+  int64_t getI64() {
+    int64_t v;
+    get(&v, sizeof(v));
+    return v;
+  }
+  void getBytes(uint8_t* v, size_t len) { get(v, len); }
+  std::string getStr() {
+    uint32_t len = getU32();
+    if (len > m_buf.size() - m_pos)
+      throw DAException("LocalRecord::getStr - record truncated");
+    std::string v(m_buf, m_pos, len);
+    m_pos += len;
+    return v;
+  }
+
+  static uint32_t checksum(const char* data, size_t len) {
+    // FNV-1a
+    uint32_t h = 2166136261U;
+    for (size_t i = 0; i < len; i++) {
+      h ^= (uint8_t) data[i];
+      h *= 16777619U;
+    }
+    return h;
+  }
+
+  void frame(std::string& out) {
+    LocalRecordHeader hdr;
+    hdr.length   = m_buf.size();
+    hdr.checksum = checksum(m_buf.data(), m_buf.size());
+    out.append((const char*) &hdr, sizeof(hdr));
+    out.append(m_buf);
+  }
+
+ private:
+  LocalRecord();
+
+  void put(const void* v, size_t len) { m_buf.append((const char*) v, len); }
+  void get(void* v, size_t len) {
+    if (len > m_buf.size() - m_pos)
+      throw DAException("LocalRecord::get - record truncated");
+    memcpy(v, m_buf.data() + m_pos, len);
+    m_pos += len;
+  }
+
+  std::string m_buf;
+  size_t m_pos;
+};
+
+static bool writeAll(int fd, const char* data, size_t len) {
+  while (len > 0) {
+    ssize_t n = write(fd, data, len);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    data += n;
+    len -= n;
+  }
+  return true;
+}
+
+// the logs rotated by LocalDataAccess::startSnapshot(), hss.log.<seq>, in the
+// order they were written
+static std::vector<std::pair<uint32_t, std::string>> rotatedLogs(
+    const std::string& dir) {
+  std::vector<std::pair<uint32_t, std::string>> logs;
+  const std::string prefix(LOCAL_LOG_FILE ".");
+  DIR* d = opendir(dir.c_str());
+
+  if (!d) return logs;
+
+  struct dirent* ent;
+  while ((ent = readdir(d)) != NULL) {
+    const char* seq = ent->d_name + prefix.size();
+    char* end;
+
+    if (strncmp(ent->d_name, prefix.c_str(), prefix.size()) != 0 ||
+        !isdigit(*seq))
+      continue;
+
+    unsigned long n = strtoul(seq, &end, 10);
+    if (*end == '\0')
+      logs.push_back(std::make_pair((uint32_t) n, dir + "/" + ent->d_name));
+  }
+
+  closedir(d);
+  std::sort(logs.begin(), logs.end());
+
+  return logs;
+}
+
+static void encodeSubscriber(LocalRecord& rec, const LocalSubscriber& sub) {
+  rec.putStr(sub.info.imsi);
+  rec.putI64(sub.info.msisdn);
+  rec.putI32(sub.info.access_restriction);
+  rec.putStr(sub.info.subscription_data);
+  rec.putStr(sub.info.subscription_data_bin);
+  rec.putStr(sub.info.ms_ps_status);
+  rec.putStr(sub.info.mmehost);
+  rec.putStr(sub.info.mmerealm);
+  rec.putI32(sub.info.mme_id);
+  rec.putStr(sub.info.visited_plmnid);
+  rec.putStr(sub.info.imei);
+  rec.putStr(sub.info.imei_sv);
+  rec.putBytes(sub.sec.key, KEY_LENGTH);
+  rec.putBytes(sub.sec.opc, OPC_LENGTH);
+  rec.putBytes(sub.sec.rand, RAND_LENGTH);
+  rec.putBytes(sub.sec.sqn, SQN_LENGTH);
+  rec.putStr(sub.niddvalidity);
+  rec.putStr(sub.nir_dest_host);
+  rec.putStr(sub.nir_dest_realm);
+  rec.putU32(sub.extids.size());
+  for (auto it = sub.extids.begin(); it != sub.extids.end(); ++it)
+    rec.putStr(*it);
+}
+
+static void decodeSubscriber(LocalRecord& rec, LocalSubscriber& sub) {
+  sub.info.imsi                  = rec.getStr();
+  sub.info.msisdn                = rec.getI64();
+  sub.info.str_msisdn            = std::to_string(sub.info.msisdn);
+  sub.info.access_restriction    = rec.getI32();
+  sub.info.subscription_data     = rec.getStr();
+  sub.info.subscription_data_bin = rec.getStr();
+  sub.info.ms_ps_status          = rec.getStr();
+  sub.info.mmehost               = rec.getStr();
+  sub.info.mmerealm              = rec.getStr();
+  sub.info.mme_id                = rec.getI32();
+  sub.info.visited_plmnid        = rec.getStr();
+  sub.info.imei                  = rec.getStr();
+  sub.info.imei_sv               = rec.getStr();
+  rec.getBytes(sub.sec.key, KEY_LENGTH);
+  rec.getBytes(sub.sec.opc, OPC_LENGTH);
+  rec.getBytes(sub.sec.rand, RAND_LENGTH);
+  rec.getBytes(sub.sec.sqn, SQN_LENGTH);
+  sub.niddvalidity   = rec.getStr();
+  sub.nir_dest_host  = rec.getStr();
+  sub.nir_dest_realm = rec.getStr();
+  for (uint32_t cnt = rec.getU32(); cnt > 0; cnt--)
+    sub.extids.insert(rec.getStr());
+}
+
+static void encodeEvent(LocalRecord& rec, const DAEvent& event) {
+  rec.putStr(event.scef_id);
+  rec.putU32(event.scef_ref_id);
+  rec.putI64(event.msisdn);
+  rec.putStr(event.extid);
+  rec.putStr(event.ui_json);
+  rec.putStr(event.mec_json);
+  rec.putI32(event.monitoring_type);
+}
+
+static void decodeEvent(LocalRecord& rec, DAEvent& event) {
+  event.scef_id         = rec.getStr();
+  event.scef_ref_id     = rec.getU32();
+  event.msisdn          = rec.getI64();
+  event.extid           = rec.getStr();
+  event.ui_json         = rec.getStr();
+  event.mec_json        = rec.getStr();
+  event.monitoring_type = rec.getI32();
+}
+
+static void encodeMme(
+    LocalRecord& rec, int32_t id, const DAMmeIdentity& mme) {
+  rec.putI32(id);
+  rec.putStr(mme.mme_host);
+  rec.putStr(mme.mme_realm);
+  rec.putStr(mme.mme_isdn);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+LocalCompletion::LocalCompletion(CassFutureCallback cb, void* data)
+    : SQueueMessage(LOCAL_COMPLETION), m_cb(cb), m_data(data) {}
+
+LocalCompletionThread::LocalCompletionThread(LocalDataAccess& local)
+    : m_local(local) {}
+
+LocalCompletionThread::~LocalCompletionThread() {}
+
+unsigned long LocalCompletionThread::threadProc(void* arg) {
+  while (true) {
+    SQueueMessage* msg = m_local.m_completions.pop();
+
+    if (!msg) continue;
+
+    if (msg->getId() == LOCAL_COMPLETION_SHUTDOWN) {
+      delete msg;
+      break;
+    }
+
+    LocalCompletion* c = (LocalCompletion*) msg;
+    c->cb()(NULL, c->data());
+    delete c;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+LocalSnapshotThread::LocalSnapshotThread(
+    const std::string& dir, std::string* data, uint32_t logseq,
+    size_t subscribers)
+    : m_dir(dir),
+      m_data(data),
+      m_logseq(logseq),
+      m_subscribers(subscribers),
+      m_ok(false) {}
+
+LocalSnapshotThread::~LocalSnapshotThread() {
+  delete m_data;
+}
+
+unsigned long LocalSnapshotThread::threadProc(void* arg) {
+  std::string snapshot = m_dir + "/" LOCAL_SNAPSHOT_FILE;
+  std::string tmp      = snapshot + ".tmp";
+
+  int fd  = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  bool ok = fd != -1 && writeAll(fd, m_data->data(), m_data->size()) &&
+            fsync(fd) == 0;
+
+  if (fd != -1) ::close(fd);
+
+  delete m_data;
+  m_data = NULL;
+
+  if (!ok || rename(tmp.c_str(), snapshot.c_str()) != 0) {
+    int err = errno;
+    unlink(tmp.c_str());
+    Logger::system().error(
+        "LocalSnapshotThread::%s - Error writing %s - errno=%d", __func__,
+        snapshot.c_str(), err);
+    return 0;
+  }
+
+  // the rotated logs are reflected in the snapshot, if the process stops
+  // before they are removed they are applied on top of it which leaves the
+  // same result
+  auto logs = rotatedLogs(m_dir);
+  for (auto it = logs.begin(); it != logs.end() && it->first <= m_logseq;
+       ++it) {
+    if (unlink(it->second.c_str()) != 0)
+      Logger::system().error(
+          "LocalSnapshotThread::%s - Unable to remove %s - errno=%d",
+          __func__, it->second.c_str(), errno);
+  }
+
+  m_ok = true;
+
+  Logger::system().info(
+      "LocalSnapshotThread::%s - wrote snapshot of %zu subscribers to %s",
+      __func__, m_subscribers, snapshot.c_str());
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+LocalDataAccess::LocalDataAccess()
+    : m_logfd(-1),
+      m_sync(false),
+      m_snapshotinterval(0),
+      m_logrecords(0),
+      m_logseq(1),
+      m_snapshotthread(NULL) {}
+
+LocalDataAccess::~LocalDataAccess() {
+  close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////// PUBLIC METHODS /////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void LocalDataAccess::open(
+    const std::string& dir, uint32_t snapshot_interval, bool sync,
+    int threads) {
+  m_dir              = dir;
+  m_sync             = sync;
+  m_snapshotinterval = snapshot_interval;
+
+  if (!m_dir.empty()) {
+    if (mkdir(m_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+      throw DAException(SUtility::string_format(
+          "LocalDataAccess::%s - Unable to create directory %s - errno=%d",
+          __func__, m_dir.c_str(), errno));
+    }
+
+    std::string snapshot = m_dir + "/" LOCAL_SNAPSHOT_FILE;
+    std::string log      = m_dir + "/" LOCAL_LOG_FILE;
+
+    // the logs rotated by a snapshot that did not complete are replayed
+    // before the current log, and counted so a snapshot replaces them soon
+    uint64_t records = 0;
+    auto logs        = rotatedLogs(m_dir);
+
+    load(snapshot, false);
+    for (auto it = logs.begin(); it != logs.end(); ++it) {
+      records += load(it->second, true);
+      m_logseq = it->first + 1;
+    }
+    m_logrecords = records + load(log, true);
+
+    m_logfd = ::open(log.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (m_logfd == -1) {
+      throw DAException(SUtility::string_format(
+          "LocalDataAccess::%s - Unable to open %s - errno=%d", __func__,
+          log.c_str(), errno));
+    }
+
+    Logger::system().startup(
+        "LocalDataAccess::%s - loaded %zu subscribers and %zu mme "
+        "identities from %s",
+        __func__, m_subscribers.size(), m_mmes.size(), m_dir.c_str());
+  }
+
+  for (int i = 0; i < threads; i++) {
+    LocalCompletionThread* t = new LocalCompletionThread(*this);
+    t->init(NULL);
+    m_threads.push_back(t);
+  }
+}
+
+void LocalDataAccess::close() {
+  for (size_t i = 0; i < m_threads.size(); i++)
+    m_completions.push(LOCAL_COMPLETION_SHUTDOWN);
+
+  for (auto it = m_threads.begin(); it != m_threads.end(); ++it) {
+    (*it)->join();
+    delete *it;
+  }
+
+  m_threads.clear();
+
+  if (m_logfd != -1) {
+    // start from a compact snapshot the next time the data is loaded
+    try {
+      snapshot();
+    } catch (DAException& ex) {
+      Logger::system().error(
+          "LocalDataAccess::%s - EXCEPTION - %s", __func__, ex.what());
+    }
+
+    ::close(m_logfd);
+    m_logfd = -1;
+  }
+}
+
+bool LocalDataAccess::snapshot() {
+  SMutexLock l(m_mutex);
+
+  if (m_logfd == -1) return false;
+
+  // the snapshot thread does not lock m_mutex, so it is waited for here
+  waitSnapshot();
+  startSnapshot();
+
+  return waitSnapshot();
+}
+
+size_t LocalDataAccess::subscriberCount() {
+  SMutexLock l(m_mutex);
+  return m_subscribers.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool LocalDataAccess::addImsi(const DAImsiInfo& info, const DAImsiSec& sec) {
+  SMutexLock l(m_mutex);
+
+  LocalSubscriber sub;
+  SubscriberKey key(info.imsi);
+
+  if (!key.valid()) return false;
+
+  auto it = m_subscribers.find(key);
+  if (it != m_subscribers.end()) sub = it->second;
+
+  sub.info = info;
+  sub.sec  = sec;
+
+  putSubscriber(sub);
+
+  return true;
+}
+
+bool LocalDataAccess::deleteImsi(const std::string& imsi) {
+  SMutexLock l(m_mutex);
+
+  if (m_subscribers.find(SubscriberKey(imsi)) == m_subscribers.end()) return false;
+
+  LocalRecord rec(lrDelImsi);
+  rec.putStr(imsi);
+  commit(rec);
+
+  return true;
+}
+
+bool LocalDataAccess::addExtId(
+    const std::string& imsi, const std::string& extid) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return false;
+
+  LocalSubscriber sub = it->second;
+  sub.extids.insert(extid);
+  putSubscriber(sub);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool LocalDataAccess::addEvent(DAEvent& event) {
+  SMutexLock l(m_mutex);
+
+  LocalRecord rec(lrPutEvent);
+  encodeEvent(rec, event);
+  commit(rec);
+
+  return true;
+}
+
+bool LocalDataAccess::getEvent(
+    const char* scef_id, uint32_t scef_ref_id, DAEvent& event) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_events.find(scef_id);
+  if (it == m_events.end()) return false;
+
+  auto eit = it->second.find(scef_ref_id);
+  if (eit == it->second.end()) return false;
+
+  event = eit->second;
+
+  return true;
+}
+
+bool LocalDataAccess::getEvents(
+    const char* scef_id, std::list<uint32_t> scef_ref_ids, DAEventList& events,
+    CassFutureCallback cb, void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    auto it = m_events.find(scef_id);
+    if (it != m_events.end()) {
+      for (auto rit = scef_ref_ids.begin(); rit != scef_ref_ids.end(); ++rit) {
+        auto eit = it->second.find(*rit);
+        if (eit != it->second.end()) events.push_back(new DAEvent(eit->second));
+      }
+    }
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::getEventsData(SCassFuture& future, DAEventList& events) {
+  return true;
+}
+
+void LocalDataAccess::deleteEvent(const char* scef_id, uint32_t scef_ref_id) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_events.find(scef_id);
+  if (it == m_events.end() || it->second.find(scef_ref_id) == it->second.end())
+    return;
+
+  LocalRecord rec(lrDelEvent);
+  rec.putStr(scef_id);
+  rec.putU32(scef_ref_id);
+  commit(rec);
+}
+
+bool LocalDataAccess::applyEvents(
+    DAEventBatch& batch, CassFutureCallback cb, void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    // a single record, so a batch is either replayed completely or not at all
+    LocalRecord rec(lrEventBatch);
+
+    rec.putU32(batch.removes().size());
+    for (auto it = batch.removes().begin(); it != batch.removes().end();
+         ++it) {
+      rec.putStr(it->scef_id);
+      rec.putU32(it->scef_ref_id);
+    }
+
+    rec.putU32(batch.adds().size());
+    for (auto it = batch.adds().begin(); it != batch.adds().end(); ++it)
+      encodeEvent(rec, *it);
+
+    commit(rec);
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::applyEventsData(SCassFuture& future) {
+  return true;
+}
+
+bool LocalDataAccess::mayHaveEvents(const char* imsi) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return false;
+
+  if (m_msisdnevents.count(it->second.info.msisdn)) return true;
+
+  for (auto eit = it->second.extids.begin(); eit != it->second.extids.end();
+       ++eit)
+    if (m_extidevents.count(*eit)) return true;
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool LocalDataAccess::checkMSISDNExists(int64_t msisdn) {
+  SMutexLock l(m_mutex);
+  return m_msisdns.find(msisdn) != m_msisdns.end();
+}
+
+bool LocalDataAccess::checkImsiExists(const char* imsi) {
+  SMutexLock l(m_mutex);
+  return m_subscribers.find(SubscriberKey(imsi)) != m_subscribers.end();
+}
+
+bool LocalDataAccess::checkExtIdExists(const char* extid) {
+  SMutexLock l(m_mutex);
+  return m_extids.find(extid) != m_extids.end();
+}
+
+bool LocalDataAccess::getImsiListFromExtId(
+    const char* extid, DAImsiList& imsilst) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_extids.find(extid);
+  if (it != m_extids.end()) {
+    for (auto iit = it->second.begin(); iit != it->second.end(); ++iit)
+      imsilst.push_back(*iit);
+  }
+
+  return true;
+}
+
+bool LocalDataAccess::getExtIdsFromImsiData(
+    SCassFuture& future, DAExtIdList& extids) {
+  return true;
+}
+
+bool LocalDataAccess::getExtIdsFromImsi(
+    const char* imsi, DAExtIdList& extids, CassFutureCallback cb, void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    auto it = m_subscribers.find(SubscriberKey(imsi));
+    if (it != m_subscribers.end()) {
+      for (auto eit = it->second.extids.begin();
+           eit != it->second.extids.end(); ++eit)
+        extids.push_back(*eit);
+    }
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::getImsiFromMsisdn(int64_t msisdn, std::string& imsi) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_msisdns.find(msisdn);
+  if (it == m_msisdns.end()) return false;
+
+  imsi = it->second.str();
+
+  return true;
+}
+
+bool LocalDataAccess::getImsiFromMsisdn(const char* msisdn, std::string& imsi) {
+  return getImsiFromMsisdn((int64_t) strtoll(msisdn, NULL, 10), imsi);
+}
+
+bool LocalDataAccess::getMsisdnFromImsi(const char* imsi, std::string& msisdn) {
+  int64_t val;
+
+  if (!getMsisdnFromImsi(imsi, val)) return false;
+
+  msisdn = std::to_string(val);
+
+  return true;
+}
+
+bool LocalDataAccess::getMsisdnFromImsi(const char* imsi, int64_t& msisdn) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return false;
+
+  msisdn = it->second.info.msisdn;
+
+  return true;
+}
+
+bool LocalDataAccess::getImsiInfoData(SCassFuture& future, DAImsiInfo& info) {
+  return true;
+}
+
+bool LocalDataAccess::getImsiInfo(
+    const char* imsi, DAImsiInfo& info, bool subdata, CassFutureCallback cb,
+    void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    auto it = m_subscribers.find(SubscriberKey(imsi));
+    if (it == m_subscribers.end()) return false;
+
+    info = it->second.info;
+  }
+
+  if (!subdata) {
+    info.subscription_data.clear();
+    info.subscription_data_bin.clear();
+  }
+
+  return complete(cb, data);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool LocalDataAccess::getEventIdsFromMsisdnData(
+    SCassFuture& future, DAEventIdList& el) {
+  return true;
+}
+
+bool LocalDataAccess::getEventIdsFromMsisdn(
+    int64_t msisdn, DAEventIdList& el, CassFutureCallback cb, void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    auto it = m_msisdnevents.find(msisdn);
+    if (it != m_msisdnevents.end()) {
+      for (auto eit = it->second.begin(); eit != it->second.end(); ++eit) {
+        DAEventId* ei   = new DAEventId();
+        ei->scef_id     = eit->first;
+        ei->scef_ref_id = eit->second;
+        el.push_back(ei);
+      }
+    }
+  }
+
+  return complete(cb, data);
+}
+
+void LocalDataAccess::getEventIdsFromExtId(
+    const char* extid, DAEventIdList& el) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_extidevents.find(extid);
+  if (it == m_extidevents.end()) return;
+
+  for (auto eit = it->second.begin(); eit != it->second.end(); ++eit) {
+    DAEventId* ei   = new DAEventId();
+    ei->scef_id     = eit->first;
+    ei->scef_ref_id = eit->second;
+    el.push_back(ei);
+  }
+}
+
+bool LocalDataAccess::getEventIdsFromExtIds(
+    const char* extids, DAEventIdList& el, CassFutureCallback cb, void* data) {
+  // extids is a comma separated list of quoted external identifiers
+  std::string s(extids);
+  size_t pos = 0;
+
+  while (pos < s.size()) {
+    size_t end = s.find(',', pos);
+    if (end == std::string::npos) end = s.size();
+
+    std::string extid = s.substr(pos, end - pos);
+    size_t first      = extid.find_first_not_of(" '");
+    size_t last       = extid.find_last_not_of(" '");
+
+    if (first != std::string::npos)
+      getEventIdsFromExtId(
+          extid.substr(first, last - first + 1).c_str(), el);
+
+    pos = end + 1;
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::getEventIdsFromExtIdsData(
+    SCassFuture& future, DAEventIdList& el) {
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool LocalDataAccess::checkOpcKeys(const uint8_t opP[16]) {
+  SMutexLock l(m_mutex);
+  int cnt = 0;
+
+  std::vector<SubscriberKey> imsis;
+  imsis.reserve(m_subscribers.size());
+  for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it)
+    imsis.push_back(it->first);
+
+  for (auto it = imsis.begin(); it != imsis.end(); ++it) {
+    LocalSubscriber sub = m_subscribers[*it];
+
+    uint8_t opccalc[OPC_LENGTH];
+    ComputeOPc(sub.sec.key, opP, opccalc);
+
+    Logger::system().info(
+        "COUNT: %d IMSI: %s KEY: %s OPC: %s NEW OPC: %s", ++cnt,
+        sub.info.imsi.c_str(),
+        Utility::bytes2hex(sub.sec.key, KEY_LENGTH).c_str(),
+        Utility::bytes2hex(sub.sec.opc, OPC_LENGTH).c_str(),
+        Utility::bytes2hex(opccalc, OPC_LENGTH).c_str());
+
+    memcpy(sub.sec.opc, opccalc, OPC_LENGTH);
+    putSubscriber(sub);
+  }
+
+  return true;
+}
+
+bool LocalDataAccess::updateOpc(std::string& imsi, std::string& opc) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return false;
+
+  LocalSubscriber sub = it->second;
+
+  if (!Utility::hex2bytes(opc, sub.sec.opc, OPC_LENGTH))
+    throw DAException(SUtility::string_format(
+        "LocalDataAccess::%s - Invalid OPc [%s] for imsi %s", __func__,
+        opc.c_str(), imsi.c_str()));
+
+  putSubscriber(sub);
+
+  return true;
+}
+
+bool LocalDataAccess::purgeUE(std::string& imsi) {
+  if (imsi.empty()) return false;
+
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return false;
+
+  LocalSubscriber sub   = it->second;
+  sub.info.ms_ps_status = "PURGED";
+  putSubscriber(sub);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool LocalDataAccess::getMmeIdentityFromImsi(
+    std::string& imsi, DAMmeIdentity& mmeid) {
+  int32_t id;
+
+  {
+    SMutexLock l(m_mutex);
+
+    auto it = m_subscribers.find(SubscriberKey(imsi));
+    if (it == m_subscribers.end()) return false;
+
+    id = it->second.info.mme_id;
+  }
+
+  return getMmeIdentity(id, mmeid);
+}
+
+bool LocalDataAccess::getMmeIdentity(
+    std::string& mme_id, DAMmeIdentity& mmeid) {
+  return getMmeIdentity((int32_t) strtol(mme_id.c_str(), NULL, 10), mmeid);
+}
+
+bool LocalDataAccess::getMmeIdentity(int32_t mme_id, DAMmeIdentity& mmeid) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_mmes.find(mme_id);
+  if (it == m_mmes.end()) return false;
+
+  mmeid = it->second;
+
+  return true;
+}
+
+bool LocalDataAccess::getMmeIdFromHostData(
+    SCassFuture& future, int32_t& mmeid) {
+  return true;
+}
+
+bool LocalDataAccess::getMmeIdFromHost(
+    std::string& host, int32_t& mmeid, CassFutureCallback cb, void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    auto it = m_mmehosts.find(host);
+    if (it == m_mmehosts.end()) return false;
+
+    mmeid = it->second;
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::addMmeIdentity(
+    std::string& host, std::string& realm, int32_t mmeid) {
+  SMutexLock l(m_mutex);
+
+  DAMmeIdentity mme;
+  mme.mme_host  = host;
+  mme.mme_realm = realm;
+
+  LocalRecord rec(lrPutMme);
+  encodeMme(rec, mmeid, mme);
+  commit(rec);
+
+  return true;
+}
+
+bool LocalDataAccess::deleteMmeIdentity(std::string& host) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_mmehosts.find(host);
+  if (it == m_mmehosts.end()) return false;
+
+  LocalRecord rec(lrDelMme);
+  rec.putI32(it->second);
+  commit(rec);
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool LocalDataAccess::updateLocation(
+    DAImsiInfo& location, uint32_t present_flags, int32_t idmmeidentity,
+    CassFutureCallback cb, void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    if (m_subscribers.find(SubscriberKey(location.imsi)) == m_subscribers.end())
+      return false;
+
+    LocalRecord rec(lrSetLocation);
+    rec.putStr(location.imsi);
+    rec.putU32(present_flags);
+    rec.putStr(location.imei);
+    rec.putStr(location.imei_sv);
+    rec.putI32(idmmeidentity);
+    rec.putStr(location.mmehost);
+    rec.putStr(location.mmerealm);
+    rec.putStr(location.visited_plmnid);
+    commit(rec);
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::updateLocation(
+    DAImsiInfo& location, uint32_t present_flags, CassFutureCallback cb,
+    void* data) {
+  return updateLocation(location, present_flags, location.mme_id, cb, data);
+}
+
+bool LocalDataAccess::updateLocationData(SCassFuture& future) {
+  return true;
+}
+
+bool LocalDataAccess::getImsiSec(
+    const std::string& imsi, DAImsiSec& imsisec, CassFutureCallback cb,
+    void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    auto it = m_subscribers.find(SubscriberKey(imsi));
+    if (it == m_subscribers.end()) return false;
+
+    imsisec = it->second.sec;
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::getImsiSecData(SCassFuture& future, DAImsiSec& imsisec) {
+  return true;
+}
+
+bool LocalDataAccess::updateRandSqn(
+    const std::string& imsi, uint8_t* rand_p, uint8_t* sqn, bool inc_sqn,
+    CassFutureCallback cb, void* data) {
+  SqnU64Union eu;
+  uint8_t newsqn[SQN_LENGTH];
+
+  SQN_TO_U64(sqn, eu);
+
+  if (inc_sqn) eu.u64 += 32;
+
+  U64_TO_SQN(eu, newsqn);
+
+  {
+    SMutexLock l(m_mutex);
+
+    if (m_subscribers.find(SubscriberKey(imsi)) == m_subscribers.end()) return false;
+
+    LocalRecord rec(lrSetSec);
+    rec.putStr(imsi);
+    rec.putBytes(rand_p, RAND_LENGTH);
+    rec.putBytes(newsqn, SQN_LENGTH);
+    commit(rec);
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::updateRandSqnData(SCassFuture& future) {
+  return true;
+}
+
+bool LocalDataAccess::incSqn(std::string& imsi, uint8_t* sqn) {
+  SqnU64Union eu;
+  uint8_t newsqn[SQN_LENGTH];
+
+  SQN_TO_U64(sqn, eu);
+
+  eu.u64 += 32;
+
+  U64_TO_SQN(eu, newsqn);
+
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return false;
+
+  LocalRecord rec(lrSetSec);
+  rec.putStr(imsi);
+  rec.putBytes(it->second.sec.rand, RAND_LENGTH);
+  rec.putBytes(newsqn, SQN_LENGTH);
+  commit(rec);
+
+  return true;
+}
+
+bool LocalDataAccess::getSubDataFromImsi(
+    const char* imsi, std::string& sub_data) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return false;
+
+  sub_data = it->second.info.subscription_data;
+
+  return true;
+}
+
+bool LocalDataAccess::updateSubscriptionData(
+    const char* imsi, const std::string& sub_data,
+    const std::string& sub_data_bin) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return false;
+
+  LocalSubscriber sub            = it->second;
+  sub.info.subscription_data     = sub_data;
+  sub.info.subscription_data_bin = sub_data_bin;
+  putSubscriber(sub);
+
+  return true;
+}
+
+bool LocalDataAccess::putImsi(
+    const DAImsiInfo& info, const DAImsiSec& sec, uint32_t present_flags,
+    CassFutureCallback cb, void* data) {
+  {
+    SMutexLock l(m_mutex);
+
+    LocalSubscriber sub;
+    SubscriberKey key(info.imsi);
+
+    if (!key.valid()) return false;
+
+    auto it = m_subscribers.find(key);
+    if (it == m_subscribers.end()) {
+      sub.info = DAImsiInfo();
+      memset(&sub.sec, 0, sizeof(sub.sec));
+      sub.info.imsi = info.imsi;
+    } else {
+      sub = it->second;
+    }
+
+    if (FLAG_IS_SET(present_flags, PUT_MSISDN_PRESENT)) {
+      sub.info.msisdn     = info.msisdn;
+      sub.info.str_msisdn = info.str_msisdn;
+    }
+    if (FLAG_IS_SET(present_flags, PUT_ACCESS_RESTRICTION_PRESENT))
+      sub.info.access_restriction = info.access_restriction;
+    if (FLAG_IS_SET(present_flags, PUT_SUBSCRIPTION_DATA_PRESENT)) {
+      sub.info.subscription_data     = info.subscription_data;
+      sub.info.subscription_data_bin = info.subscription_data_bin;
+    }
+    if (FLAG_IS_SET(present_flags, PUT_KEY_PRESENT))
+      memcpy(sub.sec.key, sec.key, sizeof(sub.sec.key));
+    if (FLAG_IS_SET(present_flags, PUT_OPC_PRESENT))
+      memcpy(sub.sec.opc, sec.opc, sizeof(sub.sec.opc));
+    if (FLAG_IS_SET(present_flags, PUT_RAND_PRESENT))
+      memcpy(sub.sec.rand, sec.rand, sizeof(sub.sec.rand));
+    if (FLAG_IS_SET(present_flags, PUT_SQN_PRESENT))
+      memcpy(sub.sec.sqn, sec.sqn, sizeof(sub.sec.sqn));
+
+    putSubscriber(sub);
+  }
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::putImsiData(SCassFuture& future) {
+  return true;
+}
+
+bool LocalDataAccess::deleteImsi(
+    const std::string& imsi, CassFutureCallback cb, void* data) {
+  if (!deleteImsi(imsi)) return false;
+
+  return complete(cb, data);
+}
+
+bool LocalDataAccess::deleteImsiData(SCassFuture& future) {
+  return true;
+}
+
+void LocalDataAccess::UpdateValidityTime(
+    const char* imsi, std::string& validity_time) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return;
+
+  LocalSubscriber sub = it->second;
+  sub.niddvalidity    = validity_time;
+  putSubscriber(sub);
+}
+
+void LocalDataAccess::UpdateNIRDestination(
+    const char* imsi, std::string& host, std::string& realm) {
+  SMutexLock l(m_mutex);
+
+  auto it = m_subscribers.find(SubscriberKey(imsi));
+  if (it == m_subscribers.end()) return;
+
+  LocalSubscriber sub = it->second;
+  sub.nir_dest_host   = host;
+  sub.nir_dest_realm  = realm;
+  putSubscriber(sub);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool LocalDataAccess::complete(CassFutureCallback cb, void* data) {
+  if (!cb) return true;
+
+  LocalCompletion* c = new LocalCompletion(cb, data);
+
+  if (!m_completions.push(c)) {
+    delete c;
+    return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/////////////////////////////// PRIVATE METHODS ////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// The methods below are called with m_mutex held.
+//
+
+void LocalDataAccess::commit(LocalRecord& rec) {
+  if (m_logfd != -1) {
+    std::string frame;
+    rec.frame(frame);
+
+    if (!writeAll(m_logfd, frame.data(), frame.size()) ||
+        (m_sync && fdatasync(m_logfd) != 0)) {
+      throw DAException(SUtility::string_format(
+          "LocalDataAccess::%s - Error writing to %s/" LOCAL_LOG_FILE
+          " - errno=%d",
+          __func__, m_dir.c_str(), errno));
+    }
+
+    m_logrecords++;
+  }
+
+  rec.rewind();
+  apply(rec);
+
+  // the change has been applied, so a failure to start the snapshot is only
+  // reported, it is retried with the next change
+  if (m_logfd != -1 && m_snapshotinterval > 0 &&
+      m_logrecords >= m_snapshotinterval && reapSnapshot()) {
+    try {
+      startSnapshot();
+    } catch (DAException& ex) {
+      Logger::system().error(
+          "LocalDataAccess::%s - EXCEPTION - %s", __func__, ex.what());
+    }
+  }
+}
+
+void LocalDataAccess::putSubscriber(const LocalSubscriber& sub) {
+  LocalRecord rec(lrPutImsi);
+  encodeSubscriber(rec, sub);
+  commit(rec);
+}
+
+void LocalDataAccess::apply(LocalRecord& rec) {
+  switch (rec.getU8()) {
+    case lrPutImsi: {
+      applyPutImsi(rec);
+      break;
+    }
+    case lrDelImsi: {
+      applyDelImsi(rec.getStr());
+      break;
+    }
+    case lrSetSec: {
+      std::string imsi = rec.getStr();
+      uint8_t rand[RAND_LENGTH];
+      uint8_t sqn[SQN_LENGTH];
+
+      rec.getBytes(rand, RAND_LENGTH);
+      rec.getBytes(sqn, SQN_LENGTH);
+
+      auto it = m_subscribers.find(SubscriberKey(imsi));
+      if (it != m_subscribers.end()) {
+        memcpy(it->second.sec.rand, rand, RAND_LENGTH);
+        memcpy(it->second.sec.sqn, sqn, SQN_LENGTH);
+      }
+      break;
+    }
+    case lrSetLocation: {
+      std::string imsi        = rec.getStr();
+      uint32_t present_flags  = rec.getU32();
+      std::string imei        = rec.getStr();
+      std::string imei_sv     = rec.getStr();
+      int32_t mme_id          = rec.getI32();
+      std::string mmehost     = rec.getStr();
+      std::string mmerealm    = rec.getStr();
+      std::string visitedplmn = rec.getStr();
+
+      auto it = m_subscribers.find(SubscriberKey(imsi));
+      if (it == m_subscribers.end()) break;
+
+      DAImsiInfo& info = it->second.info;
+
+      if (FLAG_IS_SET(present_flags, IMEI_PRESENT)) info.imei = imei;
+      if (FLAG_IS_SET(present_flags, SV_PRESENT)) info.imei_sv = imei_sv;
+      if (FLAG_IS_SET(present_flags, MME_IDENTITY_PRESENT)) {
+        info.mme_id   = mme_id;
+        info.mmehost  = mmehost;
+        info.mmerealm = mmerealm;
+      }
+      info.ms_ps_status   = "ATTACHED";
+      info.visited_plmnid = visitedplmn;
+      break;
+    }
+    case lrPutMme: {
+      int32_t id = rec.getI32();
+      DAMmeIdentity mme;
+
+      mme.mme_host  = rec.getStr();
+      mme.mme_realm = rec.getStr();
+      mme.mme_isdn  = rec.getStr();
+
+      auto it = m_mmes.find(id);
+      if (it != m_mmes.end()) m_mmehosts.erase(it->second.mme_host);
+
+      m_mmes[id]               = mme;
+      m_mmehosts[mme.mme_host] = id;
+      break;
+    }
+    case lrDelMme: {
+      auto it = m_mmes.find(rec.getI32());
+      if (it == m_mmes.end()) break;
+
+      m_mmehosts.erase(it->second.mme_host);
+      m_mmes.erase(it);
+      break;
+    }
+    case lrPutEvent: {
+      DAEvent event;
+      decodeEvent(rec, event);
+      applyPutEvent(event);
+      break;
+    }
+    case lrDelEvent: {
+      std::string scef_id  = rec.getStr();
+      uint32_t scef_ref_id = rec.getU32();
+      applyDelEvent(scef_id, scef_ref_id);
+      break;
+    }
+    case lrEventBatch: {
+      for (uint32_t cnt = rec.getU32(); cnt > 0; cnt--) {
+        std::string scef_id  = rec.getStr();
+        uint32_t scef_ref_id = rec.getU32();
+        applyDelEvent(scef_id, scef_ref_id);
+      }
+      for (uint32_t cnt = rec.getU32(); cnt > 0; cnt--) {
+        DAEvent event;
+        decodeEvent(rec, event);
+        applyPutEvent(event);
+      }
+      break;
+    }
+    default: {
+      throw DAException("LocalDataAccess::apply - unrecognized record type");
+    }
+  }
+}
+
+void LocalDataAccess::applyPutImsi(LocalRecord& rec) {
+  LocalSubscriber sub;
+
+  decodeSubscriber(rec, sub);
+
+  SubscriberKey key(sub.info.imsi);
+  if (!key.valid()) return;
+
+  // remove the index entries of the current version of the subscriber
+  applyDelImsi(sub.info.imsi);
+
+  if (sub.info.msisdn != 0) m_msisdns[sub.info.msisdn] = key;
+
+  for (auto it = sub.extids.begin(); it != sub.extids.end(); ++it)
+    m_extids[*it].insert(key);
+
+  m_subscribers[key] = std::move(sub);
+}
+
+void LocalDataAccess::applyDelImsi(const std::string& imsi) {
+  SubscriberKey key(imsi);
+
+  auto it = m_subscribers.find(key);
+  if (it == m_subscribers.end()) return;
+
+  auto mit = m_msisdns.find(it->second.info.msisdn);
+  if (mit != m_msisdns.end() && mit->second == key) m_msisdns.erase(mit);
+
+  for (auto eit = it->second.extids.begin(); eit != it->second.extids.end();
+       ++eit) {
+    auto xit = m_extids.find(*eit);
+    if (xit == m_extids.end()) continue;
+    xit->second.erase(key);
+    if (xit->second.empty()) m_extids.erase(xit);
+  }
+
+  m_subscribers.erase(it);
+}
+
+void LocalDataAccess::applyPutEvent(const DAEvent& event) {
+  applyDelEvent(event.scef_id, event.scef_ref_id);
+
+  LocalEventId id(event.scef_id, event.scef_ref_id);
+
+  m_events[event.scef_id][event.scef_ref_id] = event;
+
+  if (event.msisdn != 0) m_msisdnevents[event.msisdn].insert(id);
+  if (!event.extid.empty()) m_extidevents[event.extid].insert(id);
+}
+
+void LocalDataAccess::applyDelEvent(
+    const std::string& scef_id, uint32_t scef_ref_id) {
+  auto it = m_events.find(scef_id);
+  if (it == m_events.end()) return;
+
+  auto eit = it->second.find(scef_ref_id);
+  if (eit == it->second.end()) return;
+
+  LocalEventId id(scef_id, scef_ref_id);
+
+  auto mit = m_msisdnevents.find(eit->second.msisdn);
+  if (mit != m_msisdnevents.end()) {
+    mit->second.erase(id);
+    if (mit->second.empty()) m_msisdnevents.erase(mit);
+  }
+
+  auto xit = m_extidevents.find(eit->second.extid);
+  if (xit != m_extidevents.end()) {
+    xit->second.erase(id);
+    if (xit->second.empty()) m_extidevents.erase(xit);
+  }
+
+  it->second.erase(eit);
+  if (it->second.empty()) m_events.erase(it);
+}
+
+//
+// Applies the records in a snapshot or log file and returns the number of
+// records applied.  A record that was only partially written when the
+// process stopped ends the load, and when truncate is set the file is cut
+// back to the last complete record so new records follow a valid one.
+//
+uint64_t LocalDataAccess::load(const std::string& path, bool truncate) {
+  FILE* fp = fopen(path.c_str(), "rb");
+
+  if (!fp) {
+    if (errno == ENOENT) return 0;
+    throw DAException(SUtility::string_format(
+        "LocalDataAccess::%s - Unable to open %s - errno=%d", __func__,
+        path.c_str(), errno));
+  }
+
+  uint64_t count = 0;
+  off_t good     = 0;
+  std::string buf;
+  LocalRecordHeader hdr;
+
+  while (true) {
+    size_t n   = fread(&hdr, 1, sizeof(hdr), fp);
+    bool valid = false;
+
+    if (n == 0) break;
+
+    if (n == sizeof(hdr) && hdr.length > 0 &&
+        hdr.length <= LOCAL_MAX_RECORD) {
+      buf.resize(hdr.length);
+      valid = fread(&buf[0], 1, hdr.length, fp) == hdr.length &&
+              LocalRecord::checksum(buf.data(), buf.size()) == hdr.checksum;
+    }
+
+    if (!valid) {
+      if (!truncate) {
+        fclose(fp);
+        throw DAException(SUtility::string_format(
+            "LocalDataAccess::%s - Invalid record at offset %lld in %s",
+            __func__, (long long) good, path.c_str()));
+      }
+
+      Logger::system().warn(
+          "LocalDataAccess::%s - Discarding incomplete record at offset %lld "
+          "in %s",
+          __func__, (long long) good, path.c_str());
+
+      if (::truncate(path.c_str(), good) != 0) {
+        fclose(fp);
+        throw DAException(SUtility::string_format(
+            "LocalDataAccess::%s - Unable to truncate %s - errno=%d",
+            __func__, path.c_str(), errno));
+      }
+      break;
+    }
+
+    LocalRecord rec(buf.data(), buf.size());
+    apply(rec);
+
+    good += sizeof(hdr) + hdr.length;
+    count++;
+  }
+
+  fclose(fp);
+
+  return count;
+}
+
+//
+// Rotates the log and has a LocalSnapshotThread write the data set as it is
+// now.  Only the encoding is done while m_mutex is held, the snapshot file
+// is written and synced by the thread.
+//
+void LocalDataAccess::startSnapshot() {
+  std::string log     = m_dir + "/" LOCAL_LOG_FILE;
+  std::string rotated = log + "." + std::to_string(m_logseq);
+
+  if (rename(log.c_str(), rotated.c_str()) != 0) {
+    throw DAException(SUtility::string_format(
+        "LocalDataAccess::%s - Unable to rename %s - errno=%d", __func__,
+        log.c_str(), errno));
+  }
+
+  int fd = ::open(log.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd == -1) {
+    int err = errno;
+    rename(rotated.c_str(), log.c_str());
+    throw DAException(SUtility::string_format(
+        "LocalDataAccess::%s - Unable to open %s - errno=%d", __func__,
+        log.c_str(), err));
+  }
+
+  ::close(m_logfd);
+  m_logfd      = fd;
+  m_logrecords = 0;
+
+  std::string* data = new std::string();
+
+  for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it) {
+    LocalRecord rec(lrPutImsi);
+    encodeSubscriber(rec, it->second);
+    rec.frame(*data);
+  }
+
+  for (auto it = m_mmes.begin(); it != m_mmes.end(); ++it) {
+    LocalRecord rec(lrPutMme);
+    encodeMme(rec, it->first, it->second);
+    rec.frame(*data);
+  }
+
+  for (auto it = m_events.begin(); it != m_events.end(); ++it) {
+    for (auto eit = it->second.begin(); eit != it->second.end(); ++eit) {
+      LocalRecord rec(lrPutEvent);
+      encodeEvent(rec, eit->second);
+      rec.frame(*data);
+    }
+  }
+
+  m_snapshotthread = new LocalSnapshotThread(
+      m_dir, data, m_logseq++, m_subscribers.size());
+  m_snapshotthread->init(NULL);
+}
+
+// true when no snapshot is being written, a thread that has finished is
+// released
+bool LocalDataAccess::reapSnapshot() {
+  if (!m_snapshotthread) return true;
+  if (!m_snapshotthread->isDoneRunning()) return false;
+
+  waitSnapshot();
+
+  return true;
+}
+
+// waits for the snapshot being written, false if it could not be written
+bool LocalDataAccess::waitSnapshot() {
+  if (!m_snapshotthread) return true;
+
+  m_snapshotthread->join();
+
+  bool ok = m_snapshotthread->ok();
+
+  delete m_snapshotthread;
+  m_snapshotthread = NULL;
+
+  return ok;
+}
@@ -48,37 +48,27 @@ hss_config_t hss_config;
 FDHss fdHss;
 static bool shutdownFlag = false;
 static SEvent shutdownEvent;
-#ifdef MONITOR_PENDING_MESSAGE_LEVEL
-static timer_t timer;
-#endif
-
 #ifdef PERFORMANCE_TIMING
 void dumpUlrTimers();
 #endif
 
 void handler(int signal) {
-  if (signal == SIGRTMIN + 1) {
-    size_t cnt = fdHss.getWorkerQueue().queueDepth();
-
-    if (cnt > 0) printf("pending messages %lu\n", (unsigned long) cnt);
-  } else {
-    Logger::system().startup("Caught signal (%d)", signal);
-
-    switch (signal) {
-      case SIGINT:
-      case SIGTERM: {
-        Logger::system().startup("Setting shutdown event");
-        shutdownFlag = true;
-        shutdownEvent.set();
-        break;
-      }
+  Logger::system().startup("Caught signal (%d)", signal);
+
+  switch (signal) {
+    case SIGINT:
+    case SIGTERM: {
+      Logger::system().startup("Setting shutdown event");
+      shutdownFlag = true;
+      shutdownEvent.set();
+      break;
+    }
 #ifdef PERFORMACE_TIMING
-      case SIGUSR1: {
-        dumpUlrTimers();
-        break;
-      }
-#endif
+    case SIGUSR1: {
+      dumpUlrTimers();
+      break;
     }
+#endif
   }
 }
 
@@ -103,11 +93,6 @@ void initHandler() {
         "Unable to register SIGTERM handler");
   Logger::system().startup("signal handler registered for SIGTERM");
 
-  if (sigaction(SIGRTMIN + 1, &sa, NULL) == -1)
-    SError::throwRuntimeExceptionWithErrno(
-        "Unable to register SIGRTMIN handler");
-  Logger::system().startup("signal handler registered for SIGRTMIN");
-
 #ifdef PERFORMANCE_TIMING
   if (sigaction(SIGUSR1, &sa, NULL) == -1)
     SError::throwRuntimeExceptionWithErrno(
@@ -192,22 +177,6 @@ int main(int argc, char** argv) {
     return 0;
   }
 
-#ifdef MONITOR_PENDING_MESSAGE_LEVEL
-  {
-    struct sigevent sev;
-    sev.sigev_notify = SIGEV_SIGNAL;
-    sev.sigev_signo  = SIGRTMIN + 1;
-    timer_create(CLOCK_REALTIME, &sev, &timer);
-
-    struct itimerspec its;
-    its.it_value.tv_sec     = 1;  // seconds
-    its.it_value.tv_nsec    = 0;  // nano-seconds
-    its.it_interval.tv_sec  = its.it_value.tv_sec;
-    its.it_interval.tv_nsec = its.it_value.tv_nsec;
-    timer_settime(timer, 0, &its, NULL);
-  }
-#endif
-
   if (fdHss.init(&hss_config)) shutdownEvent.wait();
 
   // initiate the shutdown
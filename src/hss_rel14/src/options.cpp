@@ -55,6 +55,27 @@ unsigned Options::m_casscoreconnections = 1;
 unsigned Options::m_cassmaxconnections  = 2;
 unsigned Options::m_cassioqueuesize     = 8192;
 unsigned Options::m_cassiothreads       = 1;
+std::string Options::m_storage          = "cassandra";
+std::string Options::m_localdir         = "data";
+unsigned Options::m_localsnapshot       = 100000;
+bool Options::m_localsync               = false;
+unsigned Options::m_localthreads        = 2;
+unsigned Options::m_subdatacache        = 10000;
+bool Options::m_subdatabin              = false;
+bool Options::m_secbin                  = false;
+unsigned Options::m_groupcirconcurrent  = 64;
+unsigned Options::m_groupidrrate        = 0;
+unsigned Options::m_rirmaxitems         = 1000;
+unsigned Options::m_rirmaxbytes         = 0;
+unsigned Options::m_rirflushinterval    = 0;
+unsigned Options::m_restthreads         = 4;
+unsigned Options::m_restmaxpayload      = 64 * 1024 * 1024;
+unsigned Options::m_provconcurrent      = 256;
+unsigned Options::m_imeichangebatch     = 256;
+bool Options::m_eventindex              = false;
+unsigned Options::m_eventindexrefresh   = 300;
+bool Options::m_preload                 = false;
+unsigned Options::m_preloadthreads      = 4;
 bool Options::m_randvector;
 bool Options::m_roamallow;
 std::string Options::m_optkey;
@@ -228,6 +249,164 @@ bool Options::parseJson() {
       }
       m_cassiothreads = hssSection["cassiothreads"].GetUint();
     }
+    if (hssSection.HasMember("storage")) {
+      if (!hssSection["storage"].IsString()) {
+        std::cout << "Error parsing json value: [storage]" << std::endl;
+        return false;
+      }
+      m_storage = hssSection["storage"].GetString();
+      if (m_storage != "cassandra" && m_storage != "local") {
+        std::cout << "Invalid json value: [storage] must be cassandra or local"
+                  << std::endl;
+        return false;
+      }
+    }
+    if (hssSection.HasMember("localdir")) {
+      if (!hssSection["localdir"].IsString()) {
+        std::cout << "Error parsing json value: [localdir]" << std::endl;
+        return false;
+      }
+      m_localdir = hssSection["localdir"].GetString();
+    }
+    if (hssSection.HasMember("localsnapshot")) {
+      if (!hssSection["localsnapshot"].IsInt()) {
+        std::cout << "Error parsing json value: [localsnapshot]" << std::endl;
+        return false;
+      }
+      m_localsnapshot = hssSection["localsnapshot"].GetUint();
+    }
+    if (hssSection.HasMember("localsync")) {
+      if (!hssSection["localsync"].IsBool()) {
+        std::cout << "Error parsing json value: [localsync]" << std::endl;
+        return false;
+      }
+      m_localsync = hssSection["localsync"].GetBool();
+    }
+    if (hssSection.HasMember("localthreads")) {
+      if (!hssSection["localthreads"].IsInt()) {
+        std::cout << "Error parsing json value: [localthreads]" << std::endl;
+        return false;
+      }
+      m_localthreads = hssSection["localthreads"].GetUint();
+    }
+    if (hssSection.HasMember("subdatacache")) {
+      if (!hssSection["subdatacache"].IsInt()) {
+        std::cout << "Error parsing json value: [subdatacache]" << std::endl;
+        return false;
+      }
+      m_subdatacache = hssSection["subdatacache"].GetUint();
+    }
+    if (hssSection.HasMember("subdatabin")) {
+      if (!hssSection["subdatabin"].IsBool()) {
+        std::cout << "Error parsing json value: [subdatabin]" << std::endl;
+        return false;
+      }
+      m_subdatabin = hssSection["subdatabin"].GetBool();
+    }
+    if (hssSection.HasMember("secbin")) {
+      if (!hssSection["secbin"].IsBool()) {
+        std::cout << "Error parsing json value: [secbin]" << std::endl;
+        return false;
+      }
+      m_secbin = hssSection["secbin"].GetBool();
+    }
+    if (hssSection.HasMember("groupcirconcurrent")) {
+      if (!hssSection["groupcirconcurrent"].IsInt()) {
+        std::cout << "Error parsing json value: [groupcirconcurrent]"
+                  << std::endl;
+        return false;
+      }
+      m_groupcirconcurrent = hssSection["groupcirconcurrent"].GetUint();
+    }
+    if (hssSection.HasMember("groupidrrate")) {
+      if (!hssSection["groupidrrate"].IsInt()) {
+        std::cout << "Error parsing json value: [groupidrrate]" << std::endl;
+        return false;
+      }
+      m_groupidrrate = hssSection["groupidrrate"].GetUint();
+    }
+    if (hssSection.HasMember("rirmaxitems")) {
+      if (!hssSection["rirmaxitems"].IsInt()) {
+        std::cout << "Error parsing json value: [rirmaxitems]" << std::endl;
+        return false;
+      }
+      m_rirmaxitems = hssSection["rirmaxitems"].GetUint();
+    }
+    if (hssSection.HasMember("rirmaxbytes")) {
+      if (!hssSection["rirmaxbytes"].IsInt()) {
+        std::cout << "Error parsing json value: [rirmaxbytes]" << std::endl;
+        return false;
+      }
+      m_rirmaxbytes = hssSection["rirmaxbytes"].GetUint();
+    }
+    if (hssSection.HasMember("rirflushinterval")) {
+      if (!hssSection["rirflushinterval"].IsInt()) {
+        std::cout << "Error parsing json value: [rirflushinterval]"
+                  << std::endl;
+        return false;
+      }
+      m_rirflushinterval = hssSection["rirflushinterval"].GetUint();
+    }
+    if (hssSection.HasMember("restthreads")) {
+      if (!hssSection["restthreads"].IsInt()) {
+        std::cout << "Error parsing json value: [restthreads]" << std::endl;
+        return false;
+      }
+      m_restthreads = hssSection["restthreads"].GetUint();
+    }
+    if (hssSection.HasMember("restmaxpayload")) {
+      if (!hssSection["restmaxpayload"].IsInt()) {
+        std::cout << "Error parsing json value: [restmaxpayload]"
+                  << std::endl;
+        return false;
+      }
+      m_restmaxpayload = hssSection["restmaxpayload"].GetUint();
+    }
+    if (hssSection.HasMember("provconcurrent")) {
+      if (!hssSection["provconcurrent"].IsInt()) {
+        std::cout << "Error parsing json value: [provconcurrent]"
+                  << std::endl;
+        return false;
+      }
+      m_provconcurrent = hssSection["provconcurrent"].GetUint();
+    }
+    if (hssSection.HasMember("imeichangebatch")) {
+      if (!hssSection["imeichangebatch"].IsInt()) {
+        std::cout << "Error parsing json value: [imeichangebatch]"
+                  << std::endl;
+        return false;
+      }
+      m_imeichangebatch = hssSection["imeichangebatch"].GetUint();
+    }
+    if (hssSection.HasMember("eventindex")) {
+      if (!hssSection["eventindex"].IsBool()) {
+        std::cout << "Error parsing json value: [eventindex]" << std::endl;
+        return false;
+      }
+      m_eventindex = hssSection["eventindex"].GetBool();
+    }
+    if (hssSection.HasMember("eventindexrefresh")) {
+      if (!hssSection["eventindexrefresh"].IsInt()) {
+        std::cout << "Error parsing json value: [eventindexrefresh]"
+                  << std::endl;
+        return false;
+      }
+      m_eventindexrefresh = hssSection["eventindexrefresh"].GetUint();
+    }
+    if (hssSection.HasMember("preload")) {
+      if (!hssSection["preload"].IsBool()) {
+        std::cout << "Error parsing json value: [preload]" << std::endl;
+        return false;
+      }
+      m_preload = hssSection["preload"].GetBool();
+    }
+    if (hssSection.HasMember("preloadthreads")) {
+      if (!hssSection["preloadthreads"].IsInt()) {
+        std::cout << "Error parsing json value: [preloadthreads]" << std::endl;
+        return false;
+      }
+      m_preloadthreads = hssSection["preloadthreads"].GetUint();
+    }
     if (!(options & randvector) && hssSection.HasMember("randv")) {
       if (!hssSection["randv"].IsBool()) {
         std::cout << "Error parsing json value: [randv]" << std::endl;
@@ -415,8 +594,10 @@ bool Options::parseJson() {
 
 bool Options::validateOptions() {
   return (
-      (options & diameterconfiguration) && (options & cassserver) &&
-      (options & cassuser) && (options & casspwd) && (options & cassdb) &&
+      (options & diameterconfiguration) &&
+      (m_storage == "local" ||
+       ((options & cassserver) && (options & cassuser) &&
+        (options & casspwd) && (options & cassdb))) &&
       (options & optkey) && (options & gtwport) && (options & gtwhost) &&
       (options & restport) && (options & logmaxsize) &&
       (options & lognbrfiles) && (options & logfilename) &&
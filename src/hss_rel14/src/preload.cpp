@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <inttypes.h>
+#include <algorithm>
+#include <sstream>
+
+#include "fdjson.h"
+#include "logger.h"
+#include "satomic.h"
+#include "stimer.h"
+
+#include "preload.h"
+
+// token ranges per worker thread, so a slow range does not hold up the scan
+#define PRELOAD_RANGES_PER_THREAD 16
+#define PRELOAD_PAGE_SIZE 1000
+
+static void preloadJsonError(const char* err) {
+  Logger::system().error("Preloader - %s", err);
+}
+
+// the blocks of the most recently attached subscribers first, then the
+// blocks shared by the most subscribers
+static bool preloadCompare(
+    const PreloadSubDataMap::const_iterator& a,
+    const PreloadSubDataMap::const_iterator& b) {
+  if (a->second.attached != b->second.attached)
+    return a->second.attached > b->second.attached;
+  return a->second.subscribers > b->second.subscribers;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+PreloadWorker::PreloadWorker(Preloader& preloader) : m_preloader(preloader) {}
+
+PreloadWorker::~PreloadWorker() {}
+
+unsigned long PreloadWorker::threadProc(void* arg) {
+  int64_t first;
+  int64_t last;
+  bool inclusive;
+
+  while (m_preloader.nextRange(first, last, inclusive)) {
+    if (!m_preloader.scanRange(first, last, inclusive))
+      atomic_inc_fetch(m_preloader.m_rangeerrors);
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+Preloader::Preloader(
+    SCassandra& db, unsigned threads, size_t budget, bool subdata,
+    DAPreloadCallback cb, void* data)
+    : m_db(db),
+      m_threads(threads ? threads : 1),
+      m_ranges(m_threads * PRELOAD_RANGES_PER_THREAD),
+      m_budget(budget),
+      m_subdata(subdata),
+      m_cb(cb),
+      m_data(data),
+      m_attachedblocks(0),
+      m_otherblocks(0),
+      m_stop(false),
+      m_nextrange(0),
+      m_scanned(0),
+      m_attachedsubs(0),
+      m_rangeerrors(0) {}
+
+Preloader::~Preloader() {}
+
+unsigned long Preloader::threadProc(void* arg) {
+  STimerElapsed etimer;
+  std::vector<PreloadWorker*> workers;
+
+  Logger::system().startup(
+      "Preloader - scanning users_imsi with %u threads", m_threads);
+
+  for (unsigned i = 0; i < m_threads; i++) {
+    PreloadWorker* w = new PreloadWorker(*this);
+    w->init(NULL);
+    workers.push_back(w);
+  }
+
+  for (auto it = workers.begin(); it != workers.end(); ++it) {
+    (*it)->join();
+    delete *it;
+  }
+
+  if (m_stop) return 0;
+
+  size_t loaded = m_subdata ? loadTemplates() : 0;
+
+  Logger::system().startup(
+      "Preloader - scanned %" PRIu64 " subscribers (%" PRIu64
+      " attached) in %lld ms, loaded %zu subscription data templates, "
+      "%" PRIu64 " ranges incomplete",
+      (uint64_t) m_scanned, (uint64_t) m_attachedsubs, etimer.MilliSeconds(),
+      loaded, (uint64_t) m_rangeerrors);
+
+  if (m_cb) m_cb(m_data);
+
+  return 0;
+}
+
+bool Preloader::nextRange(int64_t& first, int64_t& last, bool& inclusive) {
+  int range = atomic_inc_fetch(m_nextrange) - 1;
+
+  if (m_stop || range >= m_ranges) return false;
+
+  SCassTokenRange(range, m_ranges, first, last, inclusive);
+
+  return true;
+}
+
+bool Preloader::scanRange(int64_t first, int64_t last, bool inclusive) {
+  std::stringstream ss;
+  bool more_pages = true;
+
+  ss << "SELECT imsi, ms_ps_status, writetime(ms_ps_status) AS "
+     << "ms_ps_status_ts" << (m_subdata ? ", subscription_data" : "")
+     << " FROM users_imsi WHERE token(imsi) " << (inclusive ? ">= " : "> ")
+     << first << " AND token(imsi) <= " << last;
+
+  SCassStatement stmt(ss.str());
+
+  stmt.setPagingSize(PRELOAD_PAGE_SIZE);
+
+  while (more_pages) {
+    if (m_stop) return false;
+
+    SCassFuture future = m_db.execute(stmt);
+
+    if (future.errorCode() != CASS_OK) {
+      Logger::system().error(
+          "Preloader::%s - Error %d executing [%s]", __func__,
+          future.errorCode(), ss.str().c_str());
+      return false;
+    }
+
+    SCassResult res    = future.result();
+    SCassIterator rows = res.rows();
+    PreloadSubDataMap page;
+
+    while (rows.nextRow()) {
+      SCassRow row       = rows.row();
+      SCassValue status  = row.getColumn("ms_ps_status");
+      int64_t attachedts = 0;
+      std::string s;
+
+      atomic_inc_fetch(m_scanned);
+
+      if (!status.isNull() && status.get(s) && s == "ATTACHED") {
+        atomic_inc_fetch(m_attachedsubs);
+        row.getColumn("ms_ps_status_ts").get(attachedts);
+        if (attachedts < 1) attachedts = 1;
+      }
+
+      if (!m_subdata) continue;
+
+      SCassValue json = row.getColumn("subscription_data");
+      if (json.isNull() || !json.get(s) || s.empty()) continue;
+
+      PreloadSubData& sd = page[s];
+      sd.subscribers++;
+      if (attachedts > sd.attached) sd.attached = attachedts;
+    }
+
+    merge(page);
+
+    more_pages = res.morePages();
+
+    if (more_pages) stmt.setPagingState(res);
+  }
+
+  return true;
+}
+
+void Preloader::merge(PreloadSubDataMap& page) {
+  SMutexLock l(m_mutex);
+
+  for (auto it = page.begin(); it != page.end(); ++it) {
+    auto sit = m_subdatas.find(it->first);
+
+    if (sit != m_subdatas.end()) {
+      sit->second.subscribers += it->second.subscribers;
+      if (it->second.attached > sit->second.attached)
+        sit->second.attached = it->second.attached;
+      continue;
+    }
+
+    // the scan keeps up to the budget of blocks first seen for attached
+    // subscribers and for the others, which bounds the memory it uses
+    size_t& blocks = it->second.attached ? m_attachedblocks : m_otherblocks;
+    if (blocks >= m_budget) continue;
+
+    blocks++;
+    m_subdatas.insert(*it);
+  }
+}
+
+size_t Preloader::loadTemplates() {
+  std::vector<PreloadSubDataMap::const_iterator> order;
+  size_t loaded = 0;
+
+  for (auto it = m_subdatas.begin(); it != m_subdatas.end(); ++it)
+    order.push_back(it);
+
+  std::sort(order.begin(), order.end(), preloadCompare);
+
+  if (order.size() > m_budget) order.resize(m_budget);
+
+  // the cache discards the least recently used templates first, so the
+  // most important blocks are loaded last
+  for (auto it = order.rbegin(); it != order.rend() && !m_stop; ++it) {
+    if (fdJsonPreloadTemplate((*it)->first.c_str(), preloadJsonError) ==
+        FDJSON_SUCCESS)
+      loaded++;
+  }
+
+  m_subdatas.clear();
+
+  return loaded;
+}
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <string.h>
+#include <sstream>
+
+#define RAPIDJSON_NAMESPACE fdrapidjson
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include "common_def.h"
+#include "fdjson.h"
+#include "logger.h"
+#include "options.h"
+#include "provisioning.h"
+#include "scassandra.h"
+#include "scodec.h"
+
+// maximum number of failed lines listed in the summary
+#define BULK_MAX_ERRORS 100
+
+typedef RAPIDJSON_NAMESPACE::Value BulkValue;
+
+static bool bulkGetHex(const BulkValue& v, uint8_t* dst, size_t len) {
+  return v.IsString() && v.GetStringLength() == len * 2 &&
+         SCodec::hexDecode(v.GetString(), dst, len);
+}
+
+// the MSISDN may be supplied as a number or as a string of digits
+static bool bulkGetMsisdn(const BulkValue& v, int64_t& msisdn) {
+  uint64_t u64;
+
+  if (v.IsInt64()) {
+    msisdn = v.GetInt64();
+    return msisdn > 0;
+  }
+
+  if (!v.IsString() || !SCodec::parseUint64(v.GetString(), u64) ||
+      u64 > INT64_MAX)
+    return false;
+
+  msisdn = (int64_t) u64;
+  return msisdn > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+BulkProvisioning::BulkProvisioning(DataAccess& dataaccess)
+    : m_dataaccess(dataaccess),
+      m_concurrent(
+          Options::getprovconcurrent() ? Options::getprovconcurrent() : 1),
+      m_window(m_concurrent, m_concurrent),
+      m_lines(0),
+      m_succeeded(0),
+      m_failed(0) {}
+
+BulkProvisioning::~BulkProvisioning() {}
+
+void BulkProvisioning::subscribers(const std::string& body) {
+  std::string line;
+  size_t pos = 0;
+
+  while (nextLine(body, pos, line)) subscriber(m_lines, line);
+
+  drain();
+
+  Logger::system().info(
+      "BulkProvisioning::%s - lines %zu succeeded %zu failed %zu", __func__,
+      m_lines, m_succeeded, m_failed);
+}
+
+void BulkProvisioning::mmes(const std::string& body) {
+  std::string line;
+  size_t pos = 0;
+
+  while (nextLine(body, pos, line)) mme(m_lines, line);
+
+  Logger::system().info(
+      "BulkProvisioning::%s - lines %zu succeeded %zu failed %zu", __func__,
+      m_lines, m_succeeded, m_failed);
+}
+
+std::string BulkProvisioning::summary() {
+  SMutexLock l(m_mutex);
+  std::stringstream ss;
+
+  ss << "{\"lines\":" << m_lines << ",\"succeeded\":" << m_succeeded
+     << ",\"failed\":" << m_failed << ",\"errors\":[";
+  for (auto it = m_errors.begin(); it != m_errors.end(); ++it)
+    ss << (it == m_errors.begin() ? "" : ",") << "{\"line\":" << it->first
+       << ",\"error\":\"" << it->second << "\"}";
+  ss << "]}";
+
+  return ss.str();
+}
+
+void BulkProvisioning::on_change_callback(CassFuture* future, void* data) {
+  SCassFuture f(future, true);
+  BulkProvisioningItem* item = (BulkProvisioningItem*) data;
+  BulkProvisioning& bulk     = item->bulk;
+  bool ok                    = false;
+
+  try {
+    ok = item->del ? bulk.m_dataaccess.deleteImsiData(f) :
+                     bulk.m_dataaccess.putImsiData(f);
+  } catch (DAException& ex) {
+    Logger::system().error(
+        "BulkProvisioning::%s - line %zu - EXCEPTION - %s", __func__,
+        item->line, ex.what());
+  }
+
+  bulk.complete(item->line, ok, "write failed");
+  delete item;
+
+  bulk.m_window.increment();
+}
+
+// returns the next non-empty line, the line numbers start at 1
+bool BulkProvisioning::nextLine(
+    const std::string& body, size_t& pos, std::string& line) {
+  while (pos < body.size()) {
+    size_t eol = body.find('\n', pos);
+    if (eol == std::string::npos) eol = body.size();
+
+    size_t end = eol;
+    if (end > pos && body[end - 1] == '\r') end--;
+
+    line.assign(body, pos, end - pos);
+    pos = eol + 1;
+
+    if (line.find_first_not_of(" \t") != std::string::npos) {
+      m_lines++;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void BulkProvisioning::subscriber(size_t line, const std::string& json) {
+  RAPIDJSON_NAMESPACE::Document doc;
+  std::string op("put");
+  int64_t msisdn = 0;
+
+  doc.Parse(json.c_str());
+  if (doc.HasParseError() || !doc.IsObject())
+    return complete(line, false, "invalid JSON");
+
+  if (doc.HasMember("op")) {
+    if (!doc["op"].IsString()) return complete(line, false, "invalid op");
+    op = doc["op"].GetString();
+  }
+
+  if (!doc.HasMember("imsi") || !doc["imsi"].IsString() ||
+      !SubscriberKey(doc["imsi"].GetString()).valid())
+    return complete(line, false, "invalid imsi");
+
+  if (doc.HasMember("msisdn") && !bulkGetMsisdn(doc["msisdn"], msisdn))
+    return complete(line, false, "invalid msisdn");
+
+  if (op == "delete") {
+    DAImsiInfo info = DAImsiInfo();
+    DAImsiSec sec;
+
+    // the index entry of the stored MSISDN is removed, not the one on the line
+    info.imsi = doc["imsi"].GetString();
+
+    return issue(new BulkProvisioningItem(*this, line, true), info, sec, 0);
+  }
+
+  // the Cassandra writes are upserts, so a put and a create are the same
+  // change, only the values on the line are written
+  if (op != "put" && op != "create" && op != "update")
+    return complete(line, false, "unrecognized op");
+
+  DAImsiInfo info = DAImsiInfo();
+  DAImsiSec sec;
+  uint32_t present_flags = 0;
+
+  memset(&sec, 0, sizeof(sec));
+
+  info.imsi   = doc["imsi"].GetString();
+  info.msisdn = msisdn;
+  if (doc.HasMember("msisdn")) {
+    if (msisdn != 0) info.str_msisdn = std::to_string(msisdn);
+    FLAGS_SET(present_flags, PUT_MSISDN_PRESENT);
+  }
+
+  if (doc.HasMember("access_restriction")) {
+    if (!doc["access_restriction"].IsInt())
+      return complete(line, false, "invalid access_restriction");
+    info.access_restriction = doc["access_restriction"].GetInt();
+    FLAGS_SET(present_flags, PUT_ACCESS_RESTRICTION_PRESENT);
+  }
+
+  // an update only changes the values it supplies, the security keys of a
+  // new subscriber are required
+  if (doc.HasMember("key")) {
+    if (!bulkGetHex(doc["key"], sec.key, KEY_LENGTH))
+      return complete(line, false, "invalid key");
+    FLAGS_SET(present_flags, PUT_KEY_PRESENT);
+  } else if (op != "update") {
+    return complete(line, false, "invalid key");
+  }
+  if (doc.HasMember("opc")) {
+    if (!bulkGetHex(doc["opc"], sec.opc, OPC_LENGTH))
+      return complete(line, false, "invalid opc");
+    FLAGS_SET(present_flags, PUT_OPC_PRESENT);
+  } else if (op != "update") {
+    return complete(line, false, "invalid opc");
+  }
+  if (doc.HasMember("rand")) {
+    if (!bulkGetHex(doc["rand"], sec.rand, RAND_LENGTH))
+      return complete(line, false, "invalid rand");
+    FLAGS_SET(present_flags, PUT_RAND_PRESENT);
+  }
+
+  if (doc.HasMember("sqn")) {
+    if (!doc["sqn"].IsUint64() || doc["sqn"].GetUint64() >> 48)
+      return complete(line, false, "invalid sqn");
+    FLAGS_SET(present_flags, PUT_SQN_PRESENT);
+
+    uint64_t sqn = doc["sqn"].GetUint64();
+    for (int i = SQN_LENGTH - 1; i >= 0; i--, sqn >>= 8)
+      sec.sqn[i] = (uint8_t) sqn;
+  }
+
+  if (doc.HasMember("subscription_data")) {
+    const BulkValue& sd = doc["subscription_data"];
+
+    if (sd.IsString()) {
+      info.subscription_data = sd.GetString();
+    } else if (sd.IsObject()) {
+      RAPIDJSON_NAMESPACE::StringBuffer sb;
+      RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::StringBuffer> writer(
+          sb);
+      sd.Accept(writer);
+      info.subscription_data = sb.GetString();
+    } else {
+      return complete(line, false, "invalid subscription_data");
+    }
+
+    // the encoded column is written with the JSON so the two always match
+    if (fdJsonEncodeAvps(
+            info.subscription_data.c_str(), info.subscription_data_bin,
+            NULL) != FDJSON_SUCCESS)
+      return complete(line, false, "invalid subscription_data");
+    FLAGS_SET(present_flags, PUT_SUBSCRIPTION_DATA_PRESENT);
+  }
+
+  issue(
+      new BulkProvisioningItem(*this, line, false), info, sec, present_flags);
+}
+
+void BulkProvisioning::mme(size_t line, const std::string& json) {
+  RAPIDJSON_NAMESPACE::Document doc;
+  std::string op("put");
+
+  doc.Parse(json.c_str());
+  if (doc.HasParseError() || !doc.IsObject())
+    return complete(line, false, "invalid JSON");
+
+  if (doc.HasMember("op")) {
+    if (!doc["op"].IsString()) return complete(line, false, "invalid op");
+    op = doc["op"].GetString();
+  }
+
+  if (!doc.HasMember("host") || !doc["host"].IsString() ||
+      doc["host"].GetStringLength() == 0)
+    return complete(line, false, "invalid host");
+
+  std::string host(doc["host"].GetString());
+  bool ok = false;
+
+  try {
+    if (op == "delete") {
+      ok = m_dataaccess.deleteMmeIdentity(host);
+    } else if (op == "put" || op == "create" || op == "update") {
+      if (!doc.HasMember("realm") || !doc["realm"].IsString())
+        return complete(line, false, "invalid realm");
+      if (!doc.HasMember("id") || !doc["id"].IsInt())
+        return complete(line, false, "invalid id");
+
+      std::string realm(doc["realm"].GetString());
+      ok = m_dataaccess.addMmeIdentity(host, realm, doc["id"].GetInt());
+    } else {
+      return complete(line, false, "unrecognized op");
+    }
+  } catch (DAException& ex) {
+    Logger::system().error(
+        "BulkProvisioning::%s - line %zu - EXCEPTION - %s", __func__, line,
+        ex.what());
+  }
+
+  complete(line, ok, "write failed");
+}
+
+// waits for a free slot in the window of outstanding changes and issues the
+// change, the callback releases the slot
+void BulkProvisioning::issue(
+    BulkProvisioningItem* item, DAImsiInfo& info, DAImsiSec& sec,
+    uint32_t present_flags) {
+  bool issued = false;
+
+  m_window.decrement();
+
+  try {
+    if (item->del)
+      issued = m_dataaccess.deleteImsi(info.imsi, on_change_callback, item);
+    else
+      issued = m_dataaccess.putImsi(
+          info, sec, present_flags, on_change_callback, item);
+  } catch (DAException& ex) {
+    Logger::system().error(
+        "BulkProvisioning::%s - line %zu - EXCEPTION - %s", __func__,
+        item->line, ex.what());
+  }
+
+  if (!issued) {
+    complete(item->line, false, item->del ? "not found" : "write failed");
+    delete item;
+    m_window.increment();
+  }
+}
+
+void BulkProvisioning::complete(size_t line, bool ok, const char* error) {
+  SMutexLock l(m_mutex);
+
+  if (ok) {
+    m_succeeded++;
+    return;
+  }
+
+  m_failed++;
+  if (m_errors.size() < BULK_MAX_ERRORS)
+    m_errors.push_back(std::make_pair(line, std::string(error)));
+}
+
+// waits for the outstanding changes by taking every slot of the window
+void BulkProvisioning::drain() {
+  for (unsigned i = 0; i < m_concurrent; i++) m_window.decrement();
+  for (unsigned i = 0; i < m_concurrent; i++) m_window.increment();
+}
@@ -18,7 +18,9 @@
 #include "rapidjson/error/en.h"
 #include "fdhss.h"
 
+#include "imeichange.h"
 #include "logger.h"
+#include "provisioning.h"
 #include "sstats.h"
 
 #include <pistache/endpoint.h>
@@ -26,11 +28,11 @@
 void RestHandler::onRequest(
     const Pistache::Http::Request& request,
     Pistache::Http::ResponseWriter response) {
-  std::cout << request.resource() << std::endl;
-  std::cout << request.method() << std::endl;
-  std::cout << request.body() << std::endl;
-
   if (request.resource() == "/imsis") {
+    Logger::system().debug(
+        "RestHandler::%s - %s %s", __func__, request.resource().c_str(),
+        request.body().c_str());
+
     ImsiImeiData data;
     RAPIDJSON_NAMESPACE::Document doc;
     std::string keyschema("userschema");
@@ -57,7 +59,23 @@ void RestHandler::onRequest(
         (data.old_imei_sv == data.new_imei_sv))
       return;
 
-    fdHss.sendRIR_ChangeImsiImeiSvAssn(data);
+    // the subscriber and its events are looked up on the worker threads
+    ImeiChangeProcessor::add(data);
+  } else if (
+      request.resource() == "/subscribers" || request.resource() == "/mmes") {
+    // bulk provisioning, the body is too large to be logged
+    Logger::system().debug(
+        "RestHandler::%s - %s %zu bytes", __func__,
+        request.resource().c_str(), request.body().size());
+
+    BulkProvisioning bulk(fdHss.getDb());
+
+    if (request.resource() == "/subscribers")
+      bulk.subscribers(request.body());
+    else
+      bulk.mmes(request.body());
+
+    response.send(Pistache::Http::Code::Ok, bulk.summary());
   } else {
     std::stringstream ss;
     ss << "Unrecognized resource [" << request.resource() << "]";
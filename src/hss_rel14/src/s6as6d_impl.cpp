@@ -26,6 +26,7 @@
 #include "s6t_impl.h"
 #include "dataaccess.h"
 #include "fdhss.h"
+#include "scassandra.h"
 #include "rapidjson/document.h"
 #include "statshss.h"
 #include "util.h"
@@ -123,6 +124,11 @@ void dumpUlrTimers() {
 #define ULR_TIMER_SET(_timer, _ofs)
 #endif
 
+#ifdef PHASE_TIMING
+PhaseTiming ulrPhaseTiming;
+PhaseTiming airPhaseTiming;
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -333,7 +339,8 @@ int AUIRcmd::process(FDMessageRequest* req) {
 
 IDRRreq::IDRRreq(
     Application& app, FDMessageRequest* cir_req, EvenStatusMap* evt_map,
-    RIRBuilder* rirbuilder, std::string& imsi, std::string& msisdn)
+    RIRBuilder* rirbuilder, const SubscriberKey& imsi,
+    const SubscriberKey& msisdn)
     : INSDRreq(app),
       cir_req(cir_req),
       evt_map(evt_map),
@@ -346,15 +353,8 @@ void IDRRreq::processAnswer(FDMessageAnswer& ans) {
   // Extract the IDA.
   InsertSubscriberDataAnswerExtractor ida(ans, getApplication().getDict());
 
-  // Build the CIA from the stored request.
   s6t::Application* s6tApp = fdHss.gets6tApp();
 
-  FDMessageAnswer cia(cir_req);
-
-  cia.add(s6tApp->getDict().avpAuthSessionState(), 1);
-  cia.addOrigin();
-  cia.add(s6tApp->getDict().avpResultCode(), ER_DIAMETER_SUCCESS);
-
   uint32_t vendor_code     = 0;
   uint32_t ida_result_code = 0;
   // check the global status from the IDA response
@@ -372,6 +372,14 @@ void IDRRreq::processAnswer(FDMessageAnswer& ans) {
     /////Single IMSI case
     //////////////////////////////////
 
+    // Build the CIA from the stored request, a group CIR has already been
+    // answered
+    FDMessageAnswer cia(cir_req);
+
+    cia.add(s6tApp->getDict().avpAuthSessionState(), 1);
+    cia.addOrigin();
+    cia.add(s6tApp->getDict().avpResultCode(), ER_DIAMETER_SUCCESS);
+
     // Fill the long term event result status based on the insertion result on
     // db
     for (EvenStatusMap::iterator it = evt_map->begin(); it != evt_map->end();
@@ -532,11 +540,12 @@ void IDRRreq::processAnswer(FDMessageAnswer& ans) {
 // Sends a INSDR Request to the corresponding Peer
 int Application::sendINSDRreq(
     s6t::MonitoringEventConfigurationExtractorList& cir_monevtcfg,
-    std::string& imsi, FDMessageRequest* cir_req, EvenStatusMap* evt_map,
-    RIRBuilder* rir_builder) {
+    const SubscriberKey& imsi, FDMessageRequest* cir_req,
+    EvenStatusMap* evt_map, RIRBuilder* rir_builder) {
   DAImsiInfo imsi_info;
-  // 1.get the subscription data from database
-  m_dbobj.getImsiInfo((char*) imsi.c_str(), imsi_info, NULL, NULL);
+  // 1.get the subscription data from database, the tables are keyed by the
+  // IMSI text
+  m_dbobj.getImsiInfo(imsi.str().c_str(), imsi_info, NULL, NULL);
   bool imsi_attached = (imsi_info.ms_ps_status == "ATTACHED");
   FDPeer peer;
   peer.setDiameterId((DiamId_t) imsi_info.mmehost.c_str());
@@ -548,31 +557,30 @@ int Application::sendINSDRreq(
     if (rir_builder == NULL) {
       // simple imsi
       if (!imsi_attached) {
-        printf(
-            "****************Application::sendINSDRreq::IMSI_NOT_ACTIVE\n\n");
+        Logger::s6as6d().debug(
+            "Application::%s - IMSI_NOT_ACTIVE", __func__);
         return IMSI_NOT_ACTIVE;
       }
-      printf(
-          "****************Application::sendINSDRreq::MME_DOWN: %s\n\n",
+      Logger::s6as6d().debug(
+          "Application::%s - MME_DOWN: %s", __func__,
           imsi_info.mmehost.c_str());
       return MME_DOWN;
     } else {
-      printf("****************Application::sendINSDRreq::MULTI IMSI\n\n");
+      Logger::s6as6d().debug("Application::%s - MULTI IMSI", __func__);
 
       // multi imsi
       if (!imsi_attached) {
-        printf(
-            "****************Application::sendINSDRreq::POSTING fake "
-            "IMSI_NOT_ACTIVE\n\n");
+        Logger::s6as6d().debug(
+            "Application::%s - POSTING fake IMSI_NOT_ACTIVE", __func__);
         HandleMmeResponseEvtMsg* e = new HandleMmeResponseEvtMsg(
-            NULL, imsi, IMSI_NOT_ACTIVE, imsi_info.str_msisdn);
+            NULL, imsi, IMSI_NOT_ACTIVE,
+            SubscriberKey::fromValue(imsi_info.msisdn));
         rir_builder->postMessage(e);
       } else if (!mme_reachable) {
-        printf(
-            "****************Application::sendINSDRreq::POSTING fake "
-            "MME_DOWN\n\n");
+        Logger::s6as6d().debug(
+            "Application::%s - POSTING fake MME_DOWN", __func__);
         HandleMmeResponseEvtMsg* e = new HandleMmeResponseEvtMsg(
-            NULL, imsi, MME_DOWN, imsi_info.str_msisdn);
+            NULL, imsi, MME_DOWN, SubscriberKey::fromValue(imsi_info.msisdn));
         rir_builder->postMessage(e);
       }
       return true;
@@ -598,14 +606,87 @@ int Application::sendINSDRreq(
   return s != NULL;
 }
 
+bool Application::sendINSDRreq(
+    const std::string& monevtcfg, const SubscriberKey& imsi,
+    DAImsiInfo& imsi_info, RIRBuilder* rir_builder) {
+  INSDRreq* s = createINSDRreq(monevtcfg, imsi, imsi_info, rir_builder);
+
+  try {
+    if (s) {
+      s->send();
+    }
+  } catch (FDException& ex) {
+    Logger::s6as6d().error("EXCEPTION - %s", ex.what());
+    delete s;
+    s = NULL;
+  }
+
+  return s != NULL;
+}
+
+int Application::addSubscriptionData(
+    DAImsiInfo& info, msg_or_avp* msg, void (*errfunc)(const char*)) {
+  DAView bin = info.getSubscriptionDataBin();
+
+  if (!bin.empty())
+    return fdJsonAddEncodedAvps(
+        (const uint8_t*) bin.data(), bin.size(), msg, errfunc);
+
+  // a subscriber that has not been migrated, or whose JSON was provisioned
+  // after the encoded column was written, is read from the JSON
+  DAView json = info.getSubscriptionDataView();
+
+  return fdJsonAddAvpsCached(json.data(), json.size(), msg, errfunc);
+}
+
 // A factory for INSDR reuqests
 INSDRreq* Application::createINSDRreq(
     s6t::MonitoringEventConfigurationExtractorList& cir_monevtcfg,
-    std::string& imsi, FDMessageRequest* cir_req, EvenStatusMap* evt_map,
+    const SubscriberKey& imsi, FDMessageRequest* cir_req,
+    EvenStatusMap* evt_map, DAImsiInfo& imsi_info, RIRBuilder* rir_builder) {
+  INSDRreq* s = createIDRRreq(imsi, cir_req, evt_map, imsi_info, rir_builder);
+
+  // 3.create a extractor to get to the subscription data avp
+  InsertSubscriberDataRequestExtractor idr(*s, getDict());
+  // 4. Get the pointer to the subscription data
+  FDAvp subscription_data(
+      getDict().avpSubscriptionData(),
+      (struct avp*) idr.subscription_data.getReference());
+  subscription_data.add(cir_monevtcfg);
+
+  return s;
+}
+
+// A factory for the INSDR requests of a group configuration, the
+// Monitoring-Event-Configuration AVP's are added from their Diameter encoding
+// since the CIR may already have been answered and freed
+INSDRreq* Application::createINSDRreq(
+    const std::string& monevtcfg, const SubscriberKey& imsi,
     DAImsiInfo& imsi_info, RIRBuilder* rir_builder) {
+  INSDRreq* s = createIDRRreq(imsi, NULL, NULL, imsi_info, rir_builder);
+
+  InsertSubscriberDataRequestExtractor idr(*s, getDict());
+  if (fdJsonAddEncodedAvps(
+          (const uint8_t*) monevtcfg.data(), monevtcfg.size(),
+          idr.subscription_data.getReference(), NULL) != FDJSON_SUCCESS) {
+    Logger::s6as6d().error(
+        "Application::%s - Unable to add the Monitoring-Event-Configuration "
+        "for IMSI %s",
+        __func__, imsi.str().c_str());
+    delete s;
+    return NULL;
+  }
+
+  return s;
+}
+
+INSDRreq* Application::createIDRRreq(
+    const SubscriberKey& imsi, FDMessageRequest* cir_req,
+    EvenStatusMap* evt_map, DAImsiInfo& imsi_info, RIRBuilder* rir_builder) {
   //  creates the INSDRreq object
   INSDRreq* s = new IDRRreq(
-      *this, cir_req, evt_map, rir_builder, imsi, imsi_info.str_msisdn);
+      *this, cir_req, evt_map, rir_builder, imsi,
+      SubscriberKey::fromValue(imsi_info.msisdn));
 
   s->add(getDict().avpSessionId(), s->getSessionId());
 
@@ -613,23 +694,18 @@ INSDRreq* Application::createINSDRreq(
 
   s->addOrigin();
 
-  s->add(getDict().avpUserName(), imsi);
+  s->add(getDict().avpUserName(), imsi.str());
 
   {
     s->add(getDict().avpDestinationHost(), imsi_info.mmehost);
     s->add(getDict().avpDestinationRealm(), imsi_info.mmerealm);
 
-    printf("Subscription data: %s \n", imsi_info.subscription_data.c_str());
-
     // 2.add the subscription data to the message
-    fdJsonAddAvps(imsi_info.subscription_data.c_str(), s->getMsg(), NULL);
-    // 3.create a extractor to get to the subscription data avp
-    InsertSubscriberDataRequestExtractor idr(*s, getDict());
-    // 4. Get the pointer to the subscription data
-    FDAvp subscription_data(
-        getDict().avpSubscriptionData(),
-        (struct avp*) idr.subscription_data.getReference());
-    subscription_data.add(cir_monevtcfg);
+    addSubscriptionData(imsi_info, s->getMsg(), NULL);
+
+    Logger::s6as6d().debug(
+        "Application::%s - Subscription data: %s", __func__,
+        imsi_info.subscription_data.c_str());
   }
   return s;
 }
@@ -896,7 +972,11 @@ void ULRStateProcessor::process() {
 
 ULRProcessor::ULRProcessor(
     FDMessageRequest& req, s6as6d::Application& app, s6as6d::Dictionary& dict)
-    : m_ulr(req, dict), m_ans(&req), m_app(app), m_dict(dict) {
+    : QueueProcessor(HSS_QUEUE_ULR),
+      m_ulr(req, dict),
+      m_ans(&req),
+      m_app(app),
+      m_dict(dict) {
   m_perf_timer    = 0;
   m_present_flags = 0;
   m_plmn_len      = sizeof(m_plmn_id);
@@ -920,6 +1000,7 @@ ULRProcessor::~ULRProcessor() {}
 
 void ULRProcessor::on_ulr_callback(CassFuture* future, void* data) {
   SCassFuture f(future, true);
+  PHASE_TIMING_START(cb_start, PHASE_TIMING_CALLBACK);
   ULRDatabaseAction* action = (ULRDatabaseAction*) data;
 #ifdef TRACK_EXECUTION
   const char* actions[] = {
@@ -982,6 +1063,8 @@ void ULRProcessor::on_ulr_callback(CassFuture* future, void* data) {
   if (l.acquire(false)) action->getProcessor().triggerNextPhase();
 
   atomic_dec_fetch(action->getProcessor().m_dbissued);
+
+  PHASE_TIMING_STOP(ulrPhaseTiming, cb_start);
 }
 
 void ULRProcessor::triggerNextPhase() {
@@ -1065,6 +1148,7 @@ void ULRProcessor::processNextPhase(ULRProcessor* pthis) {
           "%lld,%s,%p,%s\n", STIMER_GET_CURRENT_TIME, __PRETTY_FUNCTION__,
           pthis, phases[pthis->m_nextphase - ULRSTATE_BASE]);
 #endif
+      PHASE_TIMING_START(phase_start, pthis->m_nextphase - ULRSTATE_BASE);
       switch (pthis->m_nextphase) {
         case ULRSTATE_PHASE1: {
           pthis->phase1();
@@ -1098,13 +1182,14 @@ void ULRProcessor::processNextPhase(ULRProcessor* pthis) {
           break;
         }
       }
+      PHASE_TIMING_STOP(ulrPhaseTiming, phase_start);
     }
   }
 
   if (deleteProc) {
     delete deleteProc;
     deleteProc = NULL;
-    fdHss.getWorkerQueue().finishProcessor();
+    fdHss.getWorkerQueue().finishProcessor(HSS_QUEUE_ULR);
     fdHss.getWorkerQueue().startProcessor();
   }
 }
@@ -1259,13 +1344,7 @@ void ULRProcessor::getEvents(SCassFuture& future) {
 }
 
 void ULRProcessor::updateImsiInfo(SCassFuture& future) {
-  bool success = future.errorCode() == CASS_OK;
-
-  if (!success)
-    Logger::s6as6d().error(
-        "DataAccess::%s - Error %d executing updateImsiInfo()", __func__,
-        future.errorCode());
-
+  bool success = m_app.dataaccess().updateLocationData(future);
   DB_OP_COMPLETE(ULRDB_UPDATE_IMSI, m_dbexecuted, m_dbresult, success);
 }
 
@@ -1302,8 +1381,7 @@ void ULRProcessor::phase1() {
 
 #ifdef PERFORMANCE_TIMING
   {
-    uint64_t uimsi;
-    sscanf(m_new_info.imsi.c_str(), "%" SCNu64, &uimsi);
+    uint64_t uimsi = SubscriberKey(m_new_info.imsi).value();
     m_perf_timer = uimsi - 1014567891234ULL;
     if (m_perf_timer >= 0 && m_perf_timer < MAX_ULR_TIMERS)
       ulrTimers[m_perf_timer].ulr1 = start_timer;
@@ -1320,11 +1398,25 @@ void ULRProcessor::phase1() {
 
   m_nextphase = ULRSTATE_PHASE2;
 
+  // the subscription data is not read when the MME does not want it
+  m_ulr.ulr_flags.get(m_ulrflags);
+
   result = m_app.dataaccess().getImsiInfo(
-      m_new_info.imsi.c_str(), m_orig_info, on_ulr_callback,
+      m_new_info.imsi.c_str(), m_orig_info,
+      !FLAG_IS_SET(m_ulrflags, ULR_SKIP_SUBSCRIBER_DATA), on_ulr_callback,
       new ULRDatabaseAction(ULRDB_GET_IMSI_INFO, *this));
 
-  if (result) {
+  // most subscribers have no monitoring events, the event queries are not
+  // issued for a subscriber the data access has ruled out
+  bool noevents =
+      result && !m_app.dataaccess().mayHaveEvents(m_new_info.imsi.c_str());
+
+  if (noevents) {
+    DB_OP_COMPLETE(ULRDB_GET_EXT_IDS, m_dbexecuted, m_dbresult, true);
+    DB_OP_COMPLETE(ULRDB_GET_EVNTIDS_MSISDN, m_dbexecuted, m_dbresult, true);
+    DB_OP_COMPLETE(ULRDB_GET_EVNTIDS_EXTIDS, m_dbexecuted, m_dbresult, true);
+    DB_OP_COMPLETE(ULRDB_GET_EVNTS_EVNTIDS, m_dbexecuted, m_dbresult, true);
+  } else if (result) {
     atomic_inc_fetch(m_dbissued);
     result = m_app.dataaccess().getExtIdsFromImsi(
         m_new_info.imsi.c_str(), m_extIdLst, on_ulr_callback,
@@ -1340,7 +1432,7 @@ void ULRProcessor::phase1() {
     DB_OP_COMPLETE(ULRDB_GET_IMSI_INFO, m_dbexecuted, m_dbresult, result);
   }
 
-  if (result) {
+  if (result && !noevents) {
     atomic_inc_fetch(m_dbissued);
     result = m_app.dataaccess().getEventIdsFromMsisdn(
         m_new_info.msisdn, m_evtIdLst, on_ulr_callback,
@@ -1559,13 +1651,12 @@ void ULRProcessor::phase2() {
 
   m_ans.add(m_app.getDict().avpUlaFlags(), 1);
 
-  m_ulr.ulr_flags.get(m_ulrflags);
   if (!FLAG_IS_SET(m_ulrflags, ULR_SKIP_SUBSCRIBER_DATA)) {
     ULR_TIMER_SET(ulr4, m_perf_timer);
 
-    if (fdJsonAddAvps(
-            m_orig_info.subscription_data.c_str(), m_ans.getMsg(),
-            &s6as6d::display_error_message) != 0) {
+    if (m_app.addSubscriptionData(
+            m_orig_info, m_ans.getMsg(), &s6as6d::display_error_message) !=
+        0) {
       FDAvp er(m_dict.avpExperimentalResult());
       er.add(m_dict.avpVendorId(), VENDOR_3GPP);
       er.add(
@@ -1575,7 +1666,7 @@ void ULRProcessor::phase2() {
       m_ans.send();
       StatsHss::singleton().registerStatResult(
           stat_hss_ulr, VENDOR_3GPP, DIAMETER_ERROR_UNKNOWN_EPS_SUBSCRIPTION);
-      printf("%s:%d - ULRProcessor::phase2() aborting\n", __FILE__, __LINE__);
+      Logger::s6as6d().debug("ULRProcessor::%s - aborting", __func__);
       m_nextphase = ULRSTATE_PHASEFINAL;
       return;
     }
@@ -1742,7 +1833,11 @@ void AIRStateProcessor::process() {
 
 AIRProcessor::AIRProcessor(
     FDMessageRequest& req, s6as6d::Application& app, s6as6d::Dictionary& dict)
-    : m_air(req, dict), m_ans(&req), m_app(app), m_dict(dict) {
+    : QueueProcessor(HSS_QUEUE_AIR),
+      m_air(req, dict),
+      m_ans(&req),
+      m_app(app),
+      m_dict(dict) {
   m_uimsi       = 0;
   m_num_vectors = 0;
   m_plmn_len    = sizeof(m_plmn_id);
@@ -1763,6 +1858,7 @@ AIRProcessor::~AIRProcessor() {}
 
 void AIRProcessor::on_air_callback(CassFuture* future, void* data) {
   SCassFuture f(future, true);
+  PHASE_TIMING_START(cb_start, PHASE_TIMING_CALLBACK);
   AIRDatabaseAction* action = (AIRDatabaseAction*) data;
 #ifdef TRACK_EXECUTION
   const char* actions[] = {"AIRDB_GET_IMSI_SEC", "AIRDB_UPDATE_IMSI",
@@ -1792,6 +1888,8 @@ void AIRProcessor::on_air_callback(CassFuture* future, void* data) {
   if (l.acquire(false)) action->getProcessor().triggerNextPhase();
 
   atomic_dec_fetch(action->getProcessor().m_dbissued);
+
+  PHASE_TIMING_STOP(airPhaseTiming, cb_start);
 }
 
 void AIRProcessor::triggerNextPhase() {
@@ -1858,6 +1956,7 @@ void AIRProcessor::processNextPhase(AIRProcessor* pthis) {
           "%lld,%s,%p,%s\n", STIMER_GET_CURRENT_TIME, __PRETTY_FUNCTION__,
           pthis, phases[pthis->m_nextphase - AIRSTATE_BASE]);
 #endif
+      PHASE_TIMING_START(phase_start, pthis->m_nextphase - AIRSTATE_BASE);
       switch (pthis->m_nextphase) {
         case AIRSTATE_PHASE1: {
           pthis->phase1();
@@ -1883,12 +1982,13 @@ void AIRProcessor::processNextPhase(AIRProcessor* pthis) {
           break;
         }
       }
+      PHASE_TIMING_STOP(airPhaseTiming, phase_start);
     }
   }
 
   if (deleteProc) {
     delete deleteProc;
-    fdHss.getWorkerQueue().finishProcessor();
+    fdHss.getWorkerQueue().finishProcessor(HSS_QUEUE_AIR);
     fdHss.getWorkerQueue().startProcessor();
   }
 }
@@ -1901,14 +2001,8 @@ void AIRProcessor::getImsiSec(SCassFuture& future) {
 }
 
 void AIRProcessor::updateImsi(SCassFuture& future) {
-  bool success = future.errorCode() == CASS_OK;
+  bool success = m_app.dataaccess().updateRandSqnData(future);
   DB_OP_COMPLETE(AIRDB_UPDATE_IMSI, m_dbexecuted, m_dbresult, success);
-
-  if (!success) {
-    Logger::system().warn(
-        "AIRProcessor::%s - Error %d while executing updateRandSqn()", __func__,
-        future.errorCode());
-  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1922,7 +2016,8 @@ void AIRProcessor::phase1() {
   m_ans.add(m_dict.avpAuthSessionState(), u32);
 
   m_air.user_name.get(m_imsi);
-  if (m_imsi.length() > IMSI_LENGTH) {
+  SubscriberKey imsikey(m_imsi);
+  if (!imsikey.valid()) {
     m_ans.add(m_dict.avpResultCode(), ER_DIAMETER_INVALID_AVP_VALUE);
     m_ans.send();
     StatsHss::singleton().registerStatResult(
@@ -1931,7 +2026,7 @@ void AIRProcessor::phase1() {
     return;
   }
 
-  sscanf(m_imsi.c_str(), "%" SCNu64, &m_uimsi);
+  m_uimsi = imsikey.value();
 
   bool eutran_avp_found = false;
 
@@ -24,6 +24,7 @@
 #include "s6t_impl.h"
 #include "fdhss.h"
 #include "dataaccess.h"
+#include "groupcir.h"
 #include <inttypes.h>
 
 #include "fdjson.h"
@@ -34,6 +35,10 @@
 #define MSISDN_LEN 10
 #define IMSI_LEN 15
 
+// an MSISDN has up to 15 digits, which is 8 bytes encoded as TBCD
+#define MSISDN_DIGITS 15
+#define MSISDN_TBCD_LEN 8
+
 #define GROUP_CONFIGURATION_IN_PROGRESS (1U)
 #define ABSENT_SUBSCRIBER (1U)
 
@@ -139,6 +144,11 @@ int processHssDb(
   // COMON BLOCK
   ///////////////////////
 
+  // the long term events are removed and added with a single write, the
+  // results of the configurations in the batch are set once it completes
+  DAEventBatch batch;
+  std::list<std::pair<MonitoringConfEventStatus, bool> > results;
+
   for (std::list<MonitoringEventConfigurationExtractor*>::iterator monevt_it =
            cir.monitoring_event_configuration.getList().begin();
        monevt_it != cir.monitoring_event_configuration.getList().end();
@@ -155,37 +165,27 @@ int processHssDb(
         (*delete_it)->get(scef_ref_id);
         (*monevt_it)->scef_id.get(scef_id);
 
-        bool delete_evt_fail = false;
-        bool is_long_evt     = true;
+        bool batched = false;
         try {
           DAEvent event;
           if (m_app.getDbObj().getEvent(scef_id, scef_ref_id, event)) {
-            m_app.getDbObj().deleteEvent(scef_id, scef_ref_id);
-            // if( !m_app.getDbObj().deleteEvent(scef_id, scef_ref_id ) ){
-            //   delete_evt_fail = true;
-            //}
-          } else {
-            // the event does not exists
-            is_long_evt     = false;
-            delete_evt_fail = true;
+            batch.remove(event);
+            batched = true;
           }
         } catch (...) {
           std::cout << "Error accesing db for evt removal" << std::endl;
-          is_long_evt     = false;
-          delete_evt_fail = true;
         }
         MonitoringConfEventStatus aconf(true);
         aconf.scef_id     = scef_id;
         aconf.scef_ref_id = scef_ref_id;
-        aconf.forceLongTerm(is_long_evt);
 
-        if (delete_evt_fail) {
+        // an event that does not exist, or could not be read, is not long
+        // term
+        if (!batched) {
+          aconf.forceLongTerm(false);
           aconf.result = DIAMETER_ERROR_CONFIGURATION_EVENT_NON_EXISTANT;
-        } else {
-          aconf.result = DIAMETER_SUCCESS;
         }
-        evt_map->insert(std::make_pair(
-            std::make_pair(aconf.scef_id, aconf.scef_ref_id), aconf));
+        results.push_back(std::make_pair(aconf, batched));
       }
     }
 
@@ -225,34 +225,44 @@ int processHssDb(
       // we only add long term event to the db, the short term
       // are consider as failing and we will wait to mme response
       // for a final resolution.
-      bool add_evt_fail = false;
-      try {
-        if (aconf.isLongTermEvt()) {
-          if (!m_app.getDbObj().addEvent(acfgevt)) {
-            add_evt_fail = true;
-          }
-        } else {
-          add_evt_fail = true;
-        }
-      } catch (DAException& ex) {
-        printf("%s\n", ex.what());
-        add_evt_fail = true;
-      } catch (...) {
-        add_evt_fail = true;
-      }
+      bool batched = aconf.isLongTermEvt();
+      if (batched) batch.add(acfgevt);
 
-      if (aconf.isLongTermEvt()) {
-        if (add_evt_fail) {
-          aconf.result =
-              DIAMETER_ERROR_CONFIGURATION_EVENT_STORAGE_NOT_SUCCESSFUL;
-        } else {
-          aconf.result = DIAMETER_SUCCESS;
-        }
-      }
+      results.push_back(std::make_pair(aconf, batched));
+    }
+  }
+
+  bool batch_fail = false;
+  if (!batch.empty()) {
+    try {
+      if (!m_app.getDbObj().applyEvents(batch, NULL, NULL)) batch_fail = true;
+    } catch (DAException& ex) {
+      printf("%s\n", ex.what());
+      batch_fail = true;
+    } catch (...) {
+      batch_fail = true;
+    }
+  }
+
+  for (auto it = results.begin(); it != results.end(); ++it) {
+    MonitoringConfEventStatus& aconf = it->first;
 
-      evt_map->insert(std::make_pair(
-          std::make_pair(aconf.scef_id, aconf.scef_ref_id), aconf));
+    if (it->second) {
+      if (aconf.is_remove) {
+        aconf.forceLongTerm(!batch_fail);
+        aconf.result = batch_fail
+                           ? DIAMETER_ERROR_CONFIGURATION_EVENT_NON_EXISTANT
+                           : DIAMETER_SUCCESS;
+      } else {
+        aconf.result =
+            batch_fail
+                ? DIAMETER_ERROR_CONFIGURATION_EVENT_STORAGE_NOT_SUCCESSFUL
+                : DIAMETER_SUCCESS;
+      }
     }
+
+    evt_map->insert(std::make_pair(
+        std::make_pair(aconf.scef_id, aconf.scef_ref_id), aconf));
   }
   return 0;
 }
@@ -267,7 +277,8 @@ int processSimpleImsi(
   // The CIA response will be built on the s6as6d interface once the IDA coming
   // from the MME is received
   int ret = fdHss.sendINSDRreq(
-      cir.monitoring_event_configuration, imsi, req, hss_db_rst, NULL);
+      cir.monitoring_event_configuration, SubscriberKey(imsi), req,
+      hss_db_rst, NULL);
 
   if (ret == MME_DOWN || ret == IMSI_NOT_ACTIVE) {
     // The idr is not sent, either because the mme is down or the imsi is not
@@ -347,14 +358,16 @@ int processMultiImsi(
 
   rir_builder->init(NULL);
 
-  for (std::list<std::string>::iterator it_imsi = list_imsi.begin();
-       it_imsi != list_imsi.end(); ++it_imsi) {
-    // we need to build an event thread object, send it here and keep and keep
-    // it on the IDRRreq, so it will be available to store the responses.
-    fdHss.sendINSDRreq(
-        cir.monitoring_event_configuration, *it_imsi, req, hss_db_rst,
-        rir_builder);
-  }
+  // The IDR's are sent by the group configuration thread, which reports the
+  // members it does not send an IDR to the RIR builder.  The monitoring event
+  // configuration is copied since the CIR is freed once it has been answered.
+  std::string monevtcfg;
+  GroupConfiguration::encodeMonitoringEventConfiguration(
+      cir.monitoring_event_configuration, monevtcfg);
+
+  GroupConfiguration* group = new GroupConfiguration(
+      *fdHss.gets6as6dApp(), list_imsi, monevtcfg, rir_builder, origin_host);
+  group->init(NULL);
 
   ans.send();
   delete req;
@@ -375,7 +388,7 @@ int COIRcmd::process(FDMessageRequest* req) {
   int result_code = ER_DIAMETER_SUCCESS;
 
   uint8_t msisdn[MSISDN_LEN];
-  char msisdnchar[MSISDN_LEN + 1];
+  char msisdnchar[MSISDN_DIGITS + 1];
   int64_t msisdn64;
 
   DAImsiList list_imsi;
@@ -389,7 +402,12 @@ int COIRcmd::process(FDMessageRequest* req) {
       size_t amsisdn_size = sizeof(msisdn);
       if (cir.user_identifier.msisdn.get(msisdn, amsisdn_size)) {
         // SINGLE IMSI
-        FDUtility::tbcd2str(msisdn, amsisdn_size, msisdnchar, MSISDN_LEN + 1);
+        if (FDUtility::tbcd2str(
+                msisdn, amsisdn_size, msisdnchar, sizeof(msisdnchar)) == 0) {
+          experimental = false;
+          result_code  = ER_DIAMETER_INVALID_AVP_VALUE;
+          break;
+        }
         // Single ue scenario
         msisdn64 = std::stoll(msisdnchar);
         std::string imsi;
@@ -583,8 +601,7 @@ bool checkAPNSubscribed(
 int NIIRcmd::process(FDMessageRequest* req) {
   std::string s, reqValidTime, origHost, origRealm;
   uint8_t msisdn[MSISDN_LEN];
-  char msisdnchar[MSISDN_LEN + 1];
-  uint8_t imsi[IMSI_LEN];
+  char msisdnchar[MSISDN_DIGITS + 1];
   char imsichar[IMSI_LEN + 1];
   std::string apn;
   bool experimental = false;
@@ -594,7 +611,7 @@ int NIIRcmd::process(FDMessageRequest* req) {
   req->dump();
   s6t::NiddInformationRequestExtractor nir(*req, m_app.getDict());
   size_t msisdn_size = sizeof(msisdn);
-  size_t imsi_size   = sizeof(imsi);
+  size_t imsi_size   = sizeof(imsichar);
 
   // Create answer associated with the NIIR command
   FDMessageAnswer ans(req);
@@ -602,8 +619,8 @@ int NIIRcmd::process(FDMessageRequest* req) {
   ans.add(m_app.getDict().avpAuthSessionState(), 1);
   ans.add(m_app.getDict().avpResultCode(), ER_DIAMETER_SUCCESS);
 
-  if (nir.user_identifier.user_name.get(imsi, imsi_size)) {
-    FDUtility::tbcd2str(imsi, imsi_size, imsichar, IMSI_LEN + 1);
+  // the User-Name is the IMSI as text, not TBCD encoded
+  if (nir.user_identifier.user_name.get(imsichar, imsi_size)) {
     std::string msisdnFromDB, subDataFromDB, apnFromDB;
     DAExtIdList extids;
 
@@ -621,9 +638,10 @@ int NIIRcmd::process(FDMessageRequest* req) {
       // the IMSI in the NIDD-Authorization-Response.
 
       FDAvp ga(m_app.getDict().avpNiddAuthorizationResponse());
-      uint8_t msisdntbcd[MSISDN_LEN];
-      FDUtility::str2tbcd(msisdnFromDB.c_str(), msisdntbcd, msisdn_size);
-      ga.add(m_app.getDict().avpMsisdn(), msisdntbcd, msisdn_size);
+      uint8_t msisdntbcd[MSISDN_TBCD_LEN];
+      size_t len =
+          FDUtility::str2tbcd(msisdnFromDB, msisdntbcd, sizeof(msisdntbcd));
+      if (len > 0) ga.add(m_app.getDict().avpMsisdn(), msisdntbcd, len);
 
       for (DAExtIdList::iterator it = extids.begin(); it != extids.end();
            it++) {
@@ -654,10 +672,13 @@ int NIIRcmd::process(FDMessageRequest* req) {
   }
 
   else if (nir.user_identifier.msisdn.get(msisdn, msisdn_size)) {
-    FDUtility::tbcd2str(msisdn, msisdn_size, msisdnchar, MSISDN_LEN + 1);
     std::string imsiFromDB;
 
-    if (m_app.getDbObj().getImsiFromMsisdn(msisdnchar, imsiFromDB)) {
+    if (FDUtility::tbcd2str(
+            msisdn, msisdn_size, msisdnchar, sizeof(msisdnchar)) == 0) {
+      experimental = false;
+      result_code  = ER_DIAMETER_INVALID_AVP_VALUE;
+    } else if (m_app.getDbObj().getImsiFromMsisdn(msisdnchar, imsiFromDB)) {
       DAExtIdList extids;
       if (nir.nidd_authorization_request.service_selection.get(apn)) {
         if (!checkAPNSubscribed(imsiFromDB.c_str(), apn, m_app)) {
@@ -695,7 +716,8 @@ int NIIRcmd::process(FDMessageRequest* req) {
         // the above mentioned method in HSS
 
         if (nir.origin_host.get(origHost) && nir.origin_realm.get(origRealm)) {
-          m_app.getDbObj().UpdateNIRDestination(imsichar, origHost, origRealm);
+          m_app.getDbObj().UpdateNIRDestination(
+              imsiFromDB, origHost, origRealm);
         }
       }
     }
@@ -710,9 +732,9 @@ int NIIRcmd::process(FDMessageRequest* req) {
       FDAvp ga(m_app.getDict().avpNiddAuthorizationResponse());
 
       if (nir.nidd_authorization_request.service_selection.get(apn)) {
-        for (std::list<std::string>::iterator it = imsilst.begin();
-             it != imsilst.end(); it++) {
-          if (!checkAPNSubscribed((*it).c_str(), apn, m_app)) {
+        for (DAImsiList::iterator it = imsilst.begin(); it != imsilst.end();
+             it++) {
+          if (!checkAPNSubscribed(it->str().c_str(), apn, m_app)) {
             experimental = true;
             result_code  = DIAMETER_ERROR_USER_NO_APN_SUBSCRIPTION;
             // goto output;
@@ -722,13 +744,16 @@ int NIIRcmd::process(FDMessageRequest* req) {
       // include the IMSI and if available the MSISDN associated with the
       // appropriate External Identifier in the NIDD-Authorization-Response
 
-      for (std::list<std::string>::iterator it = imsilst.begin();
-           it != imsilst.end(); it++) {
-        ga.add(m_app.getDict().avpUserName(), *it);
-        if (m_app.getDbObj().getMsisdnFromImsi(*it, msisdnFromDB)) {
-          uint8_t msisdntbcd[MSISDN_LEN];
-          FDUtility::str2tbcd(msisdnFromDB.c_str(), msisdntbcd, msisdn_size);
-          ga.add(m_app.getDict().avpMsisdn(), msisdntbcd, msisdn_size);
+      for (DAImsiList::iterator it = imsilst.begin(); it != imsilst.end();
+           it++) {
+        std::string imsiFromDB = it->str();
+
+        ga.add(m_app.getDict().avpUserName(), imsiFromDB);
+        if (m_app.getDbObj().getMsisdnFromImsi(imsiFromDB, msisdnFromDB)) {
+          uint8_t msisdntbcd[MSISDN_TBCD_LEN];
+          size_t len = FDUtility::str2tbcd(
+              msisdnFromDB, msisdntbcd, sizeof(msisdntbcd));
+          if (len > 0) ga.add(m_app.getDict().avpMsisdn(), msisdntbcd, len);
           // msisdnlst.push_back(msisdnFromDB);
         }
 
@@ -740,7 +765,7 @@ int NIIRcmd::process(FDMessageRequest* req) {
           // some cassandra builtin functions ( available with Cassandra2.2 and
           // later )
 
-          m_app.getDbObj().UpdateValidityTime(*it, reqValidTime);
+          m_app.getDbObj().UpdateValidityTime(imsiFromDB, reqValidTime);
 
           // Store the origin host and realm of NIR in DB, so that in future
           // When the need to update/revoke a stored granted NIDD Authorization
@@ -754,7 +779,7 @@ int NIIRcmd::process(FDMessageRequest* req) {
           if (nir.origin_host.get(origHost) &&
               nir.origin_realm.get(origRealm)) {
             m_app.getDbObj().UpdateNIRDestination(
-                imsichar, origHost, origRealm);
+                imsiFromDB, origHost, origRealm);
           }
         }
       }
@@ -15,12 +15,15 @@
  */
 
 #include "statshss.h"
+#include "fdhss.h"
 
 #include <sstream>
 #include <freeDiameter/freeDiameter-host.h>
 #include <freeDiameter/libfdproto.h>
 #include <common_def.h>
 
+extern FDHss fdHss;
+
 StatsHss* StatsHss::m_singleton = NULL;
 
 StatsHss::StatsHss()
@@ -122,7 +125,17 @@ void StatsHss::getSerializedStat(std::string& stats) {
       << m_rir_collector.serialize(m_max_codes_tracked) << std::endl;
 
   res << now_str << ",S6C,SRR,"
-      << m_rir_collector.serialize(m_max_codes_tracked);
+      << m_rir_collector.serialize(m_max_codes_tracked) << std::endl;
+
+  QueueGauges g;
+  fdHss.getWorkerQueue().getGauges(g);
+  res << now_str << ",HSS,QUEUE," << g.pending << "," << g.active << ","
+      << g.concurrent << "," << g.oldest_pending_ms << ","
+      << fdHss.getWorkMgr().queueLength() << ","
+      << g.pending_by_type[HSS_QUEUE_ULR] << ","
+      << g.active_by_type[HSS_QUEUE_ULR] << ","
+      << g.pending_by_type[HSS_QUEUE_AIR] << ","
+      << g.active_by_type[HSS_QUEUE_AIR];
   stats = res.str();
 }
 
@@ -221,6 +234,33 @@ void StatsHss::processStatGetLive(StatLive& msg) {
   appendStatObject(arrayObjects, allocator, m_srr_collector);
 
   document.AddMember("stats", arrayObjects, allocator);
+
+  QueueGauges g;
+  fdHss.getWorkerQueue().getGauges(g);
+
+  RAPIDJSON_NAMESPACE::Value ulrObject(RAPIDJSON_NAMESPACE::kObjectType);
+  ulrObject.AddMember("pending", g.pending_by_type[HSS_QUEUE_ULR], allocator);
+  ulrObject.AddMember("active", g.active_by_type[HSS_QUEUE_ULR], allocator);
+
+  RAPIDJSON_NAMESPACE::Value airObject(RAPIDJSON_NAMESPACE::kObjectType);
+  airObject.AddMember("pending", g.pending_by_type[HSS_QUEUE_AIR], allocator);
+  airObject.AddMember("active", g.active_by_type[HSS_QUEUE_AIR], allocator);
+
+  RAPIDJSON_NAMESPACE::Value queueObject(RAPIDJSON_NAMESPACE::kObjectType);
+  queueObject.AddMember("pending", g.pending, allocator);
+  queueObject.AddMember("active", g.active, allocator);
+  queueObject.AddMember("concurrent", g.concurrent, allocator);
+  queueObject.AddMember(
+      "oldest_pending_ms", (int64_t) g.oldest_pending_ms, allocator);
+  queueObject.AddMember(
+      "worker_queue", fdHss.getWorkMgr().queueLength(), allocator);
+  queueObject.AddMember(
+      "workers", fdHss.getWorkMgr().numWorkers(), allocator);
+  queueObject.AddMember("ulr", ulrObject, allocator);
+  queueObject.AddMember("air", airObject, allocator);
+
+  document.AddMember("queue", queueObject, allocator);
+
   RAPIDJSON_NAMESPACE::StringBuffer strbuf;
   RAPIDJSON_NAMESPACE::Writer<RAPIDJSON_NAMESPACE::StringBuffer> writer(strbuf);
   document.Accept(writer);
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scodec.h"
+#include "subscriberkey.h"
+
+uint64_t SubscriberKey::pack(const char* s, size_t len) {
+  uint64_t value;
+
+  if (len == 0 || len > MaxDigits || !SCodec::parseUint64(s, len, value))
+    return 0;
+
+  return ((uint64_t) len << DIGITS_SHIFT) | value;
+}
+
+SubscriberKey SubscriberKey::fromValue(uint64_t value) {
+  SubscriberKey k;
+  size_t len = 1;
+
+  for (uint64_t v = value; v >= 10; v /= 10) len++;
+
+  if (len <= MaxDigits) k.m_key = ((uint64_t) len << DIGITS_SHIFT) | value;
+
+  return k;
+}
+
+size_t SubscriberKey::str(char* dst, size_t dstlen) const {
+  size_t len     = digits();
+  uint64_t value = this->value();
+
+  if (len == 0 || len + 1 > dstlen) {
+    if (dstlen) dst[0] = '\0';
+    return 0;
+  }
+
+  dst[len] = '\0';
+  for (size_t i = len; i > 0; i--) {
+    dst[i - 1] = '0' + (char) (value % 10);
+    value /= 10;
+  }
+
+  return len;
+}
+
+std::string SubscriberKey::str() const {
+  char buf[MaxDigits + 1];
+  size_t len = str(buf, sizeof(buf));
+
+  return std::string(buf, len);
+}
@@ -18,23 +18,25 @@
 #include <iostream>
 #include <sstream>
 
+#include "scodec.h"
 #include "util.h"
 
 std::string Utility::bytes2hex(
     const uint8_t* bytes, size_t len, char delim, bool upper) {
-  static const char* hexl = "0123456789abcdef";
-  static const char* hexu = "0123456789ABCDEF";
+  if (!delim) return SCodec::hexEncode(bytes, len, upper);
 
-  size_t olen(delim ? 3 : 2);
-  const char* hexc(upper ? hexu : hexl);
-  char hex[len * olen + 1];
+  std::string hex(len * 3, delim);
 
-  for (size_t i = 0; i < len; i++) {
-    hex[i * olen]     = hexc[(bytes[i] >> 4) & 0x0f];
-    hex[i * olen + 1] = hexc[bytes[i] & 0x0f];
-    if (delim) hex[i * olen + 2] = delim;
-  }
-  hex[len * olen] = '\0';
+  // each byte is followed by the delimiter except the last
+  for (size_t i = 0; i < len; i++)
+    SCodec::hexEncode(&bytes[i], 1, &hex[i * 3], upper);
+  if (len) hex.resize(len * 3 - 1);
 
-  return std::string(hex);
+  return hex;
+}
+
+bool Utility::hex2bytes(const std::string& hex, uint8_t* bytes, size_t len) {
+  if (hex.size() < len * 2) return false;
+
+  return SCodec::hexDecode(hex.data(), bytes, len);
 }
@@ -17,7 +17,7 @@
 #include "worker.h"
 #include "logger.h"
 
-WorkerManager::WorkerManager() {}
+WorkerManager::WorkerManager() : m_numWorkers(0), m_queued(0) {}
 
 WorkerManager::~WorkerManager() {}
 
@@ -37,11 +37,16 @@ bool WorkerManager::init(int numWorkers) {
 }
 
 bool WorkerManager::addWork(WorkerMessage* msg) {
-  return m_queue.push(msg);
+  atomic_inc_fetch(m_queued);
+  if (m_queue.push(msg)) return true;
+  atomic_dec_fetch(m_queued);
+  return false;
 }
 
 WorkerMessage* WorkerManager::getWork() {
-  return (WorkerMessage*) m_queue.pop();
+  WorkerMessage* msg = (WorkerMessage*) m_queue.pop();
+  if (msg && msg->getId() != WORKER_SHUTDOWN) atomic_dec_fetch(m_queued);
+  return msg;
 }
 
 void WorkerManager::waitForShutdown() {
@@ -22,37 +22,80 @@
 
 namespace CachedDNS {
 extern "C" typedef void (*CachedDNSQueryCallback)(
-    Query* q, bool cacheHit, void* data);
+    QueryPtr q, bool cacheHit, void* data);
 
-class QueryProcessor;
+//
+// Runs the callback of an asynchronous query.  When no executor is given
+// the callback is invoked by the resolver thread, so it must not block or
+// issue a synchronous query.
+//
+class QueryExecutor {
+ public:
+  virtual ~QueryExecutor() {}
+
+  virtual void execute(
+      CachedDNSQueryCallback cb, QueryPtr q, bool cacheHit, void* data) = 0;
+};
+
+class Resolver;
+struct CacheShard;
 
+//
+// The queries that miss the cache are resolved by a single resolver thread.
+// Concurrent requests for the same type and domain share one query.
+//
+// An expired query is returned while it is refreshed in the background, and
+// for as long as the DNS servers can not be reached, up to the maximum stale
+// time.  A query that is used frequently is refreshed shortly before it
+// expires.  A name that does not exist, or a query that fails, is cached
+// without any records for the negative TTL.
+//
+// A query that is replaced or evicted is deleted once the last caller it was
+// returned to releases it.
+//
 class Cache {
-  friend QueryProcessor;
+  friend Resolver;
 
  public:
   static Cache& getInstance();
 
-  Query* query(ns_type rtype, const std::string& domain, bool& cacheHit);
+  QueryPtr query(ns_type rtype, const std::string& domain, bool& cacheHit);
   void query(
       ns_type rtype, const std::string& domain, CachedDNSQueryCallback cb,
-      void* data = NULL);
+      void* data = NULL, QueryExecutor* executor = NULL);
 
- protected:
-  Query* processQuery(ns_type rtype, const std::string& domain);
+  // the least recently used query is discarded once the limit is reached
+  void setMaxEntries(size_t entries) { m_maxentries = entries; }
+  void setMaxStale(int seconds) { m_maxstale = seconds; }
+  void setNegativeTTL(int nxdomain, int failure) {
+    m_nxdomainttl = nxdomain;
+    m_failurettl  = failure;
+  }
+  // a query used at least hits times is refreshed once percent of its TTL
+  // remains, zero disables prefetching
+  void setPrefetch(int percent, int hits) {
+    m_prefetchpct  = percent;
+    m_prefetchhits = hits;
+  }
 
  private:
   Cache();
   ~Cache();
 
-  Query* lookupQuery(ns_type rtype, const std::string& domain);
-  bool processQuery(
-      ns_type rtype, const std::string& domain, CachedDNSQueryCallback cb);
+  CacheShard& getShard(ns_type rtype, const std::string& domain);
+  QueryPtr lookupQuery(
+      ns_type rtype, const std::string& domain, bool& refresh);
+  QueryPtr updateQuery(const QueryPtr& q, int status);
 
-  static void ares_callback(
-      void* arg, int status, int timeouts, unsigned char* abuf, int alen);
+  Resolver* m_resolver;
+  CacheShard* m_shards;
 
-  QueryCache m_cache;
-  SMutex m_cachemutex;
+  volatile size_t m_maxentries;
+  volatile int m_maxstale;
+  volatile int m_nxdomainttl;
+  volatile int m_failurettl;
+  volatile int m_prefetchpct;
+  volatile int m_prefetchhits;
 };
 }  // namespace CachedDNS
 
@@ -21,14 +21,19 @@
 #include <string>
 #include <map>
 #include <list>
+#include <memory>
 
 #include "cdnsrecord.h"
+#include "satomic.h"
 
 namespace CachedDNS {
 class Query {
  public:
   Query(ns_type rtype, const std::string& domain)
-      : m_type(rtype), m_domain(domain), m_expires(0) {}
+      : m_type(rtype),
+        m_domain(domain),
+        m_expires(0),
+        m_serial(nextSerial()) {}
 
   ~Query() {
     /*
@@ -94,6 +99,11 @@ class Query {
   const std::string& getDomain() { return m_domain; }
 
   bool isExpired() { return time(NULL) >= m_expires; }
+  time_t getExpires() { return m_expires; }
+
+  // identifies this instance of the query, a refreshed query is a new
+  // instance with a new serial number
+  uint64_t getSerial() { return m_serial; }
 
   const std::list<Question*>& getQuestions() { return m_question; }
   const ResourceRecordList& getAnswers() { return m_answer; }
@@ -129,6 +139,11 @@ class Query {
   }
 
  private:
+  static uint64_t nextSerial() {
+    static volatile uint64_t serial = 0;
+    return atomic_inc_fetch(serial);
+  }
+
   ns_type m_type;
   std::string m_domain;
   QuestionList m_question;
@@ -136,8 +151,12 @@ class Query {
   ResourceRecordList m_authority;
   ResourceRecordList m_additional;
   time_t m_expires;
+  uint64_t m_serial;
 };
 
+// the cache and the callers it returned a query to share the query
+typedef std::shared_ptr<Query> QueryPtr;
+
 class QueryCacheKey {
  public:
   QueryCacheKey(ns_type rtype, const std::string& domain)
@@ -169,7 +188,7 @@ class QueryCacheKey {
   std::string m_domain;
 };
 
-typedef std::map<QueryCacheKey, Query*> QueryCache;
+typedef std::map<QueryCacheKey, QueryPtr> QueryCache;
 }  // namespace CachedDNS
 
 #endif  // #ifndef __CDNSQUERY_H
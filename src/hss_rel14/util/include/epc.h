@@ -23,6 +23,7 @@
 #include <string>
 #include <sstream>
 #include <list>
+#include <memory>
 #include <vector>
 
 #include "cdnscache.h"
@@ -609,19 +610,32 @@ class NodeSelectorResultList : public std::list<NodeSelectorResult*> {
       NodeSelectorResult*& first, NodeSelectorResult*& second);
 };
 
+typedef std::shared_ptr<NodeSelectorResultList> NodeSelectorResultListPtr;
+
+//
+// The results of a selection are memoized per domain, desired service,
+// desired protocols and desired usage types for as long as the DNS cache
+// returns the same NAPTR query, so repeated selections share a single
+// snapshot of the results.  A snapshot is shared with other selectors and
+// must not be modified.
+//
+
 class NodeSelector {
  public:
   AppServiceEnum getDesiredService() { return m_desiredService; }
   AppProtocolList& getDesiredProtocols() { return m_desiredProtocols; }
   const std::string& getDomainName() { return m_domain; }
-  NodeSelectorResultList& getResults() { return m_results; }
+  const NodeSelectorResultList& getResults() { return *m_results; }
+  std::shared_ptr<const NodeSelectorResultList> getSnapshot() {
+    return m_results;
+  }
 
   UsageType addDesiredUsageType(UsageType ut) {
     m_desiredUsageTypes.push_back(ut);
     return ut;
   }
 
-  NodeSelectorResultList& process();
+  const NodeSelectorResultList& process();
 
   void dump() {
     std::cout << "NodeSelector REQUEST" << std::endl;
@@ -633,7 +647,7 @@ class NodeSelector {
     std::cout << "  desired usage types" << std::endl;
     m_desiredUsageTypes.dump("    ");
     std::cout << "  results" << std::endl;
-    m_results.dump("    ");
+    m_results->dump("    ");
   }
 
  protected:
@@ -654,14 +668,15 @@ class NodeSelector {
       const std::string& service, std::list<AppProtocolEnum>& protocols) const;
   static bool naptr_compare(
       CachedDNS::RRecordNAPTR*& first, CachedDNS::RRecordNAPTR*& second);
+  std::string getSelectionKey();
 
   std::string m_domain;
   AppServiceEnum m_desiredService;
   AppProtocolList m_desiredProtocols;
   UsageTypeList m_desiredUsageTypes;
 
-  NodeSelectorResultList m_results;
-  CachedDNS::Query* m_query;
+  NodeSelectorResultListPtr m_results;
+  CachedDNS::QueryPtr m_query;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1078,6 +1093,14 @@ class DiameterNaptrList : public std::list<DiameterNaptr*> {
   }
 };
 
+typedef std::shared_ptr<DiameterNaptrList> DiameterNaptrListPtr;
+
+//
+// As with NodeSelector, the results are memoized per realm, application and
+// protocol until the NAPTR query for the realm is refreshed.  A snapshot is
+// shared with other selectors and must not be modified.
+//
+
 class DiameterSelector {
  public:
   DiameterSelector();
@@ -1101,15 +1124,19 @@ class DiameterSelector {
     return m_protocol = proto;
   }
 
-  DiameterNaptrList& process();
+  const DiameterNaptrList& process();
+  const DiameterNaptrList& getResults() { return *m_results; }
+  std::shared_ptr<const DiameterNaptrList> getSnapshot() { return m_results; }
 
  private:
+  std::string getSelectionKey();
+
   std::string m_realm;
   DiameterApplicationEnum m_application;
   DiameterProtocolEnum m_protocol;
 
-  CachedDNS::Query* m_query;
-  DiameterNaptrList m_results;
+  CachedDNS::QueryPtr m_query;
+  DiameterNaptrListPtr m_results;
 };
 
 }  // namespace EPC
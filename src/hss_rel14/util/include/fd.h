@@ -26,6 +26,8 @@
 #include <string>
 #include <list>
 #include <map>
+#include <typeinfo>
+#include <vector>
 
 #include "freeDiameter/freeDiameter-host.h"
 #include "freeDiameter/libfdcore.h"
@@ -955,6 +957,40 @@ class FDExtractorKey {
   avp_code_t m_avpcode;
 };
 
+//
+// The members of an extractor class, sorted by vendor id and AVP code, with
+// the offset of each member from the start of the extractor.  The members
+// registered with FDExtractor::add() are the same for every instance of a
+// class, so the layout is built by the first instance to be resolved and
+// shared by all of the instances constructed after that.
+//
+class FDExtractorLayout {
+ public:
+  FDExtractorLayout() {}
+  ~FDExtractorLayout() {}
+
+  static FDExtractorLayout* find(const std::type_info& type);
+  static FDExtractorLayout* publish(
+      const std::type_info& type, FDExtractorLayout* layout);
+
+  void add(vendor_id_t vndid, avp_code_t avpcode, ptrdiff_t offset);
+  bool lookup(vendor_id_t vndid, avp_code_t avpcode, ptrdiff_t& offset) const;
+
+ private:
+  struct Entry {
+    uint64_t key;
+    ptrdiff_t offset;
+
+    bool operator<(const Entry& rval) const { return key < rval.key; }
+  };
+
+  static uint64_t makeKey(vendor_id_t vndid, avp_code_t avpcode) {
+    return ((uint64_t) vndid << 32) | avpcode;
+  }
+
+  std::vector<Entry> m_entries;
+};
+
 class FDExtractor : public FDExtractorBase {
   friend FDExtractorList;
   friend FDExtractorAvp;
@@ -990,7 +1026,8 @@ class FDExtractor : public FDExtractorBase {
  private:
   FDExtractor* m_parent;
   msg_or_avp* m_reference;
-  std::map<FDExtractorKey, FDExtractorBase*> m_entries;
+  FDExtractorLayout* m_layout;
+  bool m_ownlayout;
   int m_index;
 };
 
@@ -1135,6 +1172,7 @@ class FDUtility {
   static size_t str2tbcd(const char* src, uint8_t* dst, size_t dstlen);
   static size_t str2tbcd(const std::string& src, uint8_t* dst, size_t dstlen);
 
+  // dstlen is the size of dst including the NUL terminator
   static size_t tbcd2str(uint8_t* src, size_t srclen, char* dst, size_t dstlen);
   static size_t tbcd2str(uint8_t* src, size_t srclen, std::string& dst);
 };
@@ -27,6 +27,36 @@ void fdJsonGetJSON(
 bool fdJsonGetValueOfMember(
     std::string json, std::string member, std::string& value);
 bool fdJsonGetApnValueFromSubData(std::string json, std::string& apn);
+
+// Same as fdJsonAddAvps() except that the AVP's compiled from the JSON block
+// are cached, so adding the same block again does not parse it or search the
+// dictionary.  The cache holds up to the number of blocks set with
+// fdJsonSetTemplateCacheSize(), which is zero (disabled) by default.  The
+// block passed with its length need not be NUL terminated, a cached block
+// is found without copying it.
+int fdJsonAddAvpsCached(
+    const char* json, msg_or_avp* msg, void (*errfunc)(const char*));
+int fdJsonAddAvpsCached(
+    const char* json, size_t len, msg_or_avp* msg,
+    void (*errfunc)(const char*));
+void fdJsonSetTemplateCacheSize(size_t entries);
+// Compiles a JSON block into the template cache without adding it to a
+// message, used to warm the cache before the block is first needed.
+int fdJsonPreloadTemplate(const char* json, void (*errfunc)(const char*));
+
+// Resolves every AVP in the loaded dictionaries, so the JSON conversions do
+// not need to search the dictionary once running.  Returns the number of
+// entries added.
+int fdJsonLoadDictionary();
+
+// Converts a JSON block to the Diameter encoding of the AVP's it describes
+// and adds previously encoded AVP's to a message or grouped AVP, which only
+// requires the dictionary entries for the AVP codes.
+int fdJsonEncodeAvps(
+    const char* json, std::string& bin, void (*errfunc)(const char*));
+int fdJsonAddEncodedAvps(
+    const uint8_t* bin, size_t len, msg_or_avp* msg,
+    void (*errfunc)(const char*));
 extern "C" {
 #endif
 
@@ -18,12 +18,43 @@
 #define __SCASSANDRA_H
 
 #include <stdint.h>
+#include <memory>
 #include <string>
 
 #include <cassandra.h>
 
 #include "stime.h"
 
+class SCassResult;
+
+//
+// A non-owning view of a text or blob column.  The data belongs to the
+// SCassResult the column was read from and is only valid while that result
+// exists.
+//
+class SCassView {
+ public:
+  SCassView() : m_data(NULL), m_len(0) {}
+  SCassView(const char* data, size_t len) : m_data(data), m_len(len) {}
+
+  const char* data() const { return m_data; }
+  size_t size() const { return m_len; }
+  bool empty() const { return m_len == 0; }
+
+  std::string str() const { return std::string(m_data, m_len); }
+
+  void clear() {
+    m_data = NULL;
+    m_len  = 0;
+  }
+
+ private:
+  const char* m_data;
+  size_t m_len;
+};
+
+typedef std::shared_ptr<SCassResult> SCassResultPtr;
+
 class SCassValue {
  public:
   SCassValue();
@@ -41,8 +72,12 @@ class SCassValue {
   bool get(std::string& v);
   bool get(const char*& v, size_t& len);
   bool get(const uint8_t*& v, size_t& len);
+  bool get(SCassView& v);
   bool get(STime& v);
 
+  // decodes a hex text column into exactly len bytes
+  bool getHex(uint8_t* v, size_t len);
+
   bool get(uint32_t& v) {
     int64_t v2;
     if (!get(v2)) return false;
@@ -73,6 +108,11 @@ class SCassRow {
   SCassValue getColumn(const char* name);
   SCassValue getColumn(std::string& name);
 
+  // whether the query selected the column
+  bool hasColumn(const char* name) {
+    return cass_row_get_column_by_name(m_row, name) != NULL;
+  }
+
   bool valid() { return m_row != NULL; }
 
  private:
@@ -151,6 +191,8 @@ class SCassFuture {
 
   CassError errorCode();
   SCassResult result();
+  // a shared result for views that must outlive the completion callback
+  SCassResultPtr sharedResult();
 
  private:
   SCassFuture();
@@ -162,19 +204,49 @@ class SCassFuture {
 };
 
 class SCassandra;
+class SCassStatement;
+class SCassBatch;
+
+class SCassPrepared {
+  friend SCassandra;
+  friend SCassStatement;
+
+ public:
+  SCassPrepared();
+  ~SCassPrepared();
+
+  bool isPrepared() { return m_prepared != NULL; }
+
+ private:
+  SCassPrepared(const SCassPrepared&);
+  SCassPrepared& operator=(const SCassPrepared&);
+  void release();
+
+  const CassPrepared* m_prepared;
+};
 
 class SCassStatement {
   friend SCassandra;
+  friend SCassBatch;
 
  public:
   SCassStatement();
   SCassStatement(const char* qry);
   SCassStatement(const std::string& qry);
+  // binds a new statement to a prepared query, the values are assigned with
+  // bind() in the order of the query markers
+  SCassStatement(SCassPrepared& prepared);
   ~SCassStatement();
 
   SCassStatement& query(const char* qry);
   SCassStatement& query(const std::string& qry);
 
+  CassError bind(size_t index, const std::string& value);
+  CassError bind(size_t index, int32_t value);
+  CassError bind(size_t index, int64_t value);
+  CassError bindBytes(size_t index, const uint8_t* value, size_t len);
+  CassError bindNull(size_t index);
+
   CassError setPagingSize(int page_size);
   CassError setPagingState(SCassResult& result);
 
@@ -187,6 +259,33 @@ class SCassStatement {
   CassStatement* m_statement;
 };
 
+//
+// The statements of a logged batch are applied atomically, all or none.
+// The statements share the write timestamp of the batch.
+//
+class SCassBatch {
+  friend SCassandra;
+
+ public:
+  SCassBatch(CassBatchType type = CASS_BATCH_TYPE_LOGGED);
+  ~SCassBatch();
+
+  // the batch keeps its own reference to the statement
+  CassError add(SCassStatement& statement);
+
+  size_t size() { return m_size; }
+
+ protected:
+  SCassFuture execute(CassSession* session);
+
+ private:
+  SCassBatch(const SCassBatch&);
+  SCassBatch& operator=(const SCassBatch&);
+
+  CassBatch* m_batch;
+  size_t m_size;
+};
+
 class SCassandra {
  public:
   SCassandra();
@@ -195,6 +294,10 @@ class SCassandra {
   SCassFuture execute(SCassStatement& statement) {
     return statement.execute(m_session);
   }
+  SCassFuture execute(SCassBatch& batch) { return batch.execute(m_session); }
+
+  // waits for the query to be prepared by the cluster
+  CassError prepare(const char* qry, SCassPrepared& prepared);
 
   SCassFuture connect();
   void disconnect();
@@ -225,4 +328,10 @@ class SCassandra {
   int m_protver;
 };
 
+// Splits the Murmur3 token ring into count ranges for a parallel scan.  The
+// range covers the tokens after first, or from first when inclusive is set,
+// up to and including last.
+void SCassTokenRange(
+    int range, int count, int64_t& first, int64_t& last, bool& inclusive);
+
 #endif  // __SCASSANDRA_H
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SCODEC_H
+#define __SCODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+//
+// Conversions between the text and binary forms of the identifiers and key
+// material.  The loops are written without data dependent branches, a
+// validation failure is accumulated and checked once at the end, and the
+// hex conversions process 16 bytes at a time with SSE2 when it is available.
+//
+class SCodec {
+ public:
+  // writes len * 2 hex digits to dst, dst is not NUL terminated
+  static void hexEncode(
+      const uint8_t* src, size_t len, char* dst, bool upper = false);
+  static std::string hexEncode(
+      const uint8_t* src, size_t len, bool upper = false);
+
+  // decodes len * 2 hex digits from src, returns false if any of them is
+  // not a hex digit
+  static bool hexDecode(const char* src, uint8_t* dst, size_t len);
+
+  // The first digit is stored in the high nibble and an odd number of digits
+  // is padded with 0xf.  Returns the number of bytes written, zero if dst is
+  // too small.
+  static size_t tbcdEncode(
+      const char* src, size_t srclen, uint8_t* dst, size_t dstlen);
+
+  // Returns the number of digits written to dst, zero if dst (including the
+  // NUL terminator) is too small.  A 0xf nibble is filler and is skipped.
+  static size_t tbcdDecode(
+      const uint8_t* src, size_t srclen, char* dst, size_t dstlen);
+
+  // converts each decimal digit to its value, returns false if src contains
+  // anything other than digits
+  static bool digitsDecode(const char* src, size_t len, uint8_t* dst);
+
+  // returns false if src is empty, contains anything other than digits or
+  // does not fit in 64 bits, v is only updated on success
+  static bool parseUint64(const char* src, size_t len, uint64_t& v);
+  static bool parseUint64(const std::string& src, uint64_t& v) {
+    return parseUint64(src.data(), src.size(), v);
+  }
+};
+
+#endif  // #define __SCODEC_H
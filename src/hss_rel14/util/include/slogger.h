@@ -25,6 +25,10 @@
 #define SPDLOG_ENABLE_SYSLOG
 #include "spdlog/spdlog.h"
 
+#include "slogqueue.h"
+
+class SLogWriter;
+
 class LoggerException : public std::runtime_error {
  public:
   LoggerException(const char* m) : std::runtime_error(m) {}
@@ -32,10 +36,14 @@ class LoggerException : public std::runtime_error {
 };
 
 class SLogger {
+  friend class SLogWriter;
+
  public:
   SLogger(
       const char* category, std::vector<spdlog::sink_ptr>& sinks,
       const char* pattern, size_t queue_size);
+  ~SLogger();
+
   void trace(const char* format, ...);
   void trace(const std::string& format, ...);
   void debug(const char* format, ...);
@@ -49,7 +57,16 @@ class SLogger {
   void error(const char* format, ...);
   void error(const std::string& format, ...);
 
-  void flush() { m_log.flush(); }
+  //
+  // allow callers to skip building a message that would be discarded
+  //
+  bool trace_enabled() { return m_log.should_log(spdlog::level::trace); }
+  bool debug_enabled() { return m_log.should_log(spdlog::level::debug); }
+  bool info_enabled() { return m_log.should_log(spdlog::level::info); }
+
+  void flush();
+
+  size_t get_dropped() { return m_queue.dropped(); }
 
   void set_level(spdlog::level::level_enum lvl);
 
@@ -63,8 +80,10 @@ class SLogger {
   enum _LogType { _ltTrace, _ltDebug, _ltInfo, _ltStartup, _ltWarn, _ltError };
 
   void log(_LogType lt, const char* format, va_list& args);
+  size_t drain();
 
-  spdlog::async_logger m_log;
+  spdlog::logger m_log;
+  SLogQueue m_queue;
 };
 
 #endif  // #define __SLOGGER_H
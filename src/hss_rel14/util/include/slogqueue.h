@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SLOGQUEUE_H
+#define __SLOGQUEUE_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// maximum length of a rendered log message (matches the original
+// SLogger stack buffer)
+#define SLOG_MAX_MESSAGE 2048
+
+// size of the inline capture area of a queue slot, a capture that does
+// not fit is moved to a heap buffer owned by the slot
+#define SLOG_RECORD_PAYLOAD 224
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+struct SLogRecord {
+  volatile size_t sequence;
+  size_t position;
+  char* overflow;
+  uint32_t length;
+  uint8_t level;
+  bool preformatted;
+  char payload[SLOG_RECORD_PAYLOAD];
+
+  const char* data() const { return overflow ? overflow : payload; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Captures a printf style format string and its arguments in binary form so
+// the (expensive) formatting can be performed later on a different thread.
+// The format string and any %s arguments are copied into the capture, all
+// other arguments are stored by value.  Conversions that cannot be deferred
+// (%n, %m, wide characters) cause the message to be formatted immediately.
+//
+class SLogFormat {
+ public:
+  static void capture(SLogRecord& rec, const char* format, va_list& args);
+  static const char* render(
+      const SLogRecord& rec, char* buffer, size_t buflen);
+
+ private:
+  static size_t encode(
+      char* dest, size_t destlen, const char* format, va_list& args);
+  static void preformat(SLogRecord& rec, const char* format, va_list& args);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Bounded multi-producer/single-consumer queue of log records.  Producers
+// claim a slot with a compare-and-swap on the enqueue position and never
+// block, when the queue is full the message is discarded.
+//
+class SLogQueue {
+ public:
+  SLogQueue(size_t capacity);
+  ~SLogQueue();
+
+  // producer
+  SLogRecord* reserve();
+  void commit(SLogRecord* rec);
+
+  // consumer
+  SLogRecord* front();
+  void release(SLogRecord* rec);
+
+  size_t enqueued() { return m_enqueue; }
+  size_t dequeued() { return m_dequeue; }
+  size_t dropped() { return m_dropped; }
+
+ private:
+  SLogQueue();
+
+  SLogRecord* m_records;
+  size_t m_mask;
+  volatile size_t m_enqueue;
+  volatile size_t m_dequeue;
+  volatile size_t m_dropped;
+};
+
+#endif  // #define __SLOGQUEUE_H
@@ -73,7 +73,8 @@ class OssRestHandler {
       : m_stats(stats),
         m_auditlogger(auditlogger),
         m_logger_manager(logger_manager),
-        m_ossoption_reader(ossoptionfile) {}
+        m_ossoption_reader(ossoptionfile),
+        m_ready(true) {}
   void getLoggers(
       const Pistache::Http::Request& request,
       Pistache::Http::ResponseWriter response) {
@@ -151,6 +152,18 @@ class OssRestHandler {
     m_stats->updateInterval(statfreq);
     response.send(Pistache::Http::Code::Ok, "{\"result\": \"OK\"}");
   }
+  // polled by health checks, so the requests are not written to the audit log
+  void getReady(
+      const Pistache::Http::Request& request,
+      Pistache::Http::ResponseWriter response) {
+    if (m_ready) {
+      response.send(Pistache::Http::Code::Ok, "{\"ready\": true}");
+    } else {
+      response.send(
+          Pistache::Http::Code::Service_Unavailable, "{\"ready\": false}");
+    }
+  }
+  void setReady(bool ready) { m_ready = ready; }
   void getOssOptions(
       const Pistache::Http::Request& request,
       Pistache::Http::ResponseWriter response) {
@@ -182,6 +195,7 @@ class OssRestHandler {
   SLogger* m_auditlogger;
   T* m_logger_manager;
   OssOptionReader m_ossoption_reader;
+  volatile bool m_ready;
 };
 
 template<typename T>
@@ -204,6 +218,10 @@ class OssEndpoint {
   }
   void shutdown() { m_httpendpoint->shutdown(); }
 
+  // the /ready resource reports whether the application is ready to serve
+  // requests, true unless cleared
+  void setReady(bool ready) { m_handler.setReady(ready); }
+
  private:
   void setupRoutes() {
     Pistache::Rest::Routes::Get(
@@ -230,6 +248,10 @@ class OssEndpoint {
         m_router, "/ossoptions",
         Pistache::Rest::Routes::bind(
             &OssRestHandler<T>::getOssOptions, &m_handler));
+    Pistache::Rest::Routes::Get(
+        m_router, "/ready",
+        Pistache::Rest::Routes::bind(
+            &OssRestHandler<T>::getReady, &m_handler));
   }
   std::shared_ptr<Pistache::Http::Endpoint> m_httpendpoint;
   Pistache::Rest::Router m_router;
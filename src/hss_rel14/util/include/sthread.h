@@ -21,6 +21,7 @@
 
 #include "ssync.h"
 #include "squeue.h"
+#include "stimerwheel.h"
 
 class SThread {
  public:
@@ -101,11 +102,14 @@ class SEventThread : public SThread {
   /////////////////////////////////////////////////////////////////////////////
   /////////////////////////////////////////////////////////////////////////////
 
-  class Timer {
+  // a timer is an entry on the STimerWheel, when it expires an STimerMessage
+  // is posted to the thread that initialized it
+  class Timer : public STimerWheel::Entry {
     friend class SEventThread;
 
    protected:
     void init(SEventThread* pThread);
+    void onExpire();
 
    public:
     Timer();
@@ -127,17 +131,6 @@ class SEventThread : public SThread {
     SEventThread* m_thread;
     bool m_oneshot;
     long m_interval;
-    timer_t m_timer;
-    static void _timerHandler(int signo, siginfo_t* pinfo, void* pcontext);
-  };
-
-  class TimerHandler {
-   public:
-    TimerHandler() { init(); }
-    ~TimerHandler() { uninit(); }
-
-    void init();
-    void uninit();
   };
 
   /////////////////////////////////////////////////////////////////////////////
@@ -178,7 +171,6 @@ class SEventThread : public SThread {
   unsigned long threadProc(void* arg);
   void dispatch();
 
-  static TimerHandler m_th;
   SQueue m_events;
 };
 
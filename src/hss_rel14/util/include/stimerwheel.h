@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __STIMERWHEEL_H
+#define __STIMERWHEEL_H
+
+#include <stdint.h>
+
+#include "ssync.h"
+
+class STimerWheelThread;
+
+//
+// A hierarchical timer wheel serviced by a single thread.  The entries are
+// kept on intrusive lists, so scheduling or cancelling an entry is O(1) and
+// neither allocates memory nor consumes a kernel timer.  The thread waits on
+// a single timerfd that only ticks while entries are scheduled.
+//
+// onExpire() is called from the wheel thread with the wheel locked.  It must
+// not block, but it may schedule or cancel entries.  Once cancel() returns,
+// onExpire() is not running for that entry unless cancel() was called from
+// onExpire() itself.
+//
+class STimerWheel {
+  friend class STimerWheelThread;
+
+ public:
+  enum { TickMilliseconds = 10 };
+
+  // a derived class must cancel the entry in its own destructor, since
+  // onExpire() is no longer available once ~Entry() is running
+  class Entry {
+    friend class STimerWheel;
+
+   public:
+    Entry();
+    virtual ~Entry();
+
+    bool isScheduled() { return m_head != NULL; }
+
+   protected:
+    virtual void onExpire() = 0;
+
+   private:
+    Entry* m_prev;
+    Entry* m_next;
+    Entry** m_head;
+    uint64_t m_expires;
+    uint64_t m_interval;
+  };
+
+  static STimerWheel& singleton();
+
+  // schedules the entry to expire after the number of milliseconds, rounded
+  // up to the next tick, and then every milliseconds when periodic is set.
+  // An entry that is already scheduled is rescheduled.
+  void schedule(Entry& e, long milliseconds, bool periodic = false);
+  void cancel(Entry& e);
+
+ private:
+  enum {
+    RootBits  = 8,
+    LevelBits = 6,
+    Levels    = 3,
+    RootSize  = 1 << RootBits,
+    LevelSize = 1 << LevelBits,
+    RootMask  = RootSize - 1,
+    LevelMask = LevelSize - 1
+  };
+
+  STimerWheel();
+  ~STimerWheel();
+
+  void add(Entry* e);
+  void link(Entry* e, Entry** head);
+  void unlink(Entry* e);
+  void detach(Entry** slot, Entry*& list);
+  bool cascade(int level);
+  void tick();
+  void arm(bool on);
+  void run();
+
+  SMutex m_mutex;
+  int m_epfd;
+  int m_timerfd;
+  STimerWheelThread* m_thread;
+  uint64_t m_current;
+  size_t m_count;
+
+  Entry* m_root[RootSize];
+  Entry* m_levels[Levels][LevelSize];
+};
+
+#endif  // #define __STIMERWHEEL_H
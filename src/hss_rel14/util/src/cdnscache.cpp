@@ -14,14 +14,21 @@
  * limitations under the License.
  */
 
+#include <errno.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <memory.h>
-#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <ares.h>
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <list>
+#include <map>
+#include <set>
 
 #include "serror.h"
 #include "sthread.h"
@@ -71,161 +78,356 @@ static std::string string_format(const char* format, ...) {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+// the maximum number of events retrieved by each epoll_wait()
+#define RESOLVER_MAX_EVENTS 16
+
+// the cache is split into shards with their own lock
+#define CACHE_SHARDS 16
+
+#define CACHE_DEFAULT_MAX_ENTRIES 4096
+#define CACHE_DEFAULT_MAX_STALE 3600
+#define CACHE_DEFAULT_NXDOMAIN_TTL 60
+#define CACHE_DEFAULT_FAILURE_TTL 5
+#define CACHE_DEFAULT_PREFETCH_PCT 10
+#define CACHE_DEFAULT_PREFETCH_HITS 2
+
 namespace CachedDNS {
-class QueryProcessor {
- public:
-  QueryProcessor(Query* q) : m_query(q) {
-    m_status  = ARES_SUCCESS;
-    m_channel = NULL;
-    m_query   = q;
-  }
 
-  ~QueryProcessor() { ares_destroy(m_channel); }
+// a cached query, a negative entry holds a query without any records
+struct CacheEntry {
+  QueryPtr query;
+  bool negative;
+  bool refreshing;
+  time_t fetched;
+  time_t expires;
+  time_t retry;
+  int hits;
+  std::list<QueryCacheKey>::iterator lru;
+};
 
-  int getStatus() { return m_status; }
+// the most recently used entry is at the front of the lru list
+struct CacheShard {
+  SMutex mutex;
+  std::map<QueryCacheKey, CacheEntry> entries;
+  std::list<QueryCacheKey> lru;
+};
 
-  void execute() {
-    if ((m_status = ares_init(&m_channel)) == ARES_SUCCESS) {
-      struct ares_options opt;
-      opt.timeout = 1000;
-      opt.ndots   = 0;
-      opt.flags   = ARES_FLAG_EDNS;
-      opt.ednspsz = 8192;
-      ares_init_options(
-          &m_channel, &opt,
-          ARES_OPT_TIMEOUTMS | ARES_OPT_NDOTS | ARES_OPT_EDNSPSZ |
-              ARES_OPT_FLAGS);
+// a request waiting for a query, a synchronous request is signalled through
+// its event
+struct QueryRequest {
+  CachedDNSQueryCallback cb;
+  void* data;
+  QueryExecutor* executor;
+  SEvent* event;
+  QueryPtr* result;
+};
 
-      ares_query(
-          m_channel, m_query->getDomain().c_str(), ns_c_in, m_query->getType(),
-          ares_callback, this);
+class Resolver;
 
-      wait_for_completion();
-    }
+// a query being resolved and the requests waiting for it
+struct PendingQuery {
+  PendingQuery(Resolver* r, ns_type rtype, const std::string& domain)
+      : resolver(r), key(rtype, domain), query(new Query(rtype, domain)) {}
+
+  Resolver* resolver;
+  QueryCacheKey key;
+  QueryPtr query;
+  std::list<QueryRequest> requests;
+};
 
-    m_event.set();
+static void dispatch(
+    const QueryRequest& req, const QueryPtr& q, bool cacheHit) {
+  if (req.event) {
+    *req.result = q;
+    req.event->set();
+  } else if (req.executor) {
+    req.executor->execute(req.cb, q, cacheHit, req.data);
+  } else {
+    req.cb(q, cacheHit, req.data);
   }
+}
+
+//
+// Runs the c-ares event loop for all of the outstanding queries.  The
+// channel is only used by the resolver thread, new queries are handed over
+// through m_submitted and the thread is woken by m_eventfd.
+//
+class Resolver : public SThread {
+ public:
+  Resolver(Cache& cache);
+  ~Resolver();
+
+  // without a request the query only refreshes the cache
+  void submit(
+      ns_type rtype, const std::string& domain, const QueryRequest* req);
+  void stop();
+
+  unsigned long threadProc(void* arg);
 
  private:
-  QueryProcessor() {}
+  Resolver();
 
+  static void sock_state_callback(
+      void* data, ares_socket_t fd, int readable, int writable);
   static void ares_callback(
-      void* arg, int status, int timeouts, unsigned char* abuf, int alen) {
-    QueryProcessor* qp = (QueryProcessor*) arg;
-    qp->process(status, timeouts, abuf, alen);
+      void* arg, int status, int timeouts, unsigned char* abuf, int alen);
+
+  void wakeup();
+  void startQueries();
+  void complete(PendingQuery* pq, int status, unsigned char* abuf, int alen);
+
+  Cache& m_cache;
+  ares_channel m_channel;
+  int m_epfd;
+  int m_eventfd;
+  volatile bool m_quit;
+  std::set<int> m_sockets;
+
+  SMutex m_mutex;
+  std::map<QueryCacheKey, PendingQuery*> m_inflight;
+  std::list<PendingQuery*> m_submitted;
+};
+}  // namespace CachedDNS
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+Resolver::Resolver(Cache& cache)
+    : m_cache(cache),
+      m_channel(NULL),
+      m_epfd(-1),
+      m_eventfd(-1),
+      m_quit(false) {
+  m_epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_epfd == -1)
+    SError::throwRuntimeExceptionWithErrno("Unable to create the DNS resolver");
+
+  m_eventfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (m_eventfd == -1)
+    SError::throwRuntimeExceptionWithErrno("Unable to create the DNS resolver");
+
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events  = EPOLLIN;
+  ev.data.fd = m_eventfd;
+  if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_eventfd, &ev) == -1)
+    SError::throwRuntimeExceptionWithErrno("Unable to create the DNS resolver");
+
+  struct ares_options opt;
+  memset(&opt, 0, sizeof(opt));
+  opt.timeout            = 1000;
+  opt.ndots              = 0;
+  opt.flags              = ARES_FLAG_EDNS;
+  opt.ednspsz            = 8192;
+  opt.sock_state_cb      = sock_state_callback;
+  opt.sock_state_cb_data = this;
+
+  int status = ares_init_options(
+      &m_channel, &opt,
+      ARES_OPT_TIMEOUTMS | ARES_OPT_NDOTS | ARES_OPT_EDNSPSZ | ARES_OPT_FLAGS |
+          ARES_OPT_SOCK_STATE_CB);
+  if (status != ARES_SUCCESS) {
+    std::string msg(string_format(
+        "Resolver::Resolver() - ares_init_options() failed status = %d",
+        status));
+    SError::throwRuntimeException(msg);
+  }
+}
+
+Resolver::~Resolver() {
+  // the outstanding queries are completed with ARES_EDESTRUCTION
+  if (m_channel) ares_destroy(m_channel);
+
+  while (!m_submitted.empty()) {
+    PendingQuery* pq = m_submitted.front();
+    m_submitted.pop_front();
+    complete(pq, ARES_EDESTRUCTION, NULL, 0);
   }
 
-  void wait_for_completion() {
+  if (m_eventfd != -1) close(m_eventfd);
+  if (m_epfd != -1) close(m_epfd);
+}
+
+void Resolver::submit(
+    ns_type rtype, const std::string& domain, const QueryRequest* req) {
+  QueryCacheKey key(rtype, domain);
+  SMutexLock l(m_mutex);
+
+  // join the query already being resolved
+  std::map<QueryCacheKey, PendingQuery*>::iterator it = m_inflight.find(key);
+  if (it != m_inflight.end()) {
+    if (req) it->second->requests.push_back(*req);
+    return;
+  }
+
+  PendingQuery* pq = new PendingQuery(this, rtype, domain);
+  if (req) pq->requests.push_back(*req);
+  m_inflight[key] = pq;
+  m_submitted.push_back(pq);
+
+  if (m_submitted.size() == 1) wakeup();
+}
+
+void Resolver::stop() {
+  m_quit = true;
+  wakeup();
+  join();
+}
+
+void Resolver::wakeup() {
+  uint64_t val = 1;
+  if (write(m_eventfd, &val, sizeof(val)) == -1 && errno != EAGAIN)
+    SError::throwRuntimeExceptionWithErrno(
+        "Unable to wake up the DNS resolver");
+}
+
+unsigned long Resolver::threadProc(void* arg) {
+  struct epoll_event events[RESOLVER_MAX_EVENTS];
+
+  while (!m_quit) {
     struct timeval tv;
-    int timeout;
-    ares_socket_t sockets[ARES_GETSOCK_MAXNUM];
-    struct pollfd fds[ARES_GETSOCK_MAXNUM];
-
-    while (true) {
-      int rwbits = ares_getsock(m_channel, sockets, ARES_GETSOCK_MAXNUM);
-      int fdcnt  = 0;
-
-      memset(fds, 0, sizeof(fds));
-
-      for (int i = 0; i < ARES_GETSOCK_MAXNUM; i++) {
-        fds[fdcnt].fd = sockets[i];
-        fds[fdcnt].events |=
-            ARES_GETSOCK_READABLE(rwbits, i) ? (POLLIN | POLLRDNORM) : 0;
-        fds[fdcnt].events |=
-            ARES_GETSOCK_WRITABLE(rwbits, i) ? (POLLOUT | POLLWRNORM) : 0;
-        if (fds[fdcnt].events != 0) fdcnt++;
-      }
+    int timeout = -1;
+
+    // wait indefinitely when there is no query to time out
+    if (ares_timeout(m_channel, NULL, &tv))
+      timeout = tv.tv_sec * 1000 + (tv.tv_usec + 999) / 1000;
+
+    int cnt = epoll_wait(m_epfd, events, RESOLVER_MAX_EVENTS, timeout);
+    if (cnt == -1 && errno != EINTR) {
+      std::cout << "Resolver::threadProc() - epoll_wait() failed errno = "
+                << errno << std::endl;
+      SThread::sleep(100);
+      continue;
+    }
 
-      if (!fdcnt) break;
-
-      memset(&tv, 0, sizeof(tv));
-      ares_timeout(m_channel, NULL, &tv);
-      timeout = (tv.tv_sec * 1000) + (tv.tv_usec / 1000);
-
-      if (poll(fds, fdcnt, timeout) != 0) {
-        for (int i = 0; i < fdcnt; i++) {
-          if (fds[i].revents != 0) {
-            ares_process_fd(
-                m_channel,
-                fds[i].revents & (POLLIN | POLLRDNORM) ? fds[i].fd :
-                                                         ARES_SOCKET_BAD,
-                fds[i].revents & (POLLOUT | POLLWRNORM) ? fds[i].fd :
-                                                          ARES_SOCKET_BAD);
-          }
+    for (int i = 0; i < cnt; i++) {
+      int fd = events[i].data.fd;
+
+      if (fd == m_eventfd) {
+        uint64_t val;
+        while (read(m_eventfd, &val, sizeof(val)) > 0) {
         }
+        startQueries();
       } else {
-        // timeout
-        ares_process_fd(m_channel, ARES_SOCKET_BAD, ARES_SOCKET_BAD);
+        ares_process_fd(
+            m_channel,
+            events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP) ?
+                fd :
+                ARES_SOCKET_BAD,
+            events[i].events & EPOLLOUT ? fd : ARES_SOCKET_BAD);
       }
     }
+
+    // retry or fail the queries that have timed out
+    ares_process_fd(m_channel, ARES_SOCKET_BAD, ARES_SOCKET_BAD);
   }
 
-  void process(int status, int timeouts, unsigned char* abuf, int alen) {
-    try {
-      Parser p(m_query, abuf, alen);
-      p.parse();
-    } catch (std::exception& ex) {
-      std::cout << "EXCEPTION - " << ex.what() << std::endl;
-    }
+  return 0;
+}
+
+void Resolver::startQueries() {
+  std::list<PendingQuery*> submitted;
+
+  {
+    SMutexLock l(m_mutex);
+    submitted.swap(m_submitted);
   }
 
-  int m_status;
-  ares_channel m_channel;
-  SEvent m_event;
-  Query* m_query;
-};
+  // ares_query() may complete the query before returning
+  for (std::list<PendingQuery*>::iterator it = submitted.begin();
+       it != submitted.end(); ++it) {
+    ares_query(
+        m_channel, (*it)->query->getDomain().c_str(), ns_c_in,
+        (*it)->query->getType(), ares_callback, *it);
+  }
+}
 
-////////////////////////////////////////////////////////////////////////////////
-////////////////////////////////////////////////////////////////////////////////
+void Resolver::sock_state_callback(
+    void* data, ares_socket_t fd, int readable, int writable) {
+  Resolver* r = (Resolver*) data;
+  struct epoll_event ev;
 
-class QueryThread : public SThread {
- public:
-  QueryThread(
-      ns_type rtype, const std::string& domain, CachedDNSQueryCallback cb,
-      void* data = NULL)
-      : SThread(true),
-        m_type(rtype),
-        m_domain(domain),
-        m_cb(cb),
-        m_data(data) {}
-
-  ~QueryThread() {}
-
-  virtual unsigned long threadProc(void* arg) {
-    bool cacheHit = false;
-    Query* q      = Cache::getInstance().query(m_type, m_domain, cacheHit);
-    m_cb(q, cacheHit, m_data);
-    return 0;
+  memset(&ev, 0, sizeof(ev));
+  ev.events  = (readable ? EPOLLIN : 0) | (writable ? EPOLLOUT : 0);
+  ev.data.fd = fd;
+
+  if (!readable && !writable) {
+    epoll_ctl(r->m_epfd, EPOLL_CTL_DEL, fd, &ev);
+    r->m_sockets.erase(fd);
+  } else if (r->m_sockets.insert(fd).second) {
+    epoll_ctl(r->m_epfd, EPOLL_CTL_ADD, fd, &ev);
+  } else {
+    epoll_ctl(r->m_epfd, EPOLL_CTL_MOD, fd, &ev);
+  }
+}
+
+void Resolver::ares_callback(
+    void* arg, int status, int timeouts, unsigned char* abuf, int alen) {
+  PendingQuery* pq = (PendingQuery*) arg;
+  pq->resolver->complete(pq, status, abuf, alen);
+}
+
+void Resolver::complete(
+    PendingQuery* pq, int status, unsigned char* abuf, int alen) {
+  QueryPtr q = pq->query;
+
+  if (status == ARES_EDESTRUCTION || status == ARES_ECANCELLED) {
+    // the resolver is being stopped
+    q.reset();
+  } else {
+    if (status == ARES_SUCCESS && abuf && alen > 0) {
+      try {
+        Parser p(q.get(), abuf, alen);
+        p.parse();
+      } catch (std::exception& ex) {
+        std::cout << "EXCEPTION - " << ex.what() << std::endl;
+      }
+    }
+
+    // the cached query may be a stale query that is still usable
+    q = m_cache.updateQuery(q, status);
   }
 
- private:
-  ns_type m_type;
-  const std::string m_domain;
-  CachedDNSQueryCallback m_cb;
-  void* m_data;
-};
-}  // namespace CachedDNS
+  {
+    SMutexLock l(m_mutex);
+    m_inflight.erase(pq->key);
+  }
+
+  for (std::list<QueryRequest>::iterator it = pq->requests.begin();
+       it != pq->requests.end(); ++it)
+    dispatch(*it, q, false);
+
+  delete pq;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-Cache::Cache() {
+Cache::Cache()
+    : m_resolver(NULL),
+      m_shards(new CacheShard[CACHE_SHARDS]),
+      m_maxentries(CACHE_DEFAULT_MAX_ENTRIES),
+      m_maxstale(CACHE_DEFAULT_MAX_STALE),
+      m_nxdomainttl(CACHE_DEFAULT_NXDOMAIN_TTL),
+      m_failurettl(CACHE_DEFAULT_FAILURE_TTL),
+      m_prefetchpct(CACHE_DEFAULT_PREFETCH_PCT),
+      m_prefetchhits(CACHE_DEFAULT_PREFETCH_HITS) {
   int status = ares_library_init(ARES_LIB_INIT_ALL);
   if (status != ARES_SUCCESS) {
     std::string msg(string_format(
         "Cache::Cache() - ares_library_init() failed status = %d", status));
     SError::throwRuntimeException(msg);
   }
+
+  m_resolver = new Resolver(*this);
+  m_resolver->init(NULL);
 }
 
 Cache::~Cache() {
-  QueryCache::iterator it;
+  m_resolver->stop();
+  delete m_resolver;
 
-  while ((it = m_cache.begin()) != m_cache.end()) {
-    Query* q = it->second;
-    m_cache.erase(it);
-    delete q;
-  }
+  delete[] m_shards;
 
   ares_library_cleanup();
 }
@@ -235,75 +437,130 @@ Cache& Cache::getInstance() {
   return instance;
 }
 
-Query* Cache::query(ns_type rtype, const std::string& domain, bool& cacheHit) {
-  Query* q = lookupQuery(rtype, domain);
+QueryPtr Cache::query(
+    ns_type rtype, const std::string& domain, bool& cacheHit) {
+  bool refresh = false;
+  QueryPtr q   = lookupQuery(rtype, domain, refresh);
+
+  cacheHit = q != NULL;
 
-  cacheHit = !(!q || q->isExpired());
+  if (refresh) m_resolver->submit(rtype, domain, NULL);
 
-  if (!cacheHit)  // query not found or expired
-    q = processQuery(rtype, domain);
+  if (!cacheHit) {  // query not found or too stale to be used
+    SEvent event;
+    QueryRequest req = {NULL, NULL, NULL, &event, &q};
+
+    m_resolver->submit(rtype, domain, &req);
+    event.wait();
+  }
 
   return q;
 }
 
 void Cache::query(
     ns_type rtype, const std::string& domain, CachedDNSQueryCallback cb,
-    void* data) {
-  Query* q = lookupQuery(rtype, domain);
+    void* data, QueryExecutor* executor) {
+  bool refresh = false;
+  QueryPtr q   = lookupQuery(rtype, domain, refresh);
 
-  bool cacheHit = !(!q || q->isExpired());
+  QueryRequest req = {cb, data, executor, NULL, NULL};
 
-  if (cacheHit) {
-    cb(q, cacheHit, data);
-  } else {
-    QueryThread* qt = new QueryThread(rtype, domain, cb, data);
-    qt->init(NULL);
-    // do not delete qt since the thread is set to selfDestruct
-  }
+  if (refresh) m_resolver->submit(rtype, domain, NULL);
+
+  if (q)
+    dispatch(req, q, true);
+  else
+    m_resolver->submit(rtype, domain, &req);
 }
 
-Query* Cache::lookupQuery(ns_type rtype, const std::string& domain) {
-  SMutexLock l(m_cachemutex);
-  QueryCacheKey qck(rtype, domain);
-  QueryCache::const_iterator it = m_cache.find(qck);
-  return it != m_cache.end() ? it->second : NULL;
+CacheShard& Cache::getShard(ns_type rtype, const std::string& domain) {
+  size_t hash = std::hash<std::string>()(domain) ^ (size_t) rtype;
+  return m_shards[hash % CACHE_SHARDS];
 }
 
-Query* Cache::processQuery(ns_type rtype, const std::string& domain) {
-  Query* q = new Query(rtype, domain);
-  QueryProcessor qp(q);
-  qp.execute();
-
-  if (qp.getStatus() == ARES_SUCCESS) {
-    Query* oldQuery = NULL;
-
-    {
-      SMutexLock l(m_cachemutex);
-      QueryCacheKey qck(rtype, domain);
-
-      // lookup the query in the cache
-      QueryCache::iterator it = m_cache.find(qck);
-      if (it != m_cache.end())  // found the entry
-      {
-        // save the query* to be deleted
-        oldQuery = it->second;
-        // update the cache with the new query results
-        it->second = q;
-      } else {
-        // add the entry since it was not found
-        m_cache[qck] = q;
-      }
-    }
+QueryPtr Cache::lookupQuery(
+    ns_type rtype, const std::string& domain, bool& refresh) {
+  CacheShard& shard = getShard(rtype, domain);
+  time_t now        = time(NULL);
+  SMutexLock l(shard.mutex);
+
+  refresh = false;
+
+  std::map<QueryCacheKey, CacheEntry>::iterator it =
+      shard.entries.find(QueryCacheKey(rtype, domain));
+  if (it == shard.entries.end()) return QueryPtr();
+
+  CacheEntry& e = it->second;
+
+  if (now < e.expires) {
+    e.hits++;
+    if (!e.negative && !e.refreshing && m_prefetchpct > 0 &&
+        e.hits >= m_prefetchhits &&
+        now >= e.expires - (e.expires - e.fetched) * m_prefetchpct / 100)
+      refresh = true;
+  } else if (e.negative || now >= e.expires + m_maxstale) {
+    // resolved again by the caller
+    return QueryPtr();
+  } else if (!e.refreshing && now >= e.retry) {
+    refresh = true;
+  }
+
+  if (refresh) e.refreshing = true;
+
+  shard.lru.splice(shard.lru.begin(), shard.lru, e.lru);
+
+  return e.query;
+}
 
-    if (oldQuery) delete oldQuery;
+QueryPtr Cache::updateQuery(const QueryPtr& q, int status) {
+  CacheShard& shard = getShard(q->getType(), q->getDomain());
+  QueryCacheKey key(q->getType(), q->getDomain());
+  time_t now = time(NULL);
+  SMutexLock l(shard.mutex);
+
+  std::map<QueryCacheKey, CacheEntry>::iterator it = shard.entries.find(key);
+  bool failed = status != ARES_SUCCESS && status != ARES_ENOTFOUND &&
+                status != ARES_ENODATA;
+
+  // a stale query is used until the servers can be reached again, the
+  // refresh is retried once the failure TTL has passed
+  if (failed && it != shard.entries.end() && !it->second.negative &&
+      now < it->second.expires + m_maxstale) {
+    it->second.refreshing = false;
+    it->second.retry      = now + m_failurettl;
+    return it->second.query;
+  }
+
+  if (it == shard.entries.end()) {
+    it = shard.entries.insert(std::make_pair(key, CacheEntry())).first;
+
+    shard.lru.push_front(key);
+    it->second.lru = shard.lru.begin();
   } else {
-    // delete the query object since it failed
-    delete q;
-    q = NULL;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+  }
+
+  CacheEntry& e = it->second;
+
+  e.query      = q;
+  e.negative   = status != ARES_SUCCESS;
+  e.refreshing = false;
+  e.fetched    = now;
+  e.retry      = 0;
+  e.hits       = 0;
+
+  if (status == ARES_SUCCESS)
+    e.expires = std::max(q->getExpires(), now);
+  else
+    e.expires = now + (failed ? m_failurettl : m_nxdomainttl);
+
+  size_t max = std::max(m_maxentries / CACHE_SHARDS, (size_t) 1);
+  while (shard.entries.size() > max) {
+    std::map<QueryCacheKey, CacheEntry>::iterator lru =
+        shard.entries.find(shard.lru.back());
+    shard.entries.erase(lru);
+    shard.lru.pop_back();
   }
 
   return q;
 }
-
-void Cache::ares_callback(
-    void* arg, int status, int timeouts, unsigned char* abuf, int alen) {}
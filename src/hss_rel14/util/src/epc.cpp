@@ -16,6 +16,7 @@
 
 #include <stdlib.h>
 #include <iostream>
+#include <unordered_map>
 
 #include "epc.h"
 
@@ -890,7 +891,103 @@ int CanonicalNodeName::topologicalCompare(const CanonicalNodeName& right) {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
-NodeSelectorResultList& NodeSelector::process() {
+// maximum number of memoized selection results of each selector type
+#define EPC_SELECTION_CACHE_SIZE 1024
+
+//
+// Selection results keyed by the selection parameters.  An entry is only
+// used while the DNS cache returns the query it was built from, identified
+// by the serial number of the query.  Once the cache is full the least
+// recently used entry is discarded.
+//
+template <class T>
+class SelectionCache {
+ public:
+  SelectionCache(size_t capacity) : m_capacity(capacity) {}
+
+  std::shared_ptr<T> find(const std::string& key, uint64_t serial) {
+    SMutexLock l(m_mutex);
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end() || it->second.serial != serial)
+      return std::shared_ptr<T>();
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+
+    return it->second.results;
+  }
+
+  void insert(
+      const std::string& key, uint64_t serial,
+      const std::shared_ptr<T>& results) {
+    SMutexLock l(m_mutex);
+
+    auto result = m_entries.insert(std::make_pair(key, Entry()));
+    Entry& e    = result.first->second;
+
+    if (result.second) {
+      m_lru.push_front(&result.first->first);
+      e.lru = m_lru.begin();
+    } else if (e.serial > serial) {
+      // results built from a newer query have already been stored
+      return;
+    } else {
+      m_lru.splice(m_lru.begin(), m_lru, e.lru);
+    }
+
+    e.serial  = serial;
+    e.results = results;
+
+    trim();
+  }
+
+ private:
+  struct Entry {
+    Entry() : serial(0) {}
+
+    uint64_t serial;
+    std::shared_ptr<T> results;
+    std::list<const std::string*>::iterator lru;
+  };
+
+  void trim() {
+    while (m_entries.size() > m_capacity) {
+      const std::string* key = m_lru.back();
+      m_lru.pop_back();
+      m_entries.erase(*key);
+    }
+  }
+
+  SMutex m_mutex;
+  size_t m_capacity;
+  std::unordered_map<std::string, Entry> m_entries;
+  std::list<const std::string*> m_lru;
+};
+
+static SelectionCache<NodeSelectorResultList> nodeSelections(
+    EPC_SELECTION_CACHE_SIZE);
+static SelectionCache<DiameterNaptrList> diameterSelections(
+    EPC_SELECTION_CACHE_SIZE);
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+std::string NodeSelector::getSelectionKey() {
+  std::stringstream ss;
+
+  ss << m_domain << '|' << m_desiredService << '|';
+  for (AppProtocolList::const_iterator it = m_desiredProtocols.begin();
+       it != m_desiredProtocols.end(); ++it)
+    ss << (*it)->getProtocol() << ',';
+  ss << '|';
+  for (UsageTypeList::const_iterator it = m_desiredUsageTypes.begin();
+       it != m_desiredUsageTypes.end(); ++it)
+    ss << *it << ',';
+
+  return ss.str();
+}
+
+const NodeSelectorResultList& NodeSelector::process() {
   std::list<AppProtocolEnum> supportedProtocols;
 
   // perform dns query
@@ -898,6 +995,13 @@ NodeSelectorResultList& NodeSelector::process() {
   m_query =
       CachedDNS::Cache::getInstance().query(ns_t_naptr, m_domain, cacheHit);
 
+  // use the memoized results if they were built from this query
+  std::string key(getSelectionKey());
+  m_results = nodeSelections.find(key, m_query->getSerial());
+  if (m_results) return *m_results;
+
+  m_results.reset(new NodeSelectorResultList());
+
   // evaluate each answer to see if it matches the service/protocol requirements
   for (std::list<CachedDNS::ResourceRecord*>::const_iterator rrit =
            m_query->getAnswers().begin();
@@ -982,7 +1086,7 @@ NodeSelectorResultList& NodeSelector::process() {
         nsr->getIPv6Hosts().shuffle();
 
         // add the nsr pointer to the list since at least 1 protocol matched
-        m_results.push_back(nsr);
+        m_results->push_back(nsr);
       } else {
         // delete the nsr pointer since no protocols matched
         delete nsr;
@@ -991,18 +1095,18 @@ NodeSelectorResultList& NodeSelector::process() {
   }
 
   // sort the naptr list
-  m_results.sort(NodeSelectorResultList::sort_compare);
+  m_results->sort(NodeSelectorResultList::sort_compare);
+
+  nodeSelections.insert(key, m_query->getSerial(), m_results);
 
-  return m_results;
+  return *m_results;
 }
 
 NodeSelector::NodeSelector() {
-  m_query = NULL;
+  m_results.reset(new NodeSelectorResultList());
 }
 
 NodeSelector::~NodeSelector() {
-  // do not delete m_query, it will be deleted by CachedDNS::~Cache
-
   while (!m_desiredProtocols.empty()) {
     AppProtocol* ap = *m_desiredProtocols.begin();
     m_desiredProtocols.pop_front();
@@ -1128,17 +1232,23 @@ bool ColocatedCandidateList::sort_compare(
 DiameterSelector::DiameterSelector()
     : m_application(dia_app_unknown),
       m_protocol(dia_protocol_unknown),
-      m_query(NULL) {}
+      m_results(new DiameterNaptrList()) {}
 
-DiameterNaptrList& DiameterSelector::process() {
-  // validate m_applciation
-  if (m_application == dia_app_unknown) return m_results;
+std::string DiameterSelector::getSelectionKey() {
+  std::stringstream ss;
 
-  // validate m_protocol
-  if (m_protocol == dia_protocol_unknown) return m_results;
+  ss << m_realm << '|' << m_application << '|' << m_protocol;
 
-  // validate realm
-  if (m_realm.empty()) return m_results;
+  return ss.str();
+}
+
+const DiameterNaptrList& DiameterSelector::process() {
+  // validate m_applciation, m_protocol and realm
+  if (m_application == dia_app_unknown ||
+      m_protocol == dia_protocol_unknown || m_realm.empty()) {
+    m_results.reset(new DiameterNaptrList());
+    return *m_results;
+  }
 
   // construct the service string
   std::string service(Utility::getDiameterService(m_application, m_protocol));
@@ -1148,6 +1258,13 @@ DiameterNaptrList& DiameterSelector::process() {
   m_query =
       CachedDNS::Cache::getInstance().query(ns_t_naptr, m_realm, cacheHit);
 
+  // use the memoized results if they were built from this query
+  std::string key(getSelectionKey());
+  m_results = diameterSelections.find(key, m_query->getSerial());
+  if (m_results) return *m_results;
+
+  m_results.reset(new DiameterNaptrList());
+
   // evaluate each answer to see if it matches the service/protocol requirements
   for (std::list<CachedDNS::ResourceRecord*>::const_iterator rrit =
            m_query->getAnswers().begin();
@@ -1264,11 +1381,13 @@ DiameterNaptrList& DiameterSelector::process() {
       }
 
       // add the record to the results
-      m_results.push_back(n);
+      m_results->push_back(n);
     }
   }
 
-  return m_results;
+  diameterSelections.insert(key, m_query->getSerial(), m_results);
+
+  return *m_results;
 }
 
 void DiameterSrvVector::sort_vector() {
@@ -16,9 +16,14 @@
 
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <typeindex>
+#include <unordered_map>
 
 #include "fd.h"
 #include "fdjson.h"
+#include "scodec.h"
+#include "ssync.h"
 #include "sutility.h"
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1660,25 +1665,124 @@ FDPeer* FDPeerList::getOpenPeer() {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+// the published layouts are never released, there is one per extractor class
+static SMutex layoutsMutex;
+static std::unordered_map<std::type_index, FDExtractorLayout*> layouts;
+
+// each thread keeps its own copy of the published layouts keyed by the
+// address of the type_info, so the shared map is only locked the first
+// time a thread constructs an extractor of each class
+static thread_local std::unordered_map<const std::type_info*,
+                                       FDExtractorLayout*>
+    threadLayouts;
+
+FDExtractorLayout* FDExtractorLayout::find(const std::type_info& type) {
+  auto it = threadLayouts.find(&type);
+  if (it != threadLayouts.end()) return it->second;
+
+  SMutexLock l(layoutsMutex);
+
+  auto lit = layouts.find(std::type_index(type));
+  if (lit == layouts.end()) return NULL;
+
+  threadLayouts[&type] = lit->second;
+
+  return lit->second;
+}
+
+FDExtractorLayout* FDExtractorLayout::publish(
+    const std::type_info& type, FDExtractorLayout* layout) {
+  std::sort(layout->m_entries.begin(), layout->m_entries.end());
+
+  SMutexLock l(layoutsMutex);
+
+  // another instance of the class may have been resolved first
+  auto result = layouts.insert(std::make_pair(std::type_index(type), layout));
+  if (!result.second) delete layout;
+
+  threadLayouts[&type] = result.first->second;
+
+  return result.first->second;
+}
+
+void FDExtractorLayout::add(
+    vendor_id_t vndid, avp_code_t avpcode, ptrdiff_t offset) {
+  uint64_t key = makeKey(vndid, avpcode);
+
+  for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+    if (it->key == key) {
+      it->offset = offset;
+      return;
+    }
+  }
+
+  Entry e;
+  e.key    = key;
+  e.offset = offset;
+  m_entries.push_back(e);
+}
+
+bool FDExtractorLayout::lookup(
+    vendor_id_t vndid, avp_code_t avpcode, ptrdiff_t& offset) const {
+  Entry e;
+  e.key = makeKey(vndid, avpcode);
+
+  auto it = std::lower_bound(m_entries.begin(), m_entries.end(), e);
+  if (it == m_entries.end() || it->key != e.key) return false;
+
+  offset = it->offset;
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 FDExtractor::FDExtractor()
-    : FDExtractorBase(NULL), m_parent(NULL), m_reference(NULL), m_index(1) {}
+    : FDExtractorBase(NULL),
+      m_parent(NULL),
+      m_reference(NULL),
+      m_layout(NULL),
+      m_ownlayout(false),
+      m_index(1) {}
 
 FDExtractor::FDExtractor(FDMessage& msg)
     : FDExtractorBase(NULL),
       m_parent(NULL),
       m_reference(msg.getMsg()),
+      m_layout(NULL),
+      m_ownlayout(false),
       m_index(1) {}
 
 FDExtractor::FDExtractor(FDExtractor& parent, FDDictionaryEntryAVP& de)
-    : FDExtractorBase(&de), m_parent(&parent), m_reference(NULL), m_index(1) {}
+    : FDExtractorBase(&de),
+      m_parent(&parent),
+      m_reference(NULL),
+      m_layout(NULL),
+      m_ownlayout(false),
+      m_index(1) {}
 
-FDExtractor::~FDExtractor() {}
+FDExtractor::~FDExtractor() {
+  if (m_ownlayout) delete m_layout;
+}
 
 void FDExtractor::add(FDExtractorBase& base) {
-  FDExtractorKey k(
+  // add() is called from the constructor of the derived class, so typeid
+  // already identifies the class being constructed
+  if (!m_layout) {
+    m_layout = FDExtractorLayout::find(typeid(*this));
+    if (!m_layout) {
+      m_layout    = new FDExtractorLayout();
+      m_ownlayout = true;
+    }
+  }
+
+  // a published layout already contains this member
+  if (!m_ownlayout) return;
+
+  m_layout->add(
       base.getDictionaryEntry()->getVendorId(),
-      base.getDictionaryEntry()->getAvpCode());
-  m_entries[k] = &base;
+      base.getDictionaryEntry()->getAvpCode(),
+      (char*) &base - (char*) this);
 }
 
 bool FDExtractor::exists(bool skipResolve) {
@@ -1721,9 +1825,15 @@ void FDExtractor::resolve() {
 
   setResolved();
 
+  // the instance is fully constructed, so the layout it built is complete
+  if (m_ownlayout) {
+    m_layout    = FDExtractorLayout::publish(typeid(*this), m_layout);
+    m_ownlayout = false;
+  }
+
   // check to see if the parent AVP (reference) exists
   // if ( m_reference && !getResolved() )
-  if (m_reference && needToResolve) {
+  if (m_reference && needToResolve && m_layout) {
     msg_or_avp* loopavp;
 
     // get the first child AVP
@@ -1736,8 +1846,7 @@ void FDExtractor::resolve() {
           __FILE__, __LINE__, ret));
 
     struct avp_hdr* ah;
-    FDExtractorKey key;
-    std::map<FDExtractorKey, FDExtractorBase*>::iterator it;
+    ptrdiff_t offset;
 
     while (loopavp) {
       // get a pointer to the avp header to access the vendor id and avp code
@@ -1747,22 +1856,20 @@ void FDExtractor::resolve() {
             "%s:%d - ERROR - FDExtractor fd_msg_avp_hdr returned %d", __FILE__,
             __LINE__, ret));
 
-      // set the vendor id and avp code in the key
-      key.setVendor(ah->avp_vendor);
-      key.setAvpCode(ah->avp_code);
+      // lookup up the member by vendor id and avp code
+      if (m_layout->lookup(ah->avp_vendor, ah->avp_code, offset)) {
+        FDExtractorBase* member = (FDExtractorBase*) ((char*) this + offset);
 
-      // lookup up the entry
-      if ((it = m_entries.find(key)) != m_entries.end()) {
-        switch (it->second->getExtractorType()) {
+        switch (member->getExtractorType()) {
           case etAvp: {
-            FDExtractorAvp* a = (FDExtractorAvp*) it->second;
+            FDExtractorAvp* a = (FDExtractorAvp*) member;
             a->setIndex(m_index++);
             a->setResolved();
             a->setAvp((struct avp*) loopavp);
             break;
           }
           case etAvpList: {
-            FDExtractorAvpList* al = (FDExtractorAvpList*) it->second;
+            FDExtractorAvpList* al = (FDExtractorAvpList*) member;
             FDExtractorAvp* a =
                 new FDExtractorAvp(*this, *al->getDictionaryEntry());
             a->setIndex(m_index++);
@@ -1773,13 +1880,13 @@ void FDExtractor::resolve() {
             break;
           }
           case etExtractor: {
-            FDExtractor* e = (FDExtractor*) it->second;
+            FDExtractor* e = (FDExtractor*) member;
             e->setIndex(m_index++);
             e->setReference(loopavp);
             break;
           }
           case etExtractorList: {
-            FDExtractorList* el = (FDExtractorList*) it->second;
+            FDExtractorList* el = (FDExtractorList*) member;
             FDExtractor* e      = el->createExtractor();
             e->setIndex(m_index++);
             e->setReference(loopavp);
@@ -1937,32 +2044,9 @@ void FDUtility::splitDiameterFQDN(
   }
 }
 
-#define AQFD_CHAR2TBCD(c)                                                      \
-  (c >= '0' && c <= '9' ?                                                      \
-       c - '0' :                                                               \
-       c == '*' ?                                                              \
-       10 :                                                                    \
-       c == '#' ?                                                              \
-       11 :                                                                    \
-       (c == 'a' || c == 'A') ?                                                \
-       12 :                                                                    \
-       (c == 'b' || c == 'B') ? 13 : (c == 'c' || c == 'C') ? 14 : 15)
-
 size_t FDUtility::str2tbcd(
     const char* src, size_t srclen, uint8_t* dst, size_t dstlen) {
-  size_t len, idx;
-
-  for (len = 0, idx = 0; len < srclen; len++) {
-    if (len & 1)
-      dst[idx++] |= AQFD_CHAR2TBCD(src[len]);
-    else
-      dst[idx] = AQFD_CHAR2TBCD(src[len]) << 4;
-  }
-
-  // in case of an odd number of characters, pad with 0x0f
-  if (len & 1) dst[idx++] |= AQFD_CHAR2TBCD(0);
-
-  return idx;
+  return SCodec::tbcdEncode(src, srclen, dst, dstlen);
 }
 
 size_t FDUtility::str2tbcd(const char* src, uint8_t* dst, size_t dstlen) {
@@ -1975,62 +2059,14 @@ size_t FDUtility::str2tbcd(
   return str2tbcd(src.c_str(), src.size(), dst, dstlen);
 }
 
-#if 0
-size_t FDUtility::str2tbcd( const char *src, uint8_t *dst, size_t dstlen )
-{
-   size_t len;
-
-   for (len = 0; src[len << 1]; len++)
-   {
-      if ( len > dstlen )
-         return 0;
-
-      dst[len] = (
-            AQFD_CHAR2TBCD( src[ len << 1]) << 4 ) |
-            AQFD_CHAR2TBCD( src[ (len << 1) + 1]
-         );
-
-      if ( !src[ (len << 1) + 1 ] )
-         break;
-   }
-
-   return len;
-}
-#endif
-
-#define AQFD_LOW_NIBBLE(b) (b & 0x0f)
-#define AQFD_HIGH_NIBBLE(b) (AQFD_LOW_NIBBLE(b >> 4))
-
 size_t FDUtility::tbcd2str(
     uint8_t* src, size_t srclen, char* dst, size_t dstlen) {
-  static const uint8_t* __TBCD__ = (uint8_t*) "0123456789*#abc";
-
-  size_t srcidx;
-  size_t len = 0;
-
-  for (srcidx = 0; srcidx < srclen; srcidx++) {
-    if (len > dstlen) return 0;
-
-    dst[len] = __TBCD__[AQFD_HIGH_NIBBLE(src[srcidx])];
-
-    if (dst[len]) {
-      len++;
-
-      if (len > dstlen) return 0;
-
-      dst[len] = __TBCD__[AQFD_LOW_NIBBLE(src[srcidx])];
-      if (dst[len]) len++;
-    }
-  }
-
-  dst[len] = 0;
-
-  return len;
+  return SCodec::tbcdDecode(src, srclen, dst, dstlen);
 }
 
 size_t FDUtility::tbcd2str(uint8_t* src, size_t srclen, std::string& dst) {
-  char buffer[srclen * 2];
-  size_t len = tbcd2str(src, srclen, buffer, srclen * 2);
+  char buffer[srclen * 2 + 1];
+  size_t len = tbcd2str(src, srclen, buffer, sizeof(buffer));
 
   dst.assign(buffer, len);
 
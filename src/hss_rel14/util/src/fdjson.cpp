@@ -43,7 +43,11 @@
 #include <stdexcept>
 #include <iostream>
 #include <iomanip>
+#include <list>
+#include <atomic>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "freeDiameter/freeDiameter-host.h"
 #include "freeDiameter/libfdcore.h"
@@ -340,8 +344,165 @@ class AvpDictionaryEntry {
   AvpDataType m_type;
 };
 
+struct AvpNameHash {
+  size_t operator()(const char* s) const {
+    size_t h = 2166136261u;
+    while (*s) h = (h ^ (uint8_t) *s++) * 16777619u;
+    return h;
+  }
+};
+
+struct AvpNameEqual {
+  bool operator()(const char* a, const char* b) const {
+    return strcmp(a, b) == 0;
+  }
+};
+
+//
+// The dictionary entries are published as immutable snapshots.  Readers
+// load the current snapshot without locking, a thread that needs an entry
+// that is not in the snapshot copies it under dictEntriesMutex, adds the
+// entry and publishes the copy.  The names are keyed by the entry's own copy
+// of the name, so a lookup does not allocate.  fdJsonLoadDictionary() loads
+// every AVP at startup, so once running the snapshot is rarely replaced.
+//
+struct AvpDictionarySnapshot {
+  std::unordered_map<const char*, AvpDictionaryEntry*, AvpNameHash,
+                     AvpNameEqual>
+      byName;
+  std::unordered_map<uint64_t, AvpDictionaryEntry*> byCode;
+};
+
 static SMutex dictEntriesMutex;
-static std::unordered_map<std::string, AvpDictionaryEntry*> dictEntries;
+static std::atomic<const AvpDictionarySnapshot*> dictEntries(NULL);
+// a replaced snapshot may still be in use by a reader, so it is never freed
+static std::list<const AvpDictionarySnapshot*> dictEntriesRetired;
+
+static uint64_t fdJsonAvpKey(uint32_t vendor, uint32_t code) {
+  return ((uint64_t) vendor << 32) | code;
+}
+
+static AvpDictionaryEntry* fdJsonNewEntry(const char* avp_name) {
+  AvpDictionaryEntry* ade = new AvpDictionaryEntry();
+
+  try {
+    ade->init(avp_name);
+  } catch (...) {
+    delete ade;
+    throw;
+  }
+
+  return ade;
+}
+
+static void fdJsonInsertEntry(
+    AvpDictionarySnapshot& snap, AvpDictionaryEntry* ade) {
+  snap.byName.insert(std::make_pair(ade->getAvpName().c_str(), ade));
+  snap.byCode.insert(std::make_pair(
+      fdJsonAvpKey(ade->getBaseData().avp_vendor, ade->getBaseData().avp_code),
+      ade));
+}
+
+// must be called with dictEntriesMutex locked
+static AvpDictionarySnapshot* fdJsonCopyEntries() {
+  const AvpDictionarySnapshot* cur = dictEntries.load();
+  return cur ? new AvpDictionarySnapshot(*cur) : new AvpDictionarySnapshot();
+}
+
+// must be called with dictEntriesMutex locked
+static void fdJsonPublishEntries(AvpDictionarySnapshot* snap) {
+  const AvpDictionarySnapshot* old = dictEntries.exchange(snap);
+  if (old) dictEntriesRetired.push_back(old);
+}
+
+static AvpDictionaryEntry* fdJsonFindEntry(const char* avp_name) {
+  const AvpDictionarySnapshot* snap =
+      dictEntries.load(std::memory_order_acquire);
+
+  if (snap) {
+    auto it = snap->byName.find(avp_name);
+    if (it != snap->byName.end()) return it->second;
+  }
+
+  return NULL;
+}
+
+static AvpDictionaryEntry* fdJsonGetEntry(const char* avp_name) {
+  AvpDictionaryEntry* ade = fdJsonFindEntry(avp_name);
+  if (ade) return ade;
+
+  SMutexLock l(dictEntriesMutex);
+
+  // another thread may have added the entry while waiting for the lock
+  if ((ade = fdJsonFindEntry(avp_name))) return ade;
+
+  ade                         = fdJsonNewEntry(avp_name);
+  AvpDictionarySnapshot* snap = fdJsonCopyEntries();
+  fdJsonInsertEntry(*snap, ade);
+  fdJsonPublishEntries(snap);
+
+  return ade;
+}
+
+int fdJsonLoadDictionary() {
+  std::list<struct dict_object*> vendors;
+  struct dict_object* obj = NULL;
+  struct fd_list* sentinel;
+  vendor_id_t vendorid = 0;
+  int loaded           = 0;
+
+  /* vendor 0 is not part of the vendor list */
+  if (fd_dict_search(
+          fd_g_config->cnf_dict, DICT_VENDOR, VENDOR_BY_ID, &vendorid, &obj,
+          ENOENT) == 0)
+    vendors.push_back(obj);
+
+  if (fd_dict_getlistof(VENDOR_BY_ID, fd_g_config->cnf_dict, &sentinel) == 0) {
+    for (struct fd_list* li = sentinel->next; li != sentinel; li = li->next)
+      vendors.push_back((struct dict_object*) li->o);
+  }
+
+  SMutexLock l(dictEntriesMutex);
+
+  AvpDictionarySnapshot* snap = fdJsonCopyEntries();
+
+  for (auto vit = vendors.begin(); vit != vendors.end(); ++vit) {
+    if (fd_dict_getlistof(AVP_BY_NAME, *vit, &sentinel) != 0) continue;
+
+    for (struct fd_list* li = sentinel->next; li != sentinel; li = li->next) {
+      struct dict_avp_data data;
+
+      if (fd_dict_getval((struct dict_object*) li->o, &data) != 0 ||
+          snap->byName.find(data.avp_name) != snap->byName.end())
+        continue;
+
+      try {
+        fdJsonInsertEntry(*snap, fdJsonNewEntry(data.avp_name));
+        loaded++;
+      } catch (runtimeInfo&) {
+        /* entries that cannot be resolved are reported when they are used */
+      }
+    }
+  }
+
+  fdJsonPublishEntries(snap);
+
+  return loaded;
+}
+
+//
+// A JSON block compiled to the AVP's it describes.  The dictionary entries
+// are resolved and the values converted when the block is compiled, adding
+// the compiled block to a message only creates and links the AVP's.
+//
+struct FDJsonTemplateAvp {
+  AvpDictionaryEntry* entry;
+  union avp_value value;
+  std::string os;
+  std::vector<FDJsonTemplateAvp> children;
+};
+
+typedef std::vector<FDJsonTemplateAvp> FDJsonTemplate;
 
 class AVP {
  public:
@@ -428,11 +589,20 @@ class AVP {
     return *this;
   }
 
-  void addTo(msg_or_avp* reference) { _addTo(reference); }
-  void addTo(AVP& reference) { _addTo(reference.mAvp); }
+  FDJsonTemplateAvp& compileTo(FDJsonTemplate& tmpl) {
+    tmpl.push_back(FDJsonTemplateAvp());
+
+    FDJsonTemplateAvp& t = tmpl.back();
+    t.entry              = mEntry;
+    t.value              = mValue;
+
+    // the octet string is copied since it may refer to the JSON document
+    if (mBaseData.avp_basetype == AVP_TYPE_OCTETSTRING) {
+      t.os.assign((const char*) mValue.os.data, mValue.os.len);
+      t.value.os.data = NULL;
+    }
 
-  struct avp* getAvp() {
-    return mAvp;
+    return t;
   }
 
   void allocBuffer(size_t len) {
@@ -445,79 +615,28 @@ class AVP {
 
   dict_avp_basetype getBaseType() { return mBaseData.avp_basetype; }
   AvpDataType getType() { return mType; }
+  AvpDictionaryEntry* getEntry() { return mEntry; }
 
  private:
   void _init(const char* avp_name) {
-    mName      = avp_name;
+    mEntry     = NULL;
     mBaseEntry = NULL;
     memset(&mBaseData, 0, sizeof(mBaseData));
     mType = ADTUnknown;
     mBuf  = NULL;
-    mAvp  = NULL;
     memset(&mValue, 0, sizeof(mValue));
 
-    /* check if an entry exists in dictEntries */
-    std::string an = avp_name;
-    auto it        = dictEntries.find(an);
-    if (it == dictEntries.end()) {
-      SMutexLock l(dictEntriesMutex);
-
-      it = dictEntries.find(an);
-      if (it == dictEntries.end()) {
-        AvpDictionaryEntry* ade = new AvpDictionaryEntry();
-        ade->init(avp_name);
-        std::pair<std::string, AvpDictionaryEntry*> data(
-            ade->getAvpName(), ade);
-        auto result = dictEntries.insert(data);
-        if (result.second == false) {
-          delete ade;
-          throw runtimeInfo(string_format(
-              "%s:%d - WARN - Unable to insert AvpDictionaryEntry for [%s]",
-              __FILE__, __LINE__, avp_name));
-        }
-
-        it = result.first;
-      }
-    }
-
-    mBaseEntry = it->second->getBaseEntry();
-    memcpy(&mBaseData, &it->second->getBaseData(), sizeof(mBaseData));
-    mType = it->second->getType();
-  }
-
-  void _addTo(msg_or_avp* reference) {
-    int ret;
-
-    if ((ret = fd_msg_avp_new(mBaseEntry, 0, &mAvp)) != 0)
-      throw runtimeError(string_format(
-          "%s:%d - ERROR - Error [%d] creating [%s] AVP", __FILE__, __LINE__,
-          ret, mName));
-
-    try {
-      if (mBaseData.avp_basetype != AVP_TYPE_GROUPED) {
-        if ((ret = fd_msg_avp_setvalue(mAvp, &mValue)) != 0)
-          throw runtimeError(string_format(
-              "%s:%d - ERROR - Error [%d] setting AVP value for [%s]", __FILE__,
-              __LINE__, ret, mName));
-      }
-
-      if ((ret = fd_msg_avp_add(reference, MSG_BRW_LAST_CHILD, mAvp)) != 0)
-        throw runtimeError(string_format(
-            "%s:%d - ERROR - Error [%d] adding [%s] AVP", __FILE__, __LINE__,
-            ret, mName));
-    } catch (...) {
-      fd_msg_free(mAvp);
-      mAvp = NULL;
-      throw;
-    }
+    mEntry     = fdJsonGetEntry(avp_name);
+    mBaseEntry = mEntry->getBaseEntry();
+    memcpy(&mBaseData, &mEntry->getBaseData(), sizeof(mBaseData));
+    mType = mEntry->getType();
   }
 
-  const char* mName;
+  AvpDictionaryEntry* mEntry;
   struct dict_object* mBaseEntry;
   struct dict_avp_data mBaseData;
   AvpDataType mType;
   Buffer<uint8_t>* mBuf;
-  struct avp* mAvp;
   union avp_value mValue;
 };
 
@@ -622,15 +741,12 @@ static bool isHexString(const char* s, int len) {
   return true;
 }
 
-static void fdJsonAddAvps(
-    AVP& avp, const RAPIDJSON_NAMESPACE::Value& element,
-    void (*errfunc)(const char*));
-static void fdJsonAddAvps(
-    msg_or_avp* reference, const RAPIDJSON_NAMESPACE::Value& element,
+static void fdJsonCompileAvps(
+    FDJsonTemplate& tmpl, const RAPIDJSON_NAMESPACE::Value& element,
     void (*errfunc)(const char*));
 
-static void fdJsonAddAvp(
-    msg_or_avp* reference, const char* name,
+static void fdJsonCompileAvp(
+    FDJsonTemplate& tmpl, const char* name,
     const RAPIDJSON_NAMESPACE::Value& value, void (*errfunc)(const char*)) {
   AVP avp(name);
 
@@ -686,7 +802,7 @@ static void fdJsonAddAvp(
         }
       }
 
-      avp.addTo(reference);
+      avp.compileTo(tmpl);
 
       break;
     }
@@ -777,8 +893,8 @@ static void fdJsonAddAvp(
         avp.set((uint8_t*) value.GetString(), rawlen);
       }
 
-      /* add to the message/grouped avp */
-      avp.addTo(reference);
+      /* add to the template */
+      avp.compileTo(tmpl);
 
       break;
     }
@@ -786,13 +902,12 @@ static void fdJsonAddAvp(
       /* iterate through array elements adding them to reference */
       for (RAPIDJSON_NAMESPACE::Value::ConstValueIterator it = value.Begin();
            it != value.End(); ++it) {
-        fdJsonAddAvp(reference, name, *it, errfunc);
+        fdJsonCompileAvp(tmpl, name, *it, errfunc);
       }
       break;
     }
     case RAPIDJSON_NAMESPACE::kObjectType: {
-      avp.addTo(reference);
-      fdJsonAddAvps(avp, value, errfunc);
+      fdJsonCompileAvps(avp.compileTo(tmpl).children, value, errfunc);
       break;
     }
     default: {
@@ -804,23 +919,77 @@ static void fdJsonAddAvp(
   }
 }
 
-static void fdJsonAddAvps(
-    AVP& avp, const RAPIDJSON_NAMESPACE::Value& element,
+static void fdJsonCompileAvps(
+    FDJsonTemplate& tmpl, const RAPIDJSON_NAMESPACE::Value& element,
     void (*errfunc)(const char*)) {
-  fdJsonAddAvps(avp.getAvp(), element, errfunc);
-}
-
-static void fdJsonAddAvps(
-    msg_or_avp* reference, const RAPIDJSON_NAMESPACE::Value& element,
-    void (*errfunc)(const char*)) {
-  /* iterate through each of the child elements adding them to the reference */
+  /* iterate through each of the child elements adding them to the template */
   for (RAPIDJSON_NAMESPACE::Value::ConstMemberIterator it =
            element.MemberBegin();
        it != element.MemberEnd(); ++it) {
     try {
-      fdJsonAddAvp(reference, it->name.GetString(), it->value, errfunc);
+      fdJsonCompileAvp(tmpl, it->name.GetString(), it->value, errfunc);
     } catch (runtimeInfo& exi) {
-      errfunc(exi.what());
+      if (errfunc) errfunc(exi.what());
+    }
+  }
+}
+
+static int fdJsonCompile(
+    const char* json, FDJsonTemplate& tmpl, void (*errfunc)(const char*)) {
+  RAPIDJSON_NAMESPACE::Document doc;
+
+  if (!json ||
+      doc.Parse<RAPIDJSON_NAMESPACE::kParseNoFlags>(json).HasParseError()) {
+    if (errfunc)
+      errfunc(string_format(
+                  "%s:%d - ERROR - Error parsing JSON string", __FILE__,
+                  __LINE__)
+                  .c_str());
+    return FDJSON_JSON_PARSING_ERROR;
+  }
+
+  fdJsonCompileAvps(tmpl, doc, errfunc);
+
+  return FDJSON_SUCCESS;
+}
+
+static void fdJsonAddTemplate(
+    msg_or_avp* reference, const FDJsonTemplate& tmpl) {
+  for (FDJsonTemplate::const_iterator it = tmpl.begin(); it != tmpl.end();
+       ++it) {
+    struct avp* avp = NULL;
+    int ret;
+
+    if ((ret = fd_msg_avp_new(it->entry->getBaseEntry(), 0, &avp)) != 0)
+      throw runtimeError(string_format(
+          "%s:%d - ERROR - Error [%d] creating [%s] AVP", __FILE__, __LINE__,
+          ret, it->entry->getAvpName().c_str()));
+
+    try {
+      if (it->entry->getBaseData().avp_basetype == AVP_TYPE_GROUPED) {
+        fdJsonAddTemplate(avp, it->children);
+      } else {
+        union avp_value value = it->value;
+
+        /* freeDiameter makes its own copy of an octet string */
+        if (it->entry->getBaseData().avp_basetype == AVP_TYPE_OCTETSTRING) {
+          value.os.data = (uint8_t*) it->os.data();
+          value.os.len  = it->os.size();
+        }
+
+        if ((ret = fd_msg_avp_setvalue(avp, &value)) != 0)
+          throw runtimeError(string_format(
+              "%s:%d - ERROR - Error [%d] setting AVP value for [%s]",
+              __FILE__, __LINE__, ret, it->entry->getAvpName().c_str()));
+      }
+
+      if ((ret = fd_msg_avp_add(reference, MSG_BRW_LAST_CHILD, avp)) != 0)
+        throw runtimeError(string_format(
+            "%s:%d - ERROR - Error [%d] adding [%s] AVP", __FILE__, __LINE__,
+            ret, it->entry->getAvpName().c_str()));
+    } catch (...) {
+      fd_msg_free(avp);
+      throw;
     }
   }
 }
@@ -828,35 +997,443 @@ static void fdJsonAddAvps(
 int fdJsonAddAvps(
     const char* json, msg_or_avp* msg, void (*errfunc)(const char*)) {
   int ret = FDJSON_SUCCESS;
-  RAPIDJSON_NAMESPACE::Document doc;
+  FDJsonTemplate tmpl;
 
-  if (!json) {
-    errfunc(string_format(
-                "%s:%d - ERROR - Error parsing JSON string", __FILE__, __LINE__)
-                .c_str());
-    return FDJSON_JSON_PARSING_ERROR;
+  try {
+    ret = fdJsonCompile(json, tmpl, errfunc);
+    if (ret == FDJSON_SUCCESS) fdJsonAddTemplate(msg, tmpl);
+  } catch (runtimeError& ex) {
+    if (errfunc) errfunc(ex.what());
+    ret = FDJSON_EXCEPTION;
   }
 
-  if (doc.Parse<RAPIDJSON_NAMESPACE::kParseNoFlags>(json).HasParseError()) {
-    errfunc(string_format(
-                "%s:%d - ERROR - Error parsing JSON string", __FILE__, __LINE__)
-                .c_str());
-    return FDJSON_JSON_PARSING_ERROR;
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Compiled templates keyed by the JSON text they were compiled from.  Once
+// the cache is full the least recently used template is discarded.  The
+// templates are shared with the threads adding them to a message, so a
+// discarded template is released when the last of those threads is done.
+//
+class FDJsonTemplateCache {
+ public:
+  FDJsonTemplateCache() : m_capacity(0) {}
+
+  void setCapacity(size_t capacity) {
+    SMutexLock l(m_mutex);
+    m_capacity = capacity;
+    trim();
+  }
+
+  std::shared_ptr<FDJsonTemplate> find(const char* json, size_t len) {
+    SMutexLock l(m_mutex);
+
+    auto it = lookup(json, len, hash(json, len));
+    if (it == m_templates.end()) return std::shared_ptr<FDJsonTemplate>();
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+
+    return it->second.tmpl;
+  }
+
+  void insert(
+      const char* json, size_t len,
+      const std::shared_ptr<FDJsonTemplate>& tmpl) {
+    SMutexLock l(m_mutex);
+
+    if (m_capacity == 0) return;
+
+    size_t h = hash(json, len);
+    if (lookup(json, len, h) != m_templates.end()) return;
+
+    auto it = m_templates.insert(std::make_pair(h, Entry()));
+    it->second.hash = h;
+    it->second.json.assign(json, len);
+    it->second.tmpl = tmpl;
+
+    m_lru.push_front(&it->second);
+    it->second.lru = m_lru.begin();
+
+    trim();
+  }
+
+ private:
+  struct Entry {
+    size_t hash;
+    std::string json;
+    std::shared_ptr<FDJsonTemplate> tmpl;
+    std::list<Entry*>::iterator lru;
+  };
+
+  typedef std::unordered_multimap<size_t, Entry> TemplateMap;
+
+  // FNV-1a, the JSON is hashed where it is so a lookup does not copy it
+  static size_t hash(const char* json, size_t len) {
+    uint64_t h = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < len; i++) {
+      h ^= (uint8_t) json[i];
+      h *= 1099511628211ULL;
+    }
+
+    return (size_t) h;
+  }
+
+  TemplateMap::iterator lookup(const char* json, size_t len, size_t h) {
+    auto range = m_templates.equal_range(h);
+
+    for (auto it = range.first; it != range.second; ++it)
+      if (it->second.json.size() == len &&
+          memcmp(it->second.json.data(), json, len) == 0)
+        return it;
+
+    return m_templates.end();
   }
 
+  void trim() {
+    while (m_templates.size() > m_capacity) {
+      Entry* entry = m_lru.back();
+      auto range   = m_templates.equal_range(entry->hash);
+
+      m_lru.pop_back();
+      for (auto it = range.first; it != range.second; ++it) {
+        if (&it->second == entry) {
+          m_templates.erase(it);
+          break;
+        }
+      }
+    }
+  }
+
+  SMutex m_mutex;
+  size_t m_capacity;
+  TemplateMap m_templates;
+  std::list<Entry*> m_lru;
+};
+
+static FDJsonTemplateCache templateCache;
+
+void fdJsonSetTemplateCacheSize(size_t entries) {
+  templateCache.setCapacity(entries);
+}
+
+int fdJsonPreloadTemplate(const char* json, void (*errfunc)(const char*)) {
+  int ret = FDJSON_SUCCESS;
+
+  if (!json || templateCache.find(json, strlen(json))) return ret;
+
   try {
-    for (RAPIDJSON_NAMESPACE::Value::ConstMemberIterator it = doc.MemberBegin();
-         it != doc.MemberEnd(); ++it) {
-      fdJsonAddAvp(msg, it->name.GetString(), it->value, errfunc);
+    std::shared_ptr<FDJsonTemplate> tmpl(new FDJsonTemplate());
+    ret = fdJsonCompile(json, *tmpl, errfunc);
+    if (ret == FDJSON_SUCCESS) templateCache.insert(json, strlen(json), tmpl);
+  } catch (runtimeError& ex) {
+    if (errfunc) errfunc(ex.what());
+    ret = FDJSON_EXCEPTION;
+  }
+
+  return ret;
+}
+
+int fdJsonAddAvpsCached(
+    const char* json, msg_or_avp* msg, void (*errfunc)(const char*)) {
+  if (!json) return fdJsonAddAvps(json, msg, errfunc);
+
+  return fdJsonAddAvpsCached(json, strlen(json), msg, errfunc);
+}
+
+int fdJsonAddAvpsCached(
+    const char* json, size_t len, msg_or_avp* msg,
+    void (*errfunc)(const char*)) {
+  int ret = FDJSON_SUCCESS;
+
+  if (!json) len = 0;
+
+  try {
+    std::shared_ptr<FDJsonTemplate> tmpl = templateCache.find(json, len);
+
+    if (!tmpl) {
+      // informational messages about the block are only reported when it is
+      // compiled, not each time the cached template is used, the block is
+      // only copied to terminate it for the parser when it is compiled
+      std::string block(json ? json : "", len);
+
+      tmpl.reset(new FDJsonTemplate());
+      ret = fdJsonCompile(block.c_str(), *tmpl, errfunc);
+      if (ret != FDJSON_SUCCESS) return ret;
+      templateCache.insert(json, len, tmpl);
     }
+
+    fdJsonAddTemplate(msg, *tmpl);
   } catch (runtimeError& ex) {
-    errfunc(ex.what());
+    if (errfunc) errfunc(ex.what());
     ret = FDJSON_EXCEPTION;
   }
 
   return ret;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#define AVP_HEADER_LENGTH 8
+#define AVP_VENDOR_HEADER_LENGTH 12
+#define AVP_PADDED_LENGTH(_l) (((_l) + 3) & ~((size_t) 3))
+
+static void fdJsonPut32(std::string& bin, uint32_t v) {
+  v = htonl(v);
+  bin.append((const char*) &v, sizeof(v));
+}
+
+static void fdJsonPut64(std::string& bin, uint64_t v) {
+  fdJsonPut32(bin, (uint32_t)(v >> 32));
+  fdJsonPut32(bin, (uint32_t) v);
+}
+
+static uint32_t fdJsonGet32(const uint8_t* p) {
+  return ((uint32_t) p[0] << 24) | ((uint32_t) p[1] << 16) |
+         ((uint32_t) p[2] << 8) | (uint32_t) p[3];
+}
+
+static uint64_t fdJsonGet64(const uint8_t* p) {
+  return ((uint64_t) fdJsonGet32(p) << 32) | fdJsonGet32(p + 4);
+}
+
+static void fdJsonEncodeTemplate(const FDJsonTemplate& tmpl, std::string& bin) {
+  for (FDJsonTemplate::const_iterator it = tmpl.begin(); it != tmpl.end();
+       ++it) {
+    struct dict_avp_data& data = it->entry->getBaseData();
+    uint8_t flags              = data.avp_flag_val;
+    size_t start               = bin.size();
+
+    if (data.avp_vendor) flags |= AVP_FLAG_VENDOR;
+
+    /* the length is filled in once the value has been encoded */
+    fdJsonPut32(bin, data.avp_code);
+    fdJsonPut32(bin, 0);
+    if (flags & AVP_FLAG_VENDOR) fdJsonPut32(bin, data.avp_vendor);
+
+    switch (data.avp_basetype) {
+      case AVP_TYPE_GROUPED: {
+        fdJsonEncodeTemplate(it->children, bin);
+        break;
+      }
+      case AVP_TYPE_OCTETSTRING: {
+        bin.append(it->os);
+        break;
+      }
+      case AVP_TYPE_INTEGER32:
+      case AVP_TYPE_UNSIGNED32:
+      case AVP_TYPE_FLOAT32: {
+        fdJsonPut32(bin, it->value.u32);
+        break;
+      }
+      case AVP_TYPE_INTEGER64:
+      case AVP_TYPE_UNSIGNED64:
+      case AVP_TYPE_FLOAT64: {
+        fdJsonPut64(bin, it->value.u64);
+        break;
+      }
+      default: {
+        throw runtimeError(string_format(
+            "%s:%d - ERROR - Unable to encode [%s], unsupported base type %d",
+            __FILE__, __LINE__, it->entry->getAvpName().c_str(),
+            data.avp_basetype));
+      }
+    }
+
+    uint32_t len = bin.size() - start;
+    uint32_t hdr = htonl(((uint32_t) flags << 24) | len);
+    bin.replace(start + 4, sizeof(hdr), (const char*) &hdr, sizeof(hdr));
+
+    bin.append(AVP_PADDED_LENGTH(len) - len, '\0');
+  }
+}
+
+int fdJsonEncodeAvps(
+    const char* json, std::string& bin, void (*errfunc)(const char*)) {
+  int ret = FDJSON_SUCCESS;
+  FDJsonTemplate tmpl;
+
+  bin.clear();
+
+  try {
+    ret = fdJsonCompile(json, tmpl, errfunc);
+    if (ret == FDJSON_SUCCESS) fdJsonEncodeTemplate(tmpl, bin);
+  } catch (runtimeError& ex) {
+    if (errfunc) errfunc(ex.what());
+    ret = FDJSON_EXCEPTION;
+  }
+
+  return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+static AvpDictionaryEntry* fdJsonFindAvp(uint32_t vendor, uint32_t code) {
+  uint64_t key = fdJsonAvpKey(vendor, code);
+  const AvpDictionarySnapshot* cur =
+      dictEntries.load(std::memory_order_acquire);
+
+  if (cur) {
+    auto it = cur->byCode.find(key);
+    if (it != cur->byCode.end()) return it->second;
+  }
+
+  SMutexLock l(dictEntriesMutex);
+
+  if ((cur = dictEntries.load())) {
+    auto it = cur->byCode.find(key);
+    if (it != cur->byCode.end()) return it->second;
+  }
+
+  struct dict_avp_request req;
+  struct dict_object* obj = NULL;
+  struct dict_avp_data data;
+
+  req.avp_vendor = vendor;
+  req.avp_code   = code;
+  req.avp_name   = NULL;
+
+  if (fd_dict_search(
+          fd_g_config->cnf_dict, DICT_AVP, AVP_BY_CODE_AND_VENDOR, &req, &obj,
+          ENOENT) != 0 ||
+      fd_dict_getval(obj, &data) != 0)
+    throw runtimeError(string_format(
+        "%s:%d - ERROR - Unable to find AVP dictionary entry for code %u "
+        "vendor %u",
+        __FILE__, __LINE__, code, vendor));
+
+  // the AVP is added by name, so the same entry is used for both lookups
+  AvpDictionaryEntry* ade = fdJsonFindEntry(data.avp_name);
+  if (!ade) ade = fdJsonNewEntry(data.avp_name);
+
+  AvpDictionarySnapshot* snap = fdJsonCopyEntries();
+  fdJsonInsertEntry(*snap, ade);
+  snap->byCode[key] = ade;
+  fdJsonPublishEntries(snap);
+
+  return ade;
+}
+
+static void fdJsonAddEncoded(
+    msg_or_avp* reference, const uint8_t* p, size_t len) {
+  while (len > 0) {
+    if (len < AVP_HEADER_LENGTH)
+      throw runtimeError(string_format(
+          "%s:%d - ERROR - Truncated AVP header", __FILE__, __LINE__));
+
+    uint32_t code   = fdJsonGet32(p);
+    uint8_t flags   = p[4];
+    size_t avplen   = fdJsonGet32(p + 4) & 0x00ffffff;
+    size_t hdrlen   = AVP_HEADER_LENGTH;
+    uint32_t vendor = 0;
+
+    if (flags & AVP_FLAG_VENDOR) {
+      hdrlen = AVP_VENDOR_HEADER_LENGTH;
+      if (len >= hdrlen) vendor = fdJsonGet32(p + 8);
+    }
+
+    if (avplen < hdrlen || avplen > len)
+      throw runtimeError(string_format(
+          "%s:%d - ERROR - Invalid length %zu for AVP code %u", __FILE__,
+          __LINE__, avplen, code));
+
+    AvpDictionaryEntry* entry = fdJsonFindAvp(vendor, code);
+    const uint8_t* data       = p + hdrlen;
+    size_t datalen            = avplen - hdrlen;
+    struct avp* avp           = NULL;
+    int ret;
+
+    if ((ret = fd_msg_avp_new(entry->getBaseEntry(), 0, &avp)) != 0)
+      throw runtimeError(string_format(
+          "%s:%d - ERROR - Error [%d] creating [%s] AVP", __FILE__, __LINE__,
+          ret, entry->getAvpName().c_str()));
+
+    try {
+      union avp_value value;
+      size_t expected = 0;
+
+      memset(&value, 0, sizeof(value));
+
+      switch (entry->getBaseData().avp_basetype) {
+        case AVP_TYPE_GROUPED: {
+          fdJsonAddEncoded(avp, data, datalen);
+          break;
+        }
+        case AVP_TYPE_OCTETSTRING: {
+          value.os.data = (uint8_t*) data;
+          value.os.len  = datalen;
+          break;
+        }
+        case AVP_TYPE_INTEGER32:
+        case AVP_TYPE_UNSIGNED32:
+        case AVP_TYPE_FLOAT32: {
+          expected = sizeof(uint32_t);
+          if (datalen == expected) value.u32 = fdJsonGet32(data);
+          break;
+        }
+        case AVP_TYPE_INTEGER64:
+        case AVP_TYPE_UNSIGNED64:
+        case AVP_TYPE_FLOAT64: {
+          expected = sizeof(uint64_t);
+          if (datalen == expected) value.u64 = fdJsonGet64(data);
+          break;
+        }
+        default: {
+          break;
+        }
+      }
+
+      if (expected && datalen != expected)
+        throw runtimeError(string_format(
+            "%s:%d - ERROR - Invalid length %zu for [%s]", __FILE__, __LINE__,
+            datalen, entry->getAvpName().c_str()));
+
+      if (entry->getBaseData().avp_basetype != AVP_TYPE_GROUPED &&
+          (ret = fd_msg_avp_setvalue(avp, &value)) != 0)
+        throw runtimeError(string_format(
+            "%s:%d - ERROR - Error [%d] setting AVP value for [%s]", __FILE__,
+            __LINE__, ret, entry->getAvpName().c_str()));
+
+      if ((ret = fd_msg_avp_add(reference, MSG_BRW_LAST_CHILD, avp)) != 0)
+        throw runtimeError(string_format(
+            "%s:%d - ERROR - Error [%d] adding [%s] AVP", __FILE__, __LINE__,
+            ret, entry->getAvpName().c_str()));
+    } catch (...) {
+      fd_msg_free(avp);
+      throw;
+    }
+
+    /* the final AVP is not required to be padded */
+    size_t padded = AVP_PADDED_LENGTH(avplen);
+    if (padded > len) padded = len;
+
+    p += padded;
+    len -= padded;
+  }
+}
+
+int fdJsonAddEncodedAvps(
+    const uint8_t* bin, size_t len, msg_or_avp* msg,
+    void (*errfunc)(const char*)) {
+  try {
+    fdJsonAddEncoded(msg, bin, len);
+  } catch (runtimeError& ex) {
+    if (errfunc) errfunc(ex.what());
+    return FDJSON_EXCEPTION;
+  } catch (runtimeInfo& exi) {
+    if (errfunc) errfunc(exi.what());
+    return FDJSON_EXCEPTION;
+  }
+
+  return FDJSON_SUCCESS;
+}
+
 std::string fdJsonBinaryToHex(const unsigned char* buffer, size_t len) {
   static const char* hexDigits = "0123456789ABCDEF";
   std::stringstream ss;
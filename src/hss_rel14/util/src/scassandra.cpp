@@ -14,7 +14,10 @@
  * limitations under the License.
  */
 
+#include <limits.h>
+
 #include "scassandra.h"
+#include "scodec.h"
 
 SCassValue::SCassValue() : m_value(NULL) {}
 
@@ -85,6 +88,39 @@ bool SCassValue::get(const uint8_t*& v, size_t& len) {
   return m_error == CASS_OK;
 }
 
+bool SCassValue::get(SCassView& v) {
+  const char* val;
+  size_t len;
+
+  v.clear();
+
+  // text and blob values are both returned as bytes by the driver
+  m_error = cass_value_get_string(m_value, &val, &len);
+
+  if (m_error == CASS_OK) {
+    v = SCassView(val, len);
+    return true;
+  }
+
+  return false;
+}
+
+bool SCassValue::getHex(uint8_t* v, size_t len) {
+  const char* val;
+  size_t vallen;
+
+  m_error = cass_value_get_string(m_value, &val, &vallen);
+
+  if (m_error != CASS_OK) return false;
+
+  if (vallen != len * 2 || !SCodec::hexDecode(val, v, len)) {
+    m_error = CASS_ERROR_LIB_INVALID_DATA;
+    return false;
+  }
+
+  return true;
+}
+
 bool SCassValue::get(STime& v) {
   int64_t ms;
   if (SCassValue::get(ms)) {
@@ -289,6 +325,26 @@ SCassResult SCassFuture::result() {
   return SCassResult(cass_future_get_result(m_future));
 }
 
+SCassResultPtr SCassFuture::sharedResult() {
+  return SCassResultPtr(new SCassResult(cass_future_get_result(m_future)));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+SCassPrepared::SCassPrepared() : m_prepared(NULL) {}
+
+SCassPrepared::~SCassPrepared() {
+  release();
+}
+
+void SCassPrepared::release() {
+  if (m_prepared) {
+    cass_prepared_free(m_prepared);
+    m_prepared = NULL;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -302,6 +358,9 @@ SCassStatement::SCassStatement(const std::string& qry) : m_statement(NULL) {
   query(qry);
 }
 
+SCassStatement::SCassStatement(SCassPrepared& prepared)
+    : m_statement(cass_prepared_bind(prepared.m_prepared)) {}
+
 SCassStatement::~SCassStatement() {
   release();
 }
@@ -328,6 +387,28 @@ SCassFuture SCassStatement::execute(CassSession* session) {
   return SCassFuture(cass_session_execute(session, m_statement));
 }
 
+CassError SCassStatement::bind(size_t index, const std::string& value) {
+  return cass_statement_bind_string_n(
+      m_statement, index, value.data(), value.size());
+}
+
+CassError SCassStatement::bind(size_t index, int32_t value) {
+  return cass_statement_bind_int32(m_statement, index, value);
+}
+
+CassError SCassStatement::bind(size_t index, int64_t value) {
+  return cass_statement_bind_int64(m_statement, index, value);
+}
+
+CassError SCassStatement::bindBytes(
+    size_t index, const uint8_t* value, size_t len) {
+  return cass_statement_bind_bytes(m_statement, index, value, len);
+}
+
+CassError SCassStatement::bindNull(size_t index) {
+  return cass_statement_bind_null(m_statement, index);
+}
+
 CassError SCassStatement::setPagingSize(int page_size) {
   return cass_statement_set_paging_size(m_statement, page_size);
 }
@@ -339,6 +420,27 @@ CassError SCassStatement::setPagingState(SCassResult& result) {
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
+SCassBatch::SCassBatch(CassBatchType type) : m_size(0) {
+  m_batch = cass_batch_new(type);
+}
+
+SCassBatch::~SCassBatch() {
+  cass_batch_free(m_batch);
+}
+
+CassError SCassBatch::add(SCassStatement& statement) {
+  CassError err = cass_batch_add_statement(m_batch, statement.m_statement);
+  if (err == CASS_OK) m_size++;
+  return err;
+}
+
+SCassFuture SCassBatch::execute(CassSession* session) {
+  return SCassFuture(cass_session_execute_batch(session, m_batch));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
 SCassandra::SCassandra() : m_cluster(NULL), m_session(NULL), m_protver(3) {}
 
 SCassandra::~SCassandra() {
@@ -384,6 +486,22 @@ void SCassandra::disconnect() {
   release();
 }
 
+CassError SCassandra::prepare(const char* qry, SCassPrepared& prepared) {
+  CassFuture* future = cass_session_prepare(m_session, qry);
+
+  cass_future_wait(future);
+
+  CassError err = cass_future_error_code(future);
+  if (err == CASS_OK) {
+    prepared.release();
+    prepared.m_prepared = cass_future_get_prepared(future);
+  }
+
+  cass_future_free(future);
+
+  return err;
+}
+
 bool SCassandra::setCoreConnectionsPerHost(uint32_t num) {
   return cass_cluster_set_core_connections_per_host(m_cluster, num) == CASS_OK;
   ;
@@ -405,3 +523,21 @@ bool SCassandra::setIOQueueSize(uint32_t size) {
   return cass_cluster_set_queue_size_io(m_cluster, size) == CASS_OK;
   ;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void SCassTokenRange(
+    int range, int count, int64_t& first, int64_t& last, bool& inclusive) {
+  // the Murmur3 tokens span the full signed 64 bit range, the ranges are
+  // computed as unsigned offsets from the minimum token to avoid overflow
+  uint64_t step = (uint64_t) -1 / count;
+
+  first     = (int64_t)((uint64_t) LLONG_MIN + step * range);
+  inclusive = range == 0;
+
+  if (range == count - 1)
+    last = LLONG_MAX;
+  else
+    last = (int64_t)((uint64_t) first + step);
+}
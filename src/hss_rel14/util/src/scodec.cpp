@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "scodec.h"
+
+static const char* hexLower   = "0123456789abcdef";
+static const char* hexUpper   = "0123456789ABCDEF";
+static const char* tbcdDigits = "0123456789*#abc";
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+// the comparisons produce 0 or 1, negating them yields a 0x00 or 0xff mask
+#define SCODEC_MASK(_cond) ((uint8_t)(0 - (uint8_t)(_cond)))
+
+static inline uint8_t hexValue(uint8_t c, uint8_t& bad) {
+  uint8_t d   = c - '0';
+  uint8_t a   = (c | 0x20) - 'a';
+  uint8_t isd = SCODEC_MASK(d <= 9);
+  uint8_t isa = SCODEC_MASK(a <= 5);
+
+  bad |= ~(isd | isa) & 1;
+
+  return (d & isd) | ((a + 10) & isa);
+}
+
+static inline uint8_t tbcdValue(uint8_t c) {
+  uint8_t d     = c - '0';
+  uint8_t a     = (c | 0x20) - 'a';
+  uint8_t isd   = SCODEC_MASK(d <= 9);
+  uint8_t isa   = SCODEC_MASK(a <= 2);
+  uint8_t isstr = SCODEC_MASK(c == '*');
+  uint8_t ishsh = SCODEC_MASK(c == '#');
+  uint8_t other = ~(isd | isa | isstr | ishsh);
+
+  return (d & isd) | ((a + 12) & isa) | (10 & isstr) | (11 & ishsh) |
+         (15 & other);
+}
+
+#if defined(__SSE2__)
+
+// unsigned x <= n for each byte, SSE2 only has signed byte comparisons
+static inline __m128i lessEqual(__m128i x, uint8_t n) {
+  __m128i vn = _mm_set1_epi8(n);
+  return _mm_cmpeq_epi8(_mm_max_epu8(x, vn), vn);
+}
+
+static inline __m128i hexChars16(__m128i n, __m128i alpha) {
+  __m128i isalpha = _mm_cmpgt_epi8(n, _mm_set1_epi8(9));
+  return _mm_add_epi8(
+      _mm_add_epi8(n, _mm_set1_epi8('0')), _mm_and_si128(isalpha, alpha));
+}
+
+// 16 bytes to 32 hex digits
+static inline void hexEncode16(const uint8_t* src, char* dst, __m128i alpha) {
+  __m128i mask = _mm_set1_epi8(0x0f);
+  __m128i v    = _mm_loadu_si128((const __m128i*) src);
+  __m128i hi   = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+  __m128i lo   = _mm_and_si128(v, mask);
+
+  _mm_storeu_si128(
+      (__m128i*) dst, hexChars16(_mm_unpacklo_epi8(hi, lo), alpha));
+  _mm_storeu_si128(
+      (__m128i*) (dst + 16), hexChars16(_mm_unpackhi_epi8(hi, lo), alpha));
+}
+
+static inline __m128i hexValues16(const char* src, __m128i& bad) {
+  __m128i c   = _mm_loadu_si128((const __m128i*) src);
+  __m128i d   = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+  __m128i a   = _mm_sub_epi8(
+      _mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+  __m128i isd = lessEqual(d, 9);
+  __m128i isa = lessEqual(a, 5);
+
+  bad = _mm_or_si128(
+      bad, _mm_andnot_si128(_mm_or_si128(isd, isa), _mm_set1_epi8(-1)));
+
+  return _mm_or_si128(
+      _mm_and_si128(isd, d),
+      _mm_and_si128(isa, _mm_add_epi8(a, _mm_set1_epi8(10))));
+}
+
+// each 16 bit lane holds the high nibble in its low byte and the low nibble
+// in its high byte, combine them into a byte value in the low byte
+static inline __m128i hexPairs8(__m128i v) {
+  return _mm_or_si128(
+      _mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00ff)), 4),
+      _mm_srli_epi16(v, 8));
+}
+
+// 32 hex digits to 16 bytes
+static inline bool hexDecode16(const char* src, uint8_t* dst) {
+  __m128i bad = _mm_setzero_si128();
+  __m128i a   = hexPairs8(hexValues16(src, bad));
+  __m128i b   = hexPairs8(hexValues16(src + 16, bad));
+
+  _mm_storeu_si128((__m128i*) dst, _mm_packus_epi16(a, b));
+
+  return _mm_movemask_epi8(bad) == 0;
+}
+
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SCODEC_SWAR_DIGITS
+#endif
+
+#ifdef SCODEC_SWAR_DIGITS
+
+// Converts 8 decimal digits held in a 64 bit word, the first digit in the
+// low byte, by combining adjacent digits, then pairs, then quads.
+static inline uint64_t parse8(const uint8_t* src, uint8_t& bad) {
+  uint64_t v;
+
+  memcpy(&v, src, sizeof(v));
+
+  // every byte must be 0x30 - 0x39
+  bad |= ((v & 0xf0f0f0f0f0f0f0f0ULL) != 0x3030303030303030ULL) |
+         (((v + 0x0606060606060606ULL) & 0xf0f0f0f0f0f0f0f0ULL) !=
+          0x3030303030303030ULL);
+
+  v &= 0x0f0f0f0f0f0f0f0fULL;
+  v = (v * 10 + (v >> 8)) & 0x00ff00ff00ff00ffULL;
+  v = (v * 100 + (v >> 16)) & 0x0000ffff0000ffffULL;
+  v = (v * 10000 + (v >> 32)) & 0x00000000ffffffffULL;
+
+  return v;
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+void SCodec::hexEncode(const uint8_t* src, size_t len, char* dst, bool upper) {
+  const char* digits = upper ? hexUpper : hexLower;
+  size_t i           = 0;
+
+#if defined(__SSE2__)
+  __m128i alpha = _mm_set1_epi8((upper ? 'A' : 'a') - '0' - 10);
+  for (; i + 16 <= len; i += 16) hexEncode16(src + i, dst + i * 2, alpha);
+#endif
+
+  for (; i < len; i++) {
+    dst[i * 2]     = digits[src[i] >> 4];
+    dst[i * 2 + 1] = digits[src[i] & 0x0f];
+  }
+}
+
+std::string SCodec::hexEncode(const uint8_t* src, size_t len, bool upper) {
+  std::string s(len * 2, '\0');
+
+  if (len) hexEncode(src, len, &s[0], upper);
+
+  return s;
+}
+
+bool SCodec::hexDecode(const char* src, uint8_t* dst, size_t len) {
+  const uint8_t* s = (const uint8_t*) src;
+  uint8_t bad      = 0;
+  size_t i         = 0;
+
+#if defined(__SSE2__)
+  for (; i + 16 <= len; i += 16) bad |= !hexDecode16(src + i * 2, dst + i);
+#endif
+
+  for (; i < len; i++)
+    dst[i] = (hexValue(s[i * 2], bad) << 4) | hexValue(s[i * 2 + 1], bad);
+
+  return !bad;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+size_t SCodec::tbcdEncode(
+    const char* src, size_t srclen, uint8_t* dst, size_t dstlen) {
+  const uint8_t* s = (const uint8_t*) src;
+  size_t len       = (srclen + 1) / 2;
+
+  if (len > dstlen) return 0;
+
+  for (size_t i = 0; i < srclen / 2; i++)
+    dst[i] = (tbcdValue(s[i * 2]) << 4) | tbcdValue(s[i * 2 + 1]);
+
+  if (srclen & 1) dst[len - 1] = (tbcdValue(s[srclen - 1]) << 4) | 0x0f;
+
+  return len;
+}
+
+size_t SCodec::tbcdDecode(
+    const uint8_t* src, size_t srclen, char* dst, size_t dstlen) {
+  size_t len = 0;
+
+  if (dstlen == 0) return 0;
+
+  if (srclen * 2 < dstlen) {
+    // there is room for every digit, each nibble is stored unconditionally
+    // and only counted if it is not filler, a filler high nibble also
+    // discards the low nibble
+    for (size_t i = 0; i < srclen; i++) {
+      uint8_t hi  = src[i] >> 4;
+      uint8_t lo  = src[i] & 0x0f;
+      size_t hiok = hi != 0x0f;
+
+      dst[len] = tbcdDigits[hi];
+      len += hiok;
+      dst[len] = tbcdDigits[lo];
+      len += hiok & (lo != 0x0f);
+    }
+  } else {
+    for (size_t i = 0; i < srclen; i++) {
+      uint8_t hi = src[i] >> 4;
+      uint8_t lo = src[i] & 0x0f;
+
+      if (hi == 0x0f) continue;
+
+      if (len + 1 >= dstlen) {
+        dst[0] = '\0';
+        return 0;
+      }
+      dst[len++] = tbcdDigits[hi];
+
+      if (lo == 0x0f) continue;
+
+      if (len + 1 >= dstlen) {
+        dst[0] = '\0';
+        return 0;
+      }
+      dst[len++] = tbcdDigits[lo];
+    }
+  }
+
+  dst[len] = '\0';
+
+  return len;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+bool SCodec::digitsDecode(const char* src, size_t len, uint8_t* dst) {
+  const uint8_t* s = (const uint8_t*) src;
+  uint8_t bad      = 0;
+  size_t i         = 0;
+
+#if defined(__SSE2__)
+  for (; i + 16 <= len; i += 16) {
+    __m128i d = _mm_sub_epi8(
+        _mm_loadu_si128((const __m128i*) (s + i)), _mm_set1_epi8('0'));
+    bad |= _mm_movemask_epi8(lessEqual(d, 9)) != 0xffff;
+    _mm_storeu_si128((__m128i*) (dst + i), d);
+  }
+#endif
+
+  for (; i < len; i++) {
+    uint8_t d = s[i] - '0';
+    bad |= d > 9;
+    dst[i] = d;
+  }
+
+  return !bad;
+}
+
+bool SCodec::parseUint64(const char* src, size_t len, uint64_t& v) {
+  const uint8_t* s = (const uint8_t*) src;
+  uint8_t bad      = 0;
+  uint64_t r       = 0;
+  size_t i         = 0;
+
+  // up to 19 digits always fit, the 20th is checked for overflow below
+  if (len == 0 || len > 20) return false;
+
+  size_t n = len < 19 ? len : 19;
+
+#ifdef SCODEC_SWAR_DIGITS
+  for (; i + 8 <= n; i += 8) r = r * 100000000ULL + parse8(s + i, bad);
+#endif
+
+  for (; i < n; i++) {
+    uint8_t d = s[i] - '0';
+    bad |= d > 9;
+    r = r * 10 + d;
+  }
+
+  if (len == 20) {
+    // 18446744073709551615
+    uint8_t d = s[19] - '0';
+    bad |= d > 9;
+    if (r > 1844674407370955161ULL || (r == 1844674407370955161ULL && d > 5))
+      return false;
+    r = r * 10 + d;
+  }
+
+  if (bad) return false;
+
+  v = r;
+
+  return true;
+}
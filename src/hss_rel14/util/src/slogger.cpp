@@ -14,20 +14,131 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <list>
+
 #include "slogger.h"
+#include "sthread.h"
+
+// the sinks are flushed at this interval, as the spdlog async logger was
+#define SLOG_FLUSH_INTERVAL std::chrono::seconds(2)
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+//
+// Single background thread that renders the records captured by every
+// SLogger and writes them to the sinks.
+//
+class SLogWriter : public SThread {
+ public:
+  static void attach(SLogger* logger);
+  static void detach(SLogger* logger);
+
+  unsigned long threadProc(void* arg);
+
+ private:
+  static SLogWriter* m_singleton;
+  static SMutex m_mutex;
+  static std::list<SLogger*> m_loggers;
+};
+
+SLogWriter* SLogWriter::m_singleton = NULL;
+SMutex SLogWriter::m_mutex;
+std::list<SLogger*> SLogWriter::m_loggers;
+
+void SLogWriter::attach(SLogger* logger) {
+  SMutexLock l(m_mutex);
+
+  m_loggers.push_back(logger);
+
+  if (!m_singleton) {
+    m_singleton = new SLogWriter();
+    m_singleton->init(NULL);
+  }
+}
+
+void SLogWriter::detach(SLogger* logger) {
+  SLogWriter* writer = NULL;
+
+  {
+    SMutexLock l(m_mutex);
+
+    m_loggers.remove(logger);
+
+    if (m_loggers.empty()) {
+      writer      = m_singleton;
+      m_singleton = NULL;
+    }
+  }
+
+  // the thread exits once there are no loggers left to service
+  if (writer) {
+    writer->join();
+    delete writer;
+  }
+}
+
+unsigned long SLogWriter::threadProc(void* arg) {
+  int idle = 0;
+  std::chrono::steady_clock::time_point flushed =
+      std::chrono::steady_clock::now();
+
+  while (true) {
+    size_t cnt = 0;
+
+    {
+      SMutexLock l(m_mutex);
+
+      if (m_singleton != this) break;
+
+      for (std::list<SLogger*>::iterator it = m_loggers.begin();
+           it != m_loggers.end(); ++it)
+        cnt += (*it)->drain();
+
+      std::chrono::steady_clock::time_point now =
+          std::chrono::steady_clock::now();
+      if (now - flushed >= SLOG_FLUSH_INTERVAL) {
+        for (std::list<SLogger*>::iterator it = m_loggers.begin();
+             it != m_loggers.end(); ++it)
+          (*it)->m_log.flush();
+        flushed = now;
+      }
+    }
+
+    if (cnt > 0) {
+      idle = 0;
+    } else {
+      // back off up to 8ms while the queues are empty
+      if (idle < 8) idle++;
+      SThread::sleep(idle);
+    }
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
 
 SLogger::SLogger(
     const char* category, std::vector<spdlog::sink_ptr>& sinks,
     const char* pattern, size_t queue_size)
-    : m_log(
-          category, sinks.begin(), sinks.end(), queue_size,
-          spdlog::async_overflow_policy::discard_log_msg, nullptr,
-          std::chrono::seconds(2), nullptr) {
+    : m_log(category, sinks.begin(), sinks.end()), m_queue(queue_size) {
   m_log.set_pattern(pattern);
   m_log.flush_on(spdlog::level::err);
+
+  SLogWriter::attach(this);
+}
+
+SLogger::~SLogger() {
+  flush();
+  SLogWriter::detach(this);
 }
 
 void SLogger::trace(const char* format, ...) {
+  if (!m_log.should_log(spdlog::level::trace)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltTrace, format, args);
@@ -35,6 +146,8 @@ void SLogger::trace(const char* format, ...) {
 }
 
 void SLogger::trace(const std::string& format, ...) {
+  if (!m_log.should_log(spdlog::level::trace)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltTrace, format.c_str(), args);
@@ -42,6 +155,8 @@ void SLogger::trace(const std::string& format, ...) {
 }
 
 void SLogger::debug(const char* format, ...) {
+  if (!m_log.should_log(spdlog::level::debug)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltDebug, format, args);
@@ -49,6 +164,8 @@ void SLogger::debug(const char* format, ...) {
 }
 
 void SLogger::debug(const std::string& format, ...) {
+  if (!m_log.should_log(spdlog::level::debug)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltDebug, format.c_str(), args);
@@ -56,6 +173,8 @@ void SLogger::debug(const std::string& format, ...) {
 }
 
 void SLogger::info(const char* format, ...) {
+  if (!m_log.should_log(spdlog::level::info)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltInfo, format, args);
@@ -63,6 +182,8 @@ void SLogger::info(const char* format, ...) {
 }
 
 void SLogger::info(const std::string& format, ...) {
+  if (!m_log.should_log(spdlog::level::info)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltInfo, format.c_str(), args);
@@ -70,6 +191,8 @@ void SLogger::info(const std::string& format, ...) {
 }
 
 void SLogger::startup(const char* format, ...) {
+  if (!m_log.should_log(spdlog::level::warn)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltStartup, format, args);
@@ -77,6 +200,8 @@ void SLogger::startup(const char* format, ...) {
 }
 
 void SLogger::startup(const std::string& format, ...) {
+  if (!m_log.should_log(spdlog::level::warn)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltStartup, format.c_str(), args);
@@ -84,6 +209,8 @@ void SLogger::startup(const std::string& format, ...) {
 }
 
 void SLogger::warn(const char* format, ...) {
+  if (!m_log.should_log(spdlog::level::err)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltWarn, format, args);
@@ -91,6 +218,8 @@ void SLogger::warn(const char* format, ...) {
 }
 
 void SLogger::warn(const std::string& format, ...) {
+  if (!m_log.should_log(spdlog::level::err)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltWarn, format.c_str(), args);
@@ -98,6 +227,8 @@ void SLogger::warn(const std::string& format, ...) {
 }
 
 void SLogger::error(const char* format, ...) {
+  if (!m_log.should_log(spdlog::level::critical)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltError, format, args);
@@ -105,6 +236,8 @@ void SLogger::error(const char* format, ...) {
 }
 
 void SLogger::error(const std::string& format, ...) {
+  if (!m_log.should_log(spdlog::level::critical)) return;
+
   va_list args;
   va_start(args, format);
   log(_ltError, format.c_str(), args);
@@ -123,29 +256,58 @@ const std::string& SLogger::get_name() {
   return m_log.name();
 }
 
+void SLogger::flush() {
+  // wait for the writer thread to catch up with everything queued so far
+  size_t pos = m_queue.enqueued();
+  while (m_queue.dequeued() < pos) SThread::sleep(1);
+
+  m_log.flush();
+}
+
 void SLogger::log(_LogType lt, const char* format, va_list& args) {
-  char buffer[2048];
-
-  vsnprintf(buffer, sizeof(buffer), format, args);
-
-  switch (lt) {
-    case _ltTrace:
-      m_log.trace(buffer);
-      break;
-    case _ltDebug:
-      m_log.debug(buffer);
-      break;
-    case _ltInfo:
-      m_log.info(buffer);
-      break;
-    case _ltStartup:
-      m_log.warn(buffer);
-      break;
-    case _ltWarn:
-      m_log.error(buffer);
-      break;
-    case _ltError:
-      m_log.critical(buffer);
-      break;
+  SLogRecord* rec = m_queue.reserve();
+
+  // the queue is full, discard the message
+  if (!rec) return;
+
+  rec->level = lt;
+  SLogFormat::capture(*rec, format, args);
+
+  m_queue.commit(rec);
+}
+
+size_t SLogger::drain() {
+  char buffer[SLOG_MAX_MESSAGE];
+  size_t cnt = 0;
+  SLogRecord* rec;
+
+  while ((rec = m_queue.front())) {
+    const char* msg = SLogFormat::render(*rec, buffer, sizeof(buffer));
+
+    switch (rec->level) {
+      case _ltTrace:
+        m_log.trace(msg);
+        break;
+      case _ltDebug:
+        m_log.debug(msg);
+        break;
+      case _ltInfo:
+        m_log.info(msg);
+        break;
+      case _ltStartup:
+        m_log.warn(msg);
+        break;
+      case _ltWarn:
+        m_log.error(msg);
+        break;
+      case _ltError:
+        m_log.critical(msg);
+        break;
+    }
+
+    m_queue.release(rec);
+    cnt++;
   }
+
+  return cnt;
 }
@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "slogqueue.h"
+#include "satomic.h"
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+enum ArgType {
+  atNone,
+  atInt,
+  atLong,
+  atLongLong,
+  atSize,
+  atIntMax,
+  atPtrDiff,
+  atDouble,
+  atLongDouble,
+  atString,
+  atPointer,
+  atUnsupported
+};
+
+enum LengthModifier { lmNone, lmShort, lmLong, lmLongLong, lmLongDouble,
+                      lmSize, lmIntMax, lmPtrDiff };
+
+struct FormatSpec {
+  const char* begin;
+  size_t length;
+  int stars;
+  bool precstar;
+  int precision;
+  ArgType type;
+};
+
+#define SLOG_MAX_SPEC 32
+
+//
+// parses the conversion specification that starts at p ('%') and returns
+// a pointer to the first character following it
+//
+const char* parseSpec(const char* p, FormatSpec& spec) {
+  spec.begin     = p++;
+  spec.stars     = 0;
+  spec.precstar  = false;
+  spec.precision = -1;
+  spec.type      = atUnsupported;
+
+  if (*p == '%') {
+    spec.type   = atNone;
+    spec.length = 2;
+    return p + 1;
+  }
+
+  while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' ||
+         *p == '\'')
+    p++;
+
+  if (*p == '*') {
+    spec.stars++;
+    p++;
+  } else {
+    while (*p >= '0' && *p <= '9') p++;
+  }
+
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      spec.stars++;
+      spec.precstar = true;
+      p++;
+    } else {
+      spec.precision = 0;
+      while (*p >= '0' && *p <= '9') spec.precision = spec.precision * 10 + (*p++ - '0');
+    }
+  }
+
+  LengthModifier lm = lmNone;
+  switch (*p) {
+    case 'h':
+      lm = lmShort;
+      if (*++p == 'h') p++;
+      break;
+    case 'l':
+      lm = lmLong;
+      if (*++p == 'l') {
+        lm = lmLongLong;
+        p++;
+      }
+      break;
+    case 'q':
+      lm = lmLongLong;
+      p++;
+      break;
+    case 'L':
+      lm = lmLongDouble;
+      p++;
+      break;
+    case 'z':
+      lm = lmSize;
+      p++;
+      break;
+    case 'j':
+      lm = lmIntMax;
+      p++;
+      break;
+    case 't':
+      lm = lmPtrDiff;
+      p++;
+      break;
+  }
+
+  switch (*p) {
+    case 'd':
+    case 'i':
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      spec.type = lm == lmLong ?
+                      atLong :
+                      lm == lmLongLong ?
+                      atLongLong :
+                      lm == lmSize ?
+                      atSize :
+                      lm == lmIntMax ? atIntMax :
+                                       lm == lmPtrDiff ? atPtrDiff : atInt;
+      break;
+    case 'c':
+      spec.type = lm == lmLong ? atUnsupported : atInt;
+      break;
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      spec.type = lm == lmLongDouble ? atLongDouble : atDouble;
+      break;
+    case 's':
+      spec.type = lm == lmLong ? atUnsupported : atString;
+      break;
+    case 'p':
+      spec.type = atPointer;
+      break;
+    default:
+      // %n, %m, %C, %S and malformed specifications
+      spec.type = atUnsupported;
+      break;
+  }
+
+  if (*p) p++;
+
+  spec.length = p - spec.begin;
+  if (spec.length >= SLOG_MAX_SPEC) spec.type = atUnsupported;
+
+  return p;
+}
+
+inline void put(
+    char* dest, size_t destlen, size_t& ofs, const void* src, size_t len) {
+  if (ofs + len <= destlen) memcpy(dest + ofs, src, len);
+  ofs += len;
+}
+
+template <typename T>
+inline void get(const char* data, size_t& ofs, T& val) {
+  memcpy(&val, data + ofs, sizeof(T));
+  ofs += sizeof(T);
+}
+
+template <typename T>
+inline int emit(
+    char* buffer, size_t buflen, const char* spec, int stars, int* star,
+    T val) {
+  switch (stars) {
+    case 0:
+      return snprintf(buffer, buflen, spec, val);
+    case 1:
+      return snprintf(buffer, buflen, spec, star[0], val);
+    default:
+      return snprintf(buffer, buflen, spec, star[0], star[1], val);
+  }
+}
+
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+#define ENCODE_ARG(type)                                                       \
+  {                                                                            \
+    type v = va_arg(args, type);                                               \
+    put(dest, destlen, ofs, &v, sizeof(v));                                    \
+  }
+
+size_t SLogFormat::encode(
+    char* dest, size_t destlen, const char* format, va_list& args) {
+  size_t ofs = 0;
+
+  put(dest, destlen, ofs, format, strlen(format) + 1);
+
+  const char* p = format;
+  while (*p) {
+    if (*p != '%') {
+      p++;
+      continue;
+    }
+
+    FormatSpec spec;
+    p = parseSpec(p, spec);
+
+    if (spec.type == atUnsupported) return 0;
+    if (spec.type == atNone) continue;
+
+    int star = 0;
+    for (int i = 0; i < spec.stars; i++) {
+      star = va_arg(args, int);
+      put(dest, destlen, ofs, &star, sizeof(star));
+    }
+    if (spec.precstar) spec.precision = star;
+
+    switch (spec.type) {
+      case atInt:
+        ENCODE_ARG(int);
+        break;
+      case atLong:
+        ENCODE_ARG(long);
+        break;
+      case atLongLong:
+        ENCODE_ARG(long long);
+        break;
+      case atSize:
+        ENCODE_ARG(size_t);
+        break;
+      case atIntMax:
+        ENCODE_ARG(intmax_t);
+        break;
+      case atPtrDiff:
+        ENCODE_ARG(ptrdiff_t);
+        break;
+      case atDouble:
+        ENCODE_ARG(double);
+        break;
+      case atLongDouble:
+        ENCODE_ARG(long double);
+        break;
+      case atPointer:
+        ENCODE_ARG(void*);
+        break;
+      case atString: {
+        const char* s = va_arg(args, const char*);
+        if (!s) s = "(null)";
+        size_t len = spec.precision >= 0 ? strnlen(s, spec.precision) :
+                                           strnlen(s, SLOG_MAX_MESSAGE);
+        put(dest, destlen, ofs, s, len);
+        put(dest, destlen, ofs, "", 1);
+        break;
+      }
+      default:
+        return 0;
+    }
+  }
+
+  return ofs;
+}
+
+void SLogFormat::preformat(
+    SLogRecord& rec, const char* format, va_list& args) {
+  va_list cp;
+
+  va_copy(cp, args);
+  int len = vsnprintf(rec.payload, sizeof(rec.payload), format, cp);
+  va_end(cp);
+
+  if (len < 0) {
+    rec.payload[0] = '\0';
+    len            = 0;
+  } else if (len >= (int) sizeof(rec.payload)) {
+    size_t buflen = len < SLOG_MAX_MESSAGE ? len + 1 : SLOG_MAX_MESSAGE;
+    rec.overflow  = new char[buflen];
+    vsnprintf(rec.overflow, buflen, format, args);
+  }
+
+  rec.preformatted = true;
+  rec.length       = len;
+}
+
+void SLogFormat::capture(SLogRecord& rec, const char* format, va_list& args) {
+  va_list cp;
+
+  rec.overflow     = NULL;
+  rec.preformatted = false;
+
+  va_copy(cp, args);
+  size_t len = encode(rec.payload, sizeof(rec.payload), format, cp);
+  va_end(cp);
+
+  if (len == 0) {
+    preformat(rec, format, args);
+    return;
+  }
+
+  if (len > sizeof(rec.payload)) {
+    rec.overflow = new char[len];
+    va_copy(cp, args);
+    encode(rec.overflow, len, format, cp);
+    va_end(cp);
+  }
+
+  rec.length = len;
+}
+
+#define RENDER_ARG(type)                                                       \
+  {                                                                            \
+    type v;                                                                    \
+    get(data, ofs, v);                                                         \
+    n = emit(buffer + pos, buflen - pos, spectxt, spec.stars, star, v);        \
+  }
+
+const char* SLogFormat::render(
+    const SLogRecord& rec, char* buffer, size_t buflen) {
+  if (rec.preformatted) return rec.data();
+
+  const char* data = rec.data();
+  const char* p    = data;
+  size_t ofs       = strlen(data) + 1;
+  size_t pos       = 0;
+  char spectxt[SLOG_MAX_SPEC];
+
+  while (*p && pos < buflen - 1) {
+    if (*p != '%') {
+      buffer[pos++] = *p++;
+      continue;
+    }
+
+    FormatSpec spec;
+    p = parseSpec(p, spec);
+
+    if (spec.type == atNone) {
+      buffer[pos++] = '%';
+      continue;
+    }
+
+    memcpy(spectxt, spec.begin, spec.length);
+    spectxt[spec.length] = '\0';
+
+    int star[2] = {0, 0};
+    for (int i = 0; i < spec.stars; i++) get(data, ofs, star[i]);
+
+    int n = 0;
+    switch (spec.type) {
+      case atInt:
+        RENDER_ARG(int);
+        break;
+      case atLong:
+        RENDER_ARG(long);
+        break;
+      case atLongLong:
+        RENDER_ARG(long long);
+        break;
+      case atSize:
+        RENDER_ARG(size_t);
+        break;
+      case atIntMax:
+        RENDER_ARG(intmax_t);
+        break;
+      case atPtrDiff:
+        RENDER_ARG(ptrdiff_t);
+        break;
+      case atDouble:
+        RENDER_ARG(double);
+        break;
+      case atLongDouble:
+        RENDER_ARG(long double);
+        break;
+      case atPointer:
+        RENDER_ARG(void*);
+        break;
+      case atString: {
+        const char* s = data + ofs;
+        ofs += strlen(s) + 1;
+        n = emit(buffer + pos, buflen - pos, spectxt, spec.stars, star, s);
+        break;
+      }
+      default:
+        break;
+    }
+
+    if (n > 0) pos += (size_t) n < buflen - 1 - pos ? n : buflen - 1 - pos;
+  }
+
+  buffer[pos] = '\0';
+
+  return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+SLogQueue::SLogQueue(size_t capacity) {
+  size_t size = 2;
+  while (size < capacity) size <<= 1;
+
+  m_records = new SLogRecord[size];
+  for (size_t i = 0; i < size; i++) {
+    m_records[i].sequence = i;
+    m_records[i].overflow = NULL;
+  }
+
+  m_mask    = size - 1;
+  m_enqueue = 0;
+  m_dequeue = 0;
+  m_dropped = 0;
+}
+
+SLogQueue::~SLogQueue() {
+  for (size_t i = 0; i <= m_mask; i++) {
+    if (m_records[i].overflow) delete[] m_records[i].overflow;
+  }
+  delete[] m_records;
+}
+
+SLogRecord* SLogQueue::reserve() {
+  size_t pos = m_enqueue;
+
+  while (true) {
+    SLogRecord* rec = &m_records[pos & m_mask];
+    size_t seq      = rec->sequence;
+    __sync_synchronize();
+
+    intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+
+    if (diff == 0) {
+      size_t prev = atomic_cas(m_enqueue, pos, pos + 1);
+      if (prev == pos) {
+        rec->position = pos;
+        return rec;
+      }
+      pos = prev;
+    } else if (diff < 0) {
+      // the queue is full, discard the message
+      atomic_inc_fetch(m_dropped);
+      return NULL;
+    } else {
+      pos = m_enqueue;
+    }
+  }
+}
+
+void SLogQueue::commit(SLogRecord* rec) {
+  __sync_synchronize();
+  rec->sequence = rec->position + 1;
+}
+
+SLogRecord* SLogQueue::front() {
+  SLogRecord* rec = &m_records[m_dequeue & m_mask];
+  size_t seq      = rec->sequence;
+  __sync_synchronize();
+
+  return seq == m_dequeue + 1 ? rec : NULL;
+}
+
+void SLogQueue::release(SLogRecord* rec) {
+  if (rec->overflow) {
+    delete[] rec->overflow;
+    rec->overflow = NULL;
+  }
+
+  __sync_synchronize();
+  rec->sequence = m_dequeue + m_mask + 1;
+  m_dequeue     = m_dequeue + 1;
+}
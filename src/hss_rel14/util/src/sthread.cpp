@@ -274,8 +274,6 @@ SEventThread::Timer::Timer() {
   m_thread   = NULL;
   m_interval = 0;
   m_oneshot  = true;
-
-  m_timer = NULL;
 }
 
 SEventThread::Timer::Timer(long milliseconds, bool oneshot) {
@@ -284,8 +282,6 @@ SEventThread::Timer::Timer(long milliseconds, bool oneshot) {
   m_thread   = NULL;
   m_interval = milliseconds;
   m_oneshot  = oneshot;
-
-  m_timer = NULL;
 }
 
 SEventThread::Timer::~Timer() {
@@ -296,77 +292,32 @@ void SEventThread::Timer::init(SEventThread* pThread) {
   destroy();
 
   m_thread = pThread;
-
-  struct sigevent sev;
-  sev.sigev_notify          = SIGEV_SIGNAL;
-  sev.sigev_signo           = SIGRTMIN;
-  sev.sigev_value.sival_ptr = this;
-  if (timer_create(CLOCK_REALTIME, &sev, &m_timer) == -1)
-    SError::throwRuntimeExceptionWithErrno("Unable to initialize timer");
 }
 
 void SEventThread::Timer::destroy() {
-  if (m_timer != NULL) {
-    stop();
-    timer_delete(m_timer);
-    m_timer = NULL;
-  }
+  stop();
+  m_thread = NULL;
 }
 
 void SEventThread::Timer::start() {
-  // std::cout << "SEventThread::Timer::start() 1" << std::endl;
-  if (m_timer == NULL)
+  if (m_thread == NULL)
     SError::throwRuntimeException("Timer is not initialized");
 
-  struct itimerspec its;
-  its.it_value.tv_sec     = m_interval / 1000;              // seconds
-  its.it_value.tv_nsec    = (m_interval % 1000) * 1000000;  // nano-seconds
-  its.it_interval.tv_sec  = m_oneshot ? 0 : its.it_value.tv_sec;
-  its.it_interval.tv_nsec = m_oneshot ? 0 : its.it_value.tv_nsec;
-  // std::cout << "SEventThread::Timer::start() 2 - value.tv_sec=" <<
-  // its.it_value.tv_sec << " value.tv_nsec=" << its.it_value.tv_nsec << "
-  // interval.tv_sec=" << its.it_interval.tv_sec << " interval.tv_nsec=" <<
-  // its.it_interval.tv_nsec << std::endl;
-  if (timer_settime(m_timer, 0, &its, NULL) == -1)
-    SError::throwRuntimeExceptionWithErrno("Unable to start timer");
-  // std::cout << "SEventThread::Timer::start() 3" << std::endl;
-}
-
-void SEventThread::Timer::stop() {
-  if (m_timer != NULL) {
-    struct itimerspec its;
-    its.it_value.tv_sec     = 0;  // seconds
-    its.it_value.tv_nsec    = 0;  // nano-seconds
-    its.it_interval.tv_sec  = its.it_value.tv_sec;
-    its.it_interval.tv_nsec = its.it_value.tv_nsec;
-    timer_settime(m_timer, 0, &its, NULL);
+  // as with a zero timer_settime() value, a zero interval disarms the timer
+  if (m_interval <= 0) {
+    stop();
+    return;
   }
-}
 
-void SEventThread::Timer::_timerHandler(
-    int signo, siginfo_t* pinfo, void* pcontext) {
-  // std::cout << "SEventThread::Timer::_timerHandler() 1" << std::endl;
-  SEventThread::Timer* pTimer =
-      (SEventThread::Timer*) pinfo->si_value.sival_ptr;
-  if (pTimer) {
-    // std::cout << "SEventThread::Timer::_timerHandler() 2" << std::endl;
-    pTimer->m_thread->postMessage(new STimerMessage(pTimer));
-  }
+  STimerWheel::singleton().schedule(*this, m_interval, !m_oneshot);
 }
 
-SEventThread::TimerHandler _initTimerHandler;
-
-void SEventThread::TimerHandler::init() {
-  // std::cout << "SEventThread::TimerHandler::init()" << std::endl;
-  struct sigaction sa;
-  sa.sa_flags     = SA_SIGINFO;
-  sa.sa_sigaction = SEventThread::Timer::_timerHandler;
-  sigemptyset(&sa.sa_mask);
-  int signo = SIGRTMIN;
-  if (sigaction(signo, &sa, NULL) == -1)
-    SError::throwRuntimeExceptionWithErrno("Unable to register timer handler");
+void SEventThread::Timer::stop() {
+  // the wheel relinks a periodic entry as it expires, so the scheduled state
+  // is only checked with the wheel locked
+  if (m_thread != NULL) STimerWheel::singleton().cancel(*this);
 }
 
-void SEventThread::TimerHandler::uninit() {
-  // std::cout << "SEventThread::TimerHandler::uninit()" << std::endl;
+void SEventThread::Timer::onExpire() {
+  m_thread->postMessage(new STimerMessage(this));
 }
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2017 Sprint
+ *
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "serror.h"
+#include "sthread.h"
+#include "stimerwheel.h"
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+class STimerWheelThread : public SThread {
+ public:
+  STimerWheelThread(STimerWheel& wheel) : m_wheel(wheel) {}
+
+  unsigned long threadProc(void* arg) {
+    m_wheel.run();
+    return 0;
+  }
+
+ private:
+  STimerWheel& m_wheel;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+STimerWheel::Entry::Entry()
+    : m_prev(NULL), m_next(NULL), m_head(NULL), m_expires(0), m_interval(0) {}
+
+STimerWheel::Entry::~Entry() {
+  if (m_head) STimerWheel::singleton().cancel(*this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+STimerWheel& STimerWheel::singleton() {
+  // the wheel is never destroyed, entries owned by static objects may still
+  // be cancelled while the process exits
+  static STimerWheel* wheel = new STimerWheel();
+  return *wheel;
+}
+
+STimerWheel::STimerWheel() : m_current(0), m_count(0) {
+  for (int i = 0; i < RootSize; i++) m_root[i] = NULL;
+  for (int l = 0; l < Levels; l++)
+    for (int i = 0; i < LevelSize; i++) m_levels[l][i] = NULL;
+
+  m_timerfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (m_timerfd == -1)
+    SError::throwRuntimeExceptionWithErrno("Unable to create the timer wheel");
+
+  m_epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (m_epfd == -1)
+    SError::throwRuntimeExceptionWithErrno("Unable to create the timer wheel");
+
+  struct epoll_event ev;
+  ev.events  = EPOLLIN;
+  ev.data.fd = m_timerfd;
+  if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, m_timerfd, &ev) == -1)
+    SError::throwRuntimeExceptionWithErrno("Unable to create the timer wheel");
+
+  m_thread = new STimerWheelThread(*this);
+  m_thread->init(NULL);
+}
+
+STimerWheel::~STimerWheel() {}
+
+void STimerWheel::schedule(Entry& e, long milliseconds, bool periodic) {
+  uint64_t ticks = milliseconds <= 0 ?
+                       1 :
+                       (milliseconds + TickMilliseconds - 1) / TickMilliseconds;
+  SMutexLock l(m_mutex);
+
+  if (e.m_head) unlink(&e);
+
+  // the current tick may be partly over, an entry due in n ticks expires
+  // when tick m_current + n is processed so it never expires early
+  e.m_expires  = m_current + ticks;
+  e.m_interval = periodic ? ticks : 0;
+
+  add(&e);
+
+  if (m_count == 1) arm(true);
+}
+
+void STimerWheel::cancel(Entry& e) {
+  SMutexLock l(m_mutex);
+
+  if (!e.m_head) return;
+
+  unlink(&e);
+
+  if (m_count == 0) arm(false);
+}
+
+void STimerWheel::add(Entry* e) {
+  uint64_t expires = e->m_expires;
+  int64_t idx      = (int64_t)(expires - m_current);
+
+  if (idx < 0) {
+    link(e, &m_root[m_current & RootMask]);
+  } else if (idx < RootSize) {
+    link(e, &m_root[expires & RootMask]);
+  } else {
+    for (int l = 0; l < Levels; l++) {
+      int shift    = RootBits + l * LevelBits;
+      int64_t span = (int64_t) 1 << (shift + LevelBits);
+
+      if (idx < span || l == Levels - 1) {
+        // an entry beyond the top level is placed at its end and placed again
+        // once it has cascaded down to the root
+        if (idx >= span) expires = m_current + span - 1;
+        link(e, &m_levels[l][(expires >> shift) & LevelMask]);
+        break;
+      }
+    }
+  }
+}
+
+void STimerWheel::link(Entry* e, Entry** head) {
+  e->m_prev = NULL;
+  e->m_next = *head;
+  if (*head) (*head)->m_prev = e;
+  *head     = e;
+  e->m_head = head;
+  m_count++;
+}
+
+void STimerWheel::unlink(Entry* e) {
+  if (e->m_prev)
+    e->m_prev->m_next = e->m_next;
+  else
+    *e->m_head = e->m_next;
+  if (e->m_next) e->m_next->m_prev = e->m_prev;
+
+  e->m_prev = NULL;
+  e->m_next = NULL;
+  e->m_head = NULL;
+  m_count--;
+}
+
+// moves the entries of a slot to a list, so an entry can still be unlinked
+// while the list is being processed
+void STimerWheel::detach(Entry** slot, Entry*& list) {
+  list  = *slot;
+  *slot = NULL;
+
+  for (Entry* e = list; e; e = e->m_next) e->m_head = &list;
+}
+
+// moves the entries of the level's current slot to the lower levels, returns
+// true if the slot index has wrapped to zero so the next level is due as well
+bool STimerWheel::cascade(int level) {
+  int index = (m_current >> (RootBits + level * LevelBits)) & LevelMask;
+  Entry* list;
+
+  detach(&m_levels[level][index], list);
+
+  while (list) {
+    Entry* e = list;
+    unlink(e);
+    add(e);
+  }
+
+  return index == 0;
+}
+
+void STimerWheel::tick() {
+  int index = m_current & RootMask;
+  Entry* list;
+
+  if (index == 0 && cascade(0) && cascade(1)) cascade(2);
+
+  detach(&m_root[index], list);
+
+  while (list) {
+    Entry* e = list;
+    unlink(e);
+
+    if (e->m_expires > m_current) {
+      add(e);
+      continue;
+    }
+
+    if (e->m_interval) {
+      e->m_expires = m_current + e->m_interval;
+      add(e);
+    }
+
+    e->onExpire();
+  }
+
+  m_current++;
+}
+
+void STimerWheel::arm(bool on) {
+  struct itimerspec its;
+
+  its.it_value.tv_sec     = 0;
+  its.it_value.tv_nsec    = on ? TickMilliseconds * 1000000 : 0;
+  its.it_interval.tv_sec  = 0;
+  its.it_interval.tv_nsec = its.it_value.tv_nsec;
+
+  if (timerfd_settime(m_timerfd, 0, &its, NULL) == -1)
+    SError::throwRuntimeExceptionWithErrno("Unable to set the timer wheel");
+}
+
+void STimerWheel::run() {
+  while (true) {
+    struct epoll_event ev;
+    uint64_t expirations;
+
+    int n = epoll_wait(m_epfd, &ev, 1, -1);
+    if (n <= 0) continue;
+
+    // the timer may have been disarmed since it became readable
+    if (read(m_timerfd, &expirations, sizeof(expirations)) !=
+        sizeof(expirations))
+      continue;
+
+    SMutexLock l(m_mutex);
+
+    // ticks missed while the thread was not scheduled are caught up
+    while (expirations-- > 0 && m_count > 0) tick();
+
+    if (m_count == 0) arm(false);
+  }
+}